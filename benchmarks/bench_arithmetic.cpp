@@ -0,0 +1,103 @@
+//
+// Copyright (C) 2011-14 Mark Wiebe, DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <sstream>
+
+#include "benchmark.hpp"
+
+#include <dynd/array.hpp>
+#include <dynd/array_range.hpp>
+
+using namespace std;
+using namespace dynd;
+using namespace dynd::bench;
+
+namespace {
+    enum binary_op_t {
+        op_add,
+        op_subtract,
+        op_multiply,
+        op_divide
+    };
+
+    /**
+     * Measures building and evaluating an arithmetic expression on two
+     * one-dimensional arrays of arg(0) elements. When arg(1) is greater than
+     * one, the operands are views taking every arg(1)-th element.
+     */
+    void bm_binary_op(state& st, binary_op_t op, const ndt::type& tp0, const ndt::type& tp1)
+    {
+        intptr_t size = st.arg(0), step = st.arg(1);
+        nd::array a = nd::range(size * step).ucast(tp0).eval();
+        nd::array b = nd::range((intptr_t)1, size * step + 1).ucast(tp1).eval();
+        if (step > 1) {
+            a = a(irange().by(step));
+            b = b(irange().by(step));
+        }
+
+        nd::array c;
+        while (st.keep_running()) {
+            switch (op) {
+                case op_add:
+                    c = (a + b).eval();
+                    break;
+                case op_subtract:
+                    c = (a - b).eval();
+                    break;
+                case op_multiply:
+                    c = (a * b).eval();
+                    break;
+                case op_divide:
+                    c = (a / b).eval();
+                    break;
+            }
+        }
+        do_not_optimize(c.get_readonly_originptr());
+
+        st.set_items_processed((int64_t)st.iterations() * size);
+        stringstream ss;
+        ss << tp0 << ", " << tp1;
+        st.set_label(ss.str());
+    }
+
+    void bm_add_float64(state& st) {
+        bm_binary_op(st, op_add, ndt::make_type<double>(), ndt::make_type<double>());
+    }
+
+    void bm_add_int32(state& st) {
+        bm_binary_op(st, op_add, ndt::make_type<int32_t>(), ndt::make_type<int32_t>());
+    }
+
+    void bm_subtract_float32(state& st) {
+        bm_binary_op(st, op_subtract, ndt::make_type<float>(), ndt::make_type<float>());
+    }
+
+    void bm_multiply_int64(state& st) {
+        bm_binary_op(st, op_multiply, ndt::make_type<int64_t>(), ndt::make_type<int64_t>());
+    }
+
+    void bm_divide_float64(state& st) {
+        bm_binary_op(st, op_divide, ndt::make_type<double>(), ndt::make_type<double>());
+    }
+
+    void bm_add_complex_float64(state& st) {
+        bm_binary_op(st, op_add, ndt::make_type<dynd_complex<double> >(),
+                        ndt::make_type<dynd_complex<double> >());
+    }
+
+    vector<intptr_t> get_steps() {
+        vector<intptr_t> steps;
+        steps.push_back(1);
+        steps.push_back(3);
+        return steps;
+    }
+} // anonymous namespace
+
+DYND_BENCHMARK(bm_add_float64)->range_pair(1, 1 << 20, get_steps());
+DYND_BENCHMARK(bm_add_int32)->range_pair(1, 1 << 20, get_steps());
+DYND_BENCHMARK(bm_subtract_float32)->range_pair(1, 1 << 20, get_steps());
+DYND_BENCHMARK(bm_multiply_int64)->range_pair(1, 1 << 20, get_steps());
+DYND_BENCHMARK(bm_divide_float64)->range_pair(1, 1 << 20, get_steps());
+DYND_BENCHMARK(bm_add_complex_float64)->range_pair(1, 1 << 20, get_steps());
@@ -0,0 +1,104 @@
+//
+// Copyright (C) 2011-14 Mark Wiebe, DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <vector>
+#include <sstream>
+
+#include "benchmark.hpp"
+
+#include <dynd/type.hpp>
+#include <dynd/kernels/assignment_kernels.hpp>
+#include <dynd/types/byteswap_type.hpp>
+
+using namespace std;
+using namespace dynd;
+using namespace dynd::bench;
+
+namespace {
+    /**
+     * Measures a strided assignment kernel from src_tp to dst_tp, with
+     * arg(0) elements spaced arg(1) elements apart.
+     */
+    void bm_strided_assign(state& st, const ndt::type& dst_tp, const ndt::type& src_tp,
+                    assign_error_mode errmode)
+    {
+        intptr_t size = st.arg(0), stride = st.arg(1);
+        intptr_t dst_stride = stride * dst_tp.get_data_size();
+        intptr_t src_stride = stride * src_tp.get_data_size();
+        // All zero bytes are a valid value for every type benchmarked here
+        vector<char> dst(size * dst_stride), src(size * src_stride);
+
+        assignment_strided_ckernel_builder ckb;
+        make_assignment_kernel(&ckb, 0, dst_tp, NULL, src_tp, NULL,
+                        kernel_request_strided, errmode, &eval::default_eval_context);
+        while (st.keep_running()) {
+            ckb(&dst[0], dst_stride, &src[0], src_stride, size);
+        }
+        do_not_optimize(&dst[0]);
+
+        st.set_items_processed((int64_t)st.iterations() * size);
+        st.set_bytes_processed((int64_t)st.iterations() * size *
+                        (dst_tp.get_data_size() + src_tp.get_data_size()));
+        stringstream ss;
+        ss << dst_tp << " <- " << src_tp << ", " << errmode;
+        st.set_label(ss.str());
+    }
+
+    void bm_assign_float64_float64(state& st) {
+        bm_strided_assign(st, ndt::make_type<double>(), ndt::make_type<double>(),
+                        assign_error_none);
+    }
+
+    void bm_assign_int8_int8(state& st) {
+        bm_strided_assign(st, ndt::make_type<int8_t>(), ndt::make_type<int8_t>(),
+                        assign_error_none);
+    }
+
+    void bm_assign_float64_int32(state& st) {
+        bm_strided_assign(st, ndt::make_type<double>(), ndt::make_type<int32_t>(),
+                        assign_error_none);
+    }
+
+    void bm_assign_int32_float64_fractional(state& st) {
+        bm_strided_assign(st, ndt::make_type<int32_t>(), ndt::make_type<double>(),
+                        assign_error_fractional);
+    }
+
+    void bm_assign_int16_int64_overflow(state& st) {
+        bm_strided_assign(st, ndt::make_type<int16_t>(), ndt::make_type<int64_t>(),
+                        assign_error_overflow);
+    }
+
+    void bm_assign_float32_float64_inexact(state& st) {
+        bm_strided_assign(st, ndt::make_type<float>(), ndt::make_type<double>(),
+                        assign_error_inexact);
+    }
+
+    void bm_assign_float64_byteswap_int32(state& st) {
+        bm_strided_assign(st, ndt::make_type<double>(),
+                        ndt::make_byteswap(ndt::make_type<int32_t>()), assign_error_none);
+    }
+
+    void bm_assign_complex_float64_float32(state& st) {
+        bm_strided_assign(st, ndt::make_type<dynd_complex<double> >(), ndt::make_type<float>(),
+                        assign_error_none);
+    }
+
+    vector<intptr_t> get_strides() {
+        vector<intptr_t> strides;
+        strides.push_back(1);
+        strides.push_back(4);
+        return strides;
+    }
+} // anonymous namespace
+
+DYND_BENCHMARK(bm_assign_float64_float64)->range_pair(64, 1 << 21, get_strides());
+DYND_BENCHMARK(bm_assign_int8_int8)->range_pair(64, 1 << 21, get_strides());
+DYND_BENCHMARK(bm_assign_float64_int32)->range_pair(64, 1 << 21, get_strides());
+DYND_BENCHMARK(bm_assign_int32_float64_fractional)->range_pair(64, 1 << 21, get_strides());
+DYND_BENCHMARK(bm_assign_int16_int64_overflow)->range_pair(64, 1 << 21, get_strides());
+DYND_BENCHMARK(bm_assign_float32_float64_inexact)->range_pair(64, 1 << 21, get_strides());
+DYND_BENCHMARK(bm_assign_float64_byteswap_int32)->range_pair(64, 1 << 21, get_strides());
+DYND_BENCHMARK(bm_assign_complex_float64_float32)->range_pair(64, 1 << 21, get_strides());
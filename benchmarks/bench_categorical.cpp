@@ -0,0 +1,124 @@
+//
+// Copyright (C) 2011-14 Mark Wiebe, DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <sstream>
+
+#include "benchmark.hpp"
+
+#include <dynd/array.hpp>
+#include <dynd/types/string_type.hpp>
+#include <dynd/types/categorical_type.hpp>
+
+using namespace std;
+using namespace dynd;
+using namespace dynd::bench;
+
+namespace {
+    /**
+     * Returns a one-dimensional array of `size` strings, cycling
+     * through `ncats` distinct values in a scrambled order.
+     */
+    nd::array make_category_strings(intptr_t size, intptr_t ncats)
+    {
+        nd::array a = nd::make_strided_array(size, ndt::make_string());
+        for (intptr_t i = 0; i != size; ++i) {
+            stringstream ss;
+            ss << "category_" << ((i * 7919) % ncats);
+            a(i).vals() = ss.str();
+        }
+        return a;
+    }
+
+    /**
+     * Measures factor_categorical on arg(0) strings with
+     * arg(1) distinct values.
+     */
+    void bm_factor_categorical_string(state& st)
+    {
+        intptr_t size = st.arg(0), ncats = st.arg(1);
+        nd::array a = make_category_strings(size, ncats);
+        ndt::type cat_tp;
+        while (st.keep_running()) {
+            cat_tp = ndt::factor_categorical(a);
+        }
+        do_not_optimize(cat_tp.extended());
+
+        st.set_items_processed((int64_t)st.iterations() * size);
+        st.set_label(a.get_type().str());
+    }
+
+    /**
+     * Measures factor_categorical on arg(0) int32 values with
+     * arg(1) distinct values.
+     */
+    void bm_factor_categorical_int32(state& st)
+    {
+        intptr_t size = st.arg(0), ncats = st.arg(1);
+        nd::array a = nd::make_strided_array(size, ndt::make_type<int32_t>());
+        int32_t *data = reinterpret_cast<int32_t *>(a.get_readwrite_originptr());
+        for (intptr_t i = 0; i != size; ++i) {
+            data[i] = (int32_t)((i * 7919) % ncats);
+        }
+        ndt::type cat_tp;
+        while (st.keep_running()) {
+            cat_tp = ndt::factor_categorical(a);
+        }
+        do_not_optimize(cat_tp.extended());
+
+        st.set_items_processed((int64_t)st.iterations() * size);
+        st.set_label(a.get_type().str());
+    }
+
+    /**
+     * Measures assigning arg(0) strings with arg(1) distinct
+     * values to a categorical array, and back.
+     */
+    void bm_categorical_assign_string(state& st, bool to_categorical)
+    {
+        intptr_t size = st.arg(0), ncats = st.arg(1);
+        nd::array a = make_category_strings(size, ncats);
+        ndt::type cat_tp = ndt::factor_categorical(a);
+        nd::array c = nd::make_strided_array(size, cat_tp);
+        c.vals() = a;
+        nd::array s;
+        while (st.keep_running()) {
+            if (to_categorical) {
+                c.vals() = a;
+            } else {
+                // Strings can only be assigned once, so this includes an allocation
+                s = nd::make_strided_array(size, ndt::make_string());
+                s.vals() = c;
+            }
+        }
+        do_not_optimize(to_categorical ? c.get_readonly_originptr()
+                                       : s.get_readonly_originptr());
+
+        st.set_items_processed((int64_t)st.iterations() * size);
+        stringstream ss;
+        ss << ncats << " categories";
+        st.set_label(ss.str());
+    }
+
+    void bm_categorical_from_string(state& st) {
+        bm_categorical_assign_string(st, true);
+    }
+
+    void bm_categorical_to_string(state& st) {
+        bm_categorical_assign_string(st, false);
+    }
+
+    vector<intptr_t> get_category_counts() {
+        vector<intptr_t> ncats;
+        ncats.push_back(4);
+        ncats.push_back(256);
+        ncats.push_back(65536);
+        return ncats;
+    }
+} // anonymous namespace
+
+DYND_BENCHMARK(bm_factor_categorical_string)->range_pair(1 << 10, 1 << 16, get_category_counts(), 64);
+DYND_BENCHMARK(bm_factor_categorical_int32)->range_pair(1 << 10, 1 << 16, get_category_counts(), 64);
+DYND_BENCHMARK(bm_categorical_from_string)->range_pair(1 << 10, 1 << 16, get_category_counts(), 64);
+DYND_BENCHMARK(bm_categorical_to_string)->range_pair(1 << 10, 1 << 16, get_category_counts(), 64);
@@ -0,0 +1,103 @@
+//
+// Copyright (C) 2011-14 Mark Wiebe, DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <sstream>
+
+#include "benchmark.hpp"
+
+#include <dynd/array.hpp>
+#include <dynd/json_parser.hpp>
+#include <dynd/json_formatter.hpp>
+
+using namespace std;
+using namespace dynd;
+using namespace dynd::bench;
+
+namespace {
+    const char *record_dshape = "{id : int64, x : float64, name : string, flag : bool}";
+
+    /** Returns a JSON list of `count` integers */
+    string make_int_list_json(intptr_t count)
+    {
+        stringstream ss;
+        ss << "[";
+        for (intptr_t i = 0; i != count; ++i) {
+            ss << (i == 0 ? "" : ", ") << (i * 7919 - 1000000);
+        }
+        ss << "]";
+        return ss.str();
+    }
+
+    /** Returns a JSON list of `count` objects matching record_dshape */
+    string make_record_list_json(intptr_t count)
+    {
+        stringstream ss;
+        ss << "[";
+        for (intptr_t i = 0; i != count; ++i) {
+            ss << (i == 0 ? "" : ",\n");
+            ss << "{\"id\": " << i << ", \"x\": " << (i * 0.25 - 100.5);
+            ss << ", \"name\": \"item " << i << "\", \"flag\": ";
+            ss << ((i % 3 == 0) ? "true" : "false") << "}";
+        }
+        ss << "]";
+        return ss.str();
+    }
+
+    void bm_json(state& st, const string& json, const ndt::type& tp, bool format)
+    {
+        nd::array result;
+        if (format) {
+            nd::array a = parse_json(tp, json);
+            while (st.keep_running()) {
+                result = format_json(a);
+            }
+        } else {
+            while (st.keep_running()) {
+                result = parse_json(tp, json);
+            }
+        }
+        do_not_optimize(result.get_readonly_originptr());
+
+        st.set_items_processed((int64_t)st.iterations() * st.arg(0));
+        st.set_bytes_processed((int64_t)st.iterations() * json.size());
+        st.set_label(tp.str());
+    }
+
+    /** Returns the type "<count> * <dshape>" */
+    ndt::type make_fixed_dim_type(intptr_t count, const string& dshape)
+    {
+        stringstream ss;
+        ss << count << " * " << dshape;
+        return ndt::type(ss.str());
+    }
+
+    void bm_parse_json_int64_fixed(state& st) {
+        bm_json(st, make_int_list_json(st.arg(0)), make_fixed_dim_type(st.arg(0), "int64"), false);
+    }
+
+    void bm_parse_json_int64_var(state& st) {
+        bm_json(st, make_int_list_json(st.arg(0)), ndt::type("var * int64"), false);
+    }
+
+    void bm_parse_json_records(state& st) {
+        bm_json(st, make_record_list_json(st.arg(0)),
+                        ndt::type(string("var * ") + record_dshape), false);
+    }
+
+    void bm_format_json_int64(state& st) {
+        bm_json(st, make_int_list_json(st.arg(0)), make_fixed_dim_type(st.arg(0), "int64"), true);
+    }
+
+    void bm_format_json_records(state& st) {
+        bm_json(st, make_record_list_json(st.arg(0)),
+                        ndt::type(string("var * ") + record_dshape), true);
+    }
+} // anonymous namespace
+
+DYND_BENCHMARK(bm_parse_json_int64_fixed)->range(8, 1 << 17);
+DYND_BENCHMARK(bm_parse_json_int64_var)->range(8, 1 << 17);
+DYND_BENCHMARK(bm_parse_json_records)->range(8, 1 << 15);
+DYND_BENCHMARK(bm_format_json_int64)->range(8, 1 << 17);
+DYND_BENCHMARK(bm_format_json_records)->range(8, 1 << 15);
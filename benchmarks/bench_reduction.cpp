@@ -0,0 +1,111 @@
+//
+// Copyright (C) 2011-14 Mark Wiebe, DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <vector>
+
+#include "benchmark.hpp"
+
+#include <dynd/array.hpp>
+#include <dynd/kernels/reduction_kernels.hpp>
+#include <dynd/kernels/lift_reduction_ckernel_deferred.hpp>
+#include <dynd/types/ckernel_deferred_type.hpp>
+
+using namespace std;
+using namespace dynd;
+using namespace dynd::bench;
+
+namespace {
+    /**
+     * Measures the builtin strided sum reduction kernel, accumulating
+     * arg(0) elements spaced arg(1) elements apart into one value.
+     */
+    void bm_builtin_sum(state& st, type_id_t tid)
+    {
+        ndt::type tp(tid);
+        intptr_t size = st.arg(0), stride = st.arg(1);
+        intptr_t src_stride = stride * tp.get_data_size();
+        vector<char> src(size * src_stride), dst(tp.get_data_size());
+
+        assignment_strided_ckernel_builder ckb;
+        kernels::make_builtin_sum_reduction_ckernel(&ckb, 0, tid, kernel_request_strided);
+        while (st.keep_running()) {
+            // A zero dst stride accumulates everything into one value
+            ckb(&dst[0], 0, &src[0], src_stride, size);
+        }
+        do_not_optimize(&dst[0]);
+
+        st.set_items_processed((int64_t)st.iterations() * size);
+        st.set_bytes_processed((int64_t)st.iterations() * size * tp.get_data_size());
+        st.set_label(tp.str());
+    }
+
+    void bm_sum_int32(state& st) {
+        bm_builtin_sum(st, int32_type_id);
+    }
+
+    void bm_sum_int64(state& st) {
+        bm_builtin_sum(st, int64_type_id);
+    }
+
+    void bm_sum_float32(state& st) {
+        bm_builtin_sum(st, float32_type_id);
+    }
+
+    void bm_sum_float64(state& st) {
+        bm_builtin_sum(st, float64_type_id);
+    }
+
+    void bm_sum_complex_float64(state& st) {
+        bm_builtin_sum(st, complex_float64_type_id);
+    }
+
+    /**
+     * Measures the sum reduction lifted to reduce the inner dimension
+     * of an arg(0) by arg(1) float64 array, keeping the outer one.
+     */
+    void bm_lifted_sum_2d_inner(state& st)
+    {
+        intptr_t dim0 = st.arg(0), dim1 = st.arg(1);
+        nd::array reduction_kernel = nd::empty(ndt::make_ckernel_deferred());
+        kernels::make_builtin_sum_reduction_ckernel_deferred(
+                        reinterpret_cast<ckernel_deferred *>(reduction_kernel.get_readwrite_originptr()),
+                        float64_type_id);
+        ckernel_deferred ckd;
+        bool reduction_dimflags[2] = {false, true};
+        lift_reduction_ckernel_deferred(&ckd, reduction_kernel,
+                        ndt::type("strided * strided * float64"), nd::array(), false,
+                        2, reduction_dimflags, true, true, false, nd::array());
+
+        nd::array a = nd::make_strided_array(dim0, dim1, ndt::make_type<double>());
+        a.vals() = 1.0;
+        nd::array b = nd::make_strided_array(dim0, ndt::make_type<double>());
+
+        assignment_ckernel_builder ckb;
+        const char *dynd_metadata[2] = {b.get_ndo_meta(), a.get_ndo_meta()};
+        ckd.instantiate_func(ckd.data_ptr, &ckb, 0, dynd_metadata, kernel_request_single);
+        while (st.keep_running()) {
+            ckb(b.get_readwrite_originptr(), a.get_readonly_originptr());
+        }
+        do_not_optimize(b.get_readonly_originptr());
+
+        st.set_items_processed((int64_t)st.iterations() * dim0 * dim1);
+        st.set_label(a.get_type().str());
+    }
+
+    vector<intptr_t> get_strides() {
+        vector<intptr_t> strides;
+        strides.push_back(1);
+        strides.push_back(2);
+        return strides;
+    }
+} // anonymous namespace
+
+DYND_BENCHMARK(bm_sum_int32)->range_pair(64, 1 << 21, get_strides());
+DYND_BENCHMARK(bm_sum_int64)->range_pair(64, 1 << 21, get_strides());
+DYND_BENCHMARK(bm_sum_float32)->range_pair(64, 1 << 21, get_strides());
+DYND_BENCHMARK(bm_sum_float64)->range_pair(64, 1 << 21, get_strides());
+DYND_BENCHMARK(bm_sum_complex_float64)->range_pair(64, 1 << 21, get_strides());
+DYND_BENCHMARK(bm_lifted_sum_2d_inner)->args(1000, 10)->args(100, 100)->args(10, 1000)
+                ->args(1000, 1000);
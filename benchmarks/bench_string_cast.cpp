@@ -0,0 +1,116 @@
+//
+// Copyright (C) 2011-14 Mark Wiebe, DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <sstream>
+
+#include "benchmark.hpp"
+
+#include <dynd/array.hpp>
+#include <dynd/types/string_type.hpp>
+#include <dynd/types/fixedstring_type.hpp>
+
+using namespace std;
+using namespace dynd;
+using namespace dynd::bench;
+
+namespace {
+    /**
+     * Returns a one-dimensional array of `size` numbers of type num_tp,
+     * with a spread of magnitudes so the string lengths vary.
+     */
+    nd::array make_numbers(intptr_t size, const ndt::type& num_tp)
+    {
+        nd::array a = nd::make_strided_array(size, ndt::make_type<double>());
+        double *data = reinterpret_cast<double *>(a.get_readwrite_originptr());
+        for (intptr_t i = 0; i != size; ++i) {
+            data[i] = i * (i * 1.0625 - 37.5);
+        }
+        return a.ucast(num_tp, 0, assign_error_none).eval();
+    }
+
+    /**
+     * Measures assigning arg(0) numbers, printed as strings of type str_tp,
+     * to an array of num_tp.
+     */
+    void bm_string_to_number(state& st, const ndt::type& num_tp, const ndt::type& str_tp)
+    {
+        intptr_t size = st.arg(0);
+        nd::array s = nd::make_strided_array(size, str_tp);
+        s.vals() = make_numbers(size, num_tp);
+        nd::array n = nd::make_strided_array(size, num_tp);
+        while (st.keep_running()) {
+            n.vals() = s;
+        }
+        do_not_optimize(n.get_readonly_originptr());
+
+        st.set_items_processed((int64_t)st.iterations() * size);
+        stringstream ss;
+        ss << num_tp << " <- " << str_tp;
+        st.set_label(ss.str());
+    }
+
+    /**
+     * Measures assigning arg(0) numbers of type num_tp to an array
+     * of strings of type str_tp.
+     */
+    void bm_number_to_string(state& st, const ndt::type& str_tp, const ndt::type& num_tp)
+    {
+        intptr_t size = st.arg(0);
+        nd::array n = make_numbers(size, num_tp);
+        nd::array s = nd::make_strided_array(size, str_tp);
+        while (st.keep_running()) {
+            s.vals() = n;
+        }
+        do_not_optimize(s.get_readonly_originptr());
+
+        st.set_items_processed((int64_t)st.iterations() * size);
+        stringstream ss;
+        ss << str_tp << " <- " << num_tp;
+        st.set_label(ss.str());
+    }
+
+    void bm_string_to_int32(state& st) {
+        bm_string_to_number(st, ndt::make_type<int32_t>(), ndt::make_string());
+    }
+
+    void bm_string_to_int64(state& st) {
+        bm_string_to_number(st, ndt::make_type<int64_t>(), ndt::make_string());
+    }
+
+    void bm_string_to_float64(state& st) {
+        bm_string_to_number(st, ndt::make_type<double>(), ndt::make_string());
+    }
+
+    void bm_fixedstring_to_int32(state& st) {
+        bm_string_to_number(st, ndt::make_type<int32_t>(),
+                        ndt::make_fixedstring(24, string_encoding_utf_8));
+    }
+
+    void bm_int32_to_string(state& st) {
+        bm_number_to_string(st, ndt::make_string(), ndt::make_type<int32_t>());
+    }
+
+    void bm_int64_to_string(state& st) {
+        bm_number_to_string(st, ndt::make_string(), ndt::make_type<int64_t>());
+    }
+
+    void bm_float64_to_string(state& st) {
+        bm_number_to_string(st, ndt::make_string(), ndt::make_type<double>());
+    }
+
+    void bm_int32_to_fixedstring(state& st) {
+        bm_number_to_string(st, ndt::make_fixedstring(24, string_encoding_utf_8),
+                        ndt::make_type<int32_t>());
+    }
+} // anonymous namespace
+
+DYND_BENCHMARK(bm_string_to_int32)->range(8, 1 << 18);
+DYND_BENCHMARK(bm_string_to_int64)->range(8, 1 << 18);
+DYND_BENCHMARK(bm_string_to_float64)->range(8, 1 << 18);
+DYND_BENCHMARK(bm_fixedstring_to_int32)->range(8, 1 << 18);
+DYND_BENCHMARK(bm_int32_to_string)->range(8, 1 << 18);
+DYND_BENCHMARK(bm_int64_to_string)->range(8, 1 << 18);
+DYND_BENCHMARK(bm_float64_to_string)->range(8, 1 << 18);
+DYND_BENCHMARK(bm_int32_to_fixedstring)->range(8, 1 << 18);
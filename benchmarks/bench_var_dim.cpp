@@ -0,0 +1,157 @@
+//
+// Copyright (C) 2011-14 Mark Wiebe, DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <sstream>
+
+#include "benchmark.hpp"
+
+#include <dynd/array.hpp>
+#include <dynd/json_parser.hpp>
+
+using namespace std;
+using namespace dynd;
+using namespace dynd::bench;
+
+namespace {
+    /**
+     * Returns an arg(0) by up to arg(1) "var * var * int32" array,
+     * with row lengths varying between arg(1) / 2 and arg(1).
+     */
+    nd::array make_ragged(state& st)
+    {
+        intptr_t nrows = st.arg(0), maxlen = st.arg(1);
+        stringstream ss;
+        ss << "[";
+        for (intptr_t i = 0; i != nrows; ++i) {
+            intptr_t len = maxlen - (i * 7919) % (maxlen / 2 + 1);
+            ss << (i == 0 ? "[" : ", [");
+            for (intptr_t j = 0; j != len; ++j) {
+                ss << (j == 0 ? "" : ", ") << (i + j);
+            }
+            ss << "]";
+        }
+        ss << "]";
+        return parse_json(ndt::type("var * var * int32"), ss.str());
+    }
+
+    /**
+     * Measures assigning a "var * var * int32" array to
+     * a freshly allocated one of type dst_tp.
+     */
+    void bm_var_dim_assign(state& st, const ndt::type& dst_tp)
+    {
+        nd::array a = make_ragged(st);
+        nd::array b;
+        while (st.keep_running()) {
+            b = nd::empty(dst_tp);
+            b.vals() = a;
+        }
+        do_not_optimize(b.get_readonly_originptr());
+
+        intptr_t count = 0, nrows = a.get_dim_size();
+        for (intptr_t i = 0; i != nrows; ++i) {
+            count += a(i).get_dim_size();
+        }
+        st.set_items_processed((int64_t)st.iterations() * count);
+        stringstream ss;
+        ss << dst_tp << " <- " << a.get_type();
+        st.set_label(ss.str());
+    }
+
+    void bm_var_dim_assign_var_var(state& st) {
+        bm_var_dim_assign(st, ndt::type("var * var * int32"));
+    }
+
+    void bm_var_dim_assign_var_var_int64(state& st) {
+        bm_var_dim_assign(st, ndt::type("var * var * int64"));
+    }
+
+    /**
+     * Measures broadcasting a one-dimensional strided array into
+     * every row of an existing "var * var * int32" array.
+     */
+    void bm_var_dim_assign_broadcast(state& st)
+    {
+        // The parsed array is immutable, so copy it to get a writable one
+        nd::array a = nd::empty(ndt::type("var * var * int32"));
+        a.vals() = make_ragged(st);
+        nd::array row = nd::make_strided_array(1, ndt::make_type<int32_t>());
+        row.vals() = 3;
+        while (st.keep_running()) {
+            a.vals() = row;
+        }
+        do_not_optimize(a.get_readonly_originptr());
+
+        st.set_items_processed((int64_t)st.iterations() * a.get_dim_size());
+        st.set_label(a.get_type().str());
+    }
+
+    /**
+     * Measures indexing one element out of each row with a(i, j).
+     */
+    void bm_var_dim_index_element(state& st)
+    {
+        nd::array a = make_ragged(st);
+        intptr_t nrows = a.get_dim_size();
+        nd::array x;
+        while (st.keep_running()) {
+            for (intptr_t i = 0; i != nrows; ++i) {
+                x = a(i, 0);
+            }
+        }
+        do_not_optimize(x.get_readonly_originptr());
+
+        st.set_items_processed((int64_t)st.iterations() * nrows);
+        st.set_label(a.get_type().str());
+    }
+
+    /**
+     * Measures slicing every row with a(i, irange(1, -1)).
+     */
+    void bm_var_dim_index_slice(state& st)
+    {
+        nd::array a = make_ragged(st);
+        intptr_t nrows = a.get_dim_size();
+        nd::array x;
+        while (st.keep_running()) {
+            for (intptr_t i = 0; i != nrows; ++i) {
+                x = a(i, irange(1, -1));
+            }
+        }
+        do_not_optimize(x.get_readonly_originptr());
+
+        st.set_items_processed((int64_t)st.iterations() * nrows);
+        st.set_label(a.get_type().str());
+    }
+
+    /**
+     * Measures taking a view of each row with a(i).
+     */
+    void bm_var_dim_index_row(state& st)
+    {
+        nd::array a = make_ragged(st);
+        intptr_t nrows = a.get_dim_size();
+        nd::array x;
+        while (st.keep_running()) {
+            for (intptr_t i = 0; i != nrows; ++i) {
+                x = a(i);
+            }
+        }
+        do_not_optimize(x.get_readonly_originptr());
+
+        st.set_items_processed((int64_t)st.iterations() * nrows);
+        st.set_label(a.get_type().str());
+    }
+} // anonymous namespace
+
+DYND_BENCHMARK(bm_var_dim_assign_var_var)->args(1000, 4)->args(1000, 64)->args(100, 1024)
+                ->args(10000, 16);
+DYND_BENCHMARK(bm_var_dim_assign_var_var_int64)->args(1000, 4)->args(1000, 64)->args(100, 1024)
+                ->args(10000, 16);
+DYND_BENCHMARK(bm_var_dim_assign_broadcast)->args(1000, 4)->args(1000, 64)->args(100, 1024)
+                ->args(10000, 16);
+DYND_BENCHMARK(bm_var_dim_index_element)->args(1000, 4)->args(1000, 64);
+DYND_BENCHMARK(bm_var_dim_index_slice)->args(1000, 4)->args(1000, 64);
+DYND_BENCHMARK(bm_var_dim_index_row)->args(1000, 4)->args(1000, 64);
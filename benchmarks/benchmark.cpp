@@ -0,0 +1,395 @@
+//
+// Copyright (C) 2011-14 Mark Wiebe, DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#elif defined(__APPLE__)
+#include <sys/time.h>
+#else
+#include <time.h>
+#endif
+
+#include "benchmark.hpp"
+
+using namespace std;
+using namespace dynd;
+using namespace dynd::bench;
+
+namespace {
+    /** Returns a monotonic wall clock time in seconds */
+    double get_wall_time()
+    {
+#if defined(_WIN32)
+        LARGE_INTEGER freq, count;
+        QueryPerformanceFrequency(&freq);
+        QueryPerformanceCounter(&count);
+        return (double)count.QuadPart / (double)freq.QuadPart;
+#elif defined(__APPLE__)
+        struct timeval tv;
+        gettimeofday(&tv, NULL);
+        return tv.tv_sec + tv.tv_usec * 1e-6;
+#else
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return ts.tv_sec + ts.tv_nsec * 1e-9;
+#endif
+    }
+
+    /** Where do_not_optimize stores its pointer */
+    const void * volatile g_sink = NULL;
+
+    vector<benchmark *>& get_benchmarks()
+    {
+        static vector<benchmark *> benchmarks;
+        return benchmarks;
+    }
+
+    enum output_format_t {
+        output_format_console,
+        output_format_json,
+        output_format_csv
+    };
+
+    struct run_result {
+        string name;
+        string label;
+        intptr_t iterations;
+        double seconds;
+        int64_t items_processed, bytes_processed;
+    };
+
+    string get_run_name(const benchmark& b, const vector<intptr_t>& args)
+    {
+        stringstream ss;
+        ss << b.get_name();
+        for (size_t i = 0; i != args.size(); ++i) {
+            ss << "/" << args[i];
+        }
+        return ss.str();
+    }
+
+    /**
+     * Runs a benchmark with increasing iteration counts until the
+     * measured loop takes at least min_time seconds.
+     */
+    run_result run_benchmark(const benchmark& b, const vector<intptr_t>& args, double min_time)
+    {
+        intptr_t iterations = 1;
+        for (;;) {
+            state st(args, iterations);
+            b.get_function()(st);
+            double elapsed = st.get_elapsed();
+            if (elapsed >= min_time || iterations >= 1000000000) {
+                run_result r;
+                r.name = get_run_name(b, args);
+                r.label = st.get_label();
+                r.iterations = iterations;
+                r.seconds = elapsed;
+                r.items_processed = st.get_items_processed();
+                r.bytes_processed = st.get_bytes_processed();
+                return r;
+            }
+            // Predict the iteration count which reaches min_time, overshooting
+            // a little, and growing by at most a factor of 10 per attempt
+            double multiplier = elapsed > 0 ? min_time * 1.4 / elapsed : 10;
+            if (multiplier > 10) {
+                multiplier = 10;
+            } else if (multiplier < 2) {
+                multiplier = 2;
+            }
+            iterations = static_cast<intptr_t>(iterations * multiplier);
+        }
+    }
+
+    void print_json_string(ostream& o, const string& s)
+    {
+        o << "\"";
+        for (size_t i = 0; i != s.size(); ++i) {
+            char c = s[i];
+            if (c == '"' || c == '\\') {
+                o << '\\' << c;
+            } else if ((unsigned char)c < 0x20) {
+                o << "\\u" << hex << setw(4) << setfill('0') << (int)c << dec << setfill(' ');
+            } else {
+                o << c;
+            }
+        }
+        o << "\"";
+    }
+
+    void print_csv_string(ostream& o, const string& s)
+    {
+        o << "\"";
+        for (size_t i = 0; i != s.size(); ++i) {
+            if (s[i] == '"') {
+                o << "\"\"";
+            } else {
+                o << s[i];
+            }
+        }
+        o << "\"";
+    }
+
+    void print_header(ostream& o, output_format_t fmt)
+    {
+        switch (fmt) {
+            case output_format_console:
+                o << "libdynd " << dynd_version_string << " (" << dynd_git_sha1 << ")\n";
+                o << left << setw(48) << "Benchmark" << right << setw(14) << "Time(ns)";
+                o << setw(14) << "Iterations" << setw(16) << "Items/s" << setw(16) << "Bytes/s";
+                o << "  Label\n";
+                o << string(48 + 14 + 14 + 16 + 16 + 7, '-') << "\n";
+                break;
+            case output_format_json:
+                o << "{\n";
+                o << "  \"context\": {\n";
+                o << "    \"library\": \"libdynd\",\n";
+                o << "    \"version\": ";
+                print_json_string(o, dynd_version_string);
+                o << ",\n    \"git_sha1\": ";
+                print_json_string(o, dynd_git_sha1);
+                o << "\n  },\n";
+                o << "  \"benchmarks\": [";
+                break;
+            case output_format_csv:
+                o << "name,iterations,real_time_ns,items_per_second,bytes_per_second,label\n";
+                break;
+        }
+    }
+
+    void print_result(ostream& o, output_format_t fmt, const run_result& r, bool first)
+    {
+        double ns_per_iter = r.seconds * 1e9 / r.iterations;
+        double items_per_second = r.items_processed > 0 ? r.items_processed / r.seconds : 0;
+        double bytes_per_second = r.bytes_processed > 0 ? r.bytes_processed / r.seconds : 0;
+        switch (fmt) {
+            case output_format_console:
+                o << left << setw(48) << r.name << right << fixed << setprecision(0);
+                o << setw(14) << ns_per_iter << setw(14) << r.iterations;
+                o << scientific << setprecision(3);
+                if (items_per_second > 0) {
+                    o << setw(16) << items_per_second;
+                } else {
+                    o << setw(16) << "";
+                }
+                if (bytes_per_second > 0) {
+                    o << setw(16) << bytes_per_second;
+                } else {
+                    o << setw(16) << "";
+                }
+                o.unsetf(ios_base::floatfield);
+                o << "  " << r.label << endl;
+                break;
+            case output_format_json:
+                o << (first ? "\n" : ",\n");
+                o << "    {\n";
+                o << "      \"name\": ";
+                print_json_string(o, r.name);
+                o << ",\n      \"iterations\": " << r.iterations;
+                o << setprecision(6);
+                o << ",\n      \"real_time_ns\": " << ns_per_iter;
+                o << ",\n      \"items_per_second\": " << items_per_second;
+                o << ",\n      \"bytes_per_second\": " << bytes_per_second;
+                o << ",\n      \"label\": ";
+                print_json_string(o, r.label);
+                o << "\n    }";
+                o.flush();
+                break;
+            case output_format_csv:
+                print_csv_string(o, r.name);
+                o << "," << r.iterations << setprecision(6);
+                o << "," << ns_per_iter << "," << items_per_second << "," << bytes_per_second << ",";
+                print_csv_string(o, r.label);
+                o << endl;
+                break;
+        }
+    }
+
+    void print_footer(ostream& o, output_format_t fmt)
+    {
+        if (fmt == output_format_json) {
+            o << "\n  ]\n}\n";
+        }
+    }
+
+    void print_usage(ostream& o, const char *progname)
+    {
+        o << "Usage: " << progname << " [options]\n";
+        o << "  --format=console|json|csv  Output format (default console)\n";
+        o << "  --filter=STR               Only run benchmarks whose name contains STR\n";
+        o << "  --min_time=SECONDS         Minimum measured time per run (default 0.5)\n";
+        o << "  --list                     List the benchmark runs without running them\n";
+    }
+} // anonymous namespace
+
+state::state(const vector<intptr_t>& args, intptr_t max_iterations)
+    : m_args(args), m_iterations(0), m_max_iterations(max_iterations),
+        m_start_time(0), m_elapsed(0), m_running(false),
+        m_items_processed(0), m_bytes_processed(0)
+{
+}
+
+void state::start_timer()
+{
+    if (!m_running) {
+        m_start_time = get_wall_time();
+        m_running = true;
+    }
+}
+
+void state::stop_timer()
+{
+    if (m_running) {
+        m_elapsed += get_wall_time() - m_start_time;
+        m_running = false;
+    }
+}
+
+void state::pause_timing()
+{
+    stop_timer();
+}
+
+void state::resume_timing()
+{
+    start_timer();
+}
+
+intptr_t state::arg(size_t i) const
+{
+    if (i >= m_args.size()) {
+        stringstream ss;
+        ss << "benchmark argument " << i << " requested, but only ";
+        ss << m_args.size() << " were provided";
+        throw runtime_error(ss.str());
+    }
+    return m_args[i];
+}
+
+benchmark *benchmark::arg(intptr_t a0)
+{
+    m_arg_lists.push_back(vector<intptr_t>(1, a0));
+    return this;
+}
+
+benchmark *benchmark::args(intptr_t a0, intptr_t a1)
+{
+    vector<intptr_t> a(2);
+    a[0] = a0;
+    a[1] = a1;
+    m_arg_lists.push_back(a);
+    return this;
+}
+
+benchmark *benchmark::range(intptr_t lo, intptr_t hi, intptr_t multiplier)
+{
+    for (intptr_t a0 = lo; a0 <= hi; a0 *= multiplier) {
+        arg(a0);
+    }
+    return this;
+}
+
+benchmark *benchmark::range_pair(intptr_t lo0, intptr_t hi0, const vector<intptr_t>& a1_vals,
+                intptr_t multiplier)
+{
+    for (intptr_t a0 = lo0; a0 <= hi0; a0 *= multiplier) {
+        for (size_t i = 0; i != a1_vals.size(); ++i) {
+            args(a0, a1_vals[i]);
+        }
+    }
+    return this;
+}
+
+benchmark *dynd::bench::register_benchmark(const char *name, benchmark_function_t func)
+{
+    benchmark *b = new benchmark(name, func);
+    get_benchmarks().push_back(b);
+    return b;
+}
+
+void dynd::bench::do_not_optimize(const void *ptr)
+{
+    // A volatile store the compiler must keep, since
+    // it can't see what the caller did with ptr
+    g_sink = ptr;
+}
+
+int main(int argc, char **argv)
+{
+    output_format_t fmt = output_format_console;
+    string filter;
+    double min_time = 0.5;
+    bool list_only = false;
+
+    for (int i = 1; i < argc; ++i) {
+        const char *a = argv[i];
+        if (strncmp(a, "--format=", 9) == 0) {
+            if (strcmp(a + 9, "console") == 0) {
+                fmt = output_format_console;
+            } else if (strcmp(a + 9, "json") == 0) {
+                fmt = output_format_json;
+            } else if (strcmp(a + 9, "csv") == 0) {
+                fmt = output_format_csv;
+            } else {
+                cerr << "Unknown output format " << (a + 9) << "\n";
+                return 1;
+            }
+        } else if (strncmp(a, "--filter=", 9) == 0) {
+            filter = a + 9;
+        } else if (strncmp(a, "--min_time=", 11) == 0) {
+            min_time = atof(a + 11);
+        } else if (strcmp(a, "--list") == 0) {
+            list_only = true;
+        } else {
+            print_usage(cerr, argv[0]);
+            return (strcmp(a, "--help") == 0) ? 0 : 1;
+        }
+    }
+
+    const vector<benchmark *>& benchmarks = get_benchmarks();
+    if (!list_only) {
+        print_header(cout, fmt);
+    }
+    bool first = true, failed = false;
+    for (size_t i = 0; i != benchmarks.size(); ++i) {
+        const benchmark& b = *benchmarks[i];
+        vector<vector<intptr_t> > arg_lists = b.get_arg_lists();
+        if (arg_lists.empty()) {
+            arg_lists.push_back(vector<intptr_t>());
+        }
+        for (size_t j = 0; j != arg_lists.size(); ++j) {
+            string name = get_run_name(b, arg_lists[j]);
+            if (!filter.empty() && name.find(filter) == string::npos) {
+                continue;
+            }
+            if (list_only) {
+                cout << name << "\n";
+                continue;
+            }
+            try {
+                print_result(cout, fmt, run_benchmark(b, arg_lists[j], min_time), first);
+                first = false;
+            } catch (const exception& e) {
+                // Keep going, so one broken benchmark doesn't hide the rest
+                cerr << "Error running " << name << ": " << e.what() << endl;
+                failed = true;
+            }
+        }
+    }
+    if (!list_only) {
+        print_footer(cout, fmt);
+    }
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,167 @@
+//
+// Copyright (C) 2011-14 Mark Wiebe, DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#ifndef _DYND__BENCHMARK_HPP_
+#define _DYND__BENCHMARK_HPP_
+
+#include <string>
+#include <vector>
+
+#include <dynd/config.hpp>
+
+namespace dynd { namespace bench {
+
+/**
+ * The state passed to a benchmark function. The function does
+ * its setup, then runs the code being measured in a loop like
+ *
+ *      while (st.keep_running()) {
+ *          ...
+ *      }
+ *
+ * Only the time spent inside that loop is counted.
+ */
+class state {
+    std::vector<intptr_t> m_args;
+    intptr_t m_iterations, m_max_iterations;
+    double m_start_time, m_elapsed;
+    bool m_running;
+    int64_t m_items_processed, m_bytes_processed;
+    std::string m_label;
+
+    void start_timer();
+    void stop_timer();
+public:
+    state(const std::vector<intptr_t>& args, intptr_t max_iterations);
+
+    /**
+     * Returns true while the measured loop should keep going.
+     */
+    inline bool keep_running() {
+        if (m_iterations < m_max_iterations) {
+            if (m_iterations++ == 0) {
+                start_timer();
+            }
+            return true;
+        } else {
+            stop_timer();
+            return false;
+        }
+    }
+
+    /** Stops the timer, for setup which shouldn't be measured */
+    void pause_timing();
+    /** Restarts the timer after a pause_timing */
+    void resume_timing();
+
+    /** Returns the i-th argument the benchmark was registered with */
+    intptr_t arg(size_t i) const;
+
+    /** Returns the number of iterations of the measured loop */
+    intptr_t iterations() const {
+        return m_max_iterations;
+    }
+
+    /** Sets the total number of items processed by all the iterations */
+    void set_items_processed(int64_t items) {
+        m_items_processed = items;
+    }
+
+    /** Sets the total number of bytes processed by all the iterations */
+    void set_bytes_processed(int64_t bytes) {
+        m_bytes_processed = bytes;
+    }
+
+    /** Sets a string which describes the run, like the types involved */
+    void set_label(const std::string& label) {
+        m_label = label;
+    }
+
+    double get_elapsed() const {
+        return m_elapsed;
+    }
+
+    int64_t get_items_processed() const {
+        return m_items_processed;
+    }
+
+    int64_t get_bytes_processed() const {
+        return m_bytes_processed;
+    }
+
+    const std::string& get_label() const {
+        return m_label;
+    }
+};
+
+typedef void (*benchmark_function_t)(state& st);
+
+/**
+ * A registered benchmark function, together with the
+ * argument lists it gets run with.
+ */
+class benchmark {
+    std::string m_name;
+    benchmark_function_t m_func;
+    std::vector<std::vector<intptr_t> > m_arg_lists;
+public:
+    benchmark(const char *name, benchmark_function_t func)
+        : m_name(name), m_func(func)
+    {
+    }
+
+    /** Adds a run with the single argument a0 */
+    benchmark *arg(intptr_t a0);
+    /** Adds a run with the arguments a0 and a1 */
+    benchmark *args(intptr_t a0, intptr_t a1);
+    /**
+     * Adds runs for a0 = lo, lo * multiplier, ..., up to and including hi.
+     */
+    benchmark *range(intptr_t lo, intptr_t hi, intptr_t multiplier = 8);
+    /**
+     * Adds runs for every combination of a0 from range(lo0, hi0, multiplier)
+     * and a1 from the values in a1_vals.
+     */
+    benchmark *range_pair(intptr_t lo0, intptr_t hi0, const std::vector<intptr_t>& a1_vals,
+                    intptr_t multiplier = 8);
+
+    const std::string& get_name() const {
+        return m_name;
+    }
+
+    benchmark_function_t get_function() const {
+        return m_func;
+    }
+
+    const std::vector<std::vector<intptr_t> >& get_arg_lists() const {
+        return m_arg_lists;
+    }
+};
+
+/**
+ * Adds a benchmark to the global list, returning it so
+ * argument lists can be chained on.
+ */
+benchmark *register_benchmark(const char *name, benchmark_function_t func);
+
+/**
+ * Prevents the compiler from optimizing away a computed value.
+ */
+void do_not_optimize(const void *ptr);
+
+}} // namespace dynd::bench
+
+#define DYND_BENCHMARK_CONCAT_(a, b) a ## b
+#define DYND_BENCHMARK_CONCAT(a, b) DYND_BENCHMARK_CONCAT_(a, b)
+
+/**
+ * Registers the function `func` as a benchmark. Argument lists may be
+ * chained on, as in DYND_BENCHMARK(bm_copy)->range(1, 1 << 20);
+ */
+#define DYND_BENCHMARK(func) \
+    static ::dynd::bench::benchmark *DYND_BENCHMARK_CONCAT(dynd_benchmark_, __LINE__) = \
+        ::dynd::bench::register_benchmark(#func, func)
+
+#endif // _DYND__BENCHMARK_HPP_
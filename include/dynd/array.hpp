@@ -63,6 +63,12 @@ public:
     inline array(const array& rhs)
         : m_memblock(rhs.m_memblock)
     {}
+#ifdef DYND_RVALUE_REFS
+    /** Move constructs an array, leaving rhs NULL without touching the reference count */
+    inline array(array&& rhs)
+        : m_memblock(DYND_MOVE(rhs.m_memblock))
+    {}
+#endif // DYND_RVALUE_REFS
 
     /**
      * Constructs a zero-dimensional scalar from a C++ scalar.
@@ -304,6 +310,19 @@ public:
      */
     void flag_as_immutable();
 
+    /**
+     * Finalizes the memory blocks holding the variable-sized data of
+     * the array, so that no more memory is allocated from them. If
+     * 'compact' is true, the string and bytes data held by each memory
+     * block is also coalesced into a single exactly-sized buffer, and
+     * the pointers in the array are rewritten to match. Compaction
+     * requires that the caller has the only reference to this array
+     * and its data.
+     *
+     * \returns  The number of bytes reclaimed by compaction.
+     */
+    intptr_t finalize_buffers(bool compact = false);
+
     /** The flags, including access permissions. */
     inline uint64_t get_flags() const {
         return get_ndo()->m_flags;
@@ -492,6 +511,42 @@ public:
         return at_array(4, i);
     }
 
+    /**
+     * Indexes the array with integer indices, without creating a
+     * new array for the result. The leading strided_dim and fixed_dim
+     * dimensions are indexed in a single pass over their metadata.
+     *
+     * \param nindices  The number of indices.
+     * \param indices  The integer indices, which may be negative.
+     * \param out_tp  Is set to the type of the indexed element.
+     * \param out_metadata  Is set to the metadata of the indexed element.
+     *
+     * \returns  A pointer to the data of the indexed element, which
+     *           stays valid as long as this array does.
+     */
+    const char *get_element_ptr(intptr_t nindices, const intptr_t *indices,
+                    ndt::type& out_tp, const char *&out_metadata) const;
+
+    /**
+     * Returns the scalar at the integer index as a C++ value,
+     * equivalent to `a(i0).as<T>()` without allocating an array
+     * for the indexed element.
+     */
+    template<class T>
+    T get_at(intptr_t i0) const;
+
+    /** Returns the scalar at two integer indices as a C++ value */
+    template<class T>
+    T get_at(intptr_t i0, intptr_t i1) const;
+
+    /** Returns the scalar at three integer indices as a C++ value */
+    template<class T>
+    T get_at(intptr_t i0, intptr_t i1, intptr_t i2) const;
+
+    /** Returns the scalar at four integer indices as a C++ value */
+    template<class T>
+    T get_at(intptr_t i0, intptr_t i1, intptr_t i2, intptr_t i3) const;
+
     /** Does a value-assignment from the rhs array. */
     void val_assign(const array& rhs, assign_error_mode errmode = assign_error_default,
                         const eval::eval_context *ectx = &eval::default_eval_context) const;
@@ -1157,6 +1212,56 @@ T array::as(assign_error_mode errmode) const {
     return detail::array_as_helper<T>::as(*this, errmode);
 }
 
+namespace detail {
+    template <class T>
+    struct array_get_at_helper {
+        static typename enable_if<is_dynd_scalar<T>::value, T>::type get_at(const array& lhs,
+                        intptr_t nindices, const intptr_t *indices) {
+            ndt::type tp;
+            const char *metadata;
+            const char *data = lhs.get_element_ptr(nindices, indices, tp, metadata);
+            if (tp.is_builtin() && tp.unchecked_get_builtin_type_id() == static_cast<type_id_t>(type_id_of<T>::value)) {
+                // Load the value directly when no conversion is needed
+                return *reinterpret_cast<const T *>(data);
+            }
+            T result;
+            typed_data_assign(ndt::make_type<T>(), NULL, (char *)&result,
+                        tp, metadata, data, assign_error_default);
+            return result;
+        }
+    };
+
+    template <>
+    struct array_get_at_helper<bool> {
+        static bool get_at(const array& lhs, intptr_t nindices, const intptr_t *indices) {
+            return array_get_at_helper<dynd_bool>::get_at(lhs, nindices, indices);
+        }
+    };
+} // namespace detail
+
+template<class T>
+T array::get_at(intptr_t i0) const {
+    return detail::array_get_at_helper<T>::get_at(*this, 1, &i0);
+}
+
+template<class T>
+T array::get_at(intptr_t i0, intptr_t i1) const {
+    intptr_t i[2] = {i0, i1};
+    return detail::array_get_at_helper<T>::get_at(*this, 2, i);
+}
+
+template<class T>
+T array::get_at(intptr_t i0, intptr_t i1, intptr_t i2) const {
+    intptr_t i[3] = {i0, i1, i2};
+    return detail::array_get_at_helper<T>::get_at(*this, 3, i);
+}
+
+template<class T>
+T array::get_at(intptr_t i0, intptr_t i1, intptr_t i2, intptr_t i3) const {
+    intptr_t i[4] = {i0, i1, i2, i3};
+    return detail::array_get_at_helper<T>::get_at(*this, 4, i);
+}
+
 /** 
  * Given the type/metadata/data of an array (or sub-component of an array),
  * evaluates a new copy of it as the canonical type.
@@ -17,23 +17,84 @@
 
 #include <dynd/config.hpp>
 
-#ifdef DYND_USE_STD_ATOMIC
+#if defined(DYND_NONATOMIC_REFCOUNT)
+// Plain integer reference counts, set by the DYND_NONATOMIC_REFCOUNT
+// CMake option through the generated dynd/build_config.hpp. Such a build
+// is single-threaded only: the builtin types, the type intern table and
+// the datashape cache are shared by the whole process, so even separate
+// arrays may not be used from different threads.
+namespace dynd {
+    class atomic_refcount {
+        int32_t m_refcount;
+
+        atomic_refcount(const atomic_refcount&);
+        atomic_refcount& operator=(const atomic_refcount&);
+    public:
+        explicit atomic_refcount(uint32_t val)
+            : m_refcount(val)
+        {
+        }
+
+        int32_t operator++()
+        {
+            return ++m_refcount;
+        }
+
+        int32_t operator--()
+        {
+            return --m_refcount;
+        }
+
+        operator int32_t() const
+        {
+            return m_refcount;
+        }
+
+        bool increment_if_nonzero()
+        {
+            if (m_refcount != 0) {
+                ++m_refcount;
+                return true;
+            }
+            return false;
+        }
+    };
+} // namespace dynd
+#elif defined(DYND_USE_STD_ATOMIC)
 #include <atomic>
 namespace dynd {
     typedef std::atomic<int32_t> atomic_refcount;
+
+    /**
+     * Increments the reference count unless it is zero,
+     * returning whether it was incremented.
+     */
+    inline bool atomic_refcount_increment_if_nonzero(atomic_refcount& rc)
+    {
+        int32_t old = rc.load();
+        while (old != 0) {
+            if (rc.compare_exchange_weak(old, old + 1)) {
+                return true;
+            }
+        }
+        return false;
+    }
 } // namespace dynd
 #elif defined(_WIN32)
 
 #if defined( __CLRCALL_PURE_OR_CDECL )
 extern "C" long __CLRCALL_PURE_OR_CDECL _InterlockedIncrement( long volatile * );
 extern "C" long __CLRCALL_PURE_OR_CDECL _InterlockedDecrement( long volatile * );
+extern "C" long __CLRCALL_PURE_OR_CDECL _InterlockedCompareExchange( long volatile *, long, long );
 #else
 extern "C" long __cdecl _InterlockedIncrement( long volatile * );
 extern "C" long __cdecl _InterlockedDecrement( long volatile * );
+extern "C" long __cdecl _InterlockedCompareExchange( long volatile *, long, long );
 #endif
 
 #pragma intrinsic(_InterlockedIncrement)
 #pragma intrinsic(_InterlockedDecrement)
+#pragma intrinsic(_InterlockedCompareExchange)
 
 namespace dynd {
     class atomic_refcount {
@@ -57,6 +118,19 @@ namespace dynd {
             return _InterlockedDecrement((long *)&m_refcount);
         }
 
+        bool increment_if_nonzero()
+        {
+            long old = static_cast<const volatile int32_t&>(m_refcount);
+            while (old != 0) {
+                long prev = _InterlockedCompareExchange((long *)&m_refcount, old + 1, old);
+                if (prev == old) {
+                    return true;
+                }
+                old = prev;
+            }
+            return false;
+        }
+
         operator int32_t() const
         {
             return static_cast<const volatile int32_t&>(m_refcount);
@@ -96,6 +170,19 @@ namespace dynd {
             return atomic_exchange_and_add(&m_refcount, -1) - 1;
         }
 
+        bool increment_if_nonzero()
+        {
+            int32_t old = atomic_exchange_and_add(&m_refcount, 0);
+            while (old != 0) {
+                int32_t prev = __sync_val_compare_and_swap(&m_refcount, old, old + 1);
+                if (prev == old) {
+                    return true;
+                }
+                old = prev;
+            }
+            return false;
+        }
+
         operator int32_t() const
         {
             return atomic_exchange_and_add((int32_t *)&m_refcount, 0);
@@ -125,4 +212,17 @@ namespace dynd {
 } // namespace dynd
 #endif
 
+#ifndef DYND_USE_STD_ATOMIC
+namespace dynd {
+    /**
+     * Increments the reference count unless it is zero,
+     * returning whether it was incremented.
+     */
+    inline bool atomic_refcount_increment_if_nonzero(atomic_refcount& rc)
+    {
+        return rc.increment_if_nonzero();
+    }
+} // namespace dynd
+#endif
+
 #endif // _DYND__ATOMIC_REFCOUNT_HPP_
@@ -7,37 +7,125 @@
 #define _DYND__CODEGEN_CACHE_HPP_
 
 #include <map>
+#include <list>
 #include <iostream>
 #include <string>
 
 #include <dynd/type.hpp>
+#include <dynd/platform_mutex.hpp>
 #include <dynd/codegen/calling_conventions.hpp>
+#include <dynd/codegen/strided_loop_codegen.hpp>
+#include <dynd/kernels/ckernel_builder.hpp>
 
 namespace dynd {
 
+/**
+ * Counters describing how well a codegen_cache is working.
+ */
+struct codegen_cache_stats {
+    /** Number of lookups which found already generated code */
+    size_t hits;
+    /** Number of lookups which generated code */
+    size_t misses;
+    /** Number of generated functions dropped to stay within the capacity */
+    size_t evictions;
+    /** Number of generated functions currently cached */
+    size_t size;
+};
+
 /**
  * This class owns an executable_memory_block, and provides a caching
  * interface to kernel adapters that require codegen.
+ *
+ * The cache holds at most a fixed number of generated functions, dropping
+ * the least recently used one when it's full. Executable memory can't be
+ * freed a function at a time, so once as many dropped functions as the
+ * capacity have accumulated in the current executable memory block, the
+ * cache starts a new one. The old block is freed when the last cached
+ * function or ckernel using it goes away.
+ *
+ * All the member functions may be called from multiple threads.
  */
 class codegen_cache {
-    /** The memory block all the generated code goes into */
+    struct cached_strided_loop {
+        uint64_t unique_id;
+        unary_strided_operation_t loop;
+        /** The executable memory block the loop was generated into */
+        memory_block_ptr exec_memblock;
+    };
+    typedef std::list<cached_strided_loop> strided_loop_list;
+
+    mutable platform_mutex m_mutex;
+    /** The memory block new generated code goes into */
     memory_block_ptr m_exec_memblock;
+    /** The cached strided loops, most recently used first */
+    strided_loop_list m_strided_loops;
+    /** A mapping from strided loop unique id to its place in m_strided_loops */
+    std::map<uint64_t, strided_loop_list::iterator> m_strided_loop_index;
+    size_t m_capacity;
+    /** Number of evicted functions whose code is still in m_exec_memblock */
+    size_t m_dead_count;
+    codegen_cache_stats m_stats;
+
+    /**
+     * Finds or generates the strided loop, returning NULL if unsupported.
+     * If out_exec_memblock is not NULL, it receives a new reference to
+     * the loop's executable memory block. Must be called with m_mutex held.
+     */
+    unary_strided_operation_t lookup_strided_loop(const strided_loop_signature& sig,
+                    memory_block_data **out_exec_memblock);
+
+    // Non-copyable
+    codegen_cache(const codegen_cache&);
+    codegen_cache& operator=(const codegen_cache&);
     /** A mapping from unary kernel adapter unique id to the generated kernel adapter */
 //    std::map<uint64_t, unary_operation_pair_t> m_cached_unary_kernel_adapters;
     /** A mapping from binary kernel adapter unique id to the generated kernel adapter */
 //    std::map<uint64_t, binary_operation_pair_t> m_cached_binary_kernel_adapters;
 public:
-    codegen_cache();
+    /**
+     * Constructs a codegen cache.
+     *
+     * @param capacity  The maximum number of generated functions to keep.
+     */
+    explicit codegen_cache(size_t capacity = 256);
 
     /**
      * Returns the executable memory block that
      * this codegen cache generates into.
      */
-    const memory_block_ptr& get_exec_memblock()
-    {
-        return m_exec_memblock;
+    memory_block_ptr get_exec_memblock() const;
+
+    /** Returns the maximum number of generated functions kept */
+    size_t get_capacity() const {
+        return m_capacity;
     }
 
+    /** Returns a snapshot of the cache statistics */
+    codegen_cache_stats get_stats() const;
+
+    /**
+     * Returns the generated strided loop for the signature, generating
+     * it if it isn't in the cache yet. Returns NULL if the signature
+     * isn't supported on this platform.
+     *
+     * The returned function may be freed once it's evicted from the cache,
+     * so use make_strided_loop_kernel to hold on to it.
+     */
+    unary_strided_operation_t codegen_strided_loop(const strided_loop_signature& sig);
+
+    /**
+     * Makes a strided ckernel which calls the generated strided loop
+     * for the signature. The ckernel holds a reference to the executable
+     * memory, so it may outlive the cache.
+     *
+     * @return  The offset after the created ckernel, or zero if no
+     *          kernel could be generated. Only kernel_request_strided
+     *          requests are supported.
+     */
+    size_t make_strided_loop_kernel(ckernel_builder *out, size_t offset_out,
+                    const strided_loop_signature& sig, kernel_request_t kernreq);
+
     /**
      * Generates the requested unary function adapter, and returns a
      * specialized unary kernel for it. Reuses the low level generated
@@ -76,6 +164,12 @@ public:
     void debug_print(std::ostream& o, const std::string& indent = "") const;
 };
 
+/**
+ * Returns the codegen cache which the assignment kernels
+ * use for generated strided loops.
+ */
+codegen_cache& get_default_codegen_cache();
+
 } // namespace dynd
 
 #endif // _DYND__CODEGEN_CACHE_HPP_
@@ -0,0 +1,76 @@
+//
+// Copyright (C) 2011-14 Mark Wiebe, DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#ifndef _DYND__STRIDED_LOOP_CODEGEN_HPP_
+#define _DYND__STRIDED_LOOP_CODEGEN_HPP_
+
+#include <string>
+
+#include <dynd/type.hpp>
+#include <dynd/memblock/memory_block.hpp>
+#include <dynd/kernels/assignment_kernels.hpp>
+
+namespace dynd {
+
+/**
+ * Describes the element operation of a strided loop to generate
+ * machine code for. Each element is loaded as src_type_id, byteswapped
+ * if src_byteswap is set, converted to dst_type_id as by a static_cast
+ * (no error checking), byteswapped if dst_byteswap is set, and stored.
+ * The loaded and stored values don't need to be aligned.
+ */
+struct strided_loop_signature {
+    type_id_t dst_type_id, src_type_id;
+    bool dst_byteswap, src_byteswap;
+
+    strided_loop_signature()
+        : dst_type_id(uninitialized_type_id), src_type_id(uninitialized_type_id),
+            dst_byteswap(false), src_byteswap(false)
+    {
+    }
+
+    strided_loop_signature(type_id_t dst_tid, bool dst_swap, type_id_t src_tid, bool src_swap)
+        : dst_type_id(dst_tid), src_type_id(src_tid),
+            dst_byteswap(dst_swap), src_byteswap(src_swap)
+    {
+    }
+};
+
+/**
+ * Returns true if strided loops with the signature can be generated
+ * on this platform.
+ */
+bool is_strided_loop_codegen_supported(const strided_loop_signature& sig);
+
+/**
+ * This returns an integer ID that uniquely identifies the
+ * strided loop produced by codegen_strided_loop. If two
+ * signatures produce the same unique ID, they would also
+ * produce the same generated code.
+ */
+uint64_t get_strided_loop_unique_id(const strided_loop_signature& sig);
+
+/**
+ * Gets the unique integer ID in a string form, hopefully in human
+ * readable form.
+ */
+std::string get_strided_loop_unique_id_string(uint64_t unique_id);
+
+/**
+ * Generates machine code for a strided loop with the given signature,
+ * as a unary strided kernel function which ignores its ckernel_prefix.
+ *
+ * @param exec_memblock  An executable_memory_block where memory for the
+ *                       code generation is used.
+ * @param sig            The operation to do on each element.
+ *
+ * @return  The generated function, or NULL if the signature isn't supported.
+ */
+unary_strided_operation_t codegen_strided_loop(const memory_block_ptr& exec_memblock,
+                const strided_loop_signature& sig);
+
+} // namespace dynd
+
+#endif // _DYND__STRIDED_LOOP_CODEGEN_HPP_
@@ -18,6 +18,11 @@
 
 # define DYND_USE_STDINT
 
+#if __has_feature(cxx_thread_local)
+// Use C++11 thread_local with dynamic destruction
+#  define DYND_THREAD_LOCAL thread_local
+#endif
+
 #include <cmath>
 
 // Ran into some weird issues with
@@ -53,6 +58,12 @@ inline bool DYND_ISNAN(long double x) {
 #  define DYND_ISNAN(x) isnan(x)
 #endif
 
+#if (__GNUC__ > 4 || (__GNUC__ == 4 && (__GNUC_MINOR__ >= 8))) && \
+            __cplusplus >= 201103L
+// Use C++11 thread_local with dynamic destruction on gcc >= 4.8
+#  define DYND_THREAD_LOCAL thread_local
+#endif
+
 
 // Check for __float128 (added in gcc 4.6)
 // #if __GNUC__ > 4 || (__GNUC__ == 4 && (__GNUC_MINOR__ >= 6))
@@ -75,6 +86,11 @@ inline bool DYND_ISNAN(long double x) {
 // is #pragma fenv_access(on), which works.
 # define DYND_USE_FPSTATUS
 
+# if _MSC_VER >= 1900
+// Use C++11 thread_local with dynamic destruction
+#  define DYND_THREAD_LOCAL thread_local
+# endif
+
 # if _MSC_VER >= 1600
 // Use enable_if from std::tr1
 #  define DYND_USE_TR1_ENABLE_IF
@@ -186,6 +202,17 @@ namespace dynd {
 # define DYND_ASSIGNMENT_TRACING 0
 #endif
 
+/**
+ * This preprocessor symbol enables or disables reporting
+ * when make_kernreq_to_single_kernel_adapter inserts an
+ * adapter which calls a single kernel once per element.
+ *
+ * See diagnostics.hpp for the macros which use this.
+ */
+#ifndef DYND_KERNREQ_ADAPTER_TRACING
+# define DYND_KERNREQ_ADAPTER_TRACING 0
+#endif
+
 
 /**
  * Preprocessor macro for marking variables unused, and suppressing
@@ -234,6 +261,7 @@ namespace dynd {
     bool built_with_cuda();
 } // namespace dynd
 
+#include <dynd/build_config.hpp>
 #include <dynd/cuda_config.hpp>
 
 #endif // _DYND__CONFIG_HPP_
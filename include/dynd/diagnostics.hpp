@@ -49,9 +49,21 @@
 # define DYND_TRACE_ASSIGNMENT(dst_value, dst_type, src_value, src_type) {}
 #endif
 
+#if DYND_KERNREQ_ADAPTER_TRACING
+#include <iostream>
+#include <sstream>
+# define DYND_TRACE_KERNREQ_ADAPTER(out, offset_out) { \
+        std::cerr << "Inserted a single as strided ckernel adapter at offset " << (offset_out) \
+                << " of ckernel_builder " << ((const void *)(out)) << std::endl; \
+    }
+#else
+# define DYND_TRACE_KERNREQ_ADAPTER(out, offset_out) {}
+#endif
+
 namespace dynd {
 
-#define DYND_ANY_DIAGNOSTICS_ENABLED ((DYND_ALIGNMENT_ASSERTIONS != 0) || (DYND_ASSIGNMENT_TRACING != 0))
+#define DYND_ANY_DIAGNOSTICS_ENABLED ((DYND_ALIGNMENT_ASSERTIONS != 0) || (DYND_ASSIGNMENT_TRACING != 0) || \
+                (DYND_KERNREQ_ADAPTER_TRACING != 0))
 
 /**
  * This function returns true if any diagnostics, which might
@@ -80,6 +92,9 @@ inline std::string which_diagnostics_enabled()
 #if DYND_ASSIGNMENT_TRACING
     ss << "DYND_ASSIGNMENT_TRACING - prints individual builtin assignment operations\n";
 #endif // DYND_ASSIGNMENT_TRACING
+#if DYND_KERNREQ_ADAPTER_TRACING
+    ss << "DYND_KERNREQ_ADAPTER_TRACING - prints when a single kernel is adapted to a strided request\n";
+#endif // DYND_KERNREQ_ADAPTER_TRACING
     return ss.str();
 #else
     return "";
@@ -9,15 +9,37 @@
 #include <dynd/config.hpp>
 #include <dynd/typed_data_assign.hpp>
 
-namespace dynd { namespace eval {
+namespace dynd {
+
+class ckernel_profiler;
+
+namespace eval {
+
+class thread_pool;
 
 struct eval_context {
     assign_error_mode default_assign_error_mode;
     assign_error_mode default_cuda_device_to_device_assign_error_mode;
+    /**
+     * When not NULL, the ckernels built with this context are
+     * instrumented to record their counts and timings here.
+     */
+    ckernel_profiler *profiler;
+    /**
+     * When not NULL, eval() of arrays with a strided outermost
+     * dimension splits that dimension across the threads of this pool.
+     */
+    thread_pool *pool;
+    /**
+     * The fewest outermost elements eval() gives to one thread
+     * of the pool.
+     */
+    intptr_t parallel_grain_size;
 
     DYND_CONSTEXPR eval_context()
         : default_assign_error_mode(assign_error_fractional),
-            default_cuda_device_to_device_assign_error_mode(assign_error_none)
+            default_cuda_device_to_device_assign_error_mode(assign_error_none),
+            profiler(NULL), pool(NULL), parallel_grain_size(256)
     {
     }
 };
@@ -0,0 +1,35 @@
+//
+// Copyright (C) 2011-14 Mark Wiebe, DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#ifndef _DYND__PARALLEL_EVAL_HPP_
+#define _DYND__PARALLEL_EVAL_HPP_
+
+#include <dynd/array.hpp>
+#include <dynd/eval/eval_context.hpp>
+
+namespace dynd { namespace eval {
+
+/**
+ * Assigns src to dst, splitting their outermost dimension into
+ * contiguous ranges which the threads of ectx->pool evaluate at the
+ * same time. Each thread writes strings, var dims and other blockref
+ * data into memory blocks of its own, which are merged into the
+ * memory blocks of dst once all the threads have finished.
+ *
+ * The dst array must be one nd::array::eval just created for src,
+ * with a strided outermost dimension and its strides reordered to
+ * match src.
+ *
+ * Returns false without assigning anything when ectx has no pool,
+ * when the outermost dimension has fewer than two grains of
+ * ectx->parallel_grain_size elements, or when the types can't be
+ * split this way. The caller then does the assignment itself.
+ */
+bool parallel_eval_assign(const nd::array& dst, const nd::array& src,
+                const eval_context *ectx);
+
+}} // namespace dynd::eval
+
+#endif // _DYND__PARALLEL_EVAL_HPP_
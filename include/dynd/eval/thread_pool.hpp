@@ -0,0 +1,66 @@
+//
+// Copyright (C) 2011-14 Mark Wiebe, DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#ifndef _DYND__THREAD_POOL_HPP_
+#define _DYND__THREAD_POOL_HPP_
+
+#include <dynd/config.hpp>
+
+namespace dynd { namespace eval {
+
+namespace detail {
+    struct thread_pool_state;
+} // namespace detail
+
+/**
+ * A task run by a thread_pool. It is called once for each task index,
+ * and must not throw.
+ */
+typedef void (*thread_pool_task_t)(intptr_t task_index, void *extra);
+
+/**
+ * A fixed set of worker threads, which eval uses to split work
+ * across cores when an eval_context points at one.
+ *
+ * The threads are created by the constructor and sleep between calls
+ * to run(), so one pool is meant to be shared by many evaluations.
+ */
+class thread_pool {
+    detail::thread_pool_state *m_state;
+
+    // Non-copyable
+    thread_pool(const thread_pool&);
+    thread_pool& operator=(const thread_pool&);
+public:
+    /**
+     * Creates a pool which runs tasks on num_threads threads, counting
+     * the thread which calls run(). If num_threads is 0, it uses the
+     * number of processors.
+     */
+    explicit thread_pool(intptr_t num_threads = 0);
+
+    ~thread_pool();
+
+    /**
+     * The number of threads which run tasks, including the calling thread.
+     */
+    intptr_t get_num_threads() const;
+
+    /**
+     * Runs task(i, extra) for every i in [0, task_count), spread over
+     * the worker threads and the calling thread, and returns once they
+     * have all finished. Calls from different threads run one at a time.
+     */
+    void run(intptr_t task_count, thread_pool_task_t task, void *extra);
+
+    /**
+     * Returns the number of processors available to the process.
+     */
+    static intptr_t get_hardware_concurrency();
+};
+
+}} // namespace dynd::eval
+
+#endif // _DYND__THREAD_POOL_HPP_
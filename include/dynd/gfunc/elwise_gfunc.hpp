@@ -12,6 +12,7 @@
 
 #include <dynd/type.hpp>
 #include <dynd/codegen/codegen_cache.hpp>
+#include <dynd/gfunc/signature_index.hpp>
 
 namespace dynd { namespace gfunc {
 
@@ -37,6 +38,8 @@ class elwise {
      * and so cannot rely on C++11 move semantics.
      */
     std::deque<elwise_kernel> m_kernels;
+    /** Maps the kernel signatures to their positions in m_kernels */
+    signature_index m_index;
     std::vector<dynd::memory_block_data *> m_blockrefs;
 public:
     elwise(const char *name)
@@ -53,6 +56,14 @@ public:
      */
     const elwise_kernel *find_matching_kernel(const std::vector<ndt::type>& paramtypes) const;
 
+    /**
+     * Searches for a kernel which matches all the parameter types,
+     * or otherwise which takes their arithmetic promotion for every
+     * parameter. The caller converts the arguments to the returned
+     * kernel's m_paramtypes. See signature_index::resolve.
+     */
+    const elwise_kernel *resolve_kernel(const std::vector<ndt::type>& paramtypes) const;
+
     /**
      * Adds the provided kernel to the gfunc. This swaps it out of the provided
      * variable to avoid extra copies.
@@ -0,0 +1,84 @@
+//
+// Copyright (C) 2011-14 Mark Wiebe, DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#ifndef _DYND__SIGNATURE_INDEX_HPP_
+#define _DYND__SIGNATURE_INDEX_HPP_
+
+#include <map>
+#include <vector>
+
+#include <dynd/type.hpp>
+#include <dynd/platform_mutex.hpp>
+
+namespace dynd { namespace gfunc {
+
+/**
+ * Combines the hashes of all the parameter types of a
+ * kernel signature.
+ */
+size_t hash_signature(const std::vector<ndt::type>& paramtypes);
+
+/**
+ * Maps the parameter type signatures of a gfunc's kernels to their
+ * positions in the gfunc, keyed by hash_signature so a lookup only
+ * compares against the signatures with the same hash.
+ *
+ * Lookups which need implicit promotion are resolved through
+ * promote_types_arithmetic, and the result (including a failure)
+ * is cached per signature. The cache is guarded by a mutex, so
+ * lookups may be done concurrently, but not concurrently with insert.
+ */
+class signature_index {
+    struct entry {
+        std::vector<ndt::type> paramtypes;
+        intptr_t index;
+    };
+    typedef std::multimap<size_t, entry> map_type;
+
+    map_type m_exact;
+    mutable map_type m_resolved;
+    mutable platform_mutex m_mutex;
+
+    static const entry *find_in(const map_type& m, size_t hash,
+                    const std::vector<ndt::type>& paramtypes);
+    static void insert_in(map_type& m, size_t hash,
+                    const std::vector<ndt::type>& paramtypes, intptr_t index);
+
+    // Non-copyable
+    signature_index(const signature_index&);
+    signature_index& operator=(const signature_index&);
+public:
+    signature_index() {
+    }
+
+    /**
+     * Returns the index of the kernel with exactly these
+     * parameter types, or -1 if there is none.
+     */
+    intptr_t find_exact(const std::vector<ndt::type>& paramtypes) const;
+
+    /**
+     * Returns the index of the kernel to use for these parameter
+     * types, or -1 if there is none. If there is no exact match,
+     * all the parameter types are promoted to their common type with
+     * promote_types_arithmetic, and the kernel taking that type for
+     * every parameter is used. The caller must convert the arguments
+     * to the kernel's parameter types.
+     */
+    intptr_t resolve(const std::vector<ndt::type>& paramtypes) const;
+
+    /**
+     * Adds a signature for the kernel at `index`. This clears
+     * the cache of promoted lookups.
+     */
+    void insert(const std::vector<ndt::type>& paramtypes, intptr_t index);
+
+    /** The number of promoted lookups currently cached */
+    size_t get_resolved_cache_size() const;
+};
+
+}} // namespace dynd::gfunc
+
+#endif // _DYND__SIGNATURE_INDEX_HPP_
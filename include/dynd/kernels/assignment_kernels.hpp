@@ -6,6 +6,9 @@
 #ifndef _DYND__ASSIGNMENT_KERNELS_HPP_
 #define _DYND__ASSIGNMENT_KERNELS_HPP_
 
+#include <sstream>
+#include <stdexcept>
+
 #include <dynd/type.hpp>
 #include <dynd/typed_data_assign.hpp>
 #include <dynd/kernels/ckernel_builder.hpp>
@@ -163,6 +166,49 @@ size_t make_kernreq_to_single_kernel_adapter(
                 ckernel_builder *out, size_t offset_out,
                 kernel_request_t kernreq);
 
+/**
+ * A strided kernel function which calls the single kernel
+ * function `Single` on each element. The call is direct, so
+ * it can be inlined, and the ckernel is shared with the
+ * single function instead of needing an adapter ckernel.
+ */
+template<unary_single_operation_t Single>
+void strided_loop_of_single(char *dst, intptr_t dst_stride,
+                const char *src, intptr_t src_stride,
+                size_t count, ckernel_prefix *extra)
+{
+    for (size_t i = 0; i != count; ++i,
+                    dst += dst_stride, src += src_stride) {
+        Single(dst, src, extra);
+    }
+}
+
+/**
+ * Sets the function of a ckernel which has no strided
+ * specialization, to `Single` for kernel_request_single, or
+ * to strided_loop_of_single<Single> for kernel_request_strided.
+ * Use this instead of make_kernreq_to_single_kernel_adapter
+ * when the kernel data doesn't depend on the request.
+ */
+template<unary_single_operation_t Single>
+inline void set_unary_single_or_strided_function(ckernel_prefix *ckp,
+                kernel_request_t kernreq)
+{
+    switch (kernreq) {
+        case kernel_request_single:
+            ckp->set_function<unary_single_operation_t>(Single);
+            break;
+        case kernel_request_strided:
+            ckp->set_function<unary_strided_operation_t>(&strided_loop_of_single<Single>);
+            break;
+        default: {
+            std::stringstream ss;
+            ss << "set_unary_single_or_strided_function: unrecognized request " << (int)kernreq;
+            throw std::runtime_error(ss.str());
+        }
+    }
+}
+
 /**
  * Generic assignment kernel + destructor for a strided dimension.
  * This requires that the child kernel be created with the
@@ -183,6 +229,23 @@ struct strided_assign_kernel_extra {
     static void destruct(ckernel_prefix *extra);
 };
 
+/**
+ * Makes an assignment kernel for the leading strided_dim and fixed_dim
+ * dimensions of dst_tp, broadcasting src_tp to them. All the strided
+ * dimensions of the two operands are gathered and passed through
+ * optimize_strided_dims before the kernel levels are created, so
+ * for example a C-contiguous copy is done as one flat loop.
+ *
+ * The dst type must be a strided_dim or fixed_dim, and the src type
+ * must either have fewer dimensions or be a strided_dim or fixed_dim.
+ */
+size_t make_strided_dims_assignment_kernel(
+                ckernel_builder *out, size_t offset_out,
+                const ndt::type& dst_tp, const char *dst_metadata,
+                const ndt::type& src_tp, const char *src_metadata,
+                kernel_request_t kernreq, assign_error_mode errmode,
+                const eval::eval_context *ectx);
+
 #ifdef DYND_CUDA
 /**
  * Creates an assignment kernel for one data value from the
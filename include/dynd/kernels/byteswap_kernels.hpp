@@ -59,6 +59,17 @@ size_t make_pairwise_byteswap_assignment_function(
                 intptr_t data_size, intptr_t data_alignment,
                 kernel_request_t kernreq);
 
+/**
+ * Creates an assignment kernel between two different builtin
+ * types, where the src (if swap_src is true) or the dst is in the
+ * opposite byte order. The byteswap and the conversion are chained
+ * within the one kernel.
+ */
+size_t make_byteswap_builtin_assignment_kernel(
+                ckernel_builder *out, size_t offset_out,
+                type_id_t dst_type_id, type_id_t src_type_id, bool swap_src,
+                kernel_request_t kernreq, assign_error_mode errmode);
+
 } // namespace dynd
 
 #endif // _DYND__BYTESWAP_KERNELS_HPP_
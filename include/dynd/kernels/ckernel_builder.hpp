@@ -8,6 +8,8 @@
 
 #include <new>
 #include <algorithm>
+#include <iosfwd>
+#include <string>
 
 #include <dynd/config.hpp>
 #include <dynd/kernels/ckernel_prefix.hpp>
@@ -107,6 +109,13 @@ public:
         return reinterpret_cast<ckernel_prefix *>(m_data);
     }
 
+    /**
+     * Prints the tree of ckernels that was built, with the
+     * name, offset and size of each ckernel. See ckernel_debug_print
+     * in dynd/kernels/ckernel_debug_info.hpp.
+     */
+    void debug_print(std::ostream& o, const std::string& indent = "") const;
+
     void swap(ckernel_builder& rhs) {
         if (using_static_data()) {
             if (rhs.using_static_data()) {
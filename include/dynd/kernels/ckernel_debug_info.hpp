@@ -0,0 +1,128 @@
+//
+// Copyright (C) 2011-14 Mark Wiebe, DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#ifndef _DYND__CKERNEL_DEBUG_INFO_HPP_
+#define _DYND__CKERNEL_DEBUG_INFO_HPP_
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <dynd/config.hpp>
+#include <dynd/kernels/ckernel_prefix.hpp>
+
+namespace dynd {
+
+/**
+ * Gets the offsets of the child ckernels of a ckernel, relative
+ * to the start of the ckernel itself.
+ *
+ * \param self  The ckernel whose children are requested.
+ * \param self_size  The size registered for the ckernel.
+ * \param out_child_offsets  The child offsets are appended to this.
+ */
+typedef void (*ckernel_children_fn_t)(const ckernel_prefix *self, size_t self_size,
+                std::vector<size_t>& out_child_offsets);
+
+/**
+ * Prints extra details about one instance of a ckernel, like
+ * the strides or sizes stored in its data.
+ */
+typedef void (*ckernel_describe_fn_t)(const ckernel_prefix *self, std::ostream& o);
+
+/**
+ * Describes a ckernel function, so an instantiated ckernel
+ * can be printed by ckernel_builder::debug_print.
+ */
+struct ckernel_debug_info {
+    /** A name for the ckernel function, like "strided dim assign" */
+    std::string name;
+    /** The size of the ckernel data, including its ckernel_prefix */
+    size_t size;
+    /** Whether the function is a strided or a single ckernel function */
+    bool strided;
+    /** Gets the child offsets, NULL for a leaf ckernel */
+    ckernel_children_fn_t get_children;
+    /** Optional hook to print instance details, may be NULL */
+    ckernel_describe_fn_t describe;
+};
+
+/**
+ * A ckernel_children_fn_t for the common case of a single
+ * child ckernel placed right after the parent.
+ */
+void ckernel_child_follows(const ckernel_prefix *self, size_t self_size,
+                std::vector<size_t>& out_child_offsets);
+
+/**
+ * Registers debug information for a ckernel function. If the
+ * function was already registered, the first registration is kept.
+ * This is thread-safe, and is normally done during static
+ * initialization with a ckernel_debug_info_registrar.
+ *
+ * NOTE: The information is keyed by function pointer. A linker doing
+ *       identical code folding (MSVC /OPT:ICF, gold --icf) may merge
+ *       ckernel functions whose machine code is the same, and those
+ *       then all print with the name of whichever was registered first.
+ */
+void register_ckernel_debug_info(void *function, const std::string& name,
+                size_t size, bool strided, ckernel_children_fn_t get_children,
+                ckernel_describe_fn_t describe = NULL);
+
+/**
+ * A function which registers the debug information of a group
+ * of ckernels by calling register_ckernel_debug_info.
+ */
+typedef void (*ckernel_debug_info_loader_t)();
+
+/**
+ * Adds a loader, which is called the first time any debug information
+ * is looked up. Groups with many ckernels register this way, so that
+ * loading the library doesn't pay for building all their names.
+ */
+void register_ckernel_debug_info_loader(ckernel_debug_info_loader_t loader);
+
+/**
+ * Returns the debug information registered for a ckernel
+ * function, or NULL if there is none.
+ */
+const ckernel_debug_info *get_ckernel_debug_info(void *function);
+
+/**
+ * Registers a ckernel function when constructed, for registering
+ * the functions of a ckernel at static initialization, like
+ *
+ *      static ckernel_debug_info_registrar my_kernel_strided_reg(
+ *              &my_kernel::strided, "my kernel", sizeof(my_kernel), true,
+ *              &ckernel_child_follows);
+ */
+class ckernel_debug_info_registrar {
+public:
+    template<typename T>
+    ckernel_debug_info_registrar(T function, const char *name, size_t size,
+                    bool strided, ckernel_children_fn_t get_children,
+                    ckernel_describe_fn_t describe = NULL) {
+        register_ckernel_debug_info(reinterpret_cast<void *>(function), name,
+                        size, strided, get_children, describe);
+    }
+};
+
+/**
+ * Prints the tree of ckernels starting at ckp, one line per ckernel
+ * with its offset, name, size and any details from its describe hook.
+ * Registered ckernels are followed into their children, and a ckernel
+ * whose function was not registered is printed with its function
+ * pointer, with the walk stopping there.
+ *
+ * \param o  The stream to print to.
+ * \param ckp  The root ckernel.
+ * \param indent  A string to place at the start of every line.
+ */
+void ckernel_debug_print(std::ostream& o, const ckernel_prefix *ckp,
+                const std::string& indent = "");
+
+} // namespace dynd
+
+#endif // _DYND__CKERNEL_DEBUG_INFO_HPP_
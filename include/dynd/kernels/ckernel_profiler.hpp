@@ -0,0 +1,148 @@
+//
+// Copyright (C) 2011-14 Mark Wiebe, DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#ifndef _DYND__CKERNEL_PROFILER_HPP_
+#define _DYND__CKERNEL_PROFILER_HPP_
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <dynd/config.hpp>
+#include <dynd/kernels/ckernel_builder.hpp>
+#include <dynd/kernels/ckernel_deferred.hpp>
+#include <dynd/types/type_id.hpp>
+
+namespace dynd {
+
+/**
+ * The counters for one profiled ckernel. The nodes form a
+ * tree matching the hierarchy of the ckernels.
+ */
+struct ckernel_profile_node {
+    /** A description of the ckernel, like "assign float64 <- int32" */
+    std::string name;
+    /** Whether the ckernel is a strided one */
+    bool strided;
+    /** Number of times the ckernel was called */
+    uint64_t calls;
+    /** Number of elements processed, which is `calls` for single ckernels */
+    uint64_t elements;
+    /** Ticks spent in the ckernel, including its children */
+    uint64_t ticks;
+    ckernel_profile_node *parent;
+    std::vector<ckernel_profile_node *> children;
+
+    /** Returns the ticks spent in this ckernel excluding its profiled children */
+    uint64_t get_self_ticks() const;
+};
+
+/**
+ * Collects call counts, element counts and timing for ckernels.
+ *
+ * Profiling is enabled by setting the `profiler` of an eval_context,
+ * and passing that context to the array operations. The kernels
+ * created by `make_assignment_kernel` and the expression kernel
+ * generators are then each wrapped in a profiling ckernel, which
+ * updates the node for that kernel every time it is called.
+ *
+ * The profiler must outlive the ckernels built with it, and the
+ * counters are not synchronized, so a profiler and its ckernels
+ * should be used from one thread.
+ */
+class ckernel_profiler {
+    ckernel_profile_node m_root;
+    /** The node new nodes are added to while building ckernels */
+    ckernel_profile_node *m_current;
+
+    // Non-copyable
+    ckernel_profiler(const ckernel_profiler&);
+    ckernel_profiler& operator=(const ckernel_profiler&);
+public:
+    ckernel_profiler();
+    ~ckernel_profiler();
+
+    /**
+     * Places a profiling ckernel at offset_out, and adds a node for it
+     * as a child of the current node. The node becomes current until the
+     * matching pop_kernel, so kernels created in between become its
+     * children.
+     *
+     * \param out  The ckernel_builder being constructed.
+     * \param offset_out  The offset within 'out'.
+     * \param funcproto  Whether the ckernel is a unary or an expr ckernel.
+     * \param kernreq  Either kernel_request_single or kernel_request_strided.
+     * \param name  A description of the ckernel.
+     *
+     * \returns  The offset at which the profiled ckernel should be placed.
+     */
+    size_t push_kernel(ckernel_builder *out, size_t offset_out,
+                    deferred_ckernel_funcproto_t funcproto, kernel_request_t kernreq,
+                    const std::string& name);
+
+    /** Ends the node started by push_kernel */
+    void pop_kernel();
+
+    /** The root node, whose children are the top level profiled ckernels */
+    const ckernel_profile_node& get_root() const {
+        return m_root;
+    }
+
+    /** Sets all the counters back to zero, keeping the nodes */
+    void reset_counts();
+
+    /**
+     * Prints the tree of profiled ckernels with their counters.
+     */
+    void print(std::ostream& o) const;
+
+    /**
+     * Returns the current value of the tick counter used for timing.
+     * This is the CPU timestamp counter where it is available.
+     */
+    static uint64_t get_ticks();
+};
+
+/**
+ * Calls ckernel_profiler::pop_kernel when it goes out of scope,
+ * if a kernel was pushed through it.
+ *
+ *      ckernel_profiler_scope profiled;
+ *      if (ectx != NULL && ectx->profiler != NULL) {
+ *          offset_out = profiled.push(ectx->profiler, out, offset_out, ...);
+ *      }
+ *      return make_something_kernel(out, offset_out, ...);
+ */
+class ckernel_profiler_scope {
+    ckernel_profiler *m_profiler;
+
+    // Non-copyable
+    ckernel_profiler_scope(const ckernel_profiler_scope&);
+    ckernel_profiler_scope& operator=(const ckernel_profiler_scope&);
+public:
+    ckernel_profiler_scope()
+        : m_profiler(NULL)
+    {
+    }
+
+    ~ckernel_profiler_scope() {
+        if (m_profiler != NULL) {
+            m_profiler->pop_kernel();
+        }
+    }
+
+    inline size_t push(ckernel_profiler *profiler,
+                    ckernel_builder *out, size_t offset_out,
+                    deferred_ckernel_funcproto_t funcproto, kernel_request_t kernreq,
+                    const std::string& name) {
+        size_t result = profiler->push_kernel(out, offset_out, funcproto, kernreq, name);
+        m_profiler = profiler;
+        return result;
+    }
+};
+
+} // namespace dynd
+
+#endif // _DYND__CKERNEL_PROFILER_HPP_
@@ -0,0 +1,68 @@
+//
+// Copyright (C) 2011-14 Mark Wiebe, DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#ifndef _DYND__OFFSET_DIM_ASSIGNMENT_KERNELS_HPP_
+#define _DYND__OFFSET_DIM_ASSIGNMENT_KERNELS_HPP_
+
+#include <dynd/type.hpp>
+#include <dynd/kernels/assignment_kernels.hpp>
+
+namespace dynd {
+
+/**
+ * Makes a kernel which assigns offset dims to offset dims.
+ * The destination elements must have matching sizes.
+ */
+size_t make_offset_dim_assignment_kernel(
+                ckernel_builder *out, size_t offset_out,
+                const ndt::type& dst_offset_dim_tp, const char *dst_metadata,
+                const ndt::type& src_offset_dim_tp, const char *src_metadata,
+                kernel_request_t kernreq, assign_error_mode errmode,
+                const eval::eval_context *ectx);
+
+/**
+ * Makes a kernel which assigns strided dims to offset dims, or
+ * broadcasts the input to them if it has fewer dimensions.
+ */
+size_t make_strided_to_offset_dim_assignment_kernel(
+                ckernel_builder *out, size_t offset_out,
+                const ndt::type& dst_offset_dim_tp, const char *dst_metadata,
+                const ndt::type& src_tp, const char *src_metadata,
+                kernel_request_t kernreq, assign_error_mode errmode,
+                const eval::eval_context *ectx);
+
+/**
+ * Makes a kernel which assigns var dims to offset dims.
+ */
+size_t make_var_to_offset_dim_assignment_kernel(
+                ckernel_builder *out, size_t offset_out,
+                const ndt::type& dst_offset_dim_tp, const char *dst_metadata,
+                const ndt::type& src_var_dim_tp, const char *src_metadata,
+                kernel_request_t kernreq, assign_error_mode errmode,
+                const eval::eval_context *ectx);
+
+/**
+ * Makes a kernel which assigns offset dims to var dims.
+ */
+size_t make_offset_to_var_dim_assignment_kernel(
+                ckernel_builder *out, size_t offset_out,
+                const ndt::type& dst_var_dim_tp, const char *dst_metadata,
+                const ndt::type& src_offset_dim_tp, const char *src_metadata,
+                kernel_request_t kernreq, assign_error_mode errmode,
+                const eval::eval_context *ectx);
+
+/**
+ * Makes a kernel which assigns offset dims to strided dims.
+ */
+size_t make_offset_to_strided_dim_assignment_kernel(
+                ckernel_builder *out, size_t offset_out,
+                const ndt::type& dst_strided_dim_tp, const char *dst_metadata,
+                const ndt::type& src_offset_dim_tp, const char *src_metadata,
+                kernel_request_t kernreq, assign_error_mode errmode,
+                const eval::eval_context *ectx);
+
+} // namespace dynd
+
+#endif // _DYND__OFFSET_DIM_ASSIGNMENT_KERNELS_HPP_
@@ -61,6 +61,52 @@ size_t make_blockref_string_to_fixedstring_assignment_kernel(
                 kernel_request_t kernreq, assign_error_mode errmode,
                 const eval::eval_context *ectx);
 
+/**
+ * Makes a kernel which converts strings of any string type into
+ * packed strings, appending them to the destination's buffer.
+ */
+size_t make_to_packed_string_assignment_kernel(
+                ckernel_builder *out, size_t offset_out,
+                const ndt::type& dst_tp, const char *dst_metadata,
+                const ndt::type& src_tp, const char *src_metadata,
+                kernel_request_t kernreq, assign_error_mode errmode,
+                const eval::eval_context *ectx);
+
+/**
+ * Makes a kernel which converts packed strings into any non-builtin type
+ * a blockref string can be assigned to, by viewing each packed string
+ * as a blockref string.
+ */
+size_t make_packed_string_to_string_assignment_kernel(
+                ckernel_builder *out, size_t offset_out,
+                const ndt::type& dst_tp, const char *dst_metadata,
+                const ndt::type& src_tp, const char *src_metadata,
+                kernel_request_t kernreq, assign_error_mode errmode,
+                const eval::eval_context *ectx);
+
+/**
+ * Makes a kernel which converts strings of any string type into
+ * small strings, storing short strings inline.
+ */
+size_t make_to_small_string_assignment_kernel(
+                ckernel_builder *out, size_t offset_out,
+                const ndt::type& dst_tp, const char *dst_metadata,
+                const ndt::type& src_tp, const char *src_metadata,
+                kernel_request_t kernreq, assign_error_mode errmode,
+                const eval::eval_context *ectx);
+
+/**
+ * Makes a kernel which converts small strings into any non-builtin type
+ * a blockref string can be assigned to, by viewing each small string
+ * as a blockref string.
+ */
+size_t make_small_string_to_string_assignment_kernel(
+                ckernel_builder *out, size_t offset_out,
+                const ndt::type& dst_tp, const char *dst_metadata,
+                const ndt::type& src_tp, const char *src_metadata,
+                kernel_request_t kernreq, assign_error_mode errmode,
+                const eval::eval_context *ectx);
+
 } // namespace dynd
 
 #endif // _DYND__STRING_ASSIGNMENT_KERNELS_HPP_
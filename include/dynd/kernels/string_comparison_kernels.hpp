@@ -35,6 +35,31 @@ size_t make_string_comparison_kernel(
                 comparison_type_t comptype,
                 const eval::eval_context *ectx);
 
+/**
+ * Makes a kernel which compares packed strings of the same type.
+ *
+ * \param encoding  The encoding of the string.
+ * \param offset_type_id  The type of the offsets, int32_type_id or int64_type_id.
+ */
+size_t make_packed_string_comparison_kernel(
+                ckernel_builder *out, size_t offset_out,
+                string_encoding_t encoding, type_id_t offset_type_id,
+                const char *src0_metadata, const char *src1_metadata,
+                comparison_type_t comptype,
+                const eval::eval_context *ectx);
+
+/**
+ * Makes a kernel which compares small strings of the same type. Equality
+ * of inline strings is decided from the 16 bytes of the elements.
+ *
+ * \param encoding  The encoding of the string.
+ */
+size_t make_small_string_comparison_kernel(
+                ckernel_builder *out, size_t offset_out,
+                string_encoding_t encoding,
+                comparison_type_t comptype,
+                const eval::eval_context *ectx);
+
 /**
  * Makes a kernel which compares two .
  *
@@ -0,0 +1,79 @@
+//
+// Copyright (C) 2011-14 Mark Wiebe, DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#ifndef _DYND__CONTIGUOUS_MEMORY_BLOCK_HPP_
+#define _DYND__CONTIGUOUS_MEMORY_BLOCK_HPP_
+
+#include <iostream>
+#include <string>
+
+#include <dynd/memblock/memory_block.hpp>
+
+namespace dynd {
+
+/**
+ * A memory block which holds all its POD data in a single contiguous
+ * buffer. Unlike the pod memory block, the buffer may move when it
+ * grows, so the data within it is addressed by byte offsets from the
+ * start of the buffer instead of by pointers.
+ */
+struct contiguous_memory_block_data {
+    /** Every memory block object needs this at the front */
+    memory_block_data m_mbd;
+    /** The buffer, obtained with malloc/realloc */
+    char *m_data;
+    /** The number of bytes in use, and the number allocated */
+    intptr_t m_size, m_capacity;
+    /** Set by finalize, after which no more memory may be allocated */
+    bool m_finalized;
+
+    explicit contiguous_memory_block_data(intptr_t capacity)
+        : m_mbd(1, contiguous_memory_block_type), m_data(NULL), m_size(0),
+                m_capacity(capacity), m_finalized(false)
+    {
+    }
+};
+
+/**
+ * Creates a contiguous memory block, with the requested initial capacity.
+ */
+memory_block_ptr make_contiguous_memory_block(intptr_t initial_capacity_bytes = 2048);
+
+/**
+ * Allocates memory from the end of a contiguous memory block, growing
+ * the buffer as needed, and returns its offset from the start of the buffer.
+ * Any pointers into the buffer are invalidated by this call.
+ */
+intptr_t contiguous_memory_block_allocate(memory_block_data *self, intptr_t size_bytes, intptr_t alignment);
+
+/**
+ * Resizes the most recent allocation, which starts at the given offset.
+ * Any pointers into the buffer are invalidated by this call.
+ */
+void contiguous_memory_block_resize(memory_block_data *self, intptr_t offset, intptr_t size_bytes);
+
+/**
+ * Finalizes the contiguous memory block, shrinking the buffer
+ * to the size in use.
+ */
+void contiguous_memory_block_finalize(memory_block_data *self);
+
+/**
+ * Resets the contiguous memory block so its buffer gets reused from the start.
+ */
+void contiguous_memory_block_reset(memory_block_data *self);
+
+/**
+ * Returns the start of the buffer of a contiguous memory block.
+ */
+inline char *contiguous_memory_block_get_data(const memory_block_data *self) {
+    return reinterpret_cast<const contiguous_memory_block_data *>(self)->m_data;
+}
+
+void contiguous_memory_block_debug_print(const memory_block_data *memblock, std::ostream& o, const std::string& indent);
+
+} // namespace dynd
+
+#endif // _DYND__CONTIGUOUS_MEMORY_BLOCK_HPP_
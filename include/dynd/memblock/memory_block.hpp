@@ -34,7 +34,9 @@ enum memory_block_type_t {
     /** For memory used by code generation */
     executable_memory_block_type,
     /** Wraps memory mapped files */
-    memmap_memory_block_type
+    memmap_memory_block_type,
+    /** For POD data in one growable buffer, addressed by offsets */
+    contiguous_memory_block_type
 };
 
 std::ostream& operator<<(std::ostream& o, memory_block_type_t mbt);
@@ -143,6 +145,13 @@ memory_block_objectarray_allocator_api *get_memory_block_objectarray_allocator_a
 
 
 
+/**
+ * Moves all the memory owned by the src memory block into dst, leaving
+ * src empty, so that data allocated from src lives as long as dst does.
+ * Both must be pod or both zeroinit memory blocks.
+ */
+void memory_block_merge(memory_block_data *dst, memory_block_data *src);
+
 namespace detail {
     /**
      * Frees the data for a memory block. Is called
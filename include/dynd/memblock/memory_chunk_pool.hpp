@@ -0,0 +1,85 @@
+//
+// Copyright (C) 2011-14 Mark Wiebe, DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#ifndef _DYND__MEMORY_CHUNK_POOL_HPP_
+#define _DYND__MEMORY_CHUNK_POOL_HPP_
+
+#include <dynd/config.hpp>
+
+namespace dynd {
+
+/**
+ * Controls how the growable memory blocks (pod, zeroinit and objectarray)
+ * size each new chunk of memory when they run out of capacity.
+ *
+ * A new chunk is sized at growth_percent of the total capacity the
+ * memory block has allocated so far, clamped to the range
+ * [min_chunk_bytes, max_chunk_bytes], and never smaller than the
+ * request which triggered the growth. The default policy
+ * {0, 100, 0} doubles the total capacity with every new chunk.
+ */
+struct memory_block_growth_policy {
+    /** The smallest chunk size to request when growing */
+    intptr_t min_chunk_bytes;
+    /** The size of a new chunk, as a percentage of the capacity so far */
+    intptr_t growth_percent;
+    /** The largest chunk size to request when growing, or 0 for no limit */
+    intptr_t max_chunk_bytes;
+};
+
+/**
+ * Returns the growth policy used by the growable memory blocks.
+ */
+const memory_block_growth_policy& get_memory_block_growth_policy();
+
+/**
+ * Sets the growth policy used by the growable memory blocks. This
+ * should be called at startup, before memory blocks are used from
+ * multiple threads.
+ */
+void set_memory_block_growth_policy(const memory_block_growth_policy& policy);
+
+/**
+ * Returns the number of bytes held in the process-wide chunk pool,
+ * not counting the chunks cached by individual threads.
+ */
+intptr_t memory_chunk_pool_cached_bytes();
+
+/**
+ * Releases all the chunks held in the process-wide chunk pool, as well
+ * as those cached by the calling thread, back to the system allocator.
+ */
+void memory_chunk_pool_trim();
+
+namespace detail {
+    /**
+     * Allocates a chunk of at least size_bytes from the chunk pool.
+     * Small chunk requests are rounded up to a power of two size class,
+     * and the actual usable capacity is returned in out_capacity. The
+     * memory has malloc alignment.
+     *
+     * Throws std::bad_alloc if no memory is available.
+     */
+    char *memory_chunk_allocate(intptr_t size_bytes, intptr_t *out_capacity);
+
+    /**
+     * Returns a chunk obtained from memory_chunk_allocate to the pool.
+     * The capacity must be the one that memory_chunk_allocate returned.
+     */
+    void memory_chunk_free(char *chunk, intptr_t capacity);
+
+    /**
+     * Returns the size of the next chunk a growable memory block should
+     * allocate, according to the current growth policy.
+     *
+     * \param total_allocated_bytes  The capacity allocated so far by the memory block.
+     * \param requested_bytes  The size of the allocation which needs the new chunk.
+     */
+    intptr_t memory_block_next_chunk_size(intptr_t total_allocated_bytes, intptr_t requested_bytes);
+} // namespace detail
+
+} // namespace dynd
+
+#endif // _DYND__MEMORY_CHUNK_POOL_HPP_
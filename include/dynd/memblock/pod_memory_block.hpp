@@ -21,6 +21,28 @@ namespace dynd {
  */
 memory_block_ptr make_pod_memory_block(intptr_t initial_capacity_bytes = 2048);
 
+/**
+ * Creates a POD memory block whose initial chunk is exactly the requested
+ * size, instead of being rounded up to a chunk pool size class. This is
+ * for data whose final size is known, like when compacting the data
+ * of another memory block.
+ */
+memory_block_ptr make_exact_pod_memory_block(intptr_t capacity_bytes);
+
+/**
+ * Creates a POD memory block which takes ownership of a chunk that
+ * was obtained from detail::memory_chunk_allocate, with the capacity
+ * it returned. The whole chunk counts as already allocated, so this
+ * is for data which was built up before the memory block was made.
+ */
+memory_block_ptr make_pod_memory_block_from_chunk(char *chunk, intptr_t capacity);
+
+/**
+ * Returns the total capacity, in bytes, of the memory chunks owned
+ * by a POD memory block.
+ */
+intptr_t pod_memory_block_get_capacity(const memory_block_data *memblock);
+
 void pod_memory_block_debug_print(const memory_block_data *memblock, std::ostream& o, const std::string& indent);
 
 } // namespace dynd
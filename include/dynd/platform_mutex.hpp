@@ -0,0 +1,95 @@
+//
+// Copyright (C) 2011-14 Mark Wiebe, DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#ifndef _DYND__PLATFORM_MUTEX_HPP_
+#define _DYND__PLATFORM_MUTEX_HPP_
+
+#include <dynd/config.hpp>
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+namespace dynd {
+
+/**
+ * A non-recursive mutex using the platform's native primitive,
+ * for guarding the library's shared caches.
+ */
+class platform_mutex {
+#if defined(_WIN32)
+    CRITICAL_SECTION m_cs;
+#else
+    pthread_mutex_t m_mutex;
+#endif
+
+    // Non-copyable
+    platform_mutex(const platform_mutex&);
+    platform_mutex& operator=(const platform_mutex&);
+public:
+#if defined(_WIN32)
+    platform_mutex() {
+        InitializeCriticalSection(&m_cs);
+    }
+
+    ~platform_mutex() {
+        DeleteCriticalSection(&m_cs);
+    }
+
+    void lock() {
+        EnterCriticalSection(&m_cs);
+    }
+
+    void unlock() {
+        LeaveCriticalSection(&m_cs);
+    }
+#else
+    platform_mutex() {
+        pthread_mutex_init(&m_mutex, NULL);
+    }
+
+    ~platform_mutex() {
+        pthread_mutex_destroy(&m_mutex);
+    }
+
+    void lock() {
+        pthread_mutex_lock(&m_mutex);
+    }
+
+    void unlock() {
+        pthread_mutex_unlock(&m_mutex);
+    }
+#endif
+
+    /**
+     * Holds the mutex locked for the lifetime of the object.
+     */
+    class scoped_lock {
+        platform_mutex& m_mutex;
+
+        // Non-copyable
+        scoped_lock(const scoped_lock&);
+        scoped_lock& operator=(const scoped_lock&);
+    public:
+        explicit scoped_lock(platform_mutex& m)
+            : m_mutex(m)
+        {
+            m_mutex.lock();
+        }
+
+        ~scoped_lock() {
+            m_mutex.unlock();
+        }
+    };
+};
+
+} // namespace dynd
+
+#endif // _DYND__PLATFORM_MUTEX_HPP_
@@ -137,6 +137,31 @@ inline void multistrides_to_axis_perm(intptr_t ndim, int noperands, intptr_t **o
                 const_cast<const intptr_t **>(operstrides), out_axis_perm);
 }
 
+/**
+ * When tp is a strided_dim or fixed_dim type, gets the size and stride
+ * of its dimension along with its element type and metadata, and
+ * returns true. Returns false for any other type.
+ */
+bool get_strided_dim_params(const ndt::type& tp, const char *metadata,
+                intptr_t& out_size, intptr_t& out_stride,
+                ndt::type& out_el_tp, const char *&out_el_metadata);
+
+/**
+ * Optimizes the dimensions of a strided loop over several operands, for
+ * a kernel which will execute one loop level per dimension. Size-one
+ * dimensions are removed, the dimensions are reordered with
+ * multistrides_to_axis_perm so the smallest strides are innermost,
+ * and adjacent dimensions whose strides line up in every operand
+ * are merged into one.
+ *
+ * \param inout_ndim  The number of dimensions, updated to the number which remain.
+ * \param shape  The loop shape, outermost dimension first. Updated in place.
+ * \param noperands  The number of operands.
+ * \param operstrides  The strides of each operand, matching shape. Updated in place.
+ */
+void optimize_strided_dims(intptr_t& inout_ndim, intptr_t *shape,
+                int noperands, intptr_t **operstrides);
+
 void print_shape(std::ostream& o, intptr_t ndim, const intptr_t *shape);
 
 inline void print_shape(std::ostream& o, const std::vector<intptr_t>& shape) {
@@ -0,0 +1,156 @@
+//
+// Copyright (C) 2011-14 Mark Wiebe, DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#ifndef _DYND__STRIDED_VIEW_HPP_
+#define _DYND__STRIDED_VIEW_HPP_
+
+#include <dynd/array.hpp>
+
+namespace dynd {
+
+namespace detail {
+    /**
+     * Gets the shape and byte strides of the N leading dimensions of
+     * an array, which must all be strided_dim or fixed_dim, with dtp
+     * as the element type. Throws a type_error otherwise.
+     *
+     * \returns  True if the array data is C-contiguous.
+     */
+    bool get_strided_view_layout(const nd::array& a, int ndim, const ndt::type& dtp,
+                    intptr_t *out_shape, intptr_t *out_strides);
+
+    template<class T>
+    struct strided_view_element {
+        typedef T value_type;
+        static char *get_data(const nd::array& a) {
+            return a.get_readwrite_originptr();
+        }
+    };
+
+    template<class T>
+    struct strided_view_element<const T> {
+        typedef T value_type;
+        static char *get_data(const nd::array& a) {
+            // Only const access is given through the view
+            return const_cast<char *>(a.get_readonly_originptr());
+        }
+    };
+
+    /** Fails to compile when a strided_view is indexed with the wrong number of indices */
+    template<bool Matches>
+    struct strided_view_index_count;
+    template<>
+    struct strided_view_index_count<true> {
+        static inline void check() {}
+    };
+} // namespace detail
+
+/**
+ * A typed view of an array whose N leading dimensions are strided,
+ * with elements of type T. The type is checked once at construction,
+ * after which element access is plain pointer arithmetic that the
+ * compiler can inline and vectorize. Use `strided_view<const T, N>`
+ * for read-only access.
+ *
+ * The view holds a reference to the array, so the data stays alive.
+ * Indexing is not bounds-checked and doesn't accept negative indices.
+ *
+ *      strided_view<double, 2> v(a);
+ *      for (intptr_t i = 0; i < v.get_dim_size(0); ++i) {
+ *          for (intptr_t j = 0; j < v.get_dim_size(1); ++j) {
+ *              v(i, j) *= 2;
+ *          }
+ *      }
+ */
+template<class T, int N>
+class strided_view {
+    nd::array m_array;
+    char *m_data;
+    intptr_t m_shape[N];
+    intptr_t m_strides[N];
+    bool m_contiguous;
+public:
+    typedef T value_type;
+    typedef T *iterator;
+
+    explicit strided_view(const nd::array& a)
+        : m_array(a), m_data(detail::strided_view_element<T>::get_data(a))
+    {
+        m_contiguous = detail::get_strided_view_layout(a, N,
+                        ndt::make_type<typename detail::strided_view_element<T>::value_type>(),
+                        m_shape, m_strides);
+    }
+
+    /** The array the view is of */
+    inline const nd::array& get_array() const {
+        return m_array;
+    }
+
+    /** The size of dimension i */
+    inline intptr_t get_dim_size(int i) const {
+        return m_shape[i];
+    }
+
+    /** The stride of dimension i, in bytes */
+    inline intptr_t get_stride(int i) const {
+        return m_strides[i];
+    }
+
+    /** The total number of elements */
+    inline intptr_t get_size() const {
+        intptr_t size = 1;
+        for (int i = 0; i < N; ++i) {
+            size *= m_shape[i];
+        }
+        return size;
+    }
+
+    /** Whether the elements are C-contiguous, so begin() and end() may be used */
+    inline bool is_contiguous() const {
+        return m_contiguous;
+    }
+
+    /**
+     * Returns a pointer to the first element, for iterating over
+     * all the elements in C order. Throws if the view is not contiguous.
+     */
+    inline T *begin() const {
+        if (!m_contiguous) {
+            throw std::runtime_error("strided_view::begin() requires C-contiguous data");
+        }
+        return reinterpret_cast<T *>(m_data);
+    }
+
+    /** Returns a pointer one past the last element, see begin() */
+    inline T *end() const {
+        return begin() + get_size();
+    }
+
+    inline T& operator()(intptr_t i0) const {
+        detail::strided_view_index_count<N == 1>::check();
+        return *reinterpret_cast<T *>(m_data + i0 * m_strides[0]);
+    }
+
+    inline T& operator()(intptr_t i0, intptr_t i1) const {
+        detail::strided_view_index_count<N == 2>::check();
+        return *reinterpret_cast<T *>(m_data + i0 * m_strides[0] + i1 * m_strides[1]);
+    }
+
+    inline T& operator()(intptr_t i0, intptr_t i1, intptr_t i2) const {
+        detail::strided_view_index_count<N == 3>::check();
+        return *reinterpret_cast<T *>(m_data + i0 * m_strides[0] + i1 * m_strides[1] +
+                        i2 * m_strides[2]);
+    }
+
+    inline T& operator()(intptr_t i0, intptr_t i1, intptr_t i2, intptr_t i3) const {
+        detail::strided_view_index_count<N == 4>::check();
+        return *reinterpret_cast<T *>(m_data + i0 * m_strides[0] + i1 * m_strides[1] +
+                        i2 * m_strides[2] + i3 * m_strides[3]);
+    }
+};
+
+} // namespace dynd
+
+#endif // _DYND__STRIDED_VIEW_HPP_
@@ -116,12 +116,20 @@ public:
     type()
         : m_extended(reinterpret_cast<const base_type *>(uninitialized_type_id))
     {}
-    /** Constructor from an base_type. This claims ownership of the 'extended' reference by default, be careful! */
+    /**
+     * Constructor from an base_type. This claims ownership of the 'extended' reference
+     * by default, be careful! When claiming ownership of a type which isn't interned yet,
+     * such as a newly constructed one, the type is replaced by its interned equivalent.
+     */
     inline explicit type(const base_type *extended, bool incref)
         : m_extended(extended)
     {
-        if (incref && !is_builtin_type(extended)) {
-            base_type_incref(m_extended);
+        if (!is_builtin_type(extended)) {
+            if (incref) {
+                base_type_incref(m_extended);
+            } else if (!extended->is_interned()) {
+                m_extended = intern_base_type(extended);
+            }
         }
     }
     /** Copy constructor (should be "= default" in C++11) */
@@ -199,8 +207,13 @@ public:
     }
 
     inline bool operator==(const type& rhs) const {
-        if (is_builtin() || rhs.is_builtin()) {
-            return m_extended == rhs.m_extended;
+        if (m_extended == rhs.m_extended) {
+            return true;
+        } else if (is_builtin() || rhs.is_builtin()) {
+            return false;
+        } else if (m_extended->is_interned() && rhs.m_extended->is_interned()) {
+            // Equal interned types are always the same instance
+            return false;
         } else {
             return *m_extended == *rhs.m_extended;
         }
@@ -209,6 +222,15 @@ public:
         return !(operator==(rhs));
     }
 
+    /** A hash of the type, consistent with operator== */
+    inline size_t get_hash() const {
+        if (is_builtin()) {
+            return reinterpret_cast<uintptr_t>(m_extended);
+        } else {
+            return m_extended->get_hash();
+        }
+    }
+
     /**
      * Returns true if this type is built in, which
      * means the type id is encoded directly in the m_extended
@@ -22,6 +22,8 @@ public:
 
     virtual ~base_expression_type();
 
+    size_t compute_hash() const;
+
     /**
      * Should return a reference to the type representing the value which
      * is for calculation. This should never be an expression type.
@@ -26,6 +26,8 @@ public:
     {}
 
     virtual ~base_string_type();
+
+    size_t compute_hash() const;
     /** The encoding used by the string */
     virtual string_encoding_t get_encoding() const = 0;
 
@@ -28,6 +28,8 @@ public:
 
     virtual ~base_struct_type();
 
+    size_t compute_hash() const;
+
     /** The number of fields in the struct. This is the size of the other arrays. */
     inline size_t get_field_count() const {
         return m_field_count;
@@ -30,6 +30,29 @@ namespace ndt {
 
 class base_type;
 
+/**
+ * Takes ownership of a reference to a newly constructed type, and returns
+ * an owned reference to the interned type equal to it. This is either the
+ * type itself, now interned, or an equal type which was interned earlier,
+ * in which case the reference to the new type is released.
+ */
+const base_type *intern_base_type(const base_type *bt);
+
+/**
+ * Removes an interned type whose use count reached zero from
+ * the intern table, and deletes it.
+ */
+void release_interned_base_type(const base_type *bt);
+
+/**
+ * Mixes the hash value v into the hash h, the same way as
+ * boost::hash_combine. Types use this to hash their parameters.
+ */
+inline size_t hash_combine(size_t h, size_t v)
+{
+    return h ^ (v + 0x9e3779b9 + (h << 6) + (h >> 2));
+}
+
 struct iterdata_common;
 
 /** This is the callback function type used by the base_type::foreach function */
@@ -105,6 +128,10 @@ struct base_type_members {
 class base_type {
     /** Embedded reference counting */
     mutable atomic_refcount m_use_count;
+    /** The hash of the type, set when it is interned */
+    size_t m_hash;
+    /** Whether this is the unique instance in the type intern table */
+    bool m_interned;
 protected:
     /// Standard dynd type data
     base_type_members m_members;
@@ -121,7 +148,8 @@ public:
     /** Starts off the extended type instance with a use count of 1. */
     inline base_type(type_id_t type_id, type_kind_t kind, size_t data_size,
                     size_t alignment, flags_type flags, size_t metadata_size, size_t undim)
-        : m_use_count(1), m_members(static_cast<uint16_t>(type_id), static_cast<uint8_t>(kind),
+        : m_use_count(1), m_hash(0), m_interned(false),
+            m_members(static_cast<uint16_t>(type_id), static_cast<uint8_t>(kind),
                 static_cast<uint8_t>(alignment), flags, data_size, metadata_size, static_cast<uint8_t>(undim))
     {}
 
@@ -132,6 +160,28 @@ public:
         return m_use_count;
     }
 
+    /**
+     * True if this is the unique interned instance of the type. Two
+     * interned types are equal exactly when they are the same instance.
+     */
+    inline bool is_interned() const {
+        return m_interned;
+    }
+
+    /**
+     * A hash of the type, consistent with operator==. This is
+     * precomputed for interned types.
+     */
+    size_t get_hash() const;
+
+    /**
+     * Computes the hash which get_hash() returns. The default hashes the
+     * members every type has, and types with parameters or child types
+     * override it to mix in their parameters and the get_hash() of their
+     * children. Equal types must compute the same hash.
+     */
+    virtual size_t compute_hash() const;
+
     /** Returns the struct of data common to all types. */
     inline const base_type_members& get_base_type_members() const {
         return m_members;
@@ -412,6 +462,15 @@ public:
      * does this.
      */
     virtual void metadata_finalize_buffers(char *metadata) const;
+    /**
+     * For blockref types, moves the memory allocated through the
+     * blockrefs of src_metadata into the memory blocks of dst_metadata,
+     * so that data written using src_metadata stays valid for as long
+     * as dst_metadata is. Both metadata must be for this type. This
+     * gathers data that several threads evaluated, each with its own
+     * memory blocks, into one array.
+     */
+    virtual void metadata_merge_buffers(char *dst_metadata, char *src_metadata) const;
     /** Debug print of the metdata */
     virtual void metadata_debug_print(const char *metadata, std::ostream& o,
                     const std::string& indent) const;
@@ -594,6 +653,8 @@ public:
 
     friend void base_type_incref(const base_type *ed);
     friend void base_type_decref(const base_type *ed);
+    friend const base_type *intern_base_type(const base_type *bt);
+    friend void release_interned_base_type(const base_type *bt);
 };
 
 /**
@@ -624,7 +685,11 @@ inline void base_type_decref(const base_type *bd)
 {
     //std::cout << "dynd type " << (void *)ed << " dec: " << ed->m_use_count - 1 << "\t"; ed->print_type(std::cout); std::cout << std::endl;
     if (--bd->m_use_count == 0) {
-        delete bd;
+        if (bd->m_interned) {
+            release_interned_base_type(bd);
+        } else {
+            delete bd;
+        }
     }
 }
 
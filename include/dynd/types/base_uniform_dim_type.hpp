@@ -34,6 +34,8 @@ public:
 
     virtual ~base_uniform_dim_type();
 
+    size_t compute_hash() const;
+
     /** The element type. */
     inline const ndt::type& get_element_type() const {
         return m_element_tp;
@@ -44,6 +44,13 @@ public:
 
     ndt::type with_replaced_storage_type(const ndt::type& replacement_type) const;
 
+    size_t make_assignment_kernel(
+                    ckernel_builder *out, size_t offset_out,
+                    const ndt::type& dst_tp, const char *dst_metadata,
+                    const ndt::type& src_tp, const char *src_metadata,
+                    kernel_request_t kernreq, assign_error_mode errmode,
+                    const eval::eval_context *ectx) const;
+
     size_t make_operand_to_value_assignment_kernel(
                     ckernel_builder *out, size_t offset_out,
                     const char *dst_metadata, const char *src_metadata,
@@ -84,6 +84,8 @@ public:
 
     bool is_lossless_assignment(const ndt::type& dst_tp, const ndt::type& src_tp) const;
 
+    size_t compute_hash() const;
+
     bool operator==(const base_type& rhs) const;
 
     void metadata_default_construct(char *metadata, intptr_t ndim, const intptr_t* shape) const;
@@ -34,6 +34,10 @@ public:
     const ndt::type& get_operand_type() const {
         return m_operand_type;
     }
+    /** The error mode of the operand to value conversion */
+    assign_error_mode get_errmode_to_value() const {
+        return m_errmode_to_value;
+    }
     void print_data(std::ostream& o, const char *metadata, const char *data) const;
 
     void print_type(std::ostream& o) const;
@@ -0,0 +1,187 @@
+//
+// Copyright (C) 2011-14 Mark Wiebe, DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+// The dictionary string type stores each string as a uint32 code
+// into a dictionary of unique strings, which grows as new strings
+// are assigned. Unlike the categorical type, the dictionary is not
+// fixed when the type is constructed, and all the arrays using the
+// same type share it.
+//
+// The categorical type's storage isn't reused, because it sorts its
+// categories when the type is created and maps values by binary search
+// into that fixed array, where this type assigns codes as strings arrive.
+//
+#ifndef _DYND__DICTIONARY_STRING_TYPE_HPP_
+#define _DYND__DICTIONARY_STRING_TYPE_HPP_
+
+#include <vector>
+
+#include <dynd/type.hpp>
+#include <dynd/typed_data_assign.hpp>
+#include <dynd/string_encodings.hpp>
+#include <dynd/types/string_type.hpp>
+#include <dynd/platform_mutex.hpp>
+
+namespace dynd {
+
+/**
+ * An append-only set of unique strings, each identified by the
+ * uint32 code given to it when it was first interned. The string
+ * data is held in a POD memory block, so string pointers obtained
+ * from the dictionary stay valid as it grows.
+ *
+ * All the member functions lock the dictionary, so several threads
+ * may intern into and read from one dictionary at the same time.
+ */
+class string_dictionary {
+    struct entry {
+        string_type_data str;
+        uint32_t hash;
+    };
+
+    /** Holds the bytes of all the strings */
+    memory_block_ptr m_storage;
+    /** The strings, indexed by code */
+    std::vector<entry> m_entries;
+    /** Open addressing hash table of code + 1, or 0 for an empty slot */
+    std::vector<uint32_t> m_slots;
+    /** Guards all the fields above */
+    mutable platform_mutex m_mutex;
+
+    // Non-copyable
+    string_dictionary(const string_dictionary&);
+    string_dictionary& operator=(const string_dictionary&);
+
+    static uint32_t hash_bytes(const char *begin, const char *end);
+    void grow_slots();
+    intptr_t find_unlocked(const char *begin, const char *end) const;
+public:
+    string_dictionary();
+
+    /** The number of strings in the dictionary */
+    size_t size() const;
+
+    /**
+     * Returns the string for a code. It is returned by value, because
+     * the table of strings may move as other threads intern new ones,
+     * but the bytes it points at stay where they are.
+     */
+    string_type_data get(uint32_t code) const;
+
+    /**
+     * Returns the code of the string with the given bytes,
+     * or -1 if the dictionary doesn't contain it.
+     */
+    intptr_t find(const char *begin, const char *end) const;
+
+    /**
+     * Returns the code of the string with the given bytes,
+     * adding it to the dictionary if it is new.
+     */
+    uint32_t intern(const char *begin, const char *end);
+};
+
+class dictionary_string_type : public base_string_type {
+    string_encoding_t m_encoding;
+    string_dictionary *m_dictionary;
+
+public:
+    dictionary_string_type(string_encoding_t encoding);
+
+    virtual ~dictionary_string_type();
+
+    string_encoding_t get_encoding() const {
+        return m_encoding;
+    }
+
+    /**
+     * The dictionary of the type. It grows as strings are
+     * assigned to arrays of this type.
+     */
+    string_dictionary& get_dictionary() const {
+        return *m_dictionary;
+    }
+
+    /** Return the type of the code used to index the dictionary. */
+    ndt::type get_storage_type() const {
+        return ndt::make_type<uint32_t>();
+    }
+
+    /** Returns the strings of the dictionary, in code order, as an nd::array */
+    nd::array get_strings() const;
+
+    void get_string_range(const char **out_begin, const char**out_end, const char *metadata, const char *data) const;
+    void set_utf8_string(const char *metadata, char *data, assign_error_mode errmode,
+                    const char* utf8_begin, const char *utf8_end) const;
+
+    void print_data(std::ostream& o, const char *metadata, const char *data) const;
+
+    void print_type(std::ostream& o) const;
+
+    void get_shape(intptr_t ndim, intptr_t i, intptr_t *out_shape, const char *metadata, const char *data) const;
+
+    bool is_lossless_assignment(const ndt::type& dst_tp, const ndt::type& src_tp) const;
+
+    size_t compute_hash() const;
+
+    /**
+     * Two dictionary string types are equal when they have the same
+     * encoding and share a dictionary, because only then do their
+     * codes mean the same strings.
+     */
+    bool operator==(const base_type& rhs) const;
+
+    void metadata_default_construct(char *metadata, intptr_t ndim, const intptr_t* shape) const;
+    void metadata_copy_construct(char *dst_metadata, const char *src_metadata, memory_block_data *embedded_reference) const;
+    void metadata_destruct(char *metadata) const;
+
+    size_t make_assignment_kernel(
+                    ckernel_builder *out, size_t offset_out,
+                    const ndt::type& dst_tp, const char *dst_metadata,
+                    const ndt::type& src_tp, const char *src_metadata,
+                    kernel_request_t kernreq, assign_error_mode errmode,
+                    const eval::eval_context *ectx) const;
+
+    size_t make_comparison_kernel(
+                    ckernel_builder *out, size_t offset_out,
+                    const ndt::type& src0_dt, const char *src0_metadata,
+                    const ndt::type& src1_dt, const char *src1_metadata,
+                    comparison_type_t comptype,
+                    const eval::eval_context *ectx) const;
+
+    void make_string_iter(dim_iter *out_di, string_encoding_t encoding,
+            const char *metadata, const char *data,
+            const memory_block_ptr& ref,
+            intptr_t buffer_max_mem,
+            const eval::eval_context *ectx) const;
+
+    void get_dynamic_array_properties(
+                    const std::pair<std::string, gfunc::callable> **out_properties,
+                    size_t *out_count) const;
+    void get_dynamic_type_properties(
+                    const std::pair<std::string, gfunc::callable> **out_properties,
+                    size_t *out_count) const;
+};
+
+namespace ndt {
+    /**
+     * Makes a dictionary string type with a new, empty dictionary. Arrays
+     * share a dictionary by being created with the same type object.
+     */
+    inline ndt::type make_dictionary_string(string_encoding_t encoding = string_encoding_utf_8) {
+        return ndt::type(new dictionary_string_type(encoding), false);
+    }
+
+    /**
+     * Returns the dictionary string type shared by the whole process for
+     * the encoding, which the datashape "dictionary_string" parses to.
+     * Its dictionary holds every string ever assigned to it, so arrays
+     * with many distinct strings should use make_dictionary_string instead.
+     */
+    ndt::type make_shared_dictionary_string(string_encoding_t encoding = string_encoding_utf_8);
+} // namespace ndt
+
+} // namespace dynd
+
+#endif // _DYND__DICTIONARY_STRING_TYPE_HPP_
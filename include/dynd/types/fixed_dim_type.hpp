@@ -82,6 +82,7 @@ public:
     void metadata_copy_construct(char *dst_metadata, const char *src_metadata, memory_block_data *embedded_reference) const;
     void metadata_reset_buffers(char *metadata) const;
     void metadata_finalize_buffers(char *metadata) const;
+    void metadata_merge_buffers(char *dst_metadata, char *src_metadata) const;
     void metadata_destruct(char *metadata) const;
     void metadata_debug_print(const char *metadata, std::ostream& o, const std::string& indent) const;
     size_t metadata_copy_construct_onedim(char *dst_metadata, const char *src_metadata,
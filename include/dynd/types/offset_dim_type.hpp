@@ -0,0 +1,157 @@
+//
+// Copyright (C) 2011-14 Mark Wiebe, DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#ifndef _DYND__OFFSET_DIM_TYPE_HPP_
+#define _DYND__OFFSET_DIM_TYPE_HPP_
+
+#include <dynd/type.hpp>
+#include <dynd/array.hpp>
+#include <dynd/types/base_uniform_dim_type.hpp>
+
+namespace dynd {
+
+struct offset_dim_type_metadata {
+    /**
+     * A reference to the memory block which contains the values.
+     */
+    memory_block_data *blockref;
+    /** Pointer to value 0, which the offsets are relative to */
+    char *values;
+    intptr_t stride;
+};
+
+/**
+ * A variable-sized dimension whose elements all live in one values
+ * buffer, described by an offsets array like in CSR sparse matrices.
+ *
+ * The data of an element is one intptr_t, the offset of its first value,
+ * and the offset one past its last value is the intptr_t which
+ * immediately follows it in memory. An array `strided * offset * T` with
+ * n rows thus has an outer dimension whose data is the n+1 offsets, at
+ * 8 bytes per row instead of the 16 of var_dim, and whose values are
+ * contiguous, so they can be processed as one flat strided array.
+ *
+ * Because elements read past their own data, this type can't be
+ * default constructed. Arrays of it are views made by
+ * nd::make_offset_dim_array, and copying one makes a var_dim.
+ */
+class offset_dim_type : public base_uniform_dim_type {
+    std::vector<std::pair<std::string, gfunc::callable> > m_array_properties, m_array_functions;
+public:
+    offset_dim_type(const ndt::type& element_tp);
+
+    virtual ~offset_dim_type();
+
+    void print_data(std::ostream& o, const char *metadata, const char *data) const;
+
+    void print_type(std::ostream& o) const;
+
+    bool is_expression() const;
+    bool is_unique_data_owner(const char *metadata) const;
+    void transform_child_types(type_transform_fn_t transform_fn, void *extra,
+                    ndt::type& out_transformed_tp, bool& out_was_transformed) const;
+    ndt::type get_canonical_type() const;
+    bool is_strided() const;
+    void process_strided(const char *metadata, const char *data,
+                    ndt::type& out_dt, const char *&out_origin,
+                    intptr_t& out_stride, intptr_t& out_dim_size) const;
+
+    ndt::type apply_linear_index(intptr_t nindices, const irange *indices,
+                size_t current_i, const ndt::type& root_tp, bool leading_dimension) const;
+    intptr_t apply_linear_index(intptr_t nindices, const irange *indices, const char *metadata,
+                    const ndt::type& result_tp, char *out_metadata,
+                    memory_block_data *embedded_reference,
+                    size_t current_i, const ndt::type& root_tp,
+                    bool leading_dimension, char **inout_data,
+                    memory_block_data **inout_dataref) const;
+    ndt::type at_single(intptr_t i0, const char **inout_metadata, const char **inout_data) const;
+
+    ndt::type get_type_at_dimension(char **inout_metadata, intptr_t i, intptr_t total_ndim = 0) const;
+
+    intptr_t get_dim_size(const char *metadata, const char *data) const;
+    void get_shape(intptr_t ndim, intptr_t i, intptr_t *out_shape, const char *metadata, const char *data) const;
+    void get_strides(size_t i, intptr_t *out_strides, const char *metadata) const;
+
+    axis_order_classification_t classify_axis_order(const char *metadata) const;
+
+    bool is_lossless_assignment(const ndt::type& dst_tp, const ndt::type& src_tp) const;
+
+    bool operator==(const base_type& rhs) const;
+
+    void metadata_default_construct(char *metadata, intptr_t ndim, const intptr_t* shape) const;
+    void metadata_copy_construct(char *dst_metadata, const char *src_metadata, memory_block_data *embedded_reference) const;
+    void metadata_destruct(char *metadata) const;
+    void metadata_debug_print(const char *metadata, std::ostream& o, const std::string& indent) const;
+    size_t metadata_copy_construct_onedim(char *dst_metadata, const char *src_metadata,
+                    memory_block_data *embedded_reference) const;
+
+    size_t make_assignment_kernel(
+                    ckernel_builder *out, size_t offset_out,
+                    const ndt::type& dst_tp, const char *dst_metadata,
+                    const ndt::type& src_tp, const char *src_metadata,
+                    kernel_request_t kernreq, assign_error_mode errmode,
+                    const eval::eval_context *ectx) const;
+
+    void foreach_leading(char *data, const char *metadata, foreach_fn_t callback, void *callback_data) const;
+
+    void get_dynamic_type_properties(
+                    const std::pair<std::string, gfunc::callable> **out_properties,
+                    size_t *out_count) const;
+    void get_dynamic_array_properties(
+                    const std::pair<std::string, gfunc::callable> **out_properties,
+                    size_t *out_count) const;
+    void get_dynamic_array_functions(
+                    const std::pair<std::string, gfunc::callable> **out_functions,
+                    size_t *out_count) const;
+};
+
+/** The pointer to the first value of an offset_dim element */
+inline char *offset_dim_element_begin(const offset_dim_type_metadata *md, const char *data) {
+    return md->values + reinterpret_cast<const intptr_t *>(data)[0] * md->stride;
+}
+
+/** The number of values in an offset_dim element */
+inline intptr_t offset_dim_element_size(const char *data) {
+    const intptr_t *offsets = reinterpret_cast<const intptr_t *>(data);
+    return offsets[1] - offsets[0];
+}
+
+namespace ndt {
+    inline type make_offset_dim(const type& element_tp) {
+        return type(new offset_dim_type(element_tp), false);
+    }
+} // namespace ndt
+
+namespace nd {
+    /**
+     * Makes a `strided * offset * T` view of a one-dimensional `values`
+     * array with element type T, whose row i is values[offsets[i]:offsets[i+1]].
+     * Neither array is copied if `offsets` is a contiguous array of intptr_t.
+     *
+     * \param values  The values of all the rows, a one-dimensional array.
+     * \param offsets  The n+1 non-decreasing offsets delimiting the n rows.
+     */
+    array make_offset_dim_array(const array& values, const array& offsets);
+
+    /**
+     * Returns a `strided * T` view of all the values of an `offset * T`
+     * or `strided * offset * T` array, without copying, so operations on
+     * all the values can run as one flat loop. Throws a type_error if the
+     * rows aren't adjacent in the outer dimension, for example after
+     * reversing it, in which case the array should be copied first.
+     */
+    array offset_dim_values(const array& a);
+
+    /**
+     * Returns a read-only `strided * intptr` view of the n+1 offsets
+     * of a `strided * offset * T` array with n rows. The values returned
+     * by offset_dim_values start at the first offset, not at zero.
+     */
+    array offset_dim_offsets(const array& a);
+} // namespace nd
+
+} // namespace dynd
+
+#endif // _DYND__OFFSET_DIM_TYPE_HPP_
@@ -0,0 +1,136 @@
+//
+// Copyright (C) 2011-14 Mark Wiebe, DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+// The packed string type stores all the characters of its
+// strings in one contiguous buffer, with each element being a
+// pair of int32 or int64 offsets into that buffer.
+//
+#ifndef _DYND__PACKED_STRING_TYPE_HPP_
+#define _DYND__PACKED_STRING_TYPE_HPP_
+
+#include <dynd/type.hpp>
+#include <dynd/typed_data_assign.hpp>
+#include <dynd/string_encodings.hpp>
+#include <dynd/memblock/contiguous_memory_block.hpp>
+
+namespace dynd {
+
+struct packed_string_type_metadata {
+    /**
+     * A reference to the contiguous memory block which contains
+     * the characters of all the strings.
+     */
+    memory_block_data *blockref;
+};
+
+/**
+ * The data of a packed string element, the range of bytes
+ * [begin, end) within the contiguous buffer. The offset type
+ * is int32_t or int64_t.
+ */
+template<class T>
+struct packed_string_type_data {
+    T begin;
+    T end;
+};
+
+class packed_string_type : public base_string_type {
+    string_encoding_t m_encoding;
+    type_id_t m_offset_type_id;
+
+public:
+    packed_string_type(string_encoding_t encoding, type_id_t offset_type_id);
+
+    virtual ~packed_string_type();
+
+    string_encoding_t get_encoding() const {
+        return m_encoding;
+    }
+
+    /** The type of the offsets, int32_type_id or int64_type_id */
+    type_id_t get_offset_type_id() const {
+        return m_offset_type_id;
+    }
+
+    /** Reads the [begin, end) byte offsets of a string element */
+    inline void get_offsets(const char *data, intptr_t *out_begin, intptr_t *out_end) const {
+        if (m_offset_type_id == int32_type_id) {
+            const packed_string_type_data<int32_t> *d = reinterpret_cast<const packed_string_type_data<int32_t> *>(data);
+            *out_begin = d->begin;
+            *out_end = d->end;
+        } else {
+            const packed_string_type_data<int64_t> *d = reinterpret_cast<const packed_string_type_data<int64_t> *>(data);
+            *out_begin = static_cast<intptr_t>(d->begin);
+            *out_end = static_cast<intptr_t>(d->end);
+        }
+    }
+
+    /**
+     * Writes the [begin, end) byte offsets of a string element, raising
+     * an error if they don't fit in the offset type.
+     */
+    void set_offsets(char *data, intptr_t begin, intptr_t end) const;
+
+    void get_string_range(const char **out_begin, const char**out_end, const char *metadata, const char *data) const;
+    void set_utf8_string(const char *metadata, char *data, assign_error_mode errmode,
+                    const char* utf8_begin, const char *utf8_end) const;
+
+    void print_data(std::ostream& o, const char *metadata, const char *data) const;
+
+    void print_type(std::ostream& o) const;
+
+    bool is_unique_data_owner(const char *metadata) const;
+    ndt::type get_canonical_type() const;
+
+    void get_shape(intptr_t ndim, intptr_t i, intptr_t *out_shape, const char *metadata, const char *data) const;
+
+    bool is_lossless_assignment(const ndt::type& dst_tp, const ndt::type& src_tp) const;
+
+    bool operator==(const base_type& rhs) const;
+
+    void metadata_default_construct(char *metadata, intptr_t ndim, const intptr_t* shape) const;
+    void metadata_copy_construct(char *dst_metadata, const char *src_metadata, memory_block_data *embedded_reference) const;
+    void metadata_reset_buffers(char *metadata) const;
+    void metadata_finalize_buffers(char *metadata) const;
+    void metadata_destruct(char *metadata) const;
+    void metadata_debug_print(const char *metadata, std::ostream& o, const std::string& indent) const;
+
+    size_t make_assignment_kernel(
+                    ckernel_builder *out, size_t offset_out,
+                    const ndt::type& dst_tp, const char *dst_metadata,
+                    const ndt::type& src_tp, const char *src_metadata,
+                    kernel_request_t kernreq, assign_error_mode errmode,
+                    const eval::eval_context *ectx) const;
+
+    size_t make_comparison_kernel(
+                    ckernel_builder *out, size_t offset_out,
+                    const ndt::type& src0_dt, const char *src0_metadata,
+                    const ndt::type& src1_dt, const char *src1_metadata,
+                    comparison_type_t comptype,
+                    const eval::eval_context *ectx) const;
+
+    void make_string_iter(dim_iter *out_di, string_encoding_t encoding,
+            const char *metadata, const char *data,
+            const memory_block_ptr& ref,
+            intptr_t buffer_max_mem,
+            const eval::eval_context *ectx) const;
+};
+
+namespace ndt {
+    /**
+     * Makes a packed string type, whose characters are stored in one
+     * contiguous buffer addressed by offsets of the given type.
+     *
+     * \param encoding  The encoding of the string.
+     * \param offset_type_id  The type of the offsets, int32_type_id or int64_type_id.
+     */
+    inline ndt::type make_packed_string(string_encoding_t encoding = string_encoding_utf_8,
+                    type_id_t offset_type_id = int32_type_id) {
+        return ndt::type(new packed_string_type(encoding, offset_type_id), false);
+    }
+} // namespace ndt
+
+} // namespace dynd
+
+#endif // _DYND__PACKED_STRING_TYPE_HPP_
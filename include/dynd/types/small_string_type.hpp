@@ -0,0 +1,147 @@
+//
+// Copyright (C) 2011-14 Mark Wiebe, DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+// The small string type is a variable-sized string which
+// stores strings of up to 15 bytes inline in the element,
+// and longer strings in a memory block like the string type.
+//
+#ifndef _DYND__SMALL_STRING_TYPE_HPP_
+#define _DYND__SMALL_STRING_TYPE_HPP_
+
+#include <cstring>
+
+#include <dynd/type.hpp>
+#include <dynd/typed_data_assign.hpp>
+#include <dynd/string_encodings.hpp>
+
+namespace dynd {
+
+struct small_string_type_metadata {
+    /**
+     * A reference to the memory block which contains the bytes
+     * of the strings too long to store inline.
+     */
+    memory_block_data *blockref;
+};
+
+/**
+ * The data of a small string element. The last byte is a tag, which
+ * is the size of the string when it is stored inline in the first 15
+ * bytes, or small_string_heap_tag when the element holds a pointer
+ * to the string's bytes followed by its uint32 size. Inline strings
+ * are zero padded, and strings are only stored out of line when
+ * they don't fit inline, so equal strings have equal elements
+ * whenever one of them is inline.
+ */
+struct small_string_type_data {
+    char data[16];
+};
+
+enum {
+    small_string_inline_capacity = 15,
+    small_string_heap_tag = 0xff
+};
+
+inline bool small_string_is_inline(const char *data) {
+    return static_cast<uint8_t>(data[small_string_inline_capacity]) != small_string_heap_tag;
+}
+
+/** Gets the [begin, end) range of the bytes of a small string element */
+inline void small_string_get_range(const char *data, const char **out_begin, const char **out_end) {
+    uint8_t tag = static_cast<uint8_t>(data[small_string_inline_capacity]);
+    if (tag != small_string_heap_tag) {
+        *out_begin = data;
+        *out_end = data + tag;
+    } else {
+        *out_begin = *reinterpret_cast<char * const *>(data);
+        *out_end = *out_begin + *reinterpret_cast<const uint32_t *>(data + sizeof(char *));
+    }
+}
+
+/** Stores a string of at most small_string_inline_capacity bytes inline */
+inline void small_string_set_inline(char *data, const char *begin, const char *end) {
+    size_t size = end - begin;
+    memmove(data, begin, size);
+    memset(data + size, 0, small_string_inline_capacity - size);
+    data[small_string_inline_capacity] = static_cast<char>(size);
+}
+
+/** Stores a pointer to a string too long to store inline */
+inline void small_string_set_heap(char *data, char *begin, char *end) {
+    if (end - begin > 0xffffffffLL) {
+        throw std::runtime_error("string is too large for a dynd small string");
+    }
+    *reinterpret_cast<char **>(data) = begin;
+    *reinterpret_cast<uint32_t *>(data + sizeof(char *)) = static_cast<uint32_t>(end - begin);
+    data[small_string_inline_capacity] = static_cast<char>(small_string_heap_tag);
+}
+
+class small_string_type : public base_string_type {
+    string_encoding_t m_encoding;
+
+public:
+    small_string_type(string_encoding_t encoding);
+
+    virtual ~small_string_type();
+
+    string_encoding_t get_encoding() const {
+        return m_encoding;
+    }
+
+    void get_string_range(const char **out_begin, const char**out_end, const char *metadata, const char *data) const;
+    void set_utf8_string(const char *metadata, char *data, assign_error_mode errmode,
+                    const char* utf8_begin, const char *utf8_end) const;
+
+    void print_data(std::ostream& o, const char *metadata, const char *data) const;
+
+    void print_type(std::ostream& o) const;
+
+    bool is_unique_data_owner(const char *metadata) const;
+    ndt::type get_canonical_type() const;
+
+    void get_shape(intptr_t ndim, intptr_t i, intptr_t *out_shape, const char *metadata, const char *data) const;
+
+    bool is_lossless_assignment(const ndt::type& dst_tp, const ndt::type& src_tp) const;
+
+    bool operator==(const base_type& rhs) const;
+
+    void metadata_default_construct(char *metadata, intptr_t ndim, const intptr_t* shape) const;
+    void metadata_copy_construct(char *dst_metadata, const char *src_metadata, memory_block_data *embedded_reference) const;
+    void metadata_reset_buffers(char *metadata) const;
+    void metadata_finalize_buffers(char *metadata) const;
+    void metadata_merge_buffers(char *dst_metadata, char *src_metadata) const;
+    void metadata_destruct(char *metadata) const;
+    void metadata_debug_print(const char *metadata, std::ostream& o, const std::string& indent) const;
+
+    size_t make_assignment_kernel(
+                    ckernel_builder *out, size_t offset_out,
+                    const ndt::type& dst_tp, const char *dst_metadata,
+                    const ndt::type& src_tp, const char *src_metadata,
+                    kernel_request_t kernreq, assign_error_mode errmode,
+                    const eval::eval_context *ectx) const;
+
+    size_t make_comparison_kernel(
+                    ckernel_builder *out, size_t offset_out,
+                    const ndt::type& src0_dt, const char *src0_metadata,
+                    const ndt::type& src1_dt, const char *src1_metadata,
+                    comparison_type_t comptype,
+                    const eval::eval_context *ectx) const;
+
+    void make_string_iter(dim_iter *out_di, string_encoding_t encoding,
+            const char *metadata, const char *data,
+            const memory_block_ptr& ref,
+            intptr_t buffer_max_mem,
+            const eval::eval_context *ectx) const;
+};
+
+namespace ndt {
+    /** Makes a small string type with the given encoding */
+    inline ndt::type make_small_string(string_encoding_t encoding = string_encoding_utf_8) {
+        return ndt::type(new small_string_type(encoding), false);
+    }
+} // namespace ndt
+
+} // namespace dynd
+
+#endif // _DYND__SMALL_STRING_TYPE_HPP_
@@ -91,6 +91,12 @@ enum type_id_t {
     string_type_id,
     // A NULL-terminated string buffer of a fixed size
     fixedstring_type_id,
+    // A variable-sized string type, stored as offsets into one contiguous buffer
+    packed_string_type_id,
+    // A variable-sized string type, with short strings stored inline
+    small_string_type_id,
+    // A string stored as a code into a growable dictionary
+    dictionary_string_type_id,
 
     // A categorical (enum-like) type
     categorical_type_id,
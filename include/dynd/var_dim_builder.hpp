@@ -0,0 +1,100 @@
+//
+// Copyright (C) 2011-14 Mark Wiebe, DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#ifndef _DYND__VAR_DIM_BUILDER_HPP_
+#define _DYND__VAR_DIM_BUILDER_HPP_
+
+#include <vector>
+
+#include <dynd/array.hpp>
+
+namespace dynd {
+
+/**
+ * Builds a `strided * var * T` array one row at a time. The elements
+ * of all the rows are appended to one contiguous heap, which grows
+ * geometrically, and finalize() turns the heap into the memory block
+ * of the var dimension without copying it.
+ *
+ * The element type T must be POD and have no metadata, for example
+ * a builtin type, a fixed_dim of one, or a cstruct of them.
+ *
+ *      var_dim_builder b(ndt::make_type<float>());
+ *      b.reserve(nrows, nelements);
+ *      for (...) {
+ *          b.append_row(event_data, event_count);
+ *      }
+ *      nd::array a = b.finalize();
+ */
+class var_dim_builder {
+    struct row {
+        intptr_t offset;
+        intptr_t size;
+    };
+
+    ndt::type m_element_tp;
+    intptr_t m_element_size;
+    /** The heap of row elements, a chunk from the memory chunk pool */
+    char *m_heap;
+    intptr_t m_heap_capacity, m_heap_size;
+    std::vector<row> m_rows;
+
+    void grow_heap(intptr_t min_capacity);
+
+    // Non-copyable
+    var_dim_builder(const var_dim_builder&);
+    var_dim_builder& operator=(const var_dim_builder&);
+public:
+    explicit var_dim_builder(const ndt::type& element_tp);
+
+    ~var_dim_builder();
+
+    /** The element type of the var dimension */
+    const ndt::type& get_element_type() const {
+        return m_element_tp;
+    }
+
+    /** The number of rows appended so far */
+    intptr_t get_row_count() const {
+        return (intptr_t)m_rows.size();
+    }
+
+    /** The number of elements appended so far, in all the rows */
+    intptr_t get_element_count() const {
+        return m_element_size != 0 ? m_heap_size / m_element_size : 0;
+    }
+
+    /**
+     * Reserves room for a total of row_count rows holding
+     * element_count elements, so appending up to those
+     * counts doesn't reallocate.
+     */
+    void reserve(intptr_t row_count, intptr_t element_count);
+
+    /**
+     * Appends a row of `count` elements, whose data is left uninitialized.
+     *
+     * \returns  A pointer to the data of the row, which is only valid
+     *           until the next call which appends or reserves.
+     */
+    char *append_uninitialized_row(intptr_t count);
+
+    /**
+     * Appends a row of `count` elements, copying their data,
+     * which must be contiguous, from `data`.
+     */
+    void append_row(const void *data, intptr_t count);
+
+    /**
+     * Creates the array of all the rows appended so far, with type
+     * `strided * var * T`. The builder is empty afterwards, and may
+     * be reused.
+     */
+    nd::array finalize();
+};
+
+} // namespace dynd
+
+#endif // _DYND__VAR_DIM_BUILDER_HPP_
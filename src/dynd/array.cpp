@@ -3,6 +3,8 @@
 // BSD 2-Clause License, see LICENSE.txt
 //
 
+#include <map>
+
 #include <dynd/array.hpp>
 #include <dynd/array_iter.hpp>
 #include <dynd/types/strided_dim_type.hpp>
@@ -12,6 +14,7 @@
 #include <dynd/types/view_type.hpp>
 #include <dynd/types/string_type.hpp>
 #include <dynd/types/bytes_type.hpp>
+#include <dynd/types/json_type.hpp>
 #include <dynd/types/fixedbytes_type.hpp>
 #include <dynd/types/type_type.hpp>
 #include <dynd/types/convert_type.hpp>
@@ -27,6 +30,8 @@
 #include <dynd/types/categorical_type.hpp>
 #include <dynd/types/builtin_type_properties.hpp>
 #include <dynd/memblock/memmap_memory_block.hpp>
+#include <dynd/memblock/pod_memory_block.hpp>
+#include <dynd/eval/parallel_eval.hpp>
 
 using namespace std;
 using namespace dynd;
@@ -669,6 +674,65 @@ nd::array nd::array::storage() const
     }
 }
 
+/**
+ * Applies integer indices to the leading strided_dim and fixed_dim
+ * dimensions of tp in one pass, stopping at the first other type.
+ * The returned type is borrowed from tp, so no reference counts
+ * are touched.
+ *
+ * \returns  The number of indices which were applied.
+ */
+static intptr_t apply_strided_integer_indices(const ndt::type& tp,
+                intptr_t nindices, const intptr_t *indices,
+                const ndt::type *&inout_tp, const char *&inout_metadata,
+                const char *&inout_data)
+{
+    const ndt::type *cur_tp = &tp;
+    const char *metadata = inout_metadata, *data = inout_data;
+    intptr_t i = 0;
+    for (; i < nindices; ++i) {
+        type_id_t id = cur_tp->get_type_id();
+        if (id == strided_dim_type_id) {
+            const strided_dim_type_metadata *md =
+                            reinterpret_cast<const strided_dim_type_metadata *>(metadata);
+            data += apply_single_index(indices[i], md->size, NULL) * md->stride;
+            metadata += sizeof(strided_dim_type_metadata);
+            cur_tp = &static_cast<const strided_dim_type *>(cur_tp->extended())->get_element_type();
+        } else if (id == fixed_dim_type_id) {
+            const fixed_dim_type *fdt = static_cast<const fixed_dim_type *>(cur_tp->extended());
+            data += apply_single_index(indices[i], fdt->get_fixed_dim_size(), NULL) *
+                            fdt->get_fixed_stride();
+            cur_tp = &fdt->get_element_type();
+        } else {
+            break;
+        }
+    }
+    inout_tp = cur_tp;
+    inout_metadata = metadata;
+    inout_data = data;
+    return i;
+}
+
+const char *nd::array::get_element_ptr(intptr_t nindices, const intptr_t *indices,
+                ndt::type& out_tp, const char *&out_metadata) const
+{
+    const ndt::type *tp;
+    const char *metadata = get_ndo_meta();
+    const char *data = get_ndo()->m_data_pointer;
+    intptr_t i = apply_strided_integer_indices(get_type(), nindices, indices,
+                    tp, metadata, data);
+    out_tp = *tp;
+    // Any dimensions which aren't strided are indexed one at a time
+    for (; i < nindices; ++i) {
+        if (out_tp.is_builtin()) {
+            throw too_many_indices(get_type(), nindices, i);
+        }
+        out_tp = out_tp.at_single(indices[i], &metadata, &data);
+    }
+    out_metadata = metadata;
+    return data;
+}
+
 nd::array nd::array::at_array(intptr_t nindices, const irange *indices, bool collapse_leading) const
 {
     if (is_scalar()) {
@@ -677,18 +741,51 @@ nd::array nd::array::at_array(intptr_t nindices, const irange *indices, bool col
         }
         return *this;
     } else {
-        ndt::type this_dt(get_ndo()->m_type, true);
+        // Fast path for integer indices which all go into strided
+        // dimensions, producing a scalar or a strided view. No leading
+        // dimension collapsing applies to these, so the type and offset
+        // come from a single pass over the metadata.
+        intptr_t int_indices[8];
+        intptr_t i = 0;
+        if (nindices <= 8) {
+            for (; i < nindices && indices[i].step() == 0; ++i) {
+                int_indices[i] = indices[i].start();
+            }
+        }
+        if (i == nindices && nindices > 0) {
+            const ndt::type *tp;
+            const char *metadata = get_ndo_meta();
+            const char *data = get_ndo()->m_data_pointer;
+            if (apply_strided_integer_indices(get_type(), nindices, int_indices,
+                            tp, metadata, data) == nindices &&
+                        (tp->is_builtin() || tp->get_type_id() == strided_dim_type_id ||
+                            tp->get_type_id() == fixed_dim_type_id)) {
+                array result(make_array_memory_block(tp->get_metadata_size()));
+                array_preamble *ndo = result.get_ndo();
+                ndo->m_type = ndt::type(*tp).release();
+                ndo->m_data_pointer = const_cast<char *>(data);
+                ndo->m_data_reference = get_ndo()->m_data_reference ? get_ndo()->m_data_reference
+                                                                    : m_memblock.get();
+                memory_block_incref(ndo->m_data_reference);
+                if (!tp->is_builtin()) {
+                    tp->extended()->metadata_copy_construct(result.get_ndo_meta(),
+                                    metadata, m_memblock.get());
+                }
+                ndo->m_flags = get_ndo()->m_flags;
+                return result;
+            }
+        }
+
+        // Borrow the type references instead of copying them, to avoid
+        // reference count traffic on every indexing operation
+        const ndt::type& this_dt = get_type();
         ndt::type dt = get_ndo()->m_type->apply_linear_index(nindices, indices,
                         0, this_dt, collapse_leading);
         array result;
-        if (!dt.is_builtin()) {
-            result.set(make_array_memory_block(dt.extended()->get_metadata_size()));
-            result.get_ndo()->m_type = dt.extended();
-            base_type_incref(result.get_ndo()->m_type);
-        } else {
-            result.set(make_array_memory_block(0));
-            result.get_ndo()->m_type = reinterpret_cast<const base_type *>(dt.get_type_id());
-        }
+        result.set(make_array_memory_block(dt.is_builtin() ? 0 : dt.extended()->get_metadata_size()));
+        // Transfer the reference to the new type into the result
+        result.get_ndo()->m_type = dt.release();
+        const ndt::type& result_dt = result.get_type();
         result.get_ndo()->m_data_pointer = get_ndo()->m_data_pointer;
         if (get_ndo()->m_data_reference) {
             result.get_ndo()->m_data_reference = get_ndo()->m_data_reference;
@@ -698,7 +795,7 @@ nd::array nd::array::at_array(intptr_t nindices, const irange *indices, bool col
         }
         memory_block_incref(result.get_ndo()->m_data_reference);
         intptr_t offset = get_ndo()->m_type->apply_linear_index(nindices, indices,
-                        get_ndo_meta(), dt, result.get_ndo_meta(),
+                        get_ndo_meta(), result_dt, result.get_ndo_meta(),
                         m_memblock.get(), 0, this_dt,
                         collapse_leading,
                         &result.get_ndo()->m_data_pointer, &result.get_ndo()->m_data_reference);
@@ -729,6 +826,30 @@ void nd::array::val_assign(const ndt::type& rhs_dt, const char *rhs_metadata, co
                     errmode, ectx);
 }
 
+/**
+ * Returns true if the array is the only one referencing its data,
+ * including all the memory blocks referenced by its metadata.
+ */
+static bool is_unique_data_owner(const nd::array& n)
+{
+    const array_preamble *ndo = n.get_ndo();
+    if (ndo->m_memblockdata.m_use_count != 1) {
+        // More than one reference to the array itself
+        return false;
+    } else if (ndo->m_data_reference != NULL &&
+            (ndo->m_data_reference->m_use_count != 1 ||
+             !(ndo->m_data_reference->m_type == fixed_size_pod_memory_block_type ||
+               ndo->m_data_reference->m_type == pod_memory_block_type))) {
+        // More than one reference to the array's data, or the reference is to something
+        // other than a memblock owning its data, such as an external memblock.
+        return false;
+    } else if (!ndo->is_builtin_type() &&
+            !ndo->m_type->is_unique_data_owner(n.get_ndo_meta())) {
+        return false;
+    }
+    return true;
+}
+
 void nd::array::flag_as_immutable()
 {
     // If it's already immutable, everything's ok
@@ -737,21 +858,7 @@ void nd::array::flag_as_immutable()
     }
 
     // Check that nobody else is peeking into our data
-    bool ok = true;
-    if (m_memblock.get()->m_use_count != 1) {
-        // More than one reference to the array itself
-        ok = false;
-    } else if (get_ndo()->m_data_reference != NULL &&
-            (get_ndo()->m_data_reference->m_use_count != 1 ||
-             !(get_ndo()->m_data_reference->m_type == fixed_size_pod_memory_block_type ||
-               get_ndo()->m_data_reference->m_type == pod_memory_block_type))) {
-        // More than one reference to the array's data, or the reference is to something
-        // other than a memblock owning its data, such as an external memblock.
-        ok = false;
-    } else if (!get_ndo()->is_builtin_type() &&
-            !get_ndo()->m_type->is_unique_data_owner(get_ndo_meta())) {
-        ok = false;
-    }
+    bool ok = is_unique_data_owner(*this);
 
     if (ok) {
         // Finalize any allocated data in the metadata
@@ -768,6 +875,130 @@ void nd::array::flag_as_immutable()
     }
 }
 
+namespace {
+    struct compact_blockref_info {
+        /** The leaf metadata which holds the blockref */
+        string_type_metadata *md;
+        /** The string bytes needed, including alignment padding */
+        intptr_t size;
+        size_t alignment;
+        /** The compacted memory block, and where to copy the next string */
+        memory_block_ptr new_blockref;
+        char *new_current;
+    };
+
+    struct compact_buffers_state {
+        /** Set during the first pass, which sizes each blockref */
+        bool sizing;
+        std::map<memory_block_data *, compact_blockref_info> blockrefs;
+    };
+
+    // NOTE: string_type, bytes_type and json_type share the same
+    //       metadata and data layout, a blockref and a begin/end pair.
+    void compact_buffers_visit(const ndt::type& tp, char *data, const char *metadata, void *extra)
+    {
+        compact_buffers_state *st = reinterpret_cast<compact_buffers_state *>(extra);
+        size_t alignment;
+        switch (tp.get_type_id()) {
+            case string_type_id:
+                alignment = static_cast<const string_type *>(tp.extended())->get_target_alignment();
+                break;
+            case bytes_type_id:
+                alignment = static_cast<const bytes_type *>(tp.extended())->get_target_alignment();
+                break;
+            case json_type_id:
+                alignment = 1;
+                break;
+            case strided_dim_type_id:
+            case fixed_dim_type_id:
+            case var_dim_type_id:
+            case struct_type_id:
+            case cstruct_type_id:
+                tp.extended()->foreach_leading(data, metadata, &compact_buffers_visit, extra);
+                return;
+            default:
+                // No string data to compact
+                return;
+        }
+
+        string_type_metadata *md = reinterpret_cast<string_type_metadata *>(const_cast<char *>(metadata));
+        string_type_data *d = reinterpret_cast<string_type_data *>(data);
+        if (md->blockref == NULL || md->blockref->m_type != pod_memory_block_type) {
+            // Data embedded in the array's own memory can't be compacted
+            return;
+        }
+        compact_blockref_info& info = st->blockrefs[md->blockref];
+        intptr_t size = d->end - d->begin;
+        if (st->sizing) {
+            info.md = md;
+            info.alignment = max(info.alignment, alignment);
+            if (size > 0) {
+                info.size = (intptr_t)inc_to_alignment((size_t)info.size, alignment) + size;
+            }
+        } else {
+            if (size > 0) {
+                char *begin = inc_to_alignment(info.new_current, alignment);
+                memcpy(begin, d->begin, size);
+                d->begin = begin;
+                d->end = begin + size;
+                info.new_current = d->end;
+            } else {
+                d->begin = NULL;
+                d->end = NULL;
+            }
+        }
+    }
+} // anonymous namespace
+
+intptr_t nd::array::finalize_buffers(bool compact)
+{
+    if (get_ndo()->is_builtin_type()) {
+        return 0;
+    }
+
+    intptr_t reclaimed = 0;
+    if (compact) {
+        if (!is_unique_data_owner(*this)) {
+            stringstream ss;
+            ss << "Unable to compact the buffers of array of type " << get_type() << ", because ";
+            ss << "it does not uniquely own all of its data";
+            throw runtime_error(ss.str());
+        }
+
+        // First pass, find the size needed for each blockref
+        compact_buffers_state st;
+        st.sizing = true;
+        compact_buffers_visit(get_type(), get_ndo()->m_data_pointer, get_ndo_meta(), &st);
+
+        // Make the exactly-sized replacement memory blocks
+        for (std::map<memory_block_data *, compact_blockref_info>::iterator it = st.blockrefs.begin();
+                        it != st.blockrefs.end(); ++it) {
+            compact_blockref_info& info = it->second;
+            info.new_blockref = make_exact_pod_memory_block(info.size);
+            char *end;
+            memory_block_pod_allocator_api *api = get_memory_block_pod_allocator_api(info.new_blockref.get());
+            api->allocate(info.new_blockref.get(), info.size, info.alignment, &info.new_current, &end);
+        }
+
+        // Second pass, copy the strings and point them at the new memory
+        st.sizing = false;
+        compact_buffers_visit(get_type(), get_ndo()->m_data_pointer, get_ndo_meta(), &st);
+
+        // Swap in the new memory blocks
+        for (std::map<memory_block_data *, compact_blockref_info>::iterator it = st.blockrefs.begin();
+                        it != st.blockrefs.end(); ++it) {
+            compact_blockref_info& info = it->second;
+            reclaimed += pod_memory_block_get_capacity(it->first) -
+                            pod_memory_block_get_capacity(info.new_blockref.get());
+            memory_block_decref(info.md->blockref);
+            info.md->blockref = info.new_blockref.release();
+        }
+    }
+
+    get_ndo()->m_type->metadata_finalize_buffers(get_ndo_meta());
+    return reclaimed;
+}
+
 nd::array nd::array::p(const char *property_name) const
 {
     ndt::type dt = get_type();
@@ -838,6 +1069,19 @@ const gfunc::callable& nd::array::find_dynamic_function(const char *function_nam
     throw runtime_error(ss.str());
 }
 
+/**
+ * Assigns an array to the result that eval created for it, using
+ * the threads of the eval_context's pool when it has one.
+ */
+static void eval_assign(const nd::array& result, const nd::array& src,
+                const eval::eval_context *ectx)
+{
+    if (!(src.get_flags()&nd::read_access_flag) ||
+                    !eval::parallel_eval_assign(result, src, ectx)) {
+        result.val_assign(src, assign_error_default, ectx);
+    }
+}
+
 nd::array nd::array::eval(const eval::eval_context *ectx) const
 {
     const ndt::type& current_tp = get_type();
@@ -856,7 +1100,7 @@ nd::array nd::array::eval(const eval::eval_context *ectx) const
                             dt.extended())->reorder_default_constructed_strides(
                                             result.get_ndo_meta(), get_type(), get_ndo_meta());
         }
-        result.val_assign(*this, assign_error_default, ectx);
+        eval_assign(result, *this, ectx);
         return result;
     }
 }
@@ -880,7 +1124,7 @@ nd::array nd::array::eval_immutable(const eval::eval_context *ectx) const
                             dt.extended())->reorder_default_constructed_strides(
                                             result.get_ndo_meta(), get_type(), get_ndo_meta());
         }
-        result.val_assign(*this, assign_error_default, ectx);
+        eval_assign(result, *this, ectx);
         result.get_ndo()->m_flags = immutable_access_flag|read_access_flag;
         return result;
     }
@@ -901,7 +1145,7 @@ nd::array nd::array::eval_copy(uint32_t access_flags, const eval::eval_context *
                                         result.get_ndo_meta(),
                                         get_type(), get_ndo_meta());
     }
-    result.val_assign(*this, assign_error_default, ectx);
+    eval_assign(result, *this, ectx);
     // If the access_flags are 0, use the defaults
     access_flags = access_flags ? access_flags
                                 : (int32_t)nd::default_access_flags;
@@ -3,25 +3,169 @@
 // BSD 2-Clause License, see LICENSE.txt
 //
 
-#if 0 // Temporarily disabled
+#include <stdexcept>
+#include <cstring>
 
 #include <dynd/codegen/codegen_cache.hpp>
 #include <dynd/memblock/executable_memory_block.hpp>
-#include <dynd/codegen/unary_kernel_adapter_codegen.hpp>
-#include <dynd/codegen/binary_kernel_adapter_codegen.hpp>
-#include <dynd/codegen/binary_reduce_kernel_adapter_codegen.hpp>
-#include <dynd/kernels/kernel_instance.hpp>
 
 using namespace std;
 using namespace dynd;
 
-dynd::codegen_cache::codegen_cache()
+namespace {
+    /**
+     * A ckernel whose function is a generated strided loop,
+     * holding a reference to the executable memory it lives in.
+     */
+    struct codegen_strided_loop_kernel_extra {
+        typedef codegen_strided_loop_kernel_extra extra_type;
+
+        ckernel_prefix base;
+        memory_block_data *exec_memblock;
+
+        static void destruct(ckernel_prefix *extra)
+        {
+            extra_type *e = reinterpret_cast<extra_type *>(extra);
+            if (e->exec_memblock != NULL) {
+                memory_block_decref(e->exec_memblock);
+            }
+        }
+    };
+} // anonymous namespace
+
+dynd::codegen_cache::codegen_cache(size_t capacity)
     : m_exec_memblock(make_executable_memory_block()),
-        m_cached_unary_kernel_adapters(),
-        m_cached_binary_kernel_adapters()
+        m_strided_loops(), m_strided_loop_index(),
+        m_capacity(capacity > 0 ? capacity : 1), m_dead_count(0)
+{
+    memset(&m_stats, 0, sizeof(m_stats));
+}
+
+memory_block_ptr dynd::codegen_cache::get_exec_memblock() const
+{
+    platform_mutex::scoped_lock lock(m_mutex);
+    return m_exec_memblock;
+}
+
+codegen_cache_stats dynd::codegen_cache::get_stats() const
+{
+    platform_mutex::scoped_lock lock(m_mutex);
+    codegen_cache_stats result = m_stats;
+    result.size = m_strided_loops.size();
+    return result;
+}
+
+unary_strided_operation_t dynd::codegen_cache::lookup_strided_loop(const strided_loop_signature& sig,
+                memory_block_data **out_exec_memblock)
+{
+    if (!is_strided_loop_codegen_supported(sig)) {
+        return NULL;
+    }
+    uint64_t unique_id = get_strided_loop_unique_id(sig);
+    map<uint64_t, strided_loop_list::iterator>::iterator it = m_strided_loop_index.find(unique_id);
+    if (it != m_strided_loop_index.end()) {
+        // Move the loop to the front as the most recently used
+        ++m_stats.hits;
+        m_strided_loops.splice(m_strided_loops.begin(), m_strided_loops, it->second);
+    } else {
+        ++m_stats.misses;
+        if (m_strided_loops.size() >= m_capacity) {
+            // Evict the least recently used loop
+            cached_strided_loop& lru = m_strided_loops.back();
+            if (lru.exec_memblock.get() == m_exec_memblock.get()) {
+                ++m_dead_count;
+            }
+            m_strided_loop_index.erase(lru.unique_id);
+            m_strided_loops.pop_back();
+            ++m_stats.evictions;
+            if (m_dead_count >= m_capacity) {
+                // Stop generating into a block that's mostly unused code
+                m_exec_memblock = make_executable_memory_block();
+                m_dead_count = 0;
+            }
+        }
+        cached_strided_loop cl;
+        cl.unique_id = unique_id;
+        cl.loop = ::codegen_strided_loop(m_exec_memblock, sig);
+        cl.exec_memblock = m_exec_memblock;
+        m_strided_loops.push_front(cl);
+        m_strided_loop_index[unique_id] = m_strided_loops.begin();
+    }
+    const cached_strided_loop& cl = m_strided_loops.front();
+    if (out_exec_memblock != NULL) {
+        *out_exec_memblock = cl.exec_memblock.get();
+        memory_block_incref(*out_exec_memblock);
+    }
+    return cl.loop;
+}
+
+unary_strided_operation_t dynd::codegen_cache::codegen_strided_loop(const strided_loop_signature& sig)
+{
+    platform_mutex::scoped_lock lock(m_mutex);
+    return lookup_strided_loop(sig, NULL);
+}
+
+size_t dynd::codegen_cache::make_strided_loop_kernel(ckernel_builder *out, size_t offset_out,
+                const strided_loop_signature& sig, kernel_request_t kernreq)
 {
+    if (kernreq != kernel_request_strided) {
+        return 0;
+    }
+    out->ensure_capacity_leaf(offset_out + sizeof(codegen_strided_loop_kernel_extra));
+    codegen_strided_loop_kernel_extra *e = out->get_at<codegen_strided_loop_kernel_extra>(offset_out);
+    unary_strided_operation_t loop;
+    memory_block_data *exec_memblock = NULL;
+    try {
+        platform_mutex::scoped_lock lock(m_mutex);
+        loop = lookup_strided_loop(sig, &exec_memblock);
+    } catch(const runtime_error&) {
+        // The platform may refuse to give us executable memory,
+        // in which case the caller uses its ordinary kernels
+        return 0;
+    }
+    if (loop == NULL) {
+        return 0;
+    }
+
+    // The generated loop ignores its ckernel_prefix, so it's the kernel function directly
+    e->base.set_function<unary_strided_operation_t>(loop);
+    e->base.destructor = &codegen_strided_loop_kernel_extra::destruct;
+    e->exec_memblock = exec_memblock;
+    return offset_out + sizeof(codegen_strided_loop_kernel_extra);
 }
 
+void dynd::codegen_cache::debug_print(std::ostream& o, const std::string& indent) const
+{
+    platform_mutex::scoped_lock lock(m_mutex);
+    o << indent << "------ codegen_cache\n";
+    o << indent << " capacity: " << m_capacity << "\n";
+    o << indent << " hits: " << m_stats.hits << ", misses: " << m_stats.misses;
+    o << ", evictions: " << m_stats.evictions << "\n";
+    o << indent << " cached strided loops, most recently used first:\n";
+    for (strided_loop_list::const_iterator i = m_strided_loops.begin(),
+                i_end = m_strided_loops.end(); i != i_end; ++i) {
+        o << indent << "  unique id: " << get_strided_loop_unique_id_string(i->unique_id) << "\n";
+        o << indent << "  strided function ptr: " << (void *)i->loop << "\n";
+    }
+
+    o << indent << " executable memory block:\n";
+    memory_block_debug_print(m_exec_memblock.get(), o, indent + " ");
+    o << indent << "------" << endl;
+}
+
+codegen_cache& dynd::get_default_codegen_cache()
+{
+    static codegen_cache cgcache;
+    return cgcache;
+}
+
+#if 0 // Temporarily disabled
+
+#include <dynd/codegen/unary_kernel_adapter_codegen.hpp>
+#include <dynd/codegen/binary_kernel_adapter_codegen.hpp>
+#include <dynd/codegen/binary_reduce_kernel_adapter_codegen.hpp>
+#include <dynd/kernels/kernel_instance.hpp>
+
 void dynd::codegen_cache::codegen_unary_function_adapter(const ndt::type& restype,
                 const ndt::type& arg0type, calling_convention_t callconv,
                 void *function_pointer,
@@ -109,29 +253,4 @@ void dynd::codegen_cache::codegen_right_associative_binary_reduce_function_adapt
     ad.adaptee_memblock = function_pointer_owner;
 }
 
-void dynd::codegen_cache::debug_print(std::ostream& o, const std::string& indent) const
-{
-    o << indent << "------ codegen_cache\n";
-    o << indent << " cached unary_kernel_adapters:\n";
-    for (map<uint64_t, unary_operation_pair_t>::const_iterator i = m_cached_unary_kernel_adapters.begin(),
-                i_end = m_cached_unary_kernel_adapters.end(); i != i_end; ++i) {
-        o << indent << "  unique id: " << get_unary_function_adapter_unique_id_string(i->first) << "\n";
-        o << indent << "  single function ptr: " << i->second.single << "\n";
-        o << indent << "  strided function ptr: " << i->second.strided << "\n";
-    }
-
-    o << indent << " cached binary_kernel_adapters:\n";
-    for (map<uint64_t, binary_operation_pair_t>::const_iterator i = m_cached_binary_kernel_adapters.begin(),
-                i_end = m_cached_binary_kernel_adapters.end(); i != i_end; ++i) {
-        o << indent << "  unique id: " << get_binary_function_adapter_unique_id_string(i->first) << "\n";
-        o << indent << "  single function ptr: " << i->second.single << "\n";
-        o << indent << "  strided function ptr: " << i->second.strided << "\n";
-    }
-
-    o << indent << " executable memory block:\n";
-    memory_block_debug_print(m_exec_memblock.get(), o, indent + " ");
-    o << indent << "------" << endl;
-}
-
 #endif // temporarily disabled
-
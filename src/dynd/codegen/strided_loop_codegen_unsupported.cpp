@@ -0,0 +1,48 @@
+//
+// Copyright (C) 2011-14 Mark Wiebe, DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <dynd/platform_definitions.h>
+
+#if !defined(DYND_CALL_SYSV_X64)
+
+#include <sstream>
+
+#include <dynd/codegen/strided_loop_codegen.hpp>
+
+using namespace std;
+using namespace dynd;
+
+bool dynd::is_strided_loop_codegen_supported(const strided_loop_signature& DYND_UNUSED(sig))
+{
+    return false;
+}
+
+uint64_t dynd::get_strided_loop_unique_id(const strided_loop_signature& sig)
+{
+    uint64_t result = static_cast<uint64_t>(sig.dst_type_id);
+    result |= static_cast<uint64_t>(sig.src_type_id) << 8;
+    if (sig.dst_byteswap) {
+        result |= 1 << 16;
+    }
+    if (sig.src_byteswap) {
+        result |= 1 << 17;
+    }
+    return result;
+}
+
+std::string dynd::get_strided_loop_unique_id_string(uint64_t unique_id)
+{
+    stringstream ss;
+    ss << "strided loop " << unique_id << " (codegen unsupported)";
+    return ss.str();
+}
+
+unary_strided_operation_t dynd::codegen_strided_loop(const memory_block_ptr& DYND_UNUSED(exec_memblock),
+                const strided_loop_signature& DYND_UNUSED(sig))
+{
+    return NULL;
+}
+
+#endif // !defined(DYND_CALL_SYSV_X64)
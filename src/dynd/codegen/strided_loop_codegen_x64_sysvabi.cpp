@@ -0,0 +1,306 @@
+//
+// Copyright (C) 2011-14 Mark Wiebe, DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <dynd/platform_definitions.h>
+
+#if defined(DYND_CALL_SYSV_X64)
+
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+#include <cstring>
+
+#include <dynd/codegen/strided_loop_codegen.hpp>
+#include <dynd/memblock/executable_memory_block.hpp>
+
+using namespace std;
+using namespace dynd;
+
+namespace {
+    bool is_codegen_int(type_id_t tid) {
+        return (tid >= int8_type_id && tid <= int64_type_id) ||
+                        (tid >= uint8_type_id && tid <= uint64_type_id);
+    }
+
+    bool is_codegen_signed(type_id_t tid) {
+        return tid >= int8_type_id && tid <= int64_type_id;
+    }
+
+    bool is_codegen_float(type_id_t tid) {
+        return tid == float32_type_id || tid == float64_type_id;
+    }
+
+    /**
+     * Accumulates the bytes of a function, which get copied into
+     * executable memory when it's complete.
+     */
+    class x64_code_buffer {
+        std::vector<uint8_t> m_code;
+    public:
+        template<int N>
+        x64_code_buffer& append(const uint8_t (&code)[N]) {
+            m_code.insert(m_code.end(), code, code + N);
+            return *this;
+        }
+
+        size_t size() const {
+            return m_code.size();
+        }
+
+        /** Patches the rel32 ending at offset to jump to target */
+        void patch_rel32(size_t offset, size_t target) {
+            int32_t rel = static_cast<int32_t>(static_cast<intptr_t>(target) - static_cast<intptr_t>(offset));
+            memcpy(&m_code[offset - 4], &rel, 4);
+        }
+
+        const uint8_t *data() const {
+            return &m_code[0];
+        }
+    };
+
+    // Loop control. The strided kernel arguments arrive as
+    // rdi = dst, rsi = dst_stride, rdx = src, rcx = src_stride, r8 = count
+    const uint8_t loop_prolog[] = {
+        0x4d, 0x85, 0xc0,                           // test %r8, %r8
+        0x0f, 0x84, 0x00, 0x00, 0x00, 0x00          // jz done (patched)
+    };
+    const uint8_t loop_advance[] = {
+        0x48, 0x01, 0xf7,                           // add %rsi, %rdi
+        0x48, 0x01, 0xca,                           // add %rcx, %rdx
+        0x49, 0xff, 0xc8,                           // dec %r8
+        0x0f, 0x85, 0x00, 0x00, 0x00, 0x00          // jnz loop (patched)
+    };
+    const uint8_t loop_epilog[] = {
+        0xc3                                        // ret
+    };
+
+    // Loads of the src element into %rax, sign or zero extended
+    const uint8_t load_int8[] = {0x48, 0x0f, 0xbe, 0x02};       // movsbq (%rdx), %rax
+    const uint8_t load_uint8[] = {0x0f, 0xb6, 0x02};            // movzbl (%rdx), %eax
+    const uint8_t load_int16[] = {0x48, 0x0f, 0xbf, 0x02};      // movswq (%rdx), %rax
+    const uint8_t load_uint16[] = {0x0f, 0xb7, 0x02};           // movzwl (%rdx), %eax
+    const uint8_t load_int32[] = {0x48, 0x63, 0x02};            // movslq (%rdx), %rax
+    const uint8_t load_uint32[] = {0x8b, 0x02};                 // movl (%rdx), %eax
+    const uint8_t load_int64[] = {0x48, 0x8b, 0x02};            // movq (%rdx), %rax
+    // Loads of the src element into %xmm0
+    const uint8_t load_float32[] = {0xf3, 0x0f, 0x10, 0x02};    // movss (%rdx), %xmm0
+    const uint8_t load_float64[] = {0xf2, 0x0f, 0x10, 0x02};    // movsd (%rdx), %xmm0
+
+    // Byteswaps and extensions of %rax
+    const uint8_t swap_16[] = {0x66, 0xc1, 0xc0, 0x08};         // rolw $8, %ax
+    const uint8_t swap_32[] = {0x0f, 0xc8};                     // bswap %eax
+    const uint8_t swap_64[] = {0x48, 0x0f, 0xc8};               // bswap %rax
+    const uint8_t extend_int16[] = {0x48, 0x0f, 0xbf, 0xc0};    // movswq %ax, %rax
+    const uint8_t extend_int32[] = {0x48, 0x63, 0xc0};          // movslq %eax, %rax
+
+    // Moves between %rax and %xmm0
+    const uint8_t eax_to_xmm0[] = {0x66, 0x0f, 0x6e, 0xc0};     // movd %eax, %xmm0
+    const uint8_t rax_to_xmm0[] = {0x66, 0x48, 0x0f, 0x6e, 0xc0};   // movq %rax, %xmm0
+    const uint8_t xmm0_to_eax[] = {0x66, 0x0f, 0x7e, 0xc0};     // movd %xmm0, %eax
+    const uint8_t xmm0_to_rax[] = {0x66, 0x48, 0x0f, 0x7e, 0xc0};   // movq %xmm0, %rax
+
+    // Conversions
+    const uint8_t clear_xmm0[] = {0x66, 0x0f, 0xef, 0xc0};      // pxor %xmm0, %xmm0
+    const uint8_t int_to_float32[] = {0xf3, 0x48, 0x0f, 0x2a, 0xc0};    // cvtsi2ssq %rax, %xmm0
+    const uint8_t int_to_float64[] = {0xf2, 0x48, 0x0f, 0x2a, 0xc0};    // cvtsi2sdq %rax, %xmm0
+    const uint8_t float32_to_int[] = {0xf3, 0x48, 0x0f, 0x2c, 0xc0};    // cvttss2siq %xmm0, %rax
+    const uint8_t float64_to_int[] = {0xf2, 0x48, 0x0f, 0x2c, 0xc0};    // cvttsd2siq %xmm0, %rax
+    const uint8_t float32_to_float64[] = {0xf3, 0x0f, 0x5a, 0xc0};      // cvtss2sd %xmm0, %xmm0
+    const uint8_t float64_to_float32[] = {0xf2, 0x0f, 0x5a, 0xc0};      // cvtsd2ss %xmm0, %xmm0
+
+    // Stores of the dst element
+    const uint8_t store_8[] = {0x88, 0x07};                     // movb %al, (%rdi)
+    const uint8_t store_16[] = {0x66, 0x89, 0x07};              // movw %ax, (%rdi)
+    const uint8_t store_32[] = {0x89, 0x07};                    // movl %eax, (%rdi)
+    const uint8_t store_64[] = {0x48, 0x89, 0x07};              // movq %rax, (%rdi)
+    const uint8_t store_float32[] = {0xf3, 0x0f, 0x11, 0x07};   // movss %xmm0, (%rdi)
+    const uint8_t store_float64[] = {0xf2, 0x0f, 0x11, 0x07};   // movsd %xmm0, (%rdi)
+
+    /** Emits the load of the src element, into %rax for ints or %xmm0 for floats */
+    void emit_load(x64_code_buffer& code, type_id_t tid, bool byteswap)
+    {
+        size_t size = ndt::type(tid).get_data_size();
+        bool is_signed = is_codegen_signed(tid);
+        if (!byteswap || size == 1) {
+            switch (tid) {
+                case int8_type_id: code.append(load_int8); break;
+                case uint8_type_id: code.append(load_uint8); break;
+                case int16_type_id: code.append(load_int16); break;
+                case uint16_type_id: code.append(load_uint16); break;
+                case int32_type_id: code.append(load_int32); break;
+                case uint32_type_id: code.append(load_uint32); break;
+                case int64_type_id: case uint64_type_id: code.append(load_int64); break;
+                case float32_type_id: code.append(load_float32); break;
+                case float64_type_id: code.append(load_float64); break;
+                default: break;
+            }
+            return;
+        }
+
+        // Load the raw bits, swap them, then extend or move them to %xmm0
+        switch (size) {
+            case 2:
+                code.append(load_uint16).append(swap_16);
+                if (is_signed) {
+                    code.append(extend_int16);
+                }
+                break;
+            case 4:
+                code.append(load_uint32).append(swap_32);
+                if (is_signed) {
+                    code.append(extend_int32);
+                } else if (tid == float32_type_id) {
+                    code.append(eax_to_xmm0);
+                }
+                break;
+            case 8:
+                code.append(load_int64).append(swap_64);
+                if (tid == float64_type_id) {
+                    code.append(rax_to_xmm0);
+                }
+                break;
+        }
+    }
+
+    /** Emits the conversion of the loaded value to the dst type */
+    void emit_convert(x64_code_buffer& code, type_id_t dst_tid, type_id_t src_tid)
+    {
+        if (is_codegen_int(src_tid)) {
+            if (dst_tid == float32_type_id) {
+                code.append(clear_xmm0).append(int_to_float32);
+            } else if (dst_tid == float64_type_id) {
+                code.append(clear_xmm0).append(int_to_float64);
+            }
+            // Integer to integer truncates at the store
+        } else if (src_tid == float32_type_id) {
+            if (is_codegen_int(dst_tid)) {
+                code.append(float32_to_int);
+            } else if (dst_tid == float64_type_id) {
+                code.append(float32_to_float64);
+            }
+        } else if (src_tid == float64_type_id) {
+            if (is_codegen_int(dst_tid)) {
+                code.append(float64_to_int);
+            } else if (dst_tid == float32_type_id) {
+                code.append(float64_to_float32);
+            }
+        }
+    }
+
+    /** Emits the store of the converted value to the dst element */
+    void emit_store(x64_code_buffer& code, type_id_t tid, bool byteswap)
+    {
+        if (is_codegen_float(tid)) {
+            if (!byteswap) {
+                code.append(tid == float32_type_id ? store_float32 : store_float64);
+                return;
+            }
+            // Swap the bits as an integer
+            if (tid == float32_type_id) {
+                code.append(xmm0_to_eax);
+            } else {
+                code.append(xmm0_to_rax);
+            }
+        }
+
+        switch (ndt::type(tid).get_data_size()) {
+            case 1:
+                code.append(store_8);
+                break;
+            case 2:
+                if (byteswap) {
+                    code.append(swap_16);
+                }
+                code.append(store_16);
+                break;
+            case 4:
+                if (byteswap) {
+                    code.append(swap_32);
+                }
+                code.append(store_32);
+                break;
+            case 8:
+                if (byteswap) {
+                    code.append(swap_64);
+                }
+                code.append(store_64);
+                break;
+        }
+    }
+} // anonymous namespace
+
+bool dynd::is_strided_loop_codegen_supported(const strided_loop_signature& sig)
+{
+    type_id_t dst_tid = sig.dst_type_id, src_tid = sig.src_type_id;
+    if (!(is_codegen_int(dst_tid) || is_codegen_float(dst_tid)) ||
+                    !(is_codegen_int(src_tid) || is_codegen_float(src_tid))) {
+        return false;
+    }
+    // There are no single instructions for conversions between
+    // uint64 and floating point
+    if ((dst_tid == uint64_type_id && is_codegen_float(src_tid)) ||
+                    (src_tid == uint64_type_id && is_codegen_float(dst_tid))) {
+        return false;
+    }
+    return true;
+}
+
+uint64_t dynd::get_strided_loop_unique_id(const strided_loop_signature& sig)
+{
+    // Bits 0..7 for the dst type, 8..15 for the src type
+    uint64_t result = static_cast<uint64_t>(sig.dst_type_id);
+    result |= static_cast<uint64_t>(sig.src_type_id) << 8;
+    // Bits 16 and 17 for the byteswaps
+    if (sig.dst_byteswap) {
+        result |= 1 << 16;
+    }
+    if (sig.src_byteswap) {
+        result |= 1 << 17;
+    }
+    return result;
+}
+
+std::string dynd::get_strided_loop_unique_id_string(uint64_t unique_id)
+{
+    stringstream ss;
+    ss << ndt::type(static_cast<type_id_t>(unique_id & 0xff));
+    if (unique_id & (1 << 16)) {
+        ss << " (byteswapped)";
+    }
+    ss << " <- " << ndt::type(static_cast<type_id_t>((unique_id >> 8) & 0xff));
+    if (unique_id & (1 << 17)) {
+        ss << " (byteswapped)";
+    }
+    return ss.str();
+}
+
+unary_strided_operation_t dynd::codegen_strided_loop(const memory_block_ptr& exec_memblock,
+                const strided_loop_signature& sig)
+{
+    if (!is_strided_loop_codegen_supported(sig)) {
+        return NULL;
+    }
+
+    x64_code_buffer code;
+    code.append(loop_prolog);
+    size_t skip_jump_end = code.size();
+    size_t loop_start = code.size();
+    emit_load(code, sig.src_type_id, sig.src_byteswap);
+    emit_convert(code, sig.dst_type_id, sig.src_type_id);
+    emit_store(code, sig.dst_type_id, sig.dst_byteswap);
+    code.append(loop_advance);
+    code.patch_rel32(code.size(), loop_start);
+    size_t loop_end = code.size();
+    code.append(loop_epilog);
+    code.patch_rel32(skip_jump_end, loop_end);
+
+    char *begin, *end;
+    allocate_executable_memory(exec_memblock.get(), code.size(), 16, &begin, &end);
+    memcpy(begin, code.data(), code.size());
+    // No instruction cache flush is needed on x86-64
+    return reinterpret_cast<unary_strided_operation_t>(begin);
+}
+
+#endif // defined(DYND_CALL_SYSV_X64)
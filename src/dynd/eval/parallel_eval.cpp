@@ -0,0 +1,174 @@
+//
+// Copyright (C) 2011-14 Mark Wiebe, DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <exception>
+
+#include <dynd/eval/parallel_eval.hpp>
+#include <dynd/eval/thread_pool.hpp>
+#include <dynd/shortvector.hpp>
+#include <dynd/kernels/assignment_kernels.hpp>
+#include <dynd/memblock/array_memory_block.hpp>
+#include <dynd/types/strided_dim_type.hpp>
+#include <dynd/types/base_struct_type.hpp>
+
+using namespace std;
+using namespace dynd;
+
+namespace {
+    /**
+     * Whether a type's data can be written by several threads at once,
+     * with the memory blocks in its metadata merged afterwards by
+     * metadata_merge_buffers. This is an allowlist, so a new type
+     * with shared mutable state is evaluated serially until it is
+     * known to be safe.
+     */
+    bool has_mergeable_buffers(const ndt::type& tp)
+    {
+        if (tp.is_builtin()) {
+            return true;
+        }
+        switch (tp.get_type_id()) {
+            case strided_dim_type_id:
+            case fixed_dim_type_id:
+                return has_mergeable_buffers(
+                        static_cast<const base_uniform_dim_type *>(tp.extended())->get_element_type());
+            case var_dim_type_id: {
+                // Elements with destructors go in objectarray memory blocks
+                const ndt::type& et = static_cast<const base_uniform_dim_type *>(
+                                tp.extended())->get_element_type();
+                return !(et.get_flags()&type_flag_destructor) && has_mergeable_buffers(et);
+            }
+            case struct_type_id:
+            case cstruct_type_id: {
+                const base_struct_type *bsd = static_cast<const base_struct_type *>(tp.extended());
+                const ndt::type *field_types = bsd->get_field_types();
+                for (size_t i = 0, i_end = bsd->get_field_count(); i != i_end; ++i) {
+                    if (!has_mergeable_buffers(field_types[i])) {
+                        return false;
+                    }
+                }
+                return true;
+            }
+            case string_type_id:
+            case bytes_type_id:
+            case json_type_id:
+            case small_string_type_id:
+            case fixedstring_type_id:
+            case fixedbytes_type_id:
+            case char_type_id:
+            case date_type_id:
+            case datetime_type_id:
+            // The categories are fixed when the type is created
+            case categorical_type_id:
+                return true;
+            // The dictionary_string type's dictionary grows during assignment,
+            // so it falls through to here along with every other type
+            default:
+                return false;
+        }
+    }
+
+    /** One contiguous range of the outermost dimension, evaluated by one thread */
+    struct eval_chunk {
+        nd::array dst, src;
+        assignment_ckernel_builder kernel;
+        /** The exception the kernel threw, rethrown on the calling thread */
+        exception_ptr error;
+    };
+
+    void eval_chunk_task(intptr_t task_index, void *extra)
+    {
+        eval_chunk& c = reinterpret_cast<eval_chunk *>(extra)[task_index];
+        try {
+            c.kernel(c.dst.get_readwrite_originptr(), c.src.get_readonly_originptr());
+        } catch (...) {
+            c.error = current_exception();
+        }
+    }
+
+    /**
+     * Makes a view of rows [begin, end) of dst, whose metadata has memory
+     * blocks of its own instead of sharing those of dst.
+     */
+    nd::array make_chunk_dst(const nd::array& dst, const intptr_t *shape,
+                    const nd::array& src, intptr_t begin, intptr_t end)
+    {
+        const ndt::type& dst_tp = dst.get_type();
+        memory_block_ptr result = make_array_memory_block(dst_tp.extended()->get_metadata_size());
+        array_preamble *preamble = reinterpret_cast<array_preamble *>(result.get());
+        char *metadata = reinterpret_cast<char *>(preamble + 1);
+        preamble->m_type = ndt::type(dst_tp).release();
+        // Constructing the metadata the way eval constructed that of dst
+        // gives the same strides, and new memory blocks
+        preamble->m_type->metadata_default_construct(metadata, dst.get_ndim(), shape);
+        static_cast<const strided_dim_type *>(dst_tp.extended())->reorder_default_constructed_strides(
+                        metadata, src.get_type(), src.get_ndo_meta());
+        strided_dim_type_metadata *md = reinterpret_cast<strided_dim_type_metadata *>(metadata);
+        md->size = end - begin;
+        preamble->m_data_pointer = dst.get_ndo()->m_data_pointer + begin * md->stride;
+        preamble->m_data_reference = dst.get_data_memblock().release();
+        preamble->m_flags = nd::read_access_flag|nd::write_access_flag;
+        return nd::array(result);
+    }
+} // anonymous namespace
+
+bool eval::parallel_eval_assign(const nd::array& dst, const nd::array& src,
+                const eval_context *ectx)
+{
+#if defined(DYND_NONATOMIC_REFCOUNT)
+    // This build of libdynd is single-threaded only, because sharing
+    // types and memory blocks across threads needs atomic refcounts
+    return false;
+#endif
+    // Profiled kernels record into the profiler without locking
+    if (ectx == NULL || ectx->pool == NULL || ectx->profiler != NULL) {
+        return false;
+    }
+
+    const ndt::type& dst_tp = dst.get_type();
+    if (dst_tp.get_type_id() != strided_dim_type_id || src.get_ndim() != dst.get_ndim() ||
+                    dst_tp.get_dtype().get_kind() == memory_kind ||
+                    src.get_type().get_dtype().get_kind() == memory_kind) {
+        return false;
+    }
+    intptr_t dim_size = dst.get_dim_size();
+    intptr_t grain_size = ectx->parallel_grain_size > 0 ? ectx->parallel_grain_size : 1;
+    intptr_t chunk_count = min(ectx->pool->get_num_threads(), dim_size / grain_size);
+    if (chunk_count < 2 || src.get_dim_size() != dim_size || !has_mergeable_buffers(dst_tp)) {
+        return false;
+    }
+
+    dimvector shape(dst.get_ndim());
+    dst.get_shape(shape.get());
+    eval_context chunk_ectx = *ectx;
+    chunk_ectx.pool = NULL;
+
+    // Build the kernels on this thread, then only run them in parallel
+    shortvector<eval_chunk, 2> chunks(chunk_count);
+    for (intptr_t i = 0; i < chunk_count; ++i) {
+        eval_chunk& c = chunks[i];
+        intptr_t begin = dim_size * i / chunk_count, end = dim_size * (i + 1) / chunk_count;
+        c.src = src(irange(begin, end));
+        c.dst = make_chunk_dst(dst, shape.get(), src, begin, end);
+        make_assignment_kernel(&c.kernel, 0,
+                        c.dst.get_type(), c.dst.get_ndo_meta(),
+                        c.src.get_type(), c.src.get_ndo_meta(),
+                        kernel_request_single, ectx->default_assign_error_mode, &chunk_ectx);
+    }
+
+    ectx->pool->run(chunk_count, &eval_chunk_task, chunks.get());
+
+    for (intptr_t i = 0; i < chunk_count; ++i) {
+        if (chunks[i].error) {
+            rethrow_exception(chunks[i].error);
+        }
+    }
+    for (intptr_t i = 0; i < chunk_count; ++i) {
+        dst_tp.extended()->metadata_merge_buffers(
+                        const_cast<char *>(dst.get_ndo_meta()),
+                        const_cast<char *>(chunks[i].dst.get_ndo_meta()));
+    }
+    return true;
+}
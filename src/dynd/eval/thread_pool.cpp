@@ -0,0 +1,297 @@
+//
+// Copyright (C) 2011-14 Mark Wiebe, DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <stdexcept>
+#include <sstream>
+#include <vector>
+
+#include <dynd/eval/thread_pool.hpp>
+#include <dynd/platform_mutex.hpp>
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+using namespace dynd;
+
+namespace {
+    /**
+     * A mutex with a pair of condition variables, one the workers
+     * wait on for new tasks and one the caller of run() waits on
+     * for the tasks to finish.
+     */
+    class task_monitor {
+#if defined(_WIN32)
+        CRITICAL_SECTION m_cs;
+        CONDITION_VARIABLE m_work_cv, m_done_cv;
+#else
+        pthread_mutex_t m_mutex;
+        pthread_cond_t m_work_cv, m_done_cv;
+#endif
+
+        // Non-copyable
+        task_monitor(const task_monitor&);
+        task_monitor& operator=(const task_monitor&);
+    public:
+#if defined(_WIN32)
+        task_monitor() {
+            InitializeCriticalSection(&m_cs);
+            InitializeConditionVariable(&m_work_cv);
+            InitializeConditionVariable(&m_done_cv);
+        }
+
+        ~task_monitor() {
+            DeleteCriticalSection(&m_cs);
+        }
+
+        void lock() {
+            EnterCriticalSection(&m_cs);
+        }
+
+        void unlock() {
+            LeaveCriticalSection(&m_cs);
+        }
+
+        void wait_for_work() {
+            SleepConditionVariableCS(&m_work_cv, &m_cs, INFINITE);
+        }
+
+        void notify_work() {
+            WakeAllConditionVariable(&m_work_cv);
+        }
+
+        void wait_for_done() {
+            SleepConditionVariableCS(&m_done_cv, &m_cs, INFINITE);
+        }
+
+        void notify_done() {
+            WakeAllConditionVariable(&m_done_cv);
+        }
+#else
+        task_monitor() {
+            pthread_mutex_init(&m_mutex, NULL);
+            pthread_cond_init(&m_work_cv, NULL);
+            pthread_cond_init(&m_done_cv, NULL);
+        }
+
+        ~task_monitor() {
+            pthread_cond_destroy(&m_done_cv);
+            pthread_cond_destroy(&m_work_cv);
+            pthread_mutex_destroy(&m_mutex);
+        }
+
+        void lock() {
+            pthread_mutex_lock(&m_mutex);
+        }
+
+        void unlock() {
+            pthread_mutex_unlock(&m_mutex);
+        }
+
+        void wait_for_work() {
+            pthread_cond_wait(&m_work_cv, &m_mutex);
+        }
+
+        void notify_work() {
+            pthread_cond_broadcast(&m_work_cv);
+        }
+
+        void wait_for_done() {
+            pthread_cond_wait(&m_done_cv, &m_mutex);
+        }
+
+        void notify_done() {
+            pthread_cond_broadcast(&m_done_cv);
+        }
+#endif
+    };
+
+#if defined(_WIN32)
+    typedef HANDLE native_thread_t;
+#else
+    typedef pthread_t native_thread_t;
+#endif
+} // anonymous namespace
+
+namespace dynd { namespace eval { namespace detail {
+
+struct thread_pool_state {
+    intptr_t num_threads;
+    vector<native_thread_t> threads;
+    /** Makes concurrent calls to run() take turns */
+    platform_mutex run_mutex;
+    /** Guards all the fields below */
+    task_monitor monitor;
+    thread_pool_task_t task;
+    void *extra;
+    intptr_t task_count, next_task, unfinished_count;
+    bool shutdown;
+
+    thread_pool_state()
+        : num_threads(1), threads(), task(NULL), extra(NULL),
+            task_count(0), next_task(0), unfinished_count(0), shutdown(false)
+    {
+    }
+
+    /**
+     * Runs tasks until none are left to start. Must be called
+     * with the monitor locked, and returns with it locked.
+     */
+    void run_available_tasks()
+    {
+        while (next_task < task_count) {
+            intptr_t i = next_task++;
+            monitor.unlock();
+            task(i, extra);
+            monitor.lock();
+            if (--unfinished_count == 0) {
+                monitor.notify_done();
+            }
+        }
+    }
+
+    void worker_main()
+    {
+        monitor.lock();
+        for (;;) {
+            while (!shutdown && next_task >= task_count) {
+                monitor.wait_for_work();
+            }
+            if (shutdown) {
+                break;
+            }
+            run_available_tasks();
+        }
+        monitor.unlock();
+    }
+
+    /** Stops the worker threads and waits for them to exit */
+    void join_threads()
+    {
+        monitor.lock();
+        shutdown = true;
+        monitor.notify_work();
+        monitor.unlock();
+        for (size_t i = 0, i_end = threads.size(); i != i_end; ++i) {
+#if defined(_WIN32)
+            WaitForSingleObject(threads[i], INFINITE);
+            CloseHandle(threads[i]);
+#else
+            pthread_join(threads[i], NULL);
+#endif
+        }
+        threads.clear();
+    }
+};
+
+}}} // namespace dynd::eval::detail
+
+namespace {
+#if defined(_WIN32)
+    DWORD WINAPI thread_pool_worker(LPVOID arg)
+    {
+        reinterpret_cast<eval::detail::thread_pool_state *>(arg)->worker_main();
+        return 0;
+    }
+#else
+    void *thread_pool_worker(void *arg)
+    {
+        reinterpret_cast<eval::detail::thread_pool_state *>(arg)->worker_main();
+        return NULL;
+    }
+#endif
+} // anonymous namespace
+
+eval::thread_pool::thread_pool(intptr_t num_threads)
+    : m_state(new detail::thread_pool_state)
+{
+    if (num_threads < 0) {
+        delete m_state;
+        stringstream ss;
+        ss << "Cannot create a thread pool with " << num_threads << " threads";
+        throw invalid_argument(ss.str());
+    } else if (num_threads == 0) {
+        num_threads = get_hardware_concurrency();
+    }
+    m_state->num_threads = num_threads;
+
+    // The thread calling run() does its share of the tasks, so
+    // one fewer worker thread is needed
+    m_state->threads.reserve(num_threads - 1);
+    for (intptr_t i = 1; i < num_threads; ++i) {
+        native_thread_t thread;
+#if defined(_WIN32)
+        thread = CreateThread(NULL, 0, &thread_pool_worker, m_state, 0, NULL);
+        bool failed = (thread == NULL);
+#else
+        bool failed = (pthread_create(&thread, NULL, &thread_pool_worker, m_state) != 0);
+#endif
+        if (failed) {
+            m_state->join_threads();
+            delete m_state;
+            stringstream ss;
+            ss << "Failed to create thread " << i << " of a " << num_threads << " thread pool";
+            throw runtime_error(ss.str());
+        }
+        m_state->threads.push_back(thread);
+    }
+}
+
+eval::thread_pool::~thread_pool()
+{
+    m_state->join_threads();
+    delete m_state;
+}
+
+intptr_t eval::thread_pool::get_num_threads() const
+{
+    return m_state->num_threads;
+}
+
+void eval::thread_pool::run(intptr_t task_count, thread_pool_task_t task, void *extra)
+{
+    if (task_count <= 0) {
+        return;
+    }
+
+    platform_mutex::scoped_lock run_lock(m_state->run_mutex);
+    detail::thread_pool_state *st = m_state;
+    st->monitor.lock();
+    st->task = task;
+    st->extra = extra;
+    st->task_count = task_count;
+    st->next_task = 0;
+    st->unfinished_count = task_count;
+    st->monitor.notify_work();
+    // Work alongside the worker threads, then wait for their last tasks
+    st->run_available_tasks();
+    while (st->unfinished_count > 0) {
+        st->monitor.wait_for_done();
+    }
+    st->task = NULL;
+    st->extra = NULL;
+    st->task_count = 0;
+    st->next_task = 0;
+    st->monitor.unlock();
+}
+
+intptr_t eval::thread_pool::get_hardware_concurrency()
+{
+#if defined(_WIN32)
+    SYSTEM_INFO si;
+    GetSystemInfo(&si);
+    intptr_t result = si.dwNumberOfProcessors;
+#else
+    intptr_t result = sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+    return result > 0 ? result : 1;
+}
@@ -3,8 +3,6 @@
 // BSD 2-Clause License, see LICENSE.txt
 //
 
-#if 0 // TODO reenable
-
 #include <algorithm>
 
 #include <dynd/gfunc/elwise_gfunc.hpp>
@@ -15,14 +13,15 @@ using namespace dynd;
 const dynd::gfunc::elwise_kernel *
 dynd::gfunc::elwise::find_matching_kernel(const std::vector<ndt::type>& paramtypes) const
 {
-    for(size_t i = 0, i_end = m_kernels.size(); i != i_end; ++i) {
-        const std::vector<ndt::type>& kparamtypes = m_kernels[i].m_paramtypes;
-        if (kparamtypes == paramtypes) {
-            return &m_kernels[i];
-        }
-    }
+    intptr_t i = m_index.find_exact(paramtypes);
+    return (i >= 0) ? &m_kernels[i] : NULL;
+}
 
-    return NULL;
+const dynd::gfunc::elwise_kernel *
+dynd::gfunc::elwise::resolve_kernel(const std::vector<ndt::type>& paramtypes) const
+{
+    intptr_t i = m_index.resolve(paramtypes);
+    return (i >= 0) ? &m_kernels[i] : NULL;
 }
 
 void dynd::gfunc::elwise::add_kernel(elwise_kernel& egk)
@@ -31,6 +30,7 @@ void dynd::gfunc::elwise::add_kernel(elwise_kernel& egk)
     if (check == NULL) {
         m_kernels.push_back(elwise_kernel());
         m_kernels.back().swap(egk);
+        m_index.insert(m_kernels.back().m_paramtypes, m_kernels.size() - 1);
     } else {
         stringstream ss;
         ss << "Cannot add kernel to gfunc " << m_name << " because a kernel with the same arguments, (";
@@ -61,13 +61,6 @@ void dynd::gfunc::elwise::debug_print(std::ostream& o, const std::string& indent
             }
         }
         o << ")\n";
-        if (k.m_paramtypes.size() == 1) {
-            o << indent << "unary aux data: " << (const void *)(const dynd::AuxDataBase *)k.m_unary_kernel.auxdata << "\n";
-        } else if (k.m_paramtypes.size() == 2) {
-            o << indent << "binary aux data: " << (const void *)(const dynd::AuxDataBase *)k.m_binary_kernel.auxdata << "\n";
-        }
     }
     o << indent << "------" << endl;
 }
-
-#endif // TODO reenable
@@ -3,11 +3,8 @@
 // BSD 2-Clause License, see LICENSE.txt
 //
 
-#if 0 // TODO reenable
-
 #include <algorithm>
 
-#include <dynd/nodes/elwise_reduce_kernel_node.hpp>
 #include <dynd/gfunc/elwise_reduce_gfunc.hpp>
 
 using namespace std;
@@ -16,14 +13,15 @@ using namespace dynd;
 const dynd::gfunc::elwise_reduce_kernel *
 dynd::gfunc::elwise_reduce::find_matching_kernel(const std::vector<ndt::type>& paramtypes) const
 {
-    for(size_t i = 0, i_end = m_kernels.size(); i != i_end; ++i) {
-        const std::vector<ndt::type>& kparamtypes = m_kernels[i].m_paramtypes;
-        if (kparamtypes == paramtypes) {
-            return &m_kernels[i];
-        }
-    }
+    intptr_t i = m_index.find_exact(paramtypes);
+    return (i >= 0) ? &m_kernels[i] : NULL;
+}
 
-    return NULL;
+const dynd::gfunc::elwise_reduce_kernel *
+dynd::gfunc::elwise_reduce::resolve_kernel(const std::vector<ndt::type>& paramtypes) const
+{
+    intptr_t i = m_index.resolve(paramtypes);
+    return (i >= 0) ? &m_kernels[i] : NULL;
 }
 
 void dynd::gfunc::elwise_reduce::add_kernel(elwise_reduce_kernel& ergk)
@@ -32,6 +30,7 @@ void dynd::gfunc::elwise_reduce::add_kernel(elwise_reduce_kernel& ergk)
     if (check == NULL) {
         m_kernels.push_back(elwise_reduce_kernel());
         m_kernels.back().swap(ergk);
+        m_index.insert(m_kernels.back().m_paramtypes, m_kernels.size() - 1);
     } else {
         stringstream ss;
         ss << "Cannot add kernel to gfunc " << m_name << " because a kernel with the same arguments, (";
@@ -64,15 +63,7 @@ void dynd::gfunc::elwise_reduce::debug_print(std::ostream& o, const std::string&
         o << ")\n";
         o << indent << " associative: " << (k.m_associative ? "true" : "false") << "\n";
         o << indent << " commutative: " << (k.m_commutative ? "true" : "false") << "\n";
-        if (k.m_left_associative_reduction_kernel.kernel != NULL) {
-            o << indent << " left associative kernel aux data: ";
-            o << (const void *)(const dynd::AuxDataBase *)k.m_left_associative_reduction_kernel.auxdata << "\n";
-        }
-        if (k.m_right_associative_reduction_kernel.kernel != NULL) {
-            o << indent << " right associative kernel aux data: ";
-            o << (const void *)(const dynd::AuxDataBase *)k.m_right_associative_reduction_kernel.auxdata << "\n";
-        }
-        if (!k.m_identity.empty()) {
+        if (!k.m_identity.is_empty()) {
             o << indent << " reduction identity:\n";
             k.m_identity.debug_print(o, indent + "  ");
         } else {
@@ -81,5 +72,3 @@ void dynd::gfunc::elwise_reduce::debug_print(std::ostream& o, const std::string&
     }
     o << indent << "------" << endl;
 }
-
-#endif // TODO reenable
@@ -0,0 +1,98 @@
+//
+// Copyright (C) 2011-14 Mark Wiebe, DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <dynd/gfunc/signature_index.hpp>
+#include <dynd/type_promotion.hpp>
+#include <dynd/exceptions.hpp>
+
+using namespace std;
+using namespace dynd;
+
+size_t dynd::gfunc::hash_signature(const std::vector<ndt::type>& paramtypes)
+{
+    size_t result = paramtypes.size();
+    for (size_t i = 0, i_end = paramtypes.size(); i != i_end; ++i) {
+        result = hash_combine(result, paramtypes[i].get_hash());
+    }
+    return result;
+}
+
+const dynd::gfunc::signature_index::entry *
+dynd::gfunc::signature_index::find_in(const map_type& m, size_t hash,
+                const std::vector<ndt::type>& paramtypes)
+{
+    pair<map_type::const_iterator, map_type::const_iterator> r = m.equal_range(hash);
+    for (; r.first != r.second; ++r.first) {
+        if (r.first->second.paramtypes == paramtypes) {
+            return &r.first->second;
+        }
+    }
+    return NULL;
+}
+
+void dynd::gfunc::signature_index::insert_in(map_type& m, size_t hash,
+                const std::vector<ndt::type>& paramtypes, intptr_t index)
+{
+    map_type::iterator it = m.insert(make_pair(hash, entry()));
+    it->second.paramtypes = paramtypes;
+    it->second.index = index;
+}
+
+intptr_t dynd::gfunc::signature_index::find_exact(const std::vector<ndt::type>& paramtypes) const
+{
+    const entry *e = find_in(m_exact, hash_signature(paramtypes), paramtypes);
+    return (e != NULL) ? e->index : -1;
+}
+
+intptr_t dynd::gfunc::signature_index::resolve(const std::vector<ndt::type>& paramtypes) const
+{
+    size_t hash = hash_signature(paramtypes);
+    const entry *e = find_in(m_exact, hash, paramtypes);
+    if (e != NULL) {
+        return e->index;
+    }
+
+    {
+        platform_mutex::scoped_lock lock(m_mutex);
+        e = find_in(m_resolved, hash, paramtypes);
+        if (e != NULL) {
+            return e->index;
+        }
+    }
+
+    intptr_t index = -1;
+    if (!paramtypes.empty()) {
+        try {
+            ndt::type common_tp = promote_types_arithmetic(paramtypes[0], paramtypes[0]);
+            for (size_t i = 1, i_end = paramtypes.size(); i != i_end; ++i) {
+                common_tp = promote_types_arithmetic(common_tp, paramtypes[i]);
+            }
+            vector<ndt::type> promoted(paramtypes.size(), common_tp);
+            index = find_exact(promoted);
+        } catch (const dynd::type_error&) {
+            // No promotion between these types, so no match
+        }
+    }
+
+    platform_mutex::scoped_lock lock(m_mutex);
+    // Another thread may have resolved it in the meantime
+    if (find_in(m_resolved, hash, paramtypes) == NULL) {
+        insert_in(m_resolved, hash, paramtypes, index);
+    }
+    return index;
+}
+
+void dynd::gfunc::signature_index::insert(const std::vector<ndt::type>& paramtypes, intptr_t index)
+{
+    insert_in(m_exact, hash_signature(paramtypes), paramtypes, index);
+    platform_mutex::scoped_lock lock(m_mutex);
+    m_resolved.clear();
+}
+
+size_t dynd::gfunc::signature_index::get_resolved_cache_size() const
+{
+    platform_mutex::scoped_lock lock(m_mutex);
+    return m_resolved.size();
+}
@@ -11,6 +11,7 @@
 #include <dynd/types/strided_dim_type.hpp>
 #include <dynd/types/fixed_dim_type.hpp>
 #include <dynd/types/var_dim_type.hpp>
+#include <dynd/types/offset_dim_type.hpp>
 
 using namespace std;
 using namespace dynd;
@@ -261,6 +262,21 @@ static void format_json_uniform_dim(output_data& out, const ndt::type& dt, const
             }
             break;
         }
+        case offset_dim_type_id: {
+            const offset_dim_type *odt = static_cast<const offset_dim_type *>(dt.extended());
+            const offset_dim_type_metadata *md = reinterpret_cast<const offset_dim_type_metadata *>(metadata);
+            ndt::type element_tp = odt->get_element_type();
+            intptr_t size = offset_dim_element_size(data), stride = md->stride;
+            const char *begin = offset_dim_element_begin(md, data);
+            metadata += sizeof(offset_dim_type_metadata);
+            for (intptr_t i = 0; i < size; ++i) {
+                ::format_json(out, element_tp, metadata, begin + i * stride);
+                if (i != size - 1) {
+                    out.write(',');
+                }
+            }
+            break;
+        }
         default: {
             stringstream ss;
             ss << "Formatting dynd type " << dt << " as JSON is not implemented yet";
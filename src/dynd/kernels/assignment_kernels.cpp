@@ -3,14 +3,71 @@
 // BSD 2-Clause License, see LICENSE.txt
 //
 
+#include <algorithm>
+
 #include <dynd/type.hpp>
 #include <dynd/kernels/assignment_kernels.hpp>
+#include <dynd/kernels/ckernel_profiler.hpp>
+#include <dynd/kernels/ckernel_debug_info.hpp>
+#include <dynd/shape_tools.hpp>
+#include <dynd/exceptions.hpp>
+#include <dynd/diagnostics.hpp>
 #include "single_assigner_builtin.hpp"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+# include <emmintrin.h>
+# define DYND_NONTEMPORAL_COPY
+#endif
+
 using namespace std;
 using namespace dynd;
 
 namespace {
+#ifdef DYND_NONTEMPORAL_COPY
+    /**
+     * Copies at or above this size are assumed to be bigger than the
+     * last level cache, and are written with non-temporal stores.
+     */
+    const size_t nontemporal_copy_threshold = 8 * 1024 * 1024;
+#endif
+
+    /**
+     * Copies a contiguous block of memory, used when a strided copy
+     * has both strides equal to the element size.
+     */
+    inline void contiguous_copy(char *dst, const char *src, size_t size)
+    {
+#ifdef DYND_NONTEMPORAL_COPY
+        // Stream large copies around the cache, so they don't evict the
+        // working set. This requires that the ranges don't overlap.
+        if (size >= nontemporal_copy_threshold &&
+                        (dst + size <= src || src + size <= dst)) {
+            // Copy up to a 16 byte aligned dst
+            size_t head = (16 - (reinterpret_cast<uintptr_t>(dst) & 15)) & 15;
+            memcpy(dst, src, head);
+            dst += head;
+            src += head;
+            size -= head;
+            for (size_t i = 0, i_end = size / 64; i != i_end; ++i, dst += 64, src += 64) {
+                __m128i v0 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src));
+                __m128i v1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 16));
+                __m128i v2 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 32));
+                __m128i v3 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 48));
+                _mm_stream_si128(reinterpret_cast<__m128i *>(dst), v0);
+                _mm_stream_si128(reinterpret_cast<__m128i *>(dst + 16), v1);
+                _mm_stream_si128(reinterpret_cast<__m128i *>(dst + 32), v2);
+                _mm_stream_si128(reinterpret_cast<__m128i *>(dst + 48), v3);
+            }
+            // Make the streamed stores visible before returning
+            _mm_sfence();
+            memcpy(dst, src, size & 63);
+            return;
+        }
+#endif
+        // The ranges may be identical for an assignment to itself
+        memmove(dst, src, size);
+    }
+
     template<class T>
     struct aligned_fixed_size_copy_assign_type {
         static void single(char *dst, const char *src,
@@ -23,6 +80,10 @@ namespace {
                         const char *src, intptr_t src_stride,
                         size_t count, ckernel_prefix *DYND_UNUSED(extra))
         {
+            if (dst_stride == (intptr_t)sizeof(T) && src_stride == (intptr_t)sizeof(T)) {
+                contiguous_copy(dst, src, count * sizeof(T));
+                return;
+            }
             for (size_t i = 0; i != count; ++i,
                             dst += dst_stride, src += src_stride) {
                 *(T *)dst = *(T *)src;
@@ -44,6 +105,10 @@ namespace {
                         const char *src, intptr_t src_stride,
                         size_t count, ckernel_prefix *DYND_UNUSED(extra))
         {
+            if (dst_stride == 1 && src_stride == 1) {
+                contiguous_copy(dst, src, count);
+                return;
+            }
             for (size_t i = 0; i != count; ++i,
                             dst += dst_stride, src += src_stride) {
                 *dst = *src;
@@ -69,6 +134,10 @@ namespace {
                         const char *src, intptr_t src_stride,
                         size_t count, ckernel_prefix *DYND_UNUSED(extra))
         {
+            if (dst_stride == N && src_stride == N) {
+                contiguous_copy(dst, src, count * N);
+                return;
+            }
             for (size_t i = 0; i != count; ++i,
                             dst += dst_stride, src += src_stride) {
                 memcpy(dst, src, N);
@@ -91,6 +160,10 @@ static void unaligned_copy_strided(char *dst, intptr_t dst_stride,
                         size_t count, ckernel_prefix *extra)
 {
     size_t data_size = reinterpret_cast<unaligned_copy_single_kernel_extra *>(extra)->data_size;
+    if (dst_stride == (intptr_t)data_size && src_stride == (intptr_t)data_size) {
+        contiguous_copy(dst, src, count * data_size);
+        return;
+    }
     for (size_t i = 0; i != count; ++i,
                     dst += dst_stride, src += src_stride) {
         memcpy(dst, src, data_size);
@@ -108,6 +181,14 @@ size_t dynd::make_assignment_kernel(
         errmode = ectx->default_assign_error_mode;
     }
 
+    ckernel_profiler_scope profiled;
+    if (ectx != NULL && ectx->profiler != NULL) {
+        stringstream ss;
+        ss << "assign " << dst_tp << " <- " << src_tp;
+        offset_out = profiled.push(ectx->profiler, out, offset_out,
+                        unary_operation_funcproto, kernreq, ss.str());
+    }
+
     if (dst_tp.is_builtin()) {
         if (src_tp.is_builtin()) {
             // If the casting can be done losslessly, disable the error check to find faster code paths
@@ -309,7 +390,14 @@ static unary_single_operation_t assign_table_single_kernel[builtin_type_id_count
 };
 
 namespace {
-    template<typename dst_type, typename src_type, assign_error_mode errmode>
+    /**
+     * The number of elements a checked strided assignment range
+     * checks at once, before converting them without checks.
+     */
+    const size_t assign_check_block_size = 128;
+
+    template<typename dst_type, typename src_type, assign_error_mode errmode,
+                    bool blocked = block_range_checker_builtin<dst_type, src_type, errmode>::enabled>
     struct multiple_assignment_builtin {
         static void strided_assign(
                         char *dst, intptr_t dst_stride,
@@ -325,7 +413,7 @@ namespace {
         }
     };
     template<typename dst_type, typename src_type>
-    struct multiple_assignment_builtin<dst_type, src_type, assign_error_none> {
+    struct multiple_assignment_builtin<dst_type, src_type, assign_error_none, false> {
          DYND_CUDA_HOST_DEVICE static void strided_assign(
                         char *dst, intptr_t dst_stride,
                         const char *src, intptr_t src_stride,
@@ -339,6 +427,60 @@ namespace {
             }
         }
     };
+
+    /**
+     * Checked assignment which range checks a block of values with a
+     * branch-free reduction, and converts blocks which pass without any
+     * checks, in loops the compiler can vectorize. A block which fails
+     * is redone value by value, so the error is raised for the first
+     * bad value with everything before it assigned.
+     */
+    template<typename dst_type, typename src_type, assign_error_mode errmode>
+    struct multiple_assignment_builtin<dst_type, src_type, errmode, true> {
+        typedef block_range_checker_builtin<dst_type, src_type, errmode> checker;
+
+        static bool block_out_of_range(const char *src, intptr_t src_stride, size_t count)
+        {
+            bool result = false;
+            if (src_stride == sizeof(src_type)) {
+                const src_type *src_vals = reinterpret_cast<const src_type *>(src);
+                for (size_t i = 0; i != count; ++i) {
+                    result |= checker::out_of_range(src_vals[i]);
+                }
+            } else {
+                for (size_t i = 0; i != count; ++i, src += src_stride) {
+                    result |= checker::out_of_range(*reinterpret_cast<const src_type *>(src));
+                }
+            }
+            return result;
+        }
+
+        static void strided_assign(
+                        char *dst, intptr_t dst_stride,
+                        const char *src, intptr_t src_stride,
+                        size_t count, ckernel_prefix *extra)
+        {
+            while (count > 0) {
+                size_t block_count = std::min(count, assign_check_block_size);
+                if (block_out_of_range(src, src_stride, block_count)) {
+                    multiple_assignment_builtin<dst_type, src_type, errmode, false>::strided_assign(
+                                    dst, dst_stride, src, src_stride, block_count, extra);
+                } else if (dst_stride == sizeof(dst_type) && src_stride == sizeof(src_type)) {
+                    dst_type *dst_vals = reinterpret_cast<dst_type *>(dst);
+                    const src_type *src_vals = reinterpret_cast<const src_type *>(src);
+                    for (size_t i = 0; i != block_count; ++i) {
+                        dst_vals[i] = static_cast<dst_type>(src_vals[i]);
+                    }
+                } else {
+                    multiple_assignment_builtin<dst_type, src_type, assign_error_none>::strided_assign(
+                                    dst, dst_stride, src, src_stride, block_count, extra);
+                }
+                dst += static_cast<intptr_t>(block_count) * dst_stride;
+                src += static_cast<intptr_t>(block_count) * src_stride;
+                count -= block_count;
+            }
+        }
+    };
 } // anonymous namespace
 
 static unary_strided_operation_t assign_table_strided_kernel[builtin_type_id_count-2][builtin_type_id_count-2][4] =
@@ -461,6 +603,7 @@ size_t dynd::make_kernreq_to_single_kernel_adapter(
             return ckb_offset;
         }
         case kernel_request_strided: {
+            DYND_TRACE_KERNREQ_ADAPTER(out_ckb, ckb_offset);
             out_ckb->ensure_capacity(ckb_offset + sizeof(ckernel_prefix));
             ckernel_prefix *e = out_ckb->get_at<ckernel_prefix>(ckb_offset);
             e->set_function<unary_strided_operation_t>(&wrap_single_as_strided_kernel);
@@ -507,3 +650,173 @@ void dynd::strided_assign_kernel_extra::destruct(
         echild->destructor(echild);
     }
 }
+
+size_t dynd::make_strided_dims_assignment_kernel(
+                ckernel_builder *out, size_t offset_out,
+                const ndt::type& dst_tp, const char *dst_metadata,
+                const ndt::type& src_tp, const char *src_metadata,
+                kernel_request_t kernreq, assign_error_mode errmode,
+                const eval::eval_context *ectx)
+{
+    if (kernreq != kernel_request_single && kernreq != kernel_request_strided) {
+        stringstream ss;
+        ss << "make_strided_dims_assignment_kernel: unrecognized request " << (int)kernreq;
+        throw runtime_error(ss.str());
+    }
+
+    // Gather all the leading strided dimensions
+    intptr_t max_ndim = dst_tp.get_ndim(), ndim = 0;
+    dimvector shape(max_ndim), dst_strides(max_ndim), src_strides(max_ndim);
+    ndt::type dst_el_tp = dst_tp, src_el_tp = src_tp;
+    const char *dst_el_metadata = dst_metadata, *src_el_metadata = src_metadata;
+    while (ndim < max_ndim) {
+        intptr_t dst_size, dst_stride, src_size, src_stride;
+        ndt::type dst_child_tp, src_child_tp;
+        const char *dst_child_metadata, *src_child_metadata;
+        if (!get_strided_dim_params(dst_el_tp, dst_el_metadata, dst_size, dst_stride,
+                        dst_child_tp, dst_child_metadata)) {
+            break;
+        }
+        if (src_el_tp.get_ndim() < dst_el_tp.get_ndim()) {
+            // If the src has fewer dimensions, broadcast it across this one
+            src_stride = 0;
+            src_child_tp = src_el_tp;
+            src_child_metadata = src_el_metadata;
+        } else if (get_strided_dim_params(src_el_tp, src_el_metadata, src_size, src_stride,
+                        src_child_tp, src_child_metadata)) {
+            if (src_size != dst_size) {
+                // Check for a broadcasting error
+                if (src_size != 1) {
+                    throw broadcast_error(dst_tp, dst_metadata, src_tp, src_metadata);
+                }
+                src_stride = 0;
+            }
+        } else {
+            break;
+        }
+        shape[ndim] = dst_size;
+        dst_strides[ndim] = dst_stride;
+        src_strides[ndim] = src_stride;
+        ++ndim;
+        dst_el_tp.swap(dst_child_tp);
+        src_el_tp.swap(src_child_tp);
+        dst_el_metadata = dst_child_metadata;
+        src_el_metadata = src_child_metadata;
+    }
+    if (ndim == 0) {
+        stringstream ss;
+        ss << "make_strided_dims_assignment_kernel: cannot assign from " << src_tp << " to " << dst_tp;
+        throw runtime_error(ss.str());
+    }
+
+    intptr_t *strides[2] = {dst_strides.get(), src_strides.get()};
+    optimize_strided_dims(ndim, shape.get(), 2, strides);
+
+    // Create one kernel level per remaining dimension
+    for (intptr_t i = 0; i < ndim; ++i) {
+        out->ensure_capacity(offset_out + sizeof(strided_assign_kernel_extra));
+        strided_assign_kernel_extra *e = out->get_at<strided_assign_kernel_extra>(offset_out);
+        if (i == 0 && kernreq == kernel_request_single) {
+            e->base.set_function<unary_single_operation_t>(&strided_assign_kernel_extra::single);
+        } else {
+            e->base.set_function<unary_strided_operation_t>(&strided_assign_kernel_extra::strided);
+        }
+        e->base.destructor = strided_assign_kernel_extra::destruct;
+        e->size = shape[i];
+        e->dst_stride = dst_strides[i];
+        e->src_stride = src_strides[i];
+        offset_out += sizeof(strided_assign_kernel_extra);
+    }
+    return ::make_assignment_kernel(out, offset_out,
+                    dst_el_tp, dst_el_metadata,
+                    src_el_tp, src_el_metadata,
+                    ndim == 0 ? kernreq : kernel_request_strided, errmode, ectx);
+}
+
+namespace {
+    void describe_unaligned_copy(const ckernel_prefix *self, std::ostream& o)
+    {
+        o << "data_size=" << reinterpret_cast<const unaligned_copy_single_kernel_extra *>(self)->data_size;
+    }
+
+    void describe_strided_assign(const ckernel_prefix *self, std::ostream& o)
+    {
+        const strided_assign_kernel_extra *e = reinterpret_cast<const strided_assign_kernel_extra *>(self);
+        o << "size=" << e->size << " dst_stride=" << e->dst_stride << " src_stride=" << e->src_stride;
+    }
+
+    /**
+     * Registers the debug info of the ckernels in this file. There are
+     * nearly two thousand of them, so this is a loader which only runs
+     * when debug info is first looked up.
+     */
+    struct assignment_kernels_debug_info {
+        template<int N>
+        static void register_aligned_copy() {
+            stringstream ss;
+            ss << "aligned copy " << N << " bytes";
+            register_ckernel_debug_info((void *)&aligned_fixed_size_copy_assign<N>::single,
+                            ss.str(), sizeof(ckernel_prefix), false, NULL);
+            register_ckernel_debug_info((void *)&aligned_fixed_size_copy_assign<N>::strided,
+                            ss.str(), sizeof(ckernel_prefix), true, NULL);
+        }
+
+        template<int N>
+        static void register_unaligned_copy() {
+            stringstream ss;
+            ss << "unaligned copy " << N << " bytes";
+            register_ckernel_debug_info((void *)&unaligned_fixed_size_copy_assign<N>::single,
+                            ss.str(), sizeof(ckernel_prefix), false, NULL);
+            register_ckernel_debug_info((void *)&unaligned_fixed_size_copy_assign<N>::strided,
+                            ss.str(), sizeof(ckernel_prefix), true, NULL);
+        }
+
+        static void load() {
+            register_aligned_copy<1>();
+            register_aligned_copy<2>();
+            register_aligned_copy<4>();
+            register_aligned_copy<8>();
+            register_unaligned_copy<2>();
+            register_unaligned_copy<4>();
+            register_unaligned_copy<8>();
+            register_ckernel_debug_info((void *)&unaligned_copy_single, "unaligned copy",
+                            sizeof(unaligned_copy_single_kernel_extra), false, NULL,
+                            &describe_unaligned_copy);
+            register_ckernel_debug_info((void *)&unaligned_copy_strided, "unaligned copy",
+                            sizeof(unaligned_copy_single_kernel_extra), true, NULL,
+                            &describe_unaligned_copy);
+
+            for (int dst_tid = bool_type_id; dst_tid <= complex_float64_type_id; ++dst_tid) {
+                for (int src_tid = bool_type_id; src_tid <= complex_float64_type_id; ++src_tid) {
+                    for (int errmode = 0; errmode < 4; ++errmode) {
+                        stringstream ss;
+                        ss << "builtin assign " << (type_id_t)dst_tid << " <- " << (type_id_t)src_tid;
+                        ss << ", errmode=" << (assign_error_mode)errmode;
+                        register_ckernel_debug_info((void *)assign_table_single_kernel
+                                        [dst_tid-bool_type_id][src_tid-bool_type_id][errmode],
+                                        ss.str(), sizeof(ckernel_prefix), false, NULL);
+                        register_ckernel_debug_info((void *)assign_table_strided_kernel
+                                        [dst_tid-bool_type_id][src_tid-bool_type_id][errmode],
+                                        ss.str(), sizeof(ckernel_prefix), true, NULL);
+                    }
+                }
+            }
+
+            register_ckernel_debug_info((void *)&wrap_single_as_strided_kernel,
+                            "single as strided adapter", sizeof(ckernel_prefix), true,
+                            &ckernel_child_follows);
+            register_ckernel_debug_info((void *)&strided_assign_kernel_extra::single,
+                            "strided dim assign", sizeof(strided_assign_kernel_extra), false,
+                            &ckernel_child_follows, &describe_strided_assign);
+            register_ckernel_debug_info((void *)&strided_assign_kernel_extra::strided,
+                            "strided dim assign", sizeof(strided_assign_kernel_extra), true,
+                            &ckernel_child_follows, &describe_strided_assign);
+        }
+
+        assignment_kernels_debug_info() {
+            register_ckernel_debug_info_loader(&load);
+        }
+    };
+
+    assignment_kernels_debug_info assignment_kernels_debug_info_instance;
+} // anonymous namespace
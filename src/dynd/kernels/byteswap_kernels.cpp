@@ -4,14 +4,102 @@
 //
 
 #include <stdexcept>
+#include <algorithm>
 
 #include <dynd/diagnostics.hpp>
 #include <dynd/kernels/byteswap_kernels.hpp>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+# include <emmintrin.h>
+# define DYND_BYTESWAP_SSE2
+# if defined(__SSSE3__)
+#  include <tmmintrin.h>
+# endif
+#endif
+
 using namespace std;
 using namespace dynd;
 
 namespace {
+#ifdef DYND_BYTESWAP_SSE2
+    /**
+     * Byteswaps each N-byte value in a vector of 16 bytes, with a
+     * single byte shuffle when SSSE3 is available, or with 16-bit
+     * word shuffles and shifts otherwise.
+     */
+    template<int N>
+    __m128i byteswap_vector(__m128i v);
+
+    inline __m128i byteswap_words(__m128i v) {
+        return _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+    }
+
+    template<>
+    inline __m128i byteswap_vector<2>(__m128i v) {
+# if defined(__SSSE3__)
+        return _mm_shuffle_epi8(v, _mm_set_epi8(14, 15, 12, 13, 10, 11, 8, 9, 6, 7, 4, 5, 2, 3, 0, 1));
+# else
+        return byteswap_words(v);
+# endif
+    }
+
+    template<>
+    inline __m128i byteswap_vector<4>(__m128i v) {
+# if defined(__SSSE3__)
+        return _mm_shuffle_epi8(v, _mm_set_epi8(12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3));
+# else
+        v = _mm_shufflelo_epi16(v, _MM_SHUFFLE(2, 3, 0, 1));
+        v = _mm_shufflehi_epi16(v, _MM_SHUFFLE(2, 3, 0, 1));
+        return byteswap_words(v);
+# endif
+    }
+
+    template<>
+    inline __m128i byteswap_vector<8>(__m128i v) {
+# if defined(__SSSE3__)
+        return _mm_shuffle_epi8(v, _mm_set_epi8(8, 9, 10, 11, 12, 13, 14, 15, 0, 1, 2, 3, 4, 5, 6, 7));
+# else
+        v = _mm_shufflelo_epi16(v, _MM_SHUFFLE(0, 1, 2, 3));
+        v = _mm_shufflehi_epi16(v, _MM_SHUFFLE(0, 1, 2, 3));
+        return byteswap_words(v);
+# endif
+    }
+
+    template<>
+    inline __m128i byteswap_vector<16>(__m128i v) {
+# if defined(__SSSE3__)
+        return _mm_shuffle_epi8(v, _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15));
+# else
+        v = _mm_shuffle_epi32(v, _MM_SHUFFLE(0, 1, 2, 3));
+        v = _mm_shufflelo_epi16(v, _MM_SHUFFLE(2, 3, 0, 1));
+        v = _mm_shufflehi_epi16(v, _MM_SHUFFLE(2, 3, 0, 1));
+        return byteswap_words(v);
+# endif
+    }
+#endif // DYND_BYTESWAP_SSE2
+
+    /**
+     * Byteswaps the N-byte values in a contiguous block of memory,
+     * a vector at a time. Returns the number of values swapped,
+     * leaving the remainder for the caller.
+     */
+    template<int N>
+    inline size_t contiguous_byteswap(char *dst, const char *src, size_t count)
+    {
+#ifdef DYND_BYTESWAP_SSE2
+        size_t size = (count * N) & ~size_t(15);
+        for (size_t i = 0; i != size; i += 16) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), byteswap_vector<N>(v));
+        }
+        return size / N;
+#else
+        (void)dst;
+        (void)src;
+        (void)count;
+        return 0;
+#endif
+    }
 
     template<typename T>
     struct aligned_fixed_size_byteswap {
@@ -28,6 +116,12 @@ namespace {
         {
             DYND_ASSERT_ALIGNED(dst, dst_stride, sizeof(T), "type: " << ndt::type(dynd::type_id_of<T>::value));
             DYND_ASSERT_ALIGNED(src, src_stride, sizeof(T), "type: " << ndt::type(dynd::type_id_of<T>::value));
+            if (dst_stride == sizeof(T) && src_stride == sizeof(T)) {
+                size_t done = contiguous_byteswap<sizeof(T)>(dst, src, count);
+                dst += done * sizeof(T);
+                src += done * sizeof(T);
+                count -= done;
+            }
             for (size_t i = 0; i != count; ++i,
                             dst += dst_stride, src += src_stride) {
                 *(T *)dst = byteswap_value(*(T *)src);
@@ -35,6 +129,32 @@ namespace {
         }
     };
 
+    /** Byteswaps 16-byte values, which are at least 8-byte aligned */
+    struct aligned_16_byteswap {
+        static void single(char *dst, const char *src,
+                        ckernel_prefix *DYND_UNUSED(extra))
+        {
+            uint64_t lo = *(const uint64_t *)src, hi = *((const uint64_t *)src + 1);
+            *(uint64_t *)dst = byteswap_value(hi);
+            *((uint64_t *)dst + 1) = byteswap_value(lo);
+        }
+        static void strided(char *dst, intptr_t dst_stride,
+                        const char *src, intptr_t src_stride,
+                        size_t count, ckernel_prefix *extra)
+        {
+            if (dst_stride == 16 && src_stride == 16) {
+                size_t done = contiguous_byteswap<16>(dst, src, count);
+                dst += done * 16;
+                src += done * 16;
+                count -= done;
+            }
+            for (size_t i = 0; i != count; ++i,
+                            dst += dst_stride, src += src_stride) {
+                single(dst, src, extra);
+            }
+        }
+    };
+
     template<typename T>
     struct aligned_fixed_size_pairwise_byteswap_kernel {
         static void single(char *dst, const char *src,
@@ -51,6 +171,13 @@ namespace {
         {
             DYND_ASSERT_ALIGNED(dst, dst_stride, sizeof(T), "type: " << ndt::type(dynd::type_id_of<T>::value));
             DYND_ASSERT_ALIGNED(src, src_stride, sizeof(T), "type: " << ndt::type(dynd::type_id_of<T>::value));
+            if (dst_stride == 2 * sizeof(T) && src_stride == 2 * sizeof(T)) {
+                // Contiguous pairs are just twice as many contiguous values
+                size_t done = contiguous_byteswap<sizeof(T)>(dst, src, 2 * count) / 2;
+                dst += done * 2 * sizeof(T);
+                src += done * 2 * sizeof(T);
+                count -= done;
+            }
             for (size_t i = 0; i != count; ++i,
                             dst += dst_stride, src += src_stride) {
                 *(T *)dst = byteswap_value(*(T *)src);
@@ -116,6 +243,134 @@ namespace {
     };
 } // anonymous namespace
 
+namespace {
+    /**
+     * Chains a byteswap and a builtin conversion through a buffer
+     * on the stack, so reading or writing values of the other byte
+     * order as a different builtin type takes a single kernel.
+     */
+    struct byteswap_builtin_kernel_extra {
+        typedef byteswap_builtin_kernel_extra extra_type;
+
+        ckernel_prefix base;
+        // Offset, from the start of &base, to the kernel after the buffer
+        size_t second_kernel_offset;
+        intptr_t buffer_stride;
+
+        static void single(char *dst, const char *src, ckernel_prefix *extra)
+        {
+            char *eraw = reinterpret_cast<char *>(extra);
+            extra_type *e = reinterpret_cast<extra_type *>(extra);
+            ckernel_prefix *echild_first = &(e + 1)->base;
+            ckernel_prefix *echild_second = reinterpret_cast<ckernel_prefix *>(eraw + e->second_kernel_offset);
+            unary_single_operation_t opchild;
+            // Large enough for any builtin value
+            double buffer[2];
+            opchild = echild_first->get_function<unary_single_operation_t>();
+            opchild(reinterpret_cast<char *>(buffer), src, echild_first);
+            opchild = echild_second->get_function<unary_single_operation_t>();
+            opchild(dst, reinterpret_cast<char *>(buffer), echild_second);
+        }
+
+        static void strided(char *dst, intptr_t dst_stride,
+                        const char *src, intptr_t src_stride,
+                        size_t count, ckernel_prefix *extra)
+        {
+            char *eraw = reinterpret_cast<char *>(extra);
+            extra_type *e = reinterpret_cast<extra_type *>(extra);
+            ckernel_prefix *echild_first = &(e + 1)->base;
+            ckernel_prefix *echild_second = reinterpret_cast<ckernel_prefix *>(eraw + e->second_kernel_offset);
+            unary_strided_operation_t opchild_first = echild_first->get_function<unary_strided_operation_t>();
+            unary_strided_operation_t opchild_second = echild_second->get_function<unary_strided_operation_t>();
+            intptr_t buffer_stride = e->buffer_stride;
+            // Large enough for a chunk of any builtin value
+            double buffer[DYND_BUFFER_CHUNK_SIZE * 2];
+            char *buffer_ptr = reinterpret_cast<char *>(buffer);
+            while (count > 0) {
+                size_t chunk_size = min(DYND_BUFFER_CHUNK_SIZE, count);
+                opchild_first(buffer_ptr, buffer_stride, src, src_stride, chunk_size, echild_first);
+                opchild_second(dst, dst_stride, buffer_ptr, buffer_stride, chunk_size, echild_second);
+                dst += static_cast<intptr_t>(chunk_size) * dst_stride;
+                src += static_cast<intptr_t>(chunk_size) * src_stride;
+                count -= chunk_size;
+            }
+        }
+
+        static void destruct(ckernel_prefix *extra)
+        {
+            char *eraw = reinterpret_cast<char *>(extra);
+            extra_type *e = reinterpret_cast<extra_type *>(extra);
+            ckernel_prefix *echild = &(e + 1)->base;
+            if (echild->destructor) {
+                echild->destructor(echild);
+            }
+            if (e->second_kernel_offset != 0) {
+                echild = reinterpret_cast<ckernel_prefix *>(eraw + e->second_kernel_offset);
+                if (echild->destructor) {
+                    echild->destructor(echild);
+                }
+            }
+        }
+    };
+
+    size_t make_byteswap_value_kernel(ckernel_builder *out, size_t offset_out,
+                    const ndt::type& value_tp, kernel_request_t kernreq)
+    {
+        if (value_tp.get_kind() != complex_kind) {
+            return make_byteswap_assignment_function(out, offset_out,
+                            value_tp.get_data_size(), value_tp.get_data_alignment(), kernreq);
+        } else {
+            return make_pairwise_byteswap_assignment_function(out, offset_out,
+                            value_tp.get_data_size(), value_tp.get_data_alignment(), kernreq);
+        }
+    }
+} // anonymous namespace
+
+size_t dynd::make_byteswap_builtin_assignment_kernel(
+                ckernel_builder *out, size_t offset_out,
+                type_id_t dst_type_id, type_id_t src_type_id, bool swap_src,
+                kernel_request_t kernreq, assign_error_mode errmode)
+{
+    ndt::type value_tp(swap_src ? src_type_id : dst_type_id);
+    out->ensure_capacity(offset_out + sizeof(byteswap_builtin_kernel_extra));
+    byteswap_builtin_kernel_extra *e = out->get_at<byteswap_builtin_kernel_extra>(offset_out);
+    switch (kernreq) {
+        case kernel_request_single:
+            e->base.set_function<unary_single_operation_t>(&byteswap_builtin_kernel_extra::single);
+            break;
+        case kernel_request_strided:
+            e->base.set_function<unary_strided_operation_t>(&byteswap_builtin_kernel_extra::strided);
+            break;
+        default: {
+            stringstream ss;
+            ss << "make_byteswap_builtin_assignment_kernel: unrecognized request " << (int)kernreq;
+            throw runtime_error(ss.str());
+        }
+    }
+    e->base.destructor = &byteswap_builtin_kernel_extra::destruct;
+    e->buffer_stride = value_tp.get_data_size();
+    // The first kernel writes into the buffer, the second reads from it
+    size_t second_kernel_offset;
+    if (swap_src) {
+        second_kernel_offset = make_byteswap_value_kernel(out,
+                        offset_out + sizeof(byteswap_builtin_kernel_extra), value_tp, kernreq);
+    } else {
+        second_kernel_offset = make_builtin_type_assignment_kernel(out,
+                        offset_out + sizeof(byteswap_builtin_kernel_extra),
+                        dst_type_id, src_type_id, kernreq, errmode);
+    }
+    out->ensure_capacity(second_kernel_offset);
+    // This may have invalidated the 'e' pointer, so get it again!
+    e = out->get_at<byteswap_builtin_kernel_extra>(offset_out);
+    e->second_kernel_offset = second_kernel_offset - offset_out;
+    if (swap_src) {
+        return make_builtin_type_assignment_kernel(out, second_kernel_offset,
+                        dst_type_id, src_type_id, kernreq, errmode);
+    } else {
+        return make_byteswap_value_kernel(out, second_kernel_offset, value_tp, kernreq);
+    }
+}
+
 size_t dynd::make_byteswap_assignment_function(
                 ckernel_builder *out, size_t offset_out,
                 intptr_t data_size, intptr_t data_alignment,
@@ -173,6 +428,19 @@ size_t dynd::make_byteswap_assignment_function(
             break;
         }
     }
+    if (data_size == 16 && data_alignment >= 8) {
+        result = out->get_at<ckernel_prefix>(offset_out);
+        if (kernreq == kernel_request_single) {
+            result->set_function<unary_single_operation_t>(&aligned_16_byteswap::single);
+        } else if (kernreq == kernel_request_strided) {
+            result->set_function<unary_strided_operation_t>(&aligned_16_byteswap::strided);
+        } else {
+            stringstream ss;
+            ss << "make_byteswap_assignment_function: unrecognized request " << (int)kernreq;
+            throw runtime_error(ss.str());
+        }
+        return offset_out + sizeof(ckernel_prefix);
+    }
 
     // Use an adapter to a single kernel for this case
     offset_out = make_kernreq_to_single_kernel_adapter(out, offset_out, kernreq);
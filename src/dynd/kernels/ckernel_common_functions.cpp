@@ -6,6 +6,7 @@
 #include <dynd/kernels/ckernel_common_functions.hpp>
 #include <dynd/kernels/assignment_kernels.hpp>
 #include <dynd/kernels/expr_kernel_generator.hpp>
+#include <dynd/kernels/ckernel_debug_info.hpp>
 
 using namespace std;
 using namespace dynd;
@@ -140,3 +141,28 @@ intptr_t kernels::wrap_binary_as_unary_reduction_ckernel(
     }
     return ckb_child_offset;
 }
+
+namespace {
+    ckernel_debug_info_registrar unary_as_expr_single_reg(
+                    &kernels::unary_as_expr_adapter_single_ckernel, "unary as expr adapter",
+                    sizeof(ckernel_prefix), false, &ckernel_child_follows);
+    ckernel_debug_info_registrar unary_as_expr_strided_reg(
+                    &kernels::unary_as_expr_adapter_strided_ckernel, "unary as expr adapter",
+                    sizeof(ckernel_prefix), true, &ckernel_child_follows);
+    ckernel_debug_info_registrar right_reduction_single_reg(
+                    &binary_as_unary_right_associative_reduction_adapter_single_ckernel,
+                    "binary as right associative reduction adapter",
+                    sizeof(ckernel_prefix), false, &ckernel_child_follows);
+    ckernel_debug_info_registrar left_reduction_single_reg(
+                    &binary_as_unary_left_associative_reduction_adapter_single_ckernel,
+                    "binary as left associative reduction adapter",
+                    sizeof(ckernel_prefix), false, &ckernel_child_follows);
+    ckernel_debug_info_registrar right_reduction_strided_reg(
+                    &binary_as_unary_right_associative_reduction_adapter_strided_ckernel,
+                    "binary as right associative reduction adapter",
+                    sizeof(ckernel_prefix), true, &ckernel_child_follows);
+    ckernel_debug_info_registrar left_reduction_strided_reg(
+                    &binary_as_unary_left_associative_reduction_adapter_strided_ckernel,
+                    "binary as left associative reduction adapter",
+                    sizeof(ckernel_prefix), true, &ckernel_child_follows);
+} // anonymous namespace
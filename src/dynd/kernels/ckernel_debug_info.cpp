@@ -0,0 +1,131 @@
+//
+// Copyright (C) 2011-14 Mark Wiebe, DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <map>
+#include <vector>
+#include <iomanip>
+
+#include <dynd/kernels/ckernel_debug_info.hpp>
+#include <dynd/kernels/ckernel_builder.hpp>
+#include <dynd/platform_mutex.hpp>
+
+using namespace std;
+using namespace dynd;
+
+namespace {
+    struct debug_info_registry {
+        /** Guards the fields below */
+        platform_mutex mutex;
+        map<void *, ckernel_debug_info> infos;
+        vector<ckernel_debug_info_loader_t> pending_loaders;
+        /**
+         * Held while running the pending loaders, so lookups wait
+         * for the loaders another thread is running
+         */
+        platform_mutex load_mutex;
+    };
+
+    debug_info_registry& get_registry()
+    {
+        // Function-local so it is usable from other static initializers
+        static debug_info_registry registry;
+        return registry;
+    }
+
+    void run_pending_loaders(debug_info_registry& reg)
+    {
+        platform_mutex::scoped_lock load_lock(reg.load_mutex);
+        vector<ckernel_debug_info_loader_t> loaders;
+        {
+            platform_mutex::scoped_lock lock(reg.mutex);
+            loaders.swap(reg.pending_loaders);
+        }
+        // The loaders lock reg.mutex themselves as they register
+        for (size_t i = 0; i != loaders.size(); ++i) {
+            loaders[i]();
+        }
+    }
+
+    void print_ckernel(std::ostream& o, const ckernel_prefix *ckp,
+                    size_t offset, const std::string& indent)
+    {
+        o << indent << "[" << offset << "] ";
+        if (ckp->function == NULL) {
+            o << "(empty ckernel)\n";
+            return;
+        }
+        const ckernel_debug_info *info = get_ckernel_debug_info(ckp->function);
+        if (info == NULL) {
+            o << "unregistered ckernel function " << ckp->function << "\n";
+            return;
+        }
+        o << info->name << (info->strided ? " (strided" : " (single");
+        o << ", " << info->size << " bytes)";
+        if (info->describe != NULL) {
+            o << " ";
+            info->describe(ckp, o);
+        }
+        o << "\n";
+        if (info->get_children != NULL) {
+            vector<size_t> child_offsets;
+            info->get_children(ckp, info->size, child_offsets);
+            for (size_t i = 0; i != child_offsets.size(); ++i) {
+                const ckernel_prefix *child = reinterpret_cast<const ckernel_prefix *>(
+                                reinterpret_cast<const char *>(ckp) + child_offsets[i]);
+                print_ckernel(o, child, offset + child_offsets[i], indent + "  ");
+            }
+        }
+    }
+} // anonymous namespace
+
+void dynd::ckernel_child_follows(const ckernel_prefix *DYND_UNUSED(self), size_t self_size,
+                std::vector<size_t>& out_child_offsets)
+{
+    out_child_offsets.push_back(self_size);
+}
+
+void dynd::register_ckernel_debug_info(void *function, const std::string& name,
+                size_t size, bool strided, ckernel_children_fn_t get_children,
+                ckernel_describe_fn_t describe)
+{
+    debug_info_registry& reg = get_registry();
+    platform_mutex::scoped_lock lock(reg.mutex);
+    if (reg.infos.find(function) == reg.infos.end()) {
+        ckernel_debug_info& info = reg.infos[function];
+        info.name = name;
+        info.size = size;
+        info.strided = strided;
+        info.get_children = get_children;
+        info.describe = describe;
+    }
+}
+
+void dynd::register_ckernel_debug_info_loader(ckernel_debug_info_loader_t loader)
+{
+    debug_info_registry& reg = get_registry();
+    platform_mutex::scoped_lock lock(reg.mutex);
+    reg.pending_loaders.push_back(loader);
+}
+
+const ckernel_debug_info *dynd::get_ckernel_debug_info(void *function)
+{
+    debug_info_registry& reg = get_registry();
+    run_pending_loaders(reg);
+    platform_mutex::scoped_lock lock(reg.mutex);
+    map<void *, ckernel_debug_info>::const_iterator it = reg.infos.find(function);
+    // Entries are never removed, so the pointer stays valid after unlocking
+    return (it != reg.infos.end()) ? &it->second : NULL;
+}
+
+void dynd::ckernel_debug_print(std::ostream& o, const ckernel_prefix *ckp,
+                const std::string& indent)
+{
+    print_ckernel(o, ckp, 0, indent);
+}
+
+void ckernel_builder::debug_print(std::ostream& o, const std::string& indent) const
+{
+    ckernel_debug_print(o, get(), indent);
+}
@@ -0,0 +1,267 @@
+//
+// Copyright (C) 2011-14 Mark Wiebe, DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <stdexcept>
+#include <sstream>
+#include <iomanip>
+
+#include <dynd/kernels/ckernel_profiler.hpp>
+#include <dynd/kernels/ckernel_debug_info.hpp>
+#include <dynd/kernels/assignment_kernels.hpp>
+#include <dynd/kernels/expr_kernel_generator.hpp>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__i386__) || defined(__x86_64__)
+#include <x86intrin.h>
+#elif defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+using namespace std;
+using namespace dynd;
+
+uint64_t ckernel_profiler::get_ticks()
+{
+#if defined(_MSC_VER) || defined(__i386__) || defined(__x86_64__)
+    return __rdtsc();
+#elif defined(_WIN32)
+    LARGE_INTEGER count;
+    QueryPerformanceCounter(&count);
+    return count.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+#endif
+}
+
+namespace {
+    /**
+     * A ckernel which forwards to the child ckernel placed
+     * right after it, updating the counters in its node.
+     */
+    struct profiled_ckernel {
+        typedef profiled_ckernel extra_type;
+
+        ckernel_prefix base;
+        ckernel_profile_node *node;
+
+        static void unary_single(char *dst, const char *src, ckernel_prefix *extra)
+        {
+            extra_type *e = reinterpret_cast<extra_type *>(extra);
+            ckernel_prefix *echild = &(e + 1)->base;
+            unary_single_operation_t opchild = echild->get_function<unary_single_operation_t>();
+            uint64_t start = ckernel_profiler::get_ticks();
+            opchild(dst, src, echild);
+            ckernel_profile_node *node = e->node;
+            node->ticks += ckernel_profiler::get_ticks() - start;
+            ++node->calls;
+            ++node->elements;
+        }
+
+        static void unary_strided(char *dst, intptr_t dst_stride,
+                        const char *src, intptr_t src_stride,
+                        size_t count, ckernel_prefix *extra)
+        {
+            extra_type *e = reinterpret_cast<extra_type *>(extra);
+            ckernel_prefix *echild = &(e + 1)->base;
+            unary_strided_operation_t opchild = echild->get_function<unary_strided_operation_t>();
+            uint64_t start = ckernel_profiler::get_ticks();
+            opchild(dst, dst_stride, src, src_stride, count, echild);
+            ckernel_profile_node *node = e->node;
+            node->ticks += ckernel_profiler::get_ticks() - start;
+            ++node->calls;
+            node->elements += count;
+        }
+
+        static void expr_single(char *dst, const char * const *src, ckernel_prefix *extra)
+        {
+            extra_type *e = reinterpret_cast<extra_type *>(extra);
+            ckernel_prefix *echild = &(e + 1)->base;
+            expr_single_operation_t opchild = echild->get_function<expr_single_operation_t>();
+            uint64_t start = ckernel_profiler::get_ticks();
+            opchild(dst, src, echild);
+            ckernel_profile_node *node = e->node;
+            node->ticks += ckernel_profiler::get_ticks() - start;
+            ++node->calls;
+            ++node->elements;
+        }
+
+        static void expr_strided(char *dst, intptr_t dst_stride,
+                        const char * const *src, const intptr_t *src_stride,
+                        size_t count, ckernel_prefix *extra)
+        {
+            extra_type *e = reinterpret_cast<extra_type *>(extra);
+            ckernel_prefix *echild = &(e + 1)->base;
+            expr_strided_operation_t opchild = echild->get_function<expr_strided_operation_t>();
+            uint64_t start = ckernel_profiler::get_ticks();
+            opchild(dst, dst_stride, src, src_stride, count, echild);
+            ckernel_profile_node *node = e->node;
+            node->ticks += ckernel_profiler::get_ticks() - start;
+            ++node->calls;
+            node->elements += count;
+        }
+
+        static void destruct(ckernel_prefix *extra)
+        {
+            extra_type *e = reinterpret_cast<extra_type *>(extra);
+            ckernel_prefix *echild = &(e + 1)->base;
+            if (echild->destructor) {
+                echild->destructor(echild);
+            }
+        }
+    };
+
+    void describe_profiled_ckernel(const ckernel_prefix *self, std::ostream& o)
+    {
+        o << "\"" << reinterpret_cast<const profiled_ckernel *>(self)->node->name << "\"";
+    }
+
+    ckernel_debug_info_registrar profiled_unary_single_reg(&profiled_ckernel::unary_single,
+                    "profiled", sizeof(profiled_ckernel), false,
+                    &ckernel_child_follows, &describe_profiled_ckernel);
+    ckernel_debug_info_registrar profiled_unary_strided_reg(&profiled_ckernel::unary_strided,
+                    "profiled", sizeof(profiled_ckernel), true,
+                    &ckernel_child_follows, &describe_profiled_ckernel);
+    ckernel_debug_info_registrar profiled_expr_single_reg(&profiled_ckernel::expr_single,
+                    "profiled", sizeof(profiled_ckernel), false,
+                    &ckernel_child_follows, &describe_profiled_ckernel);
+    ckernel_debug_info_registrar profiled_expr_strided_reg(&profiled_ckernel::expr_strided,
+                    "profiled", sizeof(profiled_ckernel), true,
+                    &ckernel_child_follows, &describe_profiled_ckernel);
+
+    void delete_children(ckernel_profile_node *node)
+    {
+        for (size_t i = 0; i != node->children.size(); ++i) {
+            delete_children(node->children[i]);
+            delete node->children[i];
+        }
+        node->children.clear();
+    }
+
+    void reset_node_counts(ckernel_profile_node *node)
+    {
+        node->calls = 0;
+        node->elements = 0;
+        node->ticks = 0;
+        for (size_t i = 0; i != node->children.size(); ++i) {
+            reset_node_counts(node->children[i]);
+        }
+    }
+
+    void print_node(std::ostream& o, const ckernel_profile_node *node, const std::string& indent)
+    {
+        o << setw(12) << node->calls << setw(14) << node->elements;
+        o << setw(16) << node->ticks << setw(16) << node->get_self_ticks();
+        o << "  " << indent << node->name;
+        o << (node->strided ? " (strided)" : " (single)") << "\n";
+        for (size_t i = 0; i != node->children.size(); ++i) {
+            print_node(o, node->children[i], indent + "  ");
+        }
+    }
+} // anonymous namespace
+
+uint64_t ckernel_profile_node::get_self_ticks() const
+{
+    uint64_t children_ticks = 0;
+    for (size_t i = 0; i != children.size(); ++i) {
+        children_ticks += children[i]->ticks;
+    }
+    // Timer jitter can make the children appear to take longer
+    return (ticks > children_ticks) ? (ticks - children_ticks) : 0;
+}
+
+ckernel_profiler::ckernel_profiler()
+    : m_current(&m_root)
+{
+    m_root.strided = false;
+    m_root.calls = 0;
+    m_root.elements = 0;
+    m_root.ticks = 0;
+    m_root.parent = NULL;
+}
+
+ckernel_profiler::~ckernel_profiler()
+{
+    delete_children(&m_root);
+}
+
+size_t ckernel_profiler::push_kernel(ckernel_builder *out, size_t offset_out,
+                deferred_ckernel_funcproto_t funcproto, kernel_request_t kernreq,
+                const std::string& name)
+{
+    if (kernreq != kernel_request_single && kernreq != kernel_request_strided) {
+        stringstream ss;
+        ss << "ckernel_profiler: unrecognized request " << (int)kernreq;
+        throw runtime_error(ss.str());
+    }
+    bool strided = (kernreq == kernel_request_strided);
+
+    out->ensure_capacity(offset_out + sizeof(profiled_ckernel));
+    profiled_ckernel *e = out->get_at<profiled_ckernel>(offset_out);
+    switch (funcproto) {
+        case unary_operation_funcproto:
+            if (strided) {
+                e->base.set_function<unary_strided_operation_t>(&profiled_ckernel::unary_strided);
+            } else {
+                e->base.set_function<unary_single_operation_t>(&profiled_ckernel::unary_single);
+            }
+            break;
+        case expr_operation_funcproto:
+            if (strided) {
+                e->base.set_function<expr_strided_operation_t>(&profiled_ckernel::expr_strided);
+            } else {
+                e->base.set_function<expr_single_operation_t>(&profiled_ckernel::expr_single);
+            }
+            break;
+        default: {
+            stringstream ss;
+            ss << "ckernel_profiler: unsupported ckernel function prototype " << (int)funcproto;
+            throw runtime_error(ss.str());
+        }
+    }
+    e->base.destructor = &profiled_ckernel::destruct;
+
+    ckernel_profile_node *node = new ckernel_profile_node;
+    node->name = name;
+    node->strided = strided;
+    node->calls = 0;
+    node->elements = 0;
+    node->ticks = 0;
+    node->parent = m_current;
+    m_current->children.push_back(node);
+    m_current = node;
+    e->node = node;
+
+    return offset_out + sizeof(profiled_ckernel);
+}
+
+void ckernel_profiler::pop_kernel()
+{
+    if (m_current->parent != NULL) {
+        m_current = m_current->parent;
+    }
+}
+
+void ckernel_profiler::reset_counts()
+{
+    reset_node_counts(&m_root);
+}
+
+void ckernel_profiler::print(std::ostream& o) const
+{
+    o << "ckernel profile\n";
+    o << setw(12) << "calls" << setw(14) << "elements";
+    o << setw(16) << "ticks" << setw(16) << "self ticks" << "  ckernel\n";
+    for (size_t i = 0; i != m_root.children.size(); ++i) {
+        print_node(o, m_root.children[i], "");
+    }
+}
@@ -5,6 +5,7 @@
 
 #include <dynd/kernels/date_assignment_kernels.hpp>
 #include <dynd/kernels/assignment_kernels.hpp>
+#include <dynd/kernels/ckernel_debug_info.hpp>
 #include <dynd/types/cstruct_type.hpp>
 #include <datetime_strings.h>
 
@@ -52,10 +53,9 @@ size_t dynd::make_string_to_date_assignment_kernel(
         throw runtime_error(ss.str());
     }
 
-    offset_out = make_kernreq_to_single_kernel_adapter(out, offset_out, kernreq);
     out->ensure_capacity(offset_out + sizeof(string_to_date_kernel_extra));
     string_to_date_kernel_extra *e = out->get_at<string_to_date_kernel_extra>(offset_out);
-    e->base.set_function<unary_single_operation_t>(&string_to_date_kernel_extra::single);
+    set_unary_single_or_strided_function<&string_to_date_kernel_extra::single>(&e->base, kernreq);
     e->base.destructor = &string_to_date_kernel_extra::destruct;
     // The kernel data owns a reference to this type
     e->src_string_dt = static_cast<const base_string_type *>(ndt::type(src_string_dt).release());
@@ -112,10 +112,9 @@ size_t dynd::make_date_to_string_assignment_kernel(
         throw runtime_error(ss.str());
     }
 
-    offset_out = make_kernreq_to_single_kernel_adapter(out, offset_out, kernreq);
     out->ensure_capacity(offset_out + sizeof(date_to_string_kernel_extra));
     date_to_string_kernel_extra *e = out->get_at<date_to_string_kernel_extra>(offset_out);
-    e->base.set_function<unary_single_operation_t>(&date_to_string_kernel_extra::single);
+    set_unary_single_or_strided_function<&date_to_string_kernel_extra::single>(&e->base, kernreq);
     e->base.destructor = &date_to_string_kernel_extra::destruct;
     // The kernel data owns a reference to this type
     e->dst_string_dt = static_cast<const base_string_type *>(ndt::type(dst_string_dt).release());
@@ -124,3 +123,13 @@ size_t dynd::make_date_to_string_assignment_kernel(
     return offset_out + sizeof(date_to_string_kernel_extra);
 }
 
+namespace {
+    ckernel_debug_info_registrar string_to_date_single_reg(&string_to_date_kernel_extra::single,
+                    "string to date assign", sizeof(string_to_date_kernel_extra), false, NULL);
+    ckernel_debug_info_registrar string_to_date_strided_reg(&strided_loop_of_single<&string_to_date_kernel_extra::single>,
+                    "string to date assign", sizeof(string_to_date_kernel_extra), true, NULL);
+    ckernel_debug_info_registrar date_to_string_single_reg(&date_to_string_kernel_extra::single,
+                    "date to string assign", sizeof(date_to_string_kernel_extra), false, NULL);
+    ckernel_debug_info_registrar date_to_string_strided_reg(&strided_loop_of_single<&date_to_string_kernel_extra::single>,
+                    "date to string assign", sizeof(date_to_string_kernel_extra), true, NULL);
+} // anonymous namespace
@@ -8,10 +8,38 @@
 #include <dynd/types/strided_dim_type.hpp>
 #include <dynd/types/fixed_dim_type.hpp>
 #include <dynd/types/var_dim_type.hpp>
+#include <dynd/kernels/ckernel_profiler.hpp>
+#include <dynd/kernels/ckernel_debug_info.hpp>
 
 using namespace std;
 using namespace dynd;
 
+/**
+ * Makes the strided child kernel for the element of an elwise dimension,
+ * profiling it when the eval context requests it.
+ */
+static size_t make_elwise_child_expr_kernel(
+                const expr_kernel_generator *elwise_handler,
+                ckernel_builder *out, size_t offset_out,
+                const ndt::type& dst_tp, const char *dst_metadata,
+                size_t src_count, const ndt::type *src_tp, const char **src_metadata,
+                const eval::eval_context *ectx)
+{
+    ckernel_profiler_scope profiled;
+    if (ectx != NULL && ectx->profiler != NULL) {
+        stringstream ss;
+        ss << "elwise ";
+        elwise_handler->print_type(ss);
+        ss << " -> " << dst_tp;
+        offset_out = profiled.push(ectx->profiler, out, offset_out,
+                        expr_operation_funcproto, kernel_request_strided, ss.str());
+    }
+    return elwise_handler->make_expr_kernel(out, offset_out,
+                    dst_tp, dst_metadata,
+                    src_count, src_tp, src_metadata,
+                    kernel_request_strided, ectx);
+}
+
 ////////////////////////////////////////////////////////////////////
 // make_elwise_strided_dimension_expr_kernel
 
@@ -147,11 +175,11 @@ static size_t make_elwise_strided_dimension_expr_kernel_for_N(
             src_child_dt[i] = fdd->get_element_type();
         }
     }
-    return elwise_handler->make_expr_kernel(
+    return make_elwise_child_expr_kernel(elwise_handler,
                     out, offset_out + sizeof(strided_expr_kernel_extra<N>),
                     dst_child_dt, dst_child_metadata,
                     N, src_child_dt, src_child_metadata,
-                    kernel_request_strided, ectx);
+                    ectx);
 }
 
 inline static size_t make_elwise_strided_dimension_expr_kernel(
@@ -377,11 +405,11 @@ static size_t make_elwise_strided_or_var_to_strided_dimension_expr_kernel_for_N(
             src_child_dt[i] = vdd->get_element_type();
         }
     }
-    return elwise_handler->make_expr_kernel(
+    return make_elwise_child_expr_kernel(elwise_handler,
                     out, offset_out + sizeof(strided_or_var_to_strided_expr_kernel_extra<N>),
                     dst_child_dt, dst_child_metadata,
                     N, src_child_dt, src_child_metadata,
-                    kernel_request_strided, ectx);
+                    ectx);
 }
 
 static size_t make_elwise_strided_or_var_to_strided_dimension_expr_kernel(
@@ -665,11 +693,11 @@ static size_t make_elwise_strided_or_var_to_var_dimension_expr_kernel_for_N(
             src_child_dt[i] = vdd->get_element_type();
         }
     }
-    return elwise_handler->make_expr_kernel(
+    return make_elwise_child_expr_kernel(elwise_handler,
                     out, offset_out + sizeof(strided_or_var_to_var_expr_kernel_extra<N>),
                     dst_child_dt, dst_child_metadata,
                     N, src_child_dt, src_child_metadata,
-                    kernel_request_strided, ectx);
+                    ectx);
 }
 
 static size_t make_elwise_strided_or_var_to_var_dimension_expr_kernel(
@@ -806,3 +834,40 @@ size_t dynd::make_elwise_dimension_expr_kernel(ckernel_builder *out, size_t offs
     ss << ") to " << dst_tp;
     throw runtime_error(ss.str());
 }
+
+namespace {
+    template<template<int> class K, int N>
+    void register_elwise_debug_info(const char *name)
+    {
+        stringstream ss;
+        ss << name << ", " << N << " src";
+        register_ckernel_debug_info((void *)&K<N>::single, ss.str(),
+                        sizeof(K<N>), false, &ckernel_child_follows);
+        register_ckernel_debug_info((void *)&K<N>::strided, ss.str(),
+                        sizeof(K<N>), true, &ckernel_child_follows);
+    }
+
+    template<template<int> class K>
+    void register_elwise_debug_infos(const char *name)
+    {
+        register_elwise_debug_info<K, 1>(name);
+        register_elwise_debug_info<K, 2>(name);
+        register_elwise_debug_info<K, 3>(name);
+        register_elwise_debug_info<K, 4>(name);
+        register_elwise_debug_info<K, 5>(name);
+        register_elwise_debug_info<K, 6>(name);
+    }
+
+    struct elwise_expr_kernels_debug_info {
+        elwise_expr_kernels_debug_info() {
+            register_elwise_debug_infos<strided_expr_kernel_extra>(
+                            "elwise strided dim");
+            register_elwise_debug_infos<strided_or_var_to_strided_expr_kernel_extra>(
+                            "elwise strided or var to strided dim");
+            register_elwise_debug_infos<strided_or_var_to_var_expr_kernel_extra>(
+                            "elwise strided or var to var dim");
+        }
+    };
+
+    elwise_expr_kernels_debug_info elwise_expr_kernels_debug_info_instance;
+} // anonymous namespace
@@ -7,7 +7,11 @@
 
 #include <dynd/type.hpp>
 #include <dynd/types/base_expression_type.hpp>
+#include <dynd/types/fixedbytes_type.hpp>
+#include <dynd/types/convert_type.hpp>
 #include <dynd/kernels/expression_assignment_kernels.hpp>
+#include <dynd/kernels/ckernel_debug_info.hpp>
+#include <dynd/codegen/codegen_cache.hpp>
 
 using namespace std;
 using namespace dynd;
@@ -127,6 +131,8 @@ namespace {
                 if (buffer_metadata != NULL) {
                     buffer_tp->metadata_reset_buffers(buffer_metadata);
                 }
+                dst += static_cast<intptr_t>(chunk_size) * dst_stride;
+                src += static_cast<intptr_t>(chunk_size) * src_stride;
                 count -= chunk_size;
             }
         }
@@ -158,7 +164,341 @@ namespace {
                 }
             }
         }
+
+        static void get_children(const ckernel_prefix *self, size_t DYND_UNUSED(self_size),
+                        std::vector<size_t>& out_child_offsets)
+        {
+            const extra_type *e = reinterpret_cast<const extra_type *>(self);
+            if (e->first_kernel_offset != 0) {
+                out_child_offsets.push_back(e->first_kernel_offset);
+            }
+            if (e->second_kernel_offset != 0) {
+                out_child_offsets.push_back(e->second_kernel_offset);
+            }
+        }
+
+        static void describe(const ckernel_prefix *self, std::ostream& o)
+        {
+            const extra_type *e = reinterpret_cast<const extra_type *>(self);
+            o << "buffer " << ndt::type(e->buffer_tp, true);
+            o << ", " << e->buffer_data_size << " buffer bytes";
+        }
+    };
+} // anonymous namespace
+
+namespace {
+    enum {
+        // The most steps a fused chain kernel will hold
+        builtin_chain_max_steps = 8,
+        // The largest value a fused chain step can produce
+        builtin_chain_max_value_size = 16
+    };
+
+    /**
+     * Runs a chain of leaf kernels, each converting the output of the
+     * previous one, ping-ponging between two chunk buffers on the
+     * stack. This replaces a nest of buffered kernels when every
+     * step of an expression chain is between builtin or fixedbytes
+     * values, so each step sees contiguous data.
+     */
+    struct builtin_chain_kernel_extra {
+        typedef builtin_chain_kernel_extra extra_type;
+
+        ckernel_prefix base;
+        size_t step_count;
+        // Offsets, from the start of &base, to the kernel of each step
+        size_t kernel_offsets[builtin_chain_max_steps];
+        // The size of the value each step produces
+        intptr_t value_sizes[builtin_chain_max_steps];
+
+        static void single(char *dst, const char *src, ckernel_prefix *extra)
+        {
+            char *eraw = reinterpret_cast<char *>(extra);
+            extra_type *e = reinterpret_cast<extra_type *>(extra);
+            double buffers[2][builtin_chain_max_value_size / sizeof(double)];
+            size_t step_count = e->step_count;
+            const char *step_src = src;
+            for (size_t i = 0; i != step_count; ++i) {
+                ckernel_prefix *echild = reinterpret_cast<ckernel_prefix *>(eraw + e->kernel_offsets[i]);
+                char *step_dst = (i == step_count - 1) ? dst : reinterpret_cast<char *>(buffers[i % 2]);
+                echild->get_function<unary_single_operation_t>()(step_dst, step_src, echild);
+                step_src = step_dst;
+            }
+        }
+
+        static void strided(char *dst, intptr_t dst_stride,
+                        const char *src, intptr_t src_stride,
+                        size_t count, ckernel_prefix *extra)
+        {
+            char *eraw = reinterpret_cast<char *>(extra);
+            extra_type *e = reinterpret_cast<extra_type *>(extra);
+            double buffers[2][DYND_BUFFER_CHUNK_SIZE * builtin_chain_max_value_size / sizeof(double)];
+            size_t step_count = e->step_count;
+            while (count > 0) {
+                size_t chunk_size = min(DYND_BUFFER_CHUNK_SIZE, count);
+                const char *step_src = src;
+                intptr_t step_src_stride = src_stride;
+                for (size_t i = 0; i != step_count; ++i) {
+                    ckernel_prefix *echild = reinterpret_cast<ckernel_prefix *>(eraw + e->kernel_offsets[i]);
+                    char *step_dst;
+                    intptr_t step_dst_stride;
+                    if (i == step_count - 1) {
+                        step_dst = dst;
+                        step_dst_stride = dst_stride;
+                    } else {
+                        step_dst = reinterpret_cast<char *>(buffers[i % 2]);
+                        step_dst_stride = e->value_sizes[i];
+                    }
+                    echild->get_function<unary_strided_operation_t>()(step_dst, step_dst_stride,
+                                    step_src, step_src_stride, chunk_size, echild);
+                    step_src = step_dst;
+                    step_src_stride = step_dst_stride;
+                }
+                dst += static_cast<intptr_t>(chunk_size) * dst_stride;
+                src += static_cast<intptr_t>(chunk_size) * src_stride;
+                count -= chunk_size;
+            }
+        }
+
+        static void destruct(ckernel_prefix *extra)
+        {
+            char *eraw = reinterpret_cast<char *>(extra);
+            extra_type *e = reinterpret_cast<extra_type *>(extra);
+            for (size_t i = 0; i != e->step_count; ++i) {
+                // A zero offset is a step which was never constructed
+                if (e->kernel_offsets[i] != 0) {
+                    ckernel_prefix *echild = reinterpret_cast<ckernel_prefix *>(eraw + e->kernel_offsets[i]);
+                    if (echild->destructor) {
+                        echild->destructor(echild);
+                    }
+                }
+            }
+        }
+
+        static void get_children(const ckernel_prefix *self, size_t DYND_UNUSED(self_size),
+                        std::vector<size_t>& out_child_offsets)
+        {
+            const extra_type *e = reinterpret_cast<const extra_type *>(self);
+            for (size_t i = 0; i != e->step_count; ++i) {
+                if (e->kernel_offsets[i] != 0) {
+                    out_child_offsets.push_back(e->kernel_offsets[i]);
+                }
+            }
+        }
+
+        static void describe(const ckernel_prefix *self, std::ostream& o)
+        {
+            o << reinterpret_cast<const extra_type *>(self)->step_count << " steps";
+        }
     };
+
+    /** Whether a value can be produced by a step of a fused chain kernel */
+    bool is_builtin_chain_value(const ndt::type& tp)
+    {
+        if (tp.is_builtin()) {
+            return tp.get_type_id() >= bool_type_id && tp.get_type_id() <= complex_float64_type_id;
+        } else {
+            return tp.get_type_id() == fixedbytes_type_id &&
+                            tp.get_data_size() <= builtin_chain_max_value_size;
+        }
+    }
+
+    /**
+     * Gets the steps of an expression chain from the storage up, if
+     * every step is a view, byteswap or convert between builtin or
+     * fixedbytes values. Returns the number of steps, or zero if the
+     * chain can't be fused.
+     */
+    size_t get_builtin_chain(const ndt::type& tp, const base_expression_type **out_steps)
+    {
+        const base_expression_type *steps[builtin_chain_max_steps];
+        size_t step_count = 0;
+        const ndt::type *cur = &tp;
+        while (cur->get_kind() == expression_kind) {
+            switch (cur->get_type_id()) {
+                case view_type_id:
+                case byteswap_type_id:
+                case convert_type_id:
+                    break;
+                default:
+                    return 0;
+            }
+            const base_expression_type *bed = static_cast<const base_expression_type *>(cur->extended());
+            if (step_count == builtin_chain_max_steps || !is_builtin_chain_value(bed->get_value_type())) {
+                return 0;
+            }
+            steps[step_count++] = bed;
+            cur = &bed->get_operand_type();
+        }
+        if (!is_builtin_chain_value(*cur)) {
+            return 0;
+        }
+        for (size_t i = 0; i != step_count; ++i) {
+            out_steps[i] = steps[step_count - i - 1];
+        }
+        return step_count;
+    }
+
+    /** Resolves an error mode, returning true if it's no error checking */
+    bool is_errmode_none(const ndt::type& dst_tp, const ndt::type& src_tp,
+                    assign_error_mode errmode, const eval::eval_context *ectx)
+    {
+        if (errmode == assign_error_default) {
+            errmode = ectx->default_assign_error_mode;
+        }
+        return errmode == assign_error_none || is_lossless_assignment(dst_tp, src_tp);
+    }
+
+    /**
+     * Gets the signature of a generated strided loop equivalent to a
+     * builtin chain followed by a conversion to dst_tp. This is possible
+     * when the chain views its storage as a builtin, byteswaps it at
+     * most once, and does at most one conversion without error checking.
+     */
+    bool get_builtin_chain_loop_signature(const base_expression_type **steps, size_t chain_count,
+                    const ndt::type& dst_tp, const ndt::type& value_tp,
+                    assign_error_mode errmode, const eval::eval_context *ectx,
+                    strided_loop_signature& out_sig)
+    {
+        const ndt::type& storage_tp = steps[0]->get_operand_type();
+        // 'raw' is true while the value is still fixedbytes
+        bool raw = !storage_tp.is_builtin(), swapped = false, converted = false;
+        type_id_t loaded_tid = storage_tp.get_type_id(), dst_tid = uninitialized_type_id;
+        for (size_t i = 0; i != chain_count; ++i) {
+            const ndt::type& step_value_tp = steps[i]->get_value_type();
+            if (converted) {
+                return false;
+            }
+            switch (steps[i]->get_type_id()) {
+                case view_type_id:
+                    if (step_value_tp.is_builtin()) {
+                        loaded_tid = step_value_tp.get_type_id();
+                        raw = false;
+                    } else if (!raw) {
+                        return false;
+                    }
+                    break;
+                case byteswap_type_id:
+                    if (swapped || !step_value_tp.is_builtin()) {
+                        return false;
+                    }
+                    loaded_tid = step_value_tp.get_type_id();
+                    raw = false;
+                    swapped = true;
+                    break;
+                case convert_type_id:
+                    if (raw || !is_errmode_none(step_value_tp, steps[i]->get_operand_type(),
+                                static_cast<const convert_type *>(steps[i])->get_errmode_to_value(), ectx)) {
+                        return false;
+                    }
+                    dst_tid = step_value_tp.get_type_id();
+                    converted = true;
+                    break;
+                default:
+                    return false;
+            }
+        }
+        if (raw) {
+            return false;
+        }
+        if (dst_tp != value_tp) {
+            if (converted || !dst_tp.is_builtin() || !is_errmode_none(dst_tp, value_tp, errmode, ectx)) {
+                return false;
+            }
+            dst_tid = dst_tp.get_type_id();
+        } else if (!converted) {
+            dst_tid = loaded_tid;
+        }
+        out_sig = strided_loop_signature(dst_tid, false, loaded_tid, swapped);
+        return is_strided_loop_codegen_supported(out_sig);
+    }
+
+    /**
+     * Makes a fused chain kernel for src_tp's expression chain, followed
+     * by a conversion from its value type to dst_tp if they differ.
+     * Returns zero if the assignment isn't a chain of at least two
+     * builtin steps.
+     */
+    size_t make_builtin_chain_kernel(
+                    ckernel_builder *out, size_t offset_out,
+                    const ndt::type& dst_tp, const char *dst_metadata,
+                    const ndt::type& src_tp,
+                    kernel_request_t kernreq, assign_error_mode errmode,
+                    const eval::eval_context *ectx)
+    {
+        if (kernreq != kernel_request_single && kernreq != kernel_request_strided) {
+            return 0;
+        }
+        const base_expression_type *steps[builtin_chain_max_steps];
+        size_t chain_count = get_builtin_chain(src_tp, steps);
+        const ndt::type& value_tp = src_tp.value_type();
+        bool convert_to_dst = (dst_tp != value_tp);
+        if (chain_count == 0 || (convert_to_dst && (!is_builtin_chain_value(dst_tp) ||
+                        chain_count == builtin_chain_max_steps))) {
+            return 0;
+        }
+        size_t step_count = chain_count + (convert_to_dst ? 1 : 0);
+        if (step_count < 2) {
+            return 0;
+        }
+
+        if (kernreq == kernel_request_strided) {
+            // Use a generated loop which does the whole chain per element
+            // in registers when possible
+            strided_loop_signature sig;
+            if (get_builtin_chain_loop_signature(steps, chain_count, dst_tp, value_tp,
+                            errmode, ectx, sig)) {
+                size_t result = get_default_codegen_cache().make_strided_loop_kernel(
+                                out, offset_out, sig, kernreq);
+                if (result != 0) {
+                    return result;
+                }
+            }
+        }
+
+        out->ensure_capacity(offset_out + sizeof(builtin_chain_kernel_extra));
+        builtin_chain_kernel_extra *e = out->get_at<builtin_chain_kernel_extra>(offset_out);
+        if (kernreq == kernel_request_single) {
+            e->base.set_function<unary_single_operation_t>(&builtin_chain_kernel_extra::single);
+        } else {
+            e->base.set_function<unary_strided_operation_t>(&builtin_chain_kernel_extra::strided);
+        }
+        e->base.destructor = &builtin_chain_kernel_extra::destruct;
+        e->step_count = step_count;
+        memset(e->kernel_offsets, 0, sizeof(e->kernel_offsets));
+        size_t current_offset = offset_out + sizeof(builtin_chain_kernel_extra);
+        for (size_t i = 0; i != step_count; ++i) {
+            out->ensure_capacity(current_offset);
+            // This may have invalidated the 'e' pointer, so get it again!
+            e = out->get_at<builtin_chain_kernel_extra>(offset_out);
+            e->kernel_offsets[i] = current_offset - offset_out;
+            if (i < chain_count) {
+                e->value_sizes[i] = steps[i]->get_value_type().get_data_size();
+                // None of the steps have any metadata
+                current_offset = steps[i]->make_operand_to_value_assignment_kernel(out, current_offset,
+                                NULL, NULL, kernreq, ectx);
+            } else {
+                e->value_sizes[i] = dst_tp.get_data_size();
+                current_offset = ::make_assignment_kernel(out, current_offset,
+                                dst_tp, dst_metadata, value_tp, NULL,
+                                kernreq, errmode, ectx);
+            }
+        }
+        return current_offset;
+    }
+
+    ckernel_debug_info_registrar buffered_single_reg(&buffered_kernel_extra::single,
+                    "buffered", sizeof(buffered_kernel_extra), false,
+                    &buffered_kernel_extra::get_children, &buffered_kernel_extra::describe);
+    ckernel_debug_info_registrar buffered_strided_reg(&buffered_kernel_extra::strided,
+                    "buffered", sizeof(buffered_kernel_extra), true,
+                    &buffered_kernel_extra::get_children, &buffered_kernel_extra::describe);
+    ckernel_debug_info_registrar builtin_chain_single_reg(&builtin_chain_kernel_extra::single,
+                    "builtin chain", sizeof(builtin_chain_kernel_extra), false,
+                    &builtin_chain_kernel_extra::get_children, &builtin_chain_kernel_extra::describe);
+    ckernel_debug_info_registrar builtin_chain_strided_reg(&builtin_chain_kernel_extra::strided,
+                    "builtin chain", sizeof(builtin_chain_kernel_extra), true,
+                    &builtin_chain_kernel_extra::get_children, &builtin_chain_kernel_extra::describe);
 } // anonymous namespace
 
 size_t dynd::make_expression_assignment_kernel(
@@ -240,6 +580,13 @@ size_t dynd::make_expression_assignment_kernel(
                             kernreq, errmode, ectx);
         }
     } else {
+        // Fuse a chain of builtin steps into one kernel when possible
+        size_t chain_offset = make_builtin_chain_kernel(out, offset_out,
+                        dst_tp, dst_metadata, src_tp, kernreq, errmode, ectx);
+        if (chain_offset != 0) {
+            return chain_offset;
+        }
+
         const base_expression_type *src_bed = static_cast<const base_expression_type *>(src_tp.extended());
         if (dst_tp == src_bed->get_value_type()) {
             // In this case, it's just a chain of operand -> value on the src side
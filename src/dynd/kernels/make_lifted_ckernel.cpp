@@ -8,11 +8,32 @@
 #include <dynd/types/strided_dim_type.hpp>
 #include <dynd/types/fixed_dim_type.hpp>
 #include <dynd/types/var_dim_type.hpp>
+#include <dynd/types/offset_dim_type.hpp>
 #include <dynd/kernels/expr_kernel_generator.hpp>
+#include <dynd/shape_tools.hpp>
 
 using namespace std;
 using namespace dynd;
 
+/**
+ * Returns the error for a lifted expression which none of the
+ * kernels below can process.
+ */
+static runtime_error cannot_lift_error(const ndt::type& dst_tp,
+                intptr_t src_count, const ndt::type *src_tp)
+{
+    stringstream ss;
+    ss << "Cannot process lifted elwise expression from (";
+    for (intptr_t i = 0; i < src_count; ++i) {
+        ss << src_tp[i];
+        if (i != src_count - 1) {
+            ss << ", ";
+        }
+    }
+    ss << ") to " << dst_tp;
+    return runtime_error(ss.str());
+}
+
 ////////////////////////////////////////////////////////////////////
 // make_elwise_strided_dimension_expr_kernel
 
@@ -77,94 +98,117 @@ template<int N>
 static size_t make_elwise_strided_dimension_expr_kernel_for_N(
                 ckernel_builder *out_ckb, size_t ckb_offset,
                 const ndt::type& dst_tp, const char *dst_metadata,
-                size_t DYND_UNUSED(src_count), const ndt::type *src_tp, const char *const*src_metadata,
+                size_t src_count, const ndt::type *src_tp, const char *const*src_metadata,
                 kernel_request_t kernreq,
                 const ckernel_deferred *elwise_handler)
 {
-    intptr_t undim = dst_tp.get_ndim();
+    intptr_t max_ndim = dst_tp.get_ndim(), ndim = 0;
     const char *child_metadata[N+1];
     ndt::type child_tp[N+1];
-    intptr_t ckb_child_offset = ckb_offset + sizeof(strided_expr_kernel_extra<N>);
-    
-    out_ckb->ensure_capacity(ckb_offset + sizeof(strided_expr_kernel_extra<N>));
-    strided_expr_kernel_extra<N> *e = out_ckb->get_at<strided_expr_kernel_extra<N> >(ckb_offset);
-    switch (kernreq) {
-        case kernel_request_single:
-            e->base.template set_function<expr_single_operation_t>(&strided_expr_kernel_extra<N>::single);
+    dimvector shape(max_ndim), strides_storage((N+1) * max_ndim);
+    intptr_t *strides[N+1];
+    child_tp[0] = dst_tp;
+    child_metadata[0] = dst_metadata;
+    strides[0] = strides_storage.get();
+    for (int i = 0; i < N; ++i) {
+        child_tp[i + 1] = src_tp[i];
+        child_metadata[i + 1] = src_metadata[i];
+        strides[i + 1] = strides_storage.get() + (i + 1) * max_ndim;
+    }
+
+    // Gather the strided dimensions until the types match the elementwise
+    // handler, or one of the operands doesn't have a strided dimension
+    bool types_match = false;
+    while (!types_match && ndim < max_ndim) {
+        const char *next_metadata[N+1];
+        ndt::type next_tp[N+1];
+        intptr_t size, src_size;
+        // The dst strided parameters
+        if (!get_strided_dim_params(child_tp[0], child_metadata[0],
+                        size, strides[0][ndim], next_tp[0], next_metadata[0])) {
             break;
-        case kernel_request_strided:
-            e->base.template set_function<expr_strided_operation_t>(&strided_expr_kernel_extra<N>::strided);
+        }
+        int i = 0;
+        for (; i < N; ++i) {
+            // The src[i] strided parameters
+            if (child_tp[i + 1].get_ndim() < child_tp[0].get_ndim()) {
+                // This src value is getting broadcasted
+                strides[i + 1][ndim] = 0;
+                next_metadata[i + 1] = child_metadata[i + 1];
+                next_tp[i + 1] = child_tp[i + 1];
+            } else if (get_strided_dim_params(child_tp[i + 1], child_metadata[i + 1],
+                            src_size, strides[i + 1][ndim], next_tp[i + 1], next_metadata[i + 1])) {
+                if (src_size != size) {
+                    // Check for a broadcasting error
+                    if (src_size != 1) {
+                        throw broadcast_error(dst_tp, dst_metadata, src_tp[i], src_metadata[i]);
+                    }
+                    strides[i + 1][ndim] = 0;
+                }
+            } else {
+                break;
+            }
+        }
+        if (i != N) {
             break;
-        default: {
-            stringstream ss;
-            ss << "make_elwise_strided_dimension_expr_kernel: unrecognized request " << (int)kernreq;
-            throw runtime_error(ss.str());
         }
-    }
-    e->base.destructor = strided_expr_kernel_extra<N>::destruct;
-    // The dst strided parameters
-    if (dst_tp.get_type_id() == strided_dim_type_id) {
-        const strided_dim_type *sdd = static_cast<const strided_dim_type *>(dst_tp.extended());
-        const strided_dim_type_metadata *dst_md =
-                        reinterpret_cast<const strided_dim_type_metadata *>(dst_metadata);
-        e->size = dst_md->size;
-        e->dst_stride = dst_md->stride;
-        child_metadata[0] = dst_metadata + sizeof(strided_dim_type_metadata);
-        child_tp[0] = sdd->get_element_type();
-    } else {
-        const fixed_dim_type *fdd = static_cast<const fixed_dim_type *>(dst_tp.extended());
-        e->size = fdd->get_fixed_dim_size();
-        e->dst_stride = fdd->get_fixed_stride();
-        child_metadata[0] = dst_metadata;
-        child_tp[0] = fdd->get_element_type();
-    }
-    for (int i = 0; i < N; ++i) {
-        // The src[i] strided parameters
-        if (src_tp[i].get_ndim() < undim) {
-            // This src value is getting broadcasted
-            e->src_stride[i] = 0;
-            child_metadata[i + 1] = src_metadata[i];
-            child_tp[i + 1] = src_tp[i];
-        } else if (src_tp[i].get_type_id() == strided_dim_type_id) {
-            const strided_dim_type *sdd = static_cast<const strided_dim_type *>(src_tp[i].extended());
-            const strided_dim_type_metadata *src_md =
-                            reinterpret_cast<const strided_dim_type_metadata *>(src_metadata[i]);
-            // Check for a broadcasting error
-            if (src_md->size != 1 && e->size != src_md->size) {
-                throw broadcast_error(dst_tp, dst_metadata, src_tp[i], src_metadata[i]);
+        shape[ndim] = size;
+        ++ndim;
+        types_match = true;
+        for (i = 0; i < N + 1; ++i) {
+            child_tp[i].swap(next_tp[i]);
+            child_metadata[i] = next_metadata[i];
+            if (child_tp[i] != elwise_handler->data_dynd_types[i]) {
+                types_match = false;
             }
-            // In DyND, the src stride is required to be zero for size-one dimensions,
-            // so we don't have to check the size here.
-            e->src_stride[i] = src_md->stride;
-            child_metadata[i + 1] = src_metadata[i] + sizeof(strided_dim_type_metadata);
-            child_tp[i + 1] = sdd->get_element_type();
-        } else {
-            const fixed_dim_type *fdd = static_cast<const fixed_dim_type *>(src_tp[i].extended());
-            // Check for a broadcasting error
-            if (fdd->get_fixed_dim_size() != 1 && (size_t)e->size != fdd->get_fixed_dim_size()) {
-                throw broadcast_error(dst_tp, dst_metadata, src_tp[i], src_metadata[i]);
+        }
+    }
+
+    // Merge and reorder the dimensions, then create one kernel level for each
+    optimize_strided_dims(ndim, shape.get(), N + 1, strides);
+    for (intptr_t j = 0; j < ndim; ++j) {
+        out_ckb->ensure_capacity(ckb_offset + sizeof(strided_expr_kernel_extra<N>));
+        strided_expr_kernel_extra<N> *e = out_ckb->get_at<strided_expr_kernel_extra<N> >(ckb_offset);
+        switch (j == 0 ? kernreq : kernel_request_strided) {
+            case kernel_request_single:
+                e->base.template set_function<expr_single_operation_t>(&strided_expr_kernel_extra<N>::single);
+                break;
+            case kernel_request_strided:
+                e->base.template set_function<expr_strided_operation_t>(&strided_expr_kernel_extra<N>::strided);
+                break;
+            default: {
+                stringstream ss;
+                ss << "make_elwise_strided_dimension_expr_kernel: unrecognized request " << (int)kernreq;
+                throw runtime_error(ss.str());
             }
-            // In DyND, the src stride is required to be zero for size-one dimensions,
-            // so we don't have to check the size here.
-            e->src_stride[i] = fdd->get_fixed_stride();
-            child_metadata[i + 1] = src_metadata[i];
-            child_tp[i + 1] = fdd->get_element_type();
         }
+        e->base.destructor = strided_expr_kernel_extra<N>::destruct;
+        e->size = shape[j];
+        e->dst_stride = strides[0][j];
+        for (int i = 0; i < N; ++i) {
+            e->src_stride[i] = strides[i + 1][j];
+        }
+        ckb_offset += sizeof(strided_expr_kernel_extra<N>);
     }
+    kernel_request_t child_kernreq = (ndim == 0) ? kernreq : kernel_request_strided;
+
     // If any of the types don't match, continue broadcasting the dimensions
-    for (intptr_t i = 0; i < N + 1; ++i) {
-        if (child_tp[i] != elwise_handler->data_dynd_types[i]) {
-            return make_lifted_expr_ckernel(elwise_handler,
-                            out_ckb, ckb_child_offset,
-                            child_tp, child_metadata,
-                            kernel_request_strided);
+    if (!types_match) {
+        if (ndim == 0) {
+            // No dimension was consumed, so lifting the same types
+            // again would never terminate
+            throw cannot_lift_error(dst_tp, src_count, src_tp);
         }
+        return make_lifted_expr_ckernel(elwise_handler,
+                        out_ckb, ckb_offset,
+                        child_tp, child_metadata,
+                        child_kernreq);
     }
     // All the types matched, so instantiate the elementwise handler
     return elwise_handler->instantiate_func(
                     elwise_handler->data_ptr,
-                    out_ckb, ckb_child_offset,
-                    child_metadata, kernel_request_strided);
+                    out_ckb, ckb_offset,
+                    child_metadata, child_kernreq);
 }
 
 inline static size_t make_elwise_strided_dimension_expr_kernel(
@@ -221,9 +265,28 @@ inline static size_t make_elwise_strided_dimension_expr_kernel(
 
 namespace {
 
+/**
+ * Gets the data and size of an element of a src dimension whose size
+ * varies per element, which is either a var_dim or an offset_dim.
+ */
+inline intptr_t get_var_or_offset_src_dim(const char *src, bool is_offset, const char *values,
+                intptr_t offset, intptr_t stride, const char *&out_begin)
+{
+    if (is_offset) {
+        out_begin = values + reinterpret_cast<const intptr_t *>(src)[0] * stride;
+        return offset_dim_element_size(src);
+    } else {
+        const var_dim_type_data *vddd = reinterpret_cast<const var_dim_type_data *>(src);
+        out_begin = vddd->begin + offset;
+        return vddd->size;
+    }
+}
+
 /**
  * Generic expr kernel + destructor for a strided/var dimensions with
- * a fixed number of src operands, outputing to a strided dimension.
+ * a fixed number of src operands, outputing to a strided dimension,
+ * or to an offset dimension, whose rows are treated as strided
+ * dimensions of varying size.
  * This requires that the child kernel be created with the
  * kernel_request_strided type of kernel.
  */
@@ -233,8 +296,10 @@ struct strided_or_var_to_strided_expr_kernel_extra {
 
     ckernel_prefix base;
     intptr_t size;
-    intptr_t dst_stride, src_stride[N], src_offset[N];
-    bool is_src_var[N];
+    intptr_t dst_stride, src_stride[N], src_offset[N], src_size[N];
+    char *dst_values;
+    const char *src_values[N];
+    bool is_dst_offset, is_src_var[N], is_src_offset[N];
 
     static void single(char *dst, const char * const *src,
                     ckernel_prefix *extra)
@@ -242,23 +307,32 @@ struct strided_or_var_to_strided_expr_kernel_extra {
         extra_type *e = reinterpret_cast<extra_type *>(extra);
         ckernel_prefix *echild = &(e + 1)->base;
         expr_strided_operation_t opchild = echild->get_function<expr_strided_operation_t>();
-        // Broadcast all the src 'var' dimensions to dst
         intptr_t dim_size = e->size;
+        if (e->is_dst_offset) {
+            dim_size = offset_dim_element_size(dst);
+            dst = e->dst_values + reinterpret_cast<const intptr_t *>(dst)[0] * e->dst_stride;
+        }
+        // Broadcast all the src 'var' dimensions to dst
         const char *modified_src[N];
         intptr_t modified_src_stride[N];
         for (int i = 0; i < N; ++i) {
             if (e->is_src_var[i]) {
-                const var_dim_type_data *vddd = reinterpret_cast<const var_dim_type_data *>(src[i]);
-                modified_src[i] = vddd->begin + e->src_offset[i];
-                if (vddd->size == 1) {
+                intptr_t src_dim_size = get_var_or_offset_src_dim(src[i], e->is_src_offset[i],
+                                e->src_values[i], e->src_offset[i], e->src_stride[i], modified_src[i]);
+                if (src_dim_size == 1) {
                     modified_src_stride[i] = 0;
-                } else if (vddd->size == static_cast<size_t>(dim_size)) {
+                } else if (src_dim_size == dim_size) {
                     modified_src_stride[i] = e->src_stride[i];
                 } else {
-                    throw broadcast_error(dim_size, vddd->size, "strided", "var");
+                    throw broadcast_error(dim_size, src_dim_size, "strided",
+                                    e->is_src_offset[i] ? "offset" : "var");
                 }
             } else {
-                // strided dimensions were fully broadcast in the kernel factory
+                // strided dimensions were fully broadcast in the kernel factory,
+                // except against the rows of an offset dst
+                if (e->is_dst_offset && e->src_size[i] != 1 && e->src_size[i] != dim_size) {
+                    throw broadcast_error(dim_size, e->src_size[i], "offset", "strided");
+                }
                 modified_src[i] = src[i];
                 modified_src_stride[i] = e->src_stride[i];
             }
@@ -324,6 +398,8 @@ static size_t make_elwise_strided_or_var_to_strided_dimension_expr_kernel_for_N(
     }
     e->base.destructor = strided_or_var_to_strided_expr_kernel_extra<N>::destruct;
     // The dst strided parameters
+    e->is_dst_offset = false;
+    e->dst_values = NULL;
     if (dst_tp.get_type_id() == strided_dim_type_id) {
         const strided_dim_type *sdd = static_cast<const strided_dim_type *>(dst_tp.extended());
         const strided_dim_type_metadata *dst_md =
@@ -332,6 +408,17 @@ static size_t make_elwise_strided_or_var_to_strided_dimension_expr_kernel_for_N(
         e->dst_stride = dst_md->stride;
         child_metadata[0] = dst_metadata + sizeof(strided_dim_type_metadata);
         child_tp[0] = sdd->get_element_type();
+    } else if (dst_tp.get_type_id() == offset_dim_type_id) {
+        // The size is that of each row, so it's only known in the kernel
+        const offset_dim_type *odd = static_cast<const offset_dim_type *>(dst_tp.extended());
+        const offset_dim_type_metadata *dst_md =
+                        reinterpret_cast<const offset_dim_type_metadata *>(dst_metadata);
+        e->size = -1;
+        e->dst_stride = dst_md->stride;
+        e->dst_values = dst_md->values;
+        e->is_dst_offset = true;
+        child_metadata[0] = dst_metadata + sizeof(offset_dim_type_metadata);
+        child_tp[0] = odd->get_element_type();
     } else {
         const fixed_dim_type *fdd = static_cast<const fixed_dim_type *>(dst_tp.extended());
         e->size = fdd->get_fixed_dim_size();
@@ -345,7 +432,10 @@ static size_t make_elwise_strided_or_var_to_strided_dimension_expr_kernel_for_N(
             // This src value is getting broadcasted
             e->src_stride[i] = 0;
             e->src_offset[i] = 0;
+            e->src_size[i] = 1;
             e->is_src_var[i] = false;
+            e->is_src_offset[i] = false;
+            e->src_values[i] = NULL;
             child_metadata[i + 1] = src_metadata[i];
             child_tp[i + 1] = src_tp[i];
         } else if (src_tp[i].get_type_id() == strided_dim_type_id) {
@@ -353,36 +443,58 @@ static size_t make_elwise_strided_or_var_to_strided_dimension_expr_kernel_for_N(
             const strided_dim_type_metadata *src_md =
                             reinterpret_cast<const strided_dim_type_metadata *>(src_metadata[i]);
             // Check for a broadcasting error
-            if (src_md->size != 1 && e->size != src_md->size) {
+            if (src_md->size != 1 && !e->is_dst_offset && e->size != src_md->size) {
                 throw broadcast_error(dst_tp, dst_metadata, src_tp[i], src_metadata[i]);
             }
             // In DyND, the src stride is required to be zero for size-one dimensions,
             // so we don't have to check the size here.
             e->src_stride[i] = src_md->stride;
             e->src_offset[i] = 0;
+            e->src_size[i] = src_md->size;
             e->is_src_var[i] = false;
+            e->is_src_offset[i] = false;
+            e->src_values[i] = NULL;
             child_metadata[i + 1] = src_metadata[i] + sizeof(strided_dim_type_metadata);
             child_tp[i + 1] = sdd->get_element_type();
         } else if (src_tp[i].get_type_id() == fixed_dim_type_id) {
             const fixed_dim_type *fdd = static_cast<const fixed_dim_type *>(src_tp[i].extended());
             // Check for a broadcasting error
-            if (fdd->get_fixed_dim_size() != 1 && (size_t)e->size != fdd->get_fixed_dim_size()) {
+            if (fdd->get_fixed_dim_size() != 1 && !e->is_dst_offset &&
+                            (size_t)e->size != fdd->get_fixed_dim_size()) {
                 throw broadcast_error(dst_tp, dst_metadata, src_tp[i], src_metadata[i]);
             }
             // In DyND, the src stride is required to be zero for size-one dimensions,
             // so we don't have to check the size here.
             e->src_stride[i] = fdd->get_fixed_stride();
             e->src_offset[i] = 0;
+            e->src_size[i] = fdd->get_fixed_dim_size();
             e->is_src_var[i] = false;
+            e->is_src_offset[i] = false;
+            e->src_values[i] = NULL;
             child_metadata[i + 1] = src_metadata[i];
             child_tp[i + 1] = fdd->get_element_type();
+        } else if (src_tp[i].get_type_id() == offset_dim_type_id) {
+            const offset_dim_type *odd = static_cast<const offset_dim_type *>(src_tp[i].extended());
+            const offset_dim_type_metadata *src_md =
+                            reinterpret_cast<const offset_dim_type_metadata *>(src_metadata[i]);
+            e->src_stride[i] = src_md->stride;
+            e->src_offset[i] = 0;
+            e->src_size[i] = -1;
+            e->src_values[i] = src_md->values;
+            e->is_src_var[i] = true;
+            e->is_src_offset[i] = true;
+            child_metadata[i + 1] = src_metadata[i] + sizeof(offset_dim_type_metadata);
+            child_tp[i + 1] = odd->get_element_type();
         } else {
             const var_dim_type *vdd = static_cast<const var_dim_type *>(src_tp[i].extended());
             const var_dim_type_metadata *src_md =
                             reinterpret_cast<const var_dim_type_metadata *>(src_metadata[i]);
             e->src_stride[i] = src_md->stride;
             e->src_offset[i] = src_md->offset;
+            e->src_size[i] = -1;
             e->is_src_var[i] = true;
+            e->is_src_offset[i] = false;
+            e->src_values[i] = NULL;
             child_metadata[i + 1] = src_metadata[i] + sizeof(var_dim_type_metadata);
             child_tp[i + 1] = vdd->get_element_type();
         }
@@ -472,7 +584,8 @@ struct strided_or_var_to_var_expr_kernel_extra {
     memory_block_data *dst_memblock;
     size_t dst_target_alignment;
     intptr_t dst_stride, dst_offset, src_stride[N], src_offset[N], src_size[N];
-    bool is_src_var[N];
+    const char *src_values[N];
+    bool is_src_var[N], is_src_offset[N];
 
     static void single(char *dst, const char * const *src,
                     ckernel_prefix *extra)
@@ -493,14 +606,15 @@ struct strided_or_var_to_var_expr_kernel_extra {
             dim_size = dst_vddd->size;
             for (int i = 0; i < N; ++i) {
                 if (e->is_src_var[i]) {
-                    const var_dim_type_data *vddd = reinterpret_cast<const var_dim_type_data *>(src[i]);
-                    modified_src[i] = vddd->begin + e->src_offset[i];
-                    if (vddd->size == 1) {
+                    intptr_t src_dim_size = get_var_or_offset_src_dim(src[i], e->is_src_offset[i],
+                                    e->src_values[i], e->src_offset[i], e->src_stride[i], modified_src[i]);
+                    if (src_dim_size == 1) {
                         modified_src_stride[i] = 0;
-                    } else if (vddd->size == static_cast<size_t>(dim_size)) {
+                    } else if (src_dim_size == dim_size) {
                         modified_src_stride[i] = e->src_stride[i];
                     } else {
-                        throw broadcast_error(dim_size, vddd->size, "var", "var");
+                        throw broadcast_error(dim_size, src_dim_size, "var",
+                                        e->is_src_offset[i] ? "offset" : "var");
                     }
                 } else {
                     modified_src[i] = src[i];
@@ -521,17 +635,18 @@ struct strided_or_var_to_var_expr_kernel_extra {
             dim_size = 1;
             for (int i = 0; i < N; ++i) {
                 if (e->is_src_var[i]) {
-                    const var_dim_type_data *vddd = reinterpret_cast<const var_dim_type_data *>(src[i]);
-                    modified_src[i] = vddd->begin + e->src_offset[i];
-                    if (vddd->size == 1) {
+                    intptr_t src_dim_size = get_var_or_offset_src_dim(src[i], e->is_src_offset[i],
+                                    e->src_values[i], e->src_offset[i], e->src_stride[i], modified_src[i]);
+                    if (src_dim_size == 1) {
                         modified_src_stride[i] = 0;
                     } else if (dim_size == 1) {
-                        dim_size = vddd->size;
+                        dim_size = src_dim_size;
                         modified_src_stride[i] = e->src_stride[i];
-                    } else if (vddd->size == static_cast<size_t>(dim_size)) {
+                    } else if (src_dim_size == dim_size) {
                         modified_src_stride[i] = e->src_stride[i];
                     } else {
-                        throw broadcast_error(dim_size, vddd->size, "var", "var");
+                        throw broadcast_error(dim_size, src_dim_size, "var",
+                                        e->is_src_offset[i] ? "offset" : "var");
                     }
                 } else {
                     modified_src[i] = src[i];
@@ -653,6 +768,8 @@ static size_t make_elwise_strided_or_var_to_var_dimension_expr_kernel_for_N(
             e->src_offset[i] = 0;
             e->src_size[i] = 1;
             e->is_src_var[i] = false;
+            e->is_src_offset[i] = false;
+            e->src_values[i] = NULL;
             child_metadata[i + 1] = src_metadata[i];
             child_tp[i + 1] = src_tp[i];
         } else if (src_tp[i].get_type_id() == strided_dim_type_id) {
@@ -665,6 +782,8 @@ static size_t make_elwise_strided_or_var_to_var_dimension_expr_kernel_for_N(
             e->src_offset[i] = 0;
             e->src_size[i] = src_md->size;
             e->is_src_var[i] = false;
+            e->is_src_offset[i] = false;
+            e->src_values[i] = NULL;
             child_metadata[i + 1] = src_metadata[i] + sizeof(strided_dim_type_metadata);
             child_tp[i + 1] = sdd->get_element_type();
         } else if (src_tp[i].get_type_id() == fixed_dim_type_id) {
@@ -675,8 +794,21 @@ static size_t make_elwise_strided_or_var_to_var_dimension_expr_kernel_for_N(
             e->src_offset[i] = 0;
             e->src_size[i] = fdd->get_fixed_dim_size();
             e->is_src_var[i] = false;
+            e->is_src_offset[i] = false;
+            e->src_values[i] = NULL;
             child_metadata[i + 1] = src_metadata[i];
             child_tp[i + 1] = fdd->get_element_type();
+        } else if (src_tp[i].get_type_id() == offset_dim_type_id) {
+            const offset_dim_type *odd = static_cast<const offset_dim_type *>(src_tp[i].extended());
+            const offset_dim_type_metadata *src_md =
+                            reinterpret_cast<const offset_dim_type_metadata *>(src_metadata[i]);
+            e->src_stride[i] = src_md->stride;
+            e->src_offset[i] = 0;
+            e->src_values[i] = src_md->values;
+            e->is_src_var[i] = true;
+            e->is_src_offset[i] = true;
+            child_metadata[i + 1] = src_metadata[i] + sizeof(offset_dim_type_metadata);
+            child_tp[i + 1] = odd->get_element_type();
         } else {
             const var_dim_type *vdd = static_cast<const var_dim_type *>(src_tp[i].extended());
             const var_dim_type_metadata *src_md =
@@ -684,6 +816,8 @@ static size_t make_elwise_strided_or_var_to_var_dimension_expr_kernel_for_N(
             e->src_stride[i] = src_md->stride;
             e->src_offset[i] = src_md->offset;
             e->is_src_var[i] = true;
+            e->is_src_offset[i] = false;
+            e->src_values[i] = NULL;
             child_metadata[i + 1] = src_metadata[i] + sizeof(var_dim_type_metadata);
             child_tp[i + 1] = vdd->get_element_type();
         }
@@ -771,6 +905,7 @@ size_t dynd::make_lifted_expr_ckernel(const ckernel_deferred *elwise_handler,
             case strided_dim_type_id:
             case fixed_dim_type_id:
                 break;
+            case offset_dim_type_id:
             case var_dim_type_id:
                 src_all_strided = false;
                 break;
@@ -778,6 +913,7 @@ size_t dynd::make_lifted_expr_ckernel(const ckernel_deferred *elwise_handler,
                 // If it's a scalar, allow it to broadcast like
                 // a strided dimension
                 if (src_tp[i].get_ndim() > 0) {
+                    src_all_strided = false;
                     src_all_strided_or_var = false;
                 }
                 break;
@@ -817,20 +953,18 @@ size_t dynd::make_lifted_expr_ckernel(const ckernel_deferred *elwise_handler,
             }
             break;
         case offset_dim_type_id:
-            // TODO
+            // The rows of an offset dst are filled like strided dimensions
+            if (src_all_strided_or_var) {
+                return make_elwise_strided_or_var_to_strided_dimension_expr_kernel(
+                                out_ckb, ckb_offset,
+                                dst_tp, dst_metadata,
+                                src_count, src_tp, src_metadata,
+                                kernreq, elwise_handler);
+            }
             break;
         default:
             break;
     }
 
-    stringstream ss;
-    ss << "Cannot process lifted elwise expression from (";
-    for (intptr_t i = 0; i < src_count; ++i) {
-        ss << src_tp[i];
-        if (i != src_count - 1) {
-            ss << ", ";
-        }
-    }
-    ss << ") to " << dst_tp;
-    throw runtime_error(ss.str());
+    throw cannot_lift_error(dst_tp, src_count, src_tp);
 }
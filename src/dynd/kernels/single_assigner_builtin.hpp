@@ -1189,4 +1189,176 @@ struct single_assigner_builtin<same_type, same_type, errmode>
     }
 };
 
+// Branch-free range checks, used by the strided assignment kernels to
+// validate a whole block of values before converting it without checks.
+// A check may reject values which single_assigner_builtin accepts, as a
+// rejected block is redone one value at a time with the checked
+// assignment, but it must never accept a value which would raise an error.
+template<class T>
+struct block_range_check_native {
+    enum { value = false };
+};
+template<> struct block_range_check_native<int8_t> {enum { value = true };};
+template<> struct block_range_check_native<int16_t> {enum { value = true };};
+template<> struct block_range_check_native<int32_t> {enum { value = true };};
+template<> struct block_range_check_native<int64_t> {enum { value = true };};
+template<> struct block_range_check_native<uint8_t> {enum { value = true };};
+template<> struct block_range_check_native<uint16_t> {enum { value = true };};
+template<> struct block_range_check_native<uint32_t> {enum { value = true };};
+template<> struct block_range_check_native<uint64_t> {enum { value = true };};
+template<> struct block_range_check_native<float> {enum { value = true };};
+template<> struct block_range_check_native<double> {enum { value = true };};
+
+template<class dst_type, class src_type, type_kind_t dst_kind, type_kind_t src_kind, assign_error_mode errmode>
+struct block_range_checker_builtin_base {
+    enum { enabled = false };
+};
+
+// Signed int -> signed int
+template<class dst_type, class src_type>
+struct block_range_checker_builtin_base<dst_type, src_type, int_kind, int_kind, assign_error_overflow> {
+    enum { enabled = sizeof(dst_type) < sizeof(src_type) };
+    static bool out_of_range(src_type s) {
+        return (s < static_cast<src_type>(std::numeric_limits<dst_type>::min())) |
+                        (static_cast<src_type>(std::numeric_limits<dst_type>::max()) < s);
+    }
+};
+template<class dst_type, class src_type>
+struct block_range_checker_builtin_base<dst_type, src_type, int_kind, int_kind, assign_error_fractional>
+    : public block_range_checker_builtin_base<dst_type, src_type, int_kind, int_kind, assign_error_overflow> {};
+template<class dst_type, class src_type>
+struct block_range_checker_builtin_base<dst_type, src_type, int_kind, int_kind, assign_error_inexact>
+    : public block_range_checker_builtin_base<dst_type, src_type, int_kind, int_kind, assign_error_overflow> {};
+
+// Unsigned int -> signed int
+template<class dst_type, class src_type>
+struct block_range_checker_builtin_base<dst_type, src_type, int_kind, uint_kind, assign_error_overflow> {
+    enum { enabled = sizeof(dst_type) <= sizeof(src_type) };
+    static bool out_of_range(src_type s) {
+        return static_cast<src_type>(std::numeric_limits<dst_type>::max()) < s;
+    }
+};
+template<class dst_type, class src_type>
+struct block_range_checker_builtin_base<dst_type, src_type, int_kind, uint_kind, assign_error_fractional>
+    : public block_range_checker_builtin_base<dst_type, src_type, int_kind, uint_kind, assign_error_overflow> {};
+template<class dst_type, class src_type>
+struct block_range_checker_builtin_base<dst_type, src_type, int_kind, uint_kind, assign_error_inexact>
+    : public block_range_checker_builtin_base<dst_type, src_type, int_kind, uint_kind, assign_error_overflow> {};
+
+// Signed int -> unsigned int
+template<class dst_type, class src_type>
+struct block_range_checker_builtin_base<dst_type, src_type, uint_kind, int_kind, assign_error_overflow> {
+    enum { enabled = true };
+    static bool out_of_range(src_type s) {
+        if (sizeof(dst_type) < sizeof(src_type)) {
+            return (s < src_type(0)) |
+                        (static_cast<src_type>(std::numeric_limits<dst_type>::max()) < s);
+        } else {
+            return s < src_type(0);
+        }
+    }
+};
+template<class dst_type, class src_type>
+struct block_range_checker_builtin_base<dst_type, src_type, uint_kind, int_kind, assign_error_fractional>
+    : public block_range_checker_builtin_base<dst_type, src_type, uint_kind, int_kind, assign_error_overflow> {};
+template<class dst_type, class src_type>
+struct block_range_checker_builtin_base<dst_type, src_type, uint_kind, int_kind, assign_error_inexact>
+    : public block_range_checker_builtin_base<dst_type, src_type, uint_kind, int_kind, assign_error_overflow> {};
+
+// Unsigned int -> unsigned int
+template<class dst_type, class src_type>
+struct block_range_checker_builtin_base<dst_type, src_type, uint_kind, uint_kind, assign_error_overflow> {
+    enum { enabled = sizeof(dst_type) < sizeof(src_type) };
+    static bool out_of_range(src_type s) {
+        return static_cast<src_type>(std::numeric_limits<dst_type>::max()) < s;
+    }
+};
+template<class dst_type, class src_type>
+struct block_range_checker_builtin_base<dst_type, src_type, uint_kind, uint_kind, assign_error_fractional>
+    : public block_range_checker_builtin_base<dst_type, src_type, uint_kind, uint_kind, assign_error_overflow> {};
+template<class dst_type, class src_type>
+struct block_range_checker_builtin_base<dst_type, src_type, uint_kind, uint_kind, assign_error_inexact>
+    : public block_range_checker_builtin_base<dst_type, src_type, uint_kind, uint_kind, assign_error_overflow> {};
+
+// Floating point -> signed int
+template<class dst_type, class src_type>
+struct block_range_checker_builtin_base<dst_type, src_type, int_kind, real_kind, assign_error_overflow> {
+    enum { enabled = true };
+    static bool out_of_range(src_type s) {
+        return (s < std::numeric_limits<dst_type>::min()) | (std::numeric_limits<dst_type>::max() < s);
+    }
+};
+template<class dst_type, class src_type>
+struct block_range_checker_builtin_base<dst_type, src_type, int_kind, real_kind, assign_error_fractional> {
+    enum { enabled = true };
+    static bool out_of_range(src_type s) {
+        return (s < std::numeric_limits<dst_type>::min()) | (std::numeric_limits<dst_type>::max() < s) |
+                        (std::floor(s) != s);
+    }
+};
+template<class dst_type, class src_type>
+struct block_range_checker_builtin_base<dst_type, src_type, int_kind, real_kind, assign_error_inexact>
+    : public block_range_checker_builtin_base<dst_type, src_type, int_kind, real_kind, assign_error_fractional> {};
+
+// Floating point -> unsigned int
+template<class dst_type, class src_type>
+struct block_range_checker_builtin_base<dst_type, src_type, uint_kind, real_kind, assign_error_overflow> {
+    enum { enabled = true };
+    static bool out_of_range(src_type s) {
+        return (s < 0) | (std::numeric_limits<dst_type>::max() < s);
+    }
+};
+template<class dst_type, class src_type>
+struct block_range_checker_builtin_base<dst_type, src_type, uint_kind, real_kind, assign_error_fractional> {
+    enum { enabled = true };
+    static bool out_of_range(src_type s) {
+        return (s < 0) | (std::numeric_limits<dst_type>::max() < s) | (std::floor(s) != s);
+    }
+};
+template<class dst_type, class src_type>
+struct block_range_checker_builtin_base<dst_type, src_type, uint_kind, real_kind, assign_error_inexact>
+    : public block_range_checker_builtin_base<dst_type, src_type, uint_kind, real_kind, assign_error_fractional> {};
+
+// double -> float, rejecting infinities and NaN as well as overflow
+template<>
+struct block_range_checker_builtin_base<float, double, real_kind, real_kind, assign_error_overflow> {
+    enum { enabled = true };
+    static bool out_of_range(double s) {
+        return !((-std::numeric_limits<float>::max() <= s) & (s <= std::numeric_limits<float>::max()));
+    }
+};
+template<>
+struct block_range_checker_builtin_base<float, double, real_kind, real_kind, assign_error_fractional>
+    : public block_range_checker_builtin_base<float, double, real_kind, real_kind, assign_error_overflow> {};
+template<>
+struct block_range_checker_builtin_base<float, double, real_kind, real_kind, assign_error_inexact> {
+    enum { enabled = true };
+    static bool out_of_range(double s) {
+        return !((-std::numeric_limits<float>::max() <= s) & (s <= std::numeric_limits<float>::max())) |
+                        (static_cast<double>(static_cast<float>(s)) != s);
+    }
+};
+
+/**
+ * The block range check for an assignment. When `enabled` is true,
+ * `out_of_range(s)` returns true for any value which can't be assigned
+ * with the requested error checking.
+ */
+template <class dst_type, class src_type, assign_error_mode errmode>
+struct block_range_checker_builtin
+    : public block_range_checker_builtin_base<dst_type, src_type,
+                        dynd_kind_of<dst_type>::value, dynd_kind_of<src_type>::value, errmode>
+{
+    enum {
+        enabled = block_range_check_native<dst_type>::value && block_range_check_native<src_type>::value &&
+            block_range_checker_builtin_base<dst_type, src_type,
+                        dynd_kind_of<dst_type>::value, dynd_kind_of<src_type>::value, errmode>::enabled
+    };
+};
+template <class same_type, assign_error_mode errmode>
+struct block_range_checker_builtin<same_type, same_type, errmode>
+{
+    enum { enabled = false };
+};
+
 } // namespace dynd
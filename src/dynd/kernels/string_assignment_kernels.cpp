@@ -9,7 +9,14 @@
 #include <dynd/type.hpp>
 #include <dynd/diagnostics.hpp>
 #include <dynd/kernels/string_assignment_kernels.hpp>
+#include <dynd/kernels/ckernel_debug_info.hpp>
 #include <dynd/types/string_type.hpp>
+#include <dynd/types/packed_string_type.hpp>
+#include <dynd/types/small_string_type.hpp>
+#include <dynd/memblock/pod_memory_block.hpp>
+#include <dynd/memblock/contiguous_memory_block.hpp>
+
+#include <limits>
 
 using namespace std;
 using namespace dynd;
@@ -66,10 +73,9 @@ size_t dynd::make_fixedstring_assignment_kernel(
                 kernel_request_t kernreq, assign_error_mode errmode,
                 const eval::eval_context *DYND_UNUSED(ectx))
 {
-    offset_out = make_kernreq_to_single_kernel_adapter(out, offset_out, kernreq);
     out->ensure_capacity_leaf(offset_out + sizeof(fixedstring_assign_kernel_extra));
     fixedstring_assign_kernel_extra *e = out->get_at<fixedstring_assign_kernel_extra>(offset_out);
-    e->base.set_function<unary_single_operation_t>(&fixedstring_assign_kernel_extra::single);
+    set_unary_single_or_strided_function<&fixedstring_assign_kernel_extra::single>(&e->base, kernreq);
     e->next_fn = get_next_unicode_codepoint_function(src_encoding, errmode);
     e->append_fn = get_append_unicode_codepoint_function(dst_encoding, errmode);
     e->dst_data_size = dst_data_size;
@@ -164,10 +170,9 @@ size_t dynd::make_blockref_string_assignment_kernel(
                 kernel_request_t kernreq, assign_error_mode errmode,
                 const eval::eval_context *DYND_UNUSED(ectx))
 {
-    offset_out = make_kernreq_to_single_kernel_adapter(out, offset_out, kernreq);
     out->ensure_capacity_leaf(offset_out + sizeof(blockref_string_assign_kernel_extra));
     blockref_string_assign_kernel_extra *e = out->get_at<blockref_string_assign_kernel_extra>(offset_out);
-    e->base.set_function<unary_single_operation_t>(&blockref_string_assign_kernel_extra::single);
+    set_unary_single_or_strided_function<&blockref_string_assign_kernel_extra::single>(&e->base, kernreq);
     e->dst_encoding = dst_encoding;
     e->src_encoding = src_encoding;
     e->next_fn = get_next_unicode_codepoint_function(src_encoding, errmode);
@@ -254,18 +259,17 @@ size_t dynd::make_fixedstring_to_blockref_string_assignment_kernel(
                 kernel_request_t kernreq, assign_error_mode errmode,
                 const eval::eval_context *DYND_UNUSED(ectx))
 {
-    offset_out = make_kernreq_to_single_kernel_adapter(out, offset_out, kernreq);
-    out->ensure_capacity_leaf(offset_out + sizeof(blockref_string_assign_kernel_extra));
+    out->ensure_capacity_leaf(offset_out + sizeof(fixedstring_to_blockref_string_assign_kernel_extra));
     fixedstring_to_blockref_string_assign_kernel_extra *e =
                     out->get_at<fixedstring_to_blockref_string_assign_kernel_extra>(offset_out);
-    e->base.set_function<unary_single_operation_t>(&fixedstring_to_blockref_string_assign_kernel_extra::single);
+    set_unary_single_or_strided_function<&fixedstring_to_blockref_string_assign_kernel_extra::single>(&e->base, kernreq);
     e->dst_encoding = dst_encoding;
     e->src_encoding = src_encoding;
     e->src_element_size = src_element_size;
     e->next_fn = get_next_unicode_codepoint_function(src_encoding, errmode);
     e->append_fn = get_append_unicode_codepoint_function(dst_encoding, errmode);
     e->dst_metadata = reinterpret_cast<const string_type_metadata *>(dst_metadata);
-    return offset_out + sizeof(blockref_string_assign_kernel_extra);
+    return offset_out + sizeof(fixedstring_to_blockref_string_assign_kernel_extra);
 }
 
 /////////////////////////////////////////
@@ -315,13 +319,462 @@ size_t dynd::make_blockref_string_to_fixedstring_assignment_kernel(
                 kernel_request_t kernreq, assign_error_mode errmode,
                 const eval::eval_context *DYND_UNUSED(ectx))
 {
-    offset_out = make_kernreq_to_single_kernel_adapter(out, offset_out, kernreq);
     out->ensure_capacity_leaf(offset_out + sizeof(blockref_string_to_fixedstring_assign_kernel_extra));
     blockref_string_to_fixedstring_assign_kernel_extra *e = out->get_at<blockref_string_to_fixedstring_assign_kernel_extra>(offset_out);
-    e->base.set_function<unary_single_operation_t>(&blockref_string_to_fixedstring_assign_kernel_extra::single);
+    set_unary_single_or_strided_function<&blockref_string_to_fixedstring_assign_kernel_extra::single>(&e->base, kernreq);
     e->next_fn = get_next_unicode_codepoint_function(src_encoding, errmode);
     e->append_fn = get_append_unicode_codepoint_function(dst_encoding, errmode);
     e->dst_data_size = dst_data_size;
     e->overflow_check = (errmode != assign_error_none);
     return offset_out + sizeof(blockref_string_to_fixedstring_assign_kernel_extra);
 }
+
+/////////////////////////////////////////
+// any string to packed string assignment
+
+namespace {
+    template<class T>
+    struct to_packed_string_assign_kernel_extra {
+        typedef to_packed_string_assign_kernel_extra extra_type;
+
+        ckernel_prefix base;
+        const base_string_type *src_string_tp;
+        string_encoding_t dst_encoding, src_encoding;
+        next_unicode_codepoint_t next_fn;
+        append_unicode_codepoint_t append_fn;
+        const packed_string_type_metadata *dst_metadata;
+        const char *src_metadata;
+
+        static inline void set_offsets(char *dst, intptr_t begin, intptr_t end)
+        {
+            if (end > numeric_limits<T>::max()) {
+                throw runtime_error("The buffer of a packed string has grown too large for its offset type");
+            }
+            packed_string_type_data<T> *dst_d = reinterpret_cast<packed_string_type_data<T> *>(dst);
+            dst_d->begin = static_cast<T>(begin);
+            dst_d->end = static_cast<T>(end);
+        }
+
+        static void single(char *dst, const char *src,
+                        ckernel_prefix *extra)
+        {
+            extra_type *e = reinterpret_cast<extra_type *>(extra);
+            memory_block_data *dst_blockref = e->dst_metadata->blockref;
+            const base_string_type *src_tp = e->src_string_tp;
+            const char *src_begin, *src_end;
+
+            if (src_tp->get_type_id() == string_type_id) {
+                src_begin = reinterpret_cast<const string_type_data *>(src)->begin;
+                src_end = reinterpret_cast<const string_type_data *>(src)->end;
+            } else if (src_tp->get_type_id() == packed_string_type_id &&
+                            reinterpret_cast<const packed_string_type_metadata *>(
+                                e->src_metadata)->blockref == dst_blockref) {
+                // Strings already in the destination buffer are shared
+                if (e->dst_encoding != e->src_encoding) {
+                    throw runtime_error("Attempted to reference source data when changing string encoding");
+                }
+                intptr_t begin, end;
+                static_cast<const packed_string_type *>(src_tp)->get_offsets(src, &begin, &end);
+                set_offsets(dst, begin, end);
+                return;
+            } else {
+                src_tp->get_string_range(&src_begin, &src_end, e->src_metadata, src);
+            }
+
+            if (e->dst_encoding == e->src_encoding) {
+                // With matching encodings, the bytes are appended as is
+                intptr_t size = src_end - src_begin;
+                intptr_t offset = contiguous_memory_block_allocate(dst_blockref, size,
+                                string_encoding_char_size_table[e->dst_encoding]);
+                memcpy(contiguous_memory_block_get_data(dst_blockref) + offset, src_begin, size);
+                set_offsets(dst, offset, offset + size);
+                return;
+            }
+
+            intptr_t src_charsize = string_encoding_char_size_table[e->src_encoding];
+            intptr_t dst_charsize = string_encoding_char_size_table[e->dst_encoding];
+            next_unicode_codepoint_t next_fn = e->next_fn;
+            append_unicode_codepoint_t append_fn = e->append_fn;
+            uint32_t cp;
+
+            // Allocate the initial output as the src number of characters + some padding
+            intptr_t capacity = ((src_end - src_begin) / src_charsize + 16) * dst_charsize * 1124 / 1024;
+            intptr_t offset = contiguous_memory_block_allocate(dst_blockref, capacity, dst_charsize);
+            char *dst_begin = contiguous_memory_block_get_data(dst_blockref) + offset;
+            char *dst_current = dst_begin, *dst_end = dst_begin + capacity;
+            while (src_begin < src_end) {
+                cp = next_fn(src_begin, src_end);
+                // Append the codepoint, or increase the allocated memory as necessary.
+                // Growing may move the buffer, so the pointers are recomputed.
+                if (dst_end - dst_current < 8) {
+                    intptr_t used = dst_current - dst_begin;
+                    capacity *= 2;
+                    contiguous_memory_block_resize(dst_blockref, offset, capacity);
+                    dst_begin = contiguous_memory_block_get_data(dst_blockref) + offset;
+                    dst_current = dst_begin + used;
+                    dst_end = dst_begin + capacity;
+                }
+                append_fn(cp, dst_current, dst_end);
+            }
+
+            // Shrink-wrap the memory to just fit the string
+            intptr_t size = dst_current - dst_begin;
+            contiguous_memory_block_resize(dst_blockref, offset, size);
+            set_offsets(dst, offset, offset + size);
+        }
+
+        static void destruct(ckernel_prefix *extra)
+        {
+            extra_type *e = reinterpret_cast<extra_type *>(extra);
+            base_type_xdecref(e->src_string_tp);
+        }
+    };
+
+    template<class T>
+    size_t make_to_packed_string_assignment_kernel_impl(
+                    ckernel_builder *out, size_t offset_out,
+                    const packed_string_type *dst_string_tp, const char *dst_metadata,
+                    const base_string_type *src_string_tp, const char *src_metadata,
+                    kernel_request_t kernreq, assign_error_mode errmode)
+    {
+        typedef to_packed_string_assign_kernel_extra<T> extra_type;
+        out->ensure_capacity_leaf(offset_out + sizeof(extra_type));
+        extra_type *e = out->get_at<extra_type>(offset_out);
+        set_unary_single_or_strided_function<&extra_type::single>(&e->base, kernreq);
+        e->base.destructor = &extra_type::destruct;
+        // The kernel data owns a reference to this type
+        base_type_incref(src_string_tp);
+        e->src_string_tp = src_string_tp;
+        e->dst_encoding = dst_string_tp->get_encoding();
+        e->src_encoding = src_string_tp->get_encoding();
+        e->next_fn = get_next_unicode_codepoint_function(e->src_encoding, errmode);
+        e->append_fn = get_append_unicode_codepoint_function(e->dst_encoding, errmode);
+        e->dst_metadata = reinterpret_cast<const packed_string_type_metadata *>(dst_metadata);
+        e->src_metadata = src_metadata;
+        return offset_out + sizeof(extra_type);
+    }
+} // anonymous namespace
+
+size_t dynd::make_to_packed_string_assignment_kernel(
+                ckernel_builder *out, size_t offset_out,
+                const ndt::type& dst_tp, const char *dst_metadata,
+                const ndt::type& src_tp, const char *src_metadata,
+                kernel_request_t kernreq, assign_error_mode errmode,
+                const eval::eval_context *DYND_UNUSED(ectx))
+{
+    if (dst_tp.get_type_id() != packed_string_type_id || src_tp.get_kind() != string_kind) {
+        stringstream ss;
+        ss << "make_to_packed_string_assignment_kernel: cannot assign from " << src_tp << " to " << dst_tp;
+        throw runtime_error(ss.str());
+    }
+    const packed_string_type *dst_string_tp = static_cast<const packed_string_type *>(dst_tp.extended());
+    const base_string_type *src_string_tp = static_cast<const base_string_type *>(src_tp.extended());
+    if (dst_string_tp->get_offset_type_id() == int32_type_id) {
+        return make_to_packed_string_assignment_kernel_impl<int32_t>(out, offset_out,
+                        dst_string_tp, dst_metadata, src_string_tp, src_metadata,
+                        kernreq, errmode);
+    } else {
+        return make_to_packed_string_assignment_kernel_impl<int64_t>(out, offset_out,
+                        dst_string_tp, dst_metadata, src_string_tp, src_metadata,
+                        kernreq, errmode);
+    }
+}
+
+/////////////////////////////////////////
+// packed string to other assignment
+
+namespace {
+    /**
+     * The metadata of the blockref string views of packed and small
+     * strings. With a NULL blockref, assignment to a blockref string
+     * always copies.
+     */
+    const string_type_metadata string_view_metadata = {NULL};
+
+    template<class T>
+    struct packed_string_to_string_assign_kernel_extra {
+        typedef packed_string_to_string_assign_kernel_extra extra_type;
+
+        ckernel_prefix base;
+        const packed_string_type_metadata *src_metadata;
+
+        static void single(char *dst, const char *src,
+                        ckernel_prefix *extra)
+        {
+            extra_type *e = reinterpret_cast<extra_type *>(extra);
+            ckernel_prefix *echild = reinterpret_cast<ckernel_prefix *>(
+                            reinterpret_cast<char *>(extra) + sizeof(extra_type));
+            unary_single_operation_t opchild = echild->get_function<unary_single_operation_t>();
+            const packed_string_type_data<T> *src_d = reinterpret_cast<const packed_string_type_data<T> *>(src);
+            char *buffer = contiguous_memory_block_get_data(e->src_metadata->blockref);
+            string_type_data src_view;
+            src_view.begin = buffer + src_d->begin;
+            src_view.end = buffer + src_d->end;
+            opchild(dst, reinterpret_cast<const char *>(&src_view), echild);
+        }
+
+        static void destruct(ckernel_prefix *extra)
+        {
+            ckernel_prefix *echild = reinterpret_cast<ckernel_prefix *>(
+                            reinterpret_cast<char *>(extra) + sizeof(extra_type));
+            if (echild->destructor) {
+                echild->destructor(echild);
+            }
+        }
+    };
+
+    template<class T>
+    size_t make_packed_string_to_string_assignment_kernel_impl(
+                    ckernel_builder *out, size_t offset_out,
+                    const ndt::type& dst_tp, const char *dst_metadata,
+                    string_encoding_t src_encoding, const char *src_metadata,
+                    kernel_request_t kernreq, assign_error_mode errmode,
+                    const eval::eval_context *ectx)
+    {
+        typedef packed_string_to_string_assign_kernel_extra<T> extra_type;
+        out->ensure_capacity(offset_out + sizeof(extra_type));
+        extra_type *e = out->get_at<extra_type>(offset_out);
+        set_unary_single_or_strided_function<&extra_type::single>(&e->base, kernreq);
+        e->base.destructor = &extra_type::destruct;
+        e->src_metadata = reinterpret_cast<const packed_string_type_metadata *>(src_metadata);
+        return ::make_assignment_kernel(out, offset_out + sizeof(extra_type),
+                        dst_tp, dst_metadata,
+                        ndt::make_string(src_encoding),
+                        reinterpret_cast<const char *>(&string_view_metadata),
+                        kernel_request_single, errmode, ectx);
+    }
+} // anonymous namespace
+
+size_t dynd::make_packed_string_to_string_assignment_kernel(
+                ckernel_builder *out, size_t offset_out,
+                const ndt::type& dst_tp, const char *dst_metadata,
+                const ndt::type& src_tp, const char *src_metadata,
+                kernel_request_t kernreq, assign_error_mode errmode,
+                const eval::eval_context *ectx)
+{
+    if (src_tp.get_type_id() != packed_string_type_id) {
+        stringstream ss;
+        ss << "make_packed_string_to_string_assignment_kernel: source type " << src_tp << " is not a packed string type";
+        throw runtime_error(ss.str());
+    }
+    const packed_string_type *src_string_tp = static_cast<const packed_string_type *>(src_tp.extended());
+    if (src_string_tp->get_offset_type_id() == int32_type_id) {
+        return make_packed_string_to_string_assignment_kernel_impl<int32_t>(out, offset_out,
+                        dst_tp, dst_metadata, src_string_tp->get_encoding(), src_metadata,
+                        kernreq, errmode, ectx);
+    } else {
+        return make_packed_string_to_string_assignment_kernel_impl<int64_t>(out, offset_out,
+                        dst_tp, dst_metadata, src_string_tp->get_encoding(), src_metadata,
+                        kernreq, errmode, ectx);
+    }
+}
+
+/////////////////////////////////////////
+// any string to small string assignment
+
+namespace {
+    struct to_small_string_assign_kernel_extra {
+        typedef to_small_string_assign_kernel_extra extra_type;
+
+        ckernel_prefix base;
+        const base_string_type *src_string_tp;
+        string_encoding_t dst_encoding, src_encoding;
+        next_unicode_codepoint_t next_fn;
+        append_unicode_codepoint_t append_fn;
+        const small_string_type_metadata *dst_metadata;
+        const char *src_metadata;
+
+        static void single(char *dst, const char *src,
+                        ckernel_prefix *extra)
+        {
+            extra_type *e = reinterpret_cast<extra_type *>(extra);
+            memory_block_data *dst_blockref = e->dst_metadata->blockref;
+            const base_string_type *src_tp = e->src_string_tp;
+            const char *src_begin, *src_end;
+
+            if (src_tp->get_type_id() == small_string_type_id) {
+                // Inline strings, and strings already in the destination
+                // memory block, are copied as a whole element
+                if (e->dst_encoding == e->src_encoding && (small_string_is_inline(src) ||
+                                reinterpret_cast<const small_string_type_metadata *>(
+                                    e->src_metadata)->blockref == dst_blockref)) {
+                    memcpy(dst, src, sizeof(small_string_type_data));
+                    return;
+                }
+                small_string_get_range(src, &src_begin, &src_end);
+            } else if (src_tp->get_type_id() == string_type_id) {
+                src_begin = reinterpret_cast<const string_type_data *>(src)->begin;
+                src_end = reinterpret_cast<const string_type_data *>(src)->end;
+            } else {
+                src_tp->get_string_range(&src_begin, &src_end, e->src_metadata, src);
+            }
+
+            memory_block_pod_allocator_api *allocator = get_memory_block_pod_allocator_api(dst_blockref);
+            intptr_t dst_charsize = string_encoding_char_size_table[e->dst_encoding];
+            char *dst_begin = NULL, *dst_current, *dst_end = NULL;
+
+            if (e->dst_encoding == e->src_encoding) {
+                // With matching encodings, the bytes are copied as is
+                if (src_end - src_begin <= small_string_inline_capacity) {
+                    small_string_set_inline(dst, src_begin, src_end);
+                } else {
+                    allocator->allocate(dst_blockref, src_end - src_begin, dst_charsize, &dst_begin, &dst_end);
+                    memcpy(dst_begin, src_begin, src_end - src_begin);
+                    small_string_set_heap(dst, dst_begin, dst_end);
+                }
+                return;
+            }
+
+            intptr_t src_charsize = string_encoding_char_size_table[e->src_encoding];
+            next_unicode_codepoint_t next_fn = e->next_fn;
+            append_unicode_codepoint_t append_fn = e->append_fn;
+            uint32_t cp;
+
+            // Allocate the initial output as the src number of characters + some padding
+            allocator->allocate(dst_blockref, ((src_end - src_begin) / src_charsize + 16) * dst_charsize * 1124 / 1024,
+                            dst_charsize, &dst_begin, &dst_end);
+            dst_current = dst_begin;
+            while (src_begin < src_end) {
+                cp = next_fn(src_begin, src_end);
+                // Append the codepoint, or increase the allocated memory as necessary
+                if (dst_end - dst_current < 8) {
+                    char *dst_begin_saved = dst_begin;
+                    allocator->resize(dst_blockref, 2 * (dst_end - dst_begin), &dst_begin, &dst_end);
+                    dst_current = dst_begin + (dst_current - dst_begin_saved);
+                }
+                append_fn(cp, dst_current, dst_end);
+            }
+
+            if (dst_current - dst_begin <= small_string_inline_capacity) {
+                // Move a short result inline, giving the memory back
+                small_string_set_inline(dst, dst_begin, dst_current);
+                allocator->resize(dst_blockref, 0, &dst_begin, &dst_end);
+            } else {
+                // Shrink-wrap the memory to just fit the string
+                allocator->resize(dst_blockref, dst_current - dst_begin, &dst_begin, &dst_end);
+                small_string_set_heap(dst, dst_begin, dst_end);
+            }
+        }
+
+        static void destruct(ckernel_prefix *extra)
+        {
+            extra_type *e = reinterpret_cast<extra_type *>(extra);
+            base_type_xdecref(e->src_string_tp);
+        }
+    };
+} // anonymous namespace
+
+size_t dynd::make_to_small_string_assignment_kernel(
+                ckernel_builder *out, size_t offset_out,
+                const ndt::type& dst_tp, const char *dst_metadata,
+                const ndt::type& src_tp, const char *src_metadata,
+                kernel_request_t kernreq, assign_error_mode errmode,
+                const eval::eval_context *DYND_UNUSED(ectx))
+{
+    if (dst_tp.get_type_id() != small_string_type_id || src_tp.get_kind() != string_kind) {
+        stringstream ss;
+        ss << "make_to_small_string_assignment_kernel: cannot assign from " << src_tp << " to " << dst_tp;
+        throw runtime_error(ss.str());
+    }
+    const base_string_type *src_string_tp = static_cast<const base_string_type *>(src_tp.extended());
+    typedef to_small_string_assign_kernel_extra extra_type;
+    out->ensure_capacity_leaf(offset_out + sizeof(extra_type));
+    extra_type *e = out->get_at<extra_type>(offset_out);
+    set_unary_single_or_strided_function<&extra_type::single>(&e->base, kernreq);
+    e->base.destructor = &extra_type::destruct;
+    // The kernel data owns a reference to this type
+    base_type_incref(src_string_tp);
+    e->src_string_tp = src_string_tp;
+    e->dst_encoding = static_cast<const small_string_type *>(dst_tp.extended())->get_encoding();
+    e->src_encoding = src_string_tp->get_encoding();
+    e->next_fn = get_next_unicode_codepoint_function(e->src_encoding, errmode);
+    e->append_fn = get_append_unicode_codepoint_function(e->dst_encoding, errmode);
+    e->dst_metadata = reinterpret_cast<const small_string_type_metadata *>(dst_metadata);
+    e->src_metadata = src_metadata;
+    return offset_out + sizeof(extra_type);
+}
+
+/////////////////////////////////////////
+// small string to other assignment
+
+namespace {
+    struct small_string_to_string_assign_kernel_extra {
+        typedef small_string_to_string_assign_kernel_extra extra_type;
+
+        ckernel_prefix base;
+
+        static void single(char *dst, const char *src,
+                        ckernel_prefix *extra)
+        {
+            ckernel_prefix *echild = reinterpret_cast<ckernel_prefix *>(
+                            reinterpret_cast<char *>(extra) + sizeof(extra_type));
+            unary_single_operation_t opchild = echild->get_function<unary_single_operation_t>();
+            const char *begin, *end;
+            small_string_get_range(src, &begin, &end);
+            string_type_data src_view;
+            src_view.begin = const_cast<char *>(begin);
+            src_view.end = const_cast<char *>(end);
+            opchild(dst, reinterpret_cast<const char *>(&src_view), echild);
+        }
+
+        static void destruct(ckernel_prefix *extra)
+        {
+            ckernel_prefix *echild = reinterpret_cast<ckernel_prefix *>(
+                            reinterpret_cast<char *>(extra) + sizeof(extra_type));
+            if (echild->destructor) {
+                echild->destructor(echild);
+            }
+        }
+    };
+} // anonymous namespace
+
+size_t dynd::make_small_string_to_string_assignment_kernel(
+                ckernel_builder *out, size_t offset_out,
+                const ndt::type& dst_tp, const char *dst_metadata,
+                const ndt::type& src_tp, const char *DYND_UNUSED(src_metadata),
+                kernel_request_t kernreq, assign_error_mode errmode,
+                const eval::eval_context *ectx)
+{
+    if (src_tp.get_type_id() != small_string_type_id) {
+        stringstream ss;
+        ss << "make_small_string_to_string_assignment_kernel: source type " << src_tp << " is not a small string type";
+        throw runtime_error(ss.str());
+    }
+    typedef small_string_to_string_assign_kernel_extra extra_type;
+    out->ensure_capacity(offset_out + sizeof(extra_type));
+    extra_type *e = out->get_at<extra_type>(offset_out);
+    set_unary_single_or_strided_function<&extra_type::single>(&e->base, kernreq);
+    e->base.destructor = &extra_type::destruct;
+    return ::make_assignment_kernel(out, offset_out + sizeof(extra_type),
+                    dst_tp, dst_metadata,
+                    ndt::make_string(static_cast<const small_string_type *>(src_tp.extended())->get_encoding()),
+                    reinterpret_cast<const char *>(&string_view_metadata),
+                    kernel_request_single, errmode, ectx);
+}
+
+namespace {
+    ckernel_debug_info_registrar fixedstring_assign_single_reg(&fixedstring_assign_kernel_extra::single,
+                    "fixedstring assign", sizeof(fixedstring_assign_kernel_extra), false, NULL);
+    ckernel_debug_info_registrar fixedstring_assign_strided_reg(&strided_loop_of_single<&fixedstring_assign_kernel_extra::single>,
+                    "fixedstring assign", sizeof(fixedstring_assign_kernel_extra), true, NULL);
+    ckernel_debug_info_registrar blockref_string_assign_single_reg(&blockref_string_assign_kernel_extra::single,
+                    "blockref string assign", sizeof(blockref_string_assign_kernel_extra), false, NULL);
+    ckernel_debug_info_registrar blockref_string_assign_strided_reg(&strided_loop_of_single<&blockref_string_assign_kernel_extra::single>,
+                    "blockref string assign", sizeof(blockref_string_assign_kernel_extra), true, NULL);
+    ckernel_debug_info_registrar fixedstring_to_blockref_string_assign_single_reg(&fixedstring_to_blockref_string_assign_kernel_extra::single,
+                    "fixedstring to blockref string assign", sizeof(fixedstring_to_blockref_string_assign_kernel_extra), false, NULL);
+    ckernel_debug_info_registrar fixedstring_to_blockref_string_assign_strided_reg(&strided_loop_of_single<&fixedstring_to_blockref_string_assign_kernel_extra::single>,
+                    "fixedstring to blockref string assign", sizeof(fixedstring_to_blockref_string_assign_kernel_extra), true, NULL);
+    ckernel_debug_info_registrar blockref_string_to_fixedstring_assign_single_reg(&blockref_string_to_fixedstring_assign_kernel_extra::single,
+                    "blockref string to fixedstring assign", sizeof(blockref_string_to_fixedstring_assign_kernel_extra), false, NULL);
+    ckernel_debug_info_registrar blockref_string_to_fixedstring_assign_strided_reg(&strided_loop_of_single<&blockref_string_to_fixedstring_assign_kernel_extra::single>,
+                    "blockref string to fixedstring assign", sizeof(blockref_string_to_fixedstring_assign_kernel_extra), true, NULL);
+    ckernel_debug_info_registrar to_small_string_assign_single_reg(&to_small_string_assign_kernel_extra::single,
+                    "to small string assign", sizeof(to_small_string_assign_kernel_extra), false, NULL);
+    ckernel_debug_info_registrar to_small_string_assign_strided_reg(&strided_loop_of_single<&to_small_string_assign_kernel_extra::single>,
+                    "to small string assign", sizeof(to_small_string_assign_kernel_extra), true, NULL);
+    ckernel_debug_info_registrar small_string_to_string_assign_single_reg(&small_string_to_string_assign_kernel_extra::single,
+                    "small string to string assign", sizeof(small_string_to_string_assign_kernel_extra), false, &ckernel_child_follows);
+    ckernel_debug_info_registrar small_string_to_string_assign_strided_reg(&strided_loop_of_single<&small_string_to_string_assign_kernel_extra::single>,
+                    "small string to string assign", sizeof(small_string_to_string_assign_kernel_extra), true, &ckernel_child_follows);
+} // anonymous namespace
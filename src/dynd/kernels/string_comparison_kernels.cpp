@@ -11,6 +11,8 @@
 #include <dynd/kernels/string_comparison_kernels.hpp>
 #include <dynd/types/fixedstring_type.hpp>
 #include <dynd/types/string_type.hpp>
+#include <dynd/types/packed_string_type.hpp>
+#include <dynd/types/small_string_type.hpp>
 #include <dynd/types/convert_type.hpp>
 
 using namespace std;
@@ -307,6 +309,213 @@ size_t dynd::make_string_comparison_kernel(
 
 #undef DYND_STRING_COMPARISON_TABLE_TYPE_LEVEL
 
+/////////////////////////////////////////
+// packed string comparison
+
+namespace {
+    struct packed_string_compare_kernel_extra {
+        ckernel_prefix base;
+        const packed_string_type_metadata *src0_metadata, *src1_metadata;
+    };
+
+    template<typename T, typename O>
+    struct packed_string_compare_kernel {
+        static inline void get_ranges(const char *a, const char *b, ckernel_prefix *extra,
+                        const T *&a_begin, const T *&a_end, const T *&b_begin, const T *&b_end)
+        {
+            packed_string_compare_kernel_extra *e = reinterpret_cast<packed_string_compare_kernel_extra *>(extra);
+            const packed_string_type_data<O> *da = reinterpret_cast<const packed_string_type_data<O> *>(a);
+            const packed_string_type_data<O> *db = reinterpret_cast<const packed_string_type_data<O> *>(b);
+            const char *buffer_a = contiguous_memory_block_get_data(e->src0_metadata->blockref);
+            const char *buffer_b = contiguous_memory_block_get_data(e->src1_metadata->blockref);
+            a_begin = reinterpret_cast<const T *>(buffer_a + da->begin);
+            a_end = reinterpret_cast<const T *>(buffer_a + da->end);
+            b_begin = reinterpret_cast<const T *>(buffer_b + db->begin);
+            b_end = reinterpret_cast<const T *>(buffer_b + db->end);
+        }
+
+        static int less(const char *a, const char *b, ckernel_prefix *extra) {
+            const T *a_begin, *a_end, *b_begin, *b_end;
+            get_ranges(a, b, extra, a_begin, a_end, b_begin, b_end);
+            return lexicographical_compare(a_begin, a_end, b_begin, b_end);
+        }
+
+        static int less_equal(const char *a, const char *b, ckernel_prefix *extra) {
+            const T *a_begin, *a_end, *b_begin, *b_end;
+            get_ranges(a, b, extra, a_begin, a_end, b_begin, b_end);
+            return !lexicographical_compare(b_begin, b_end, a_begin, a_end);
+        }
+
+        static int equal(const char *a, const char *b, ckernel_prefix *extra) {
+            const T *a_begin, *a_end, *b_begin, *b_end;
+            get_ranges(a, b, extra, a_begin, a_end, b_begin, b_end);
+            return (a_end - a_begin == b_end - b_begin) &&
+                    memcmp(a_begin, b_begin, (a_end - a_begin) * sizeof(T)) == 0;
+        }
+
+        static int not_equal(const char *a, const char *b, ckernel_prefix *extra) {
+            const T *a_begin, *a_end, *b_begin, *b_end;
+            get_ranges(a, b, extra, a_begin, a_end, b_begin, b_end);
+            return (a_end - a_begin != b_end - b_begin) ||
+                    memcmp(a_begin, b_begin, (a_end - a_begin) * sizeof(T)) != 0;
+        }
+
+        static int greater_equal(const char *a, const char *b, ckernel_prefix *extra) {
+            const T *a_begin, *a_end, *b_begin, *b_end;
+            get_ranges(a, b, extra, a_begin, a_end, b_begin, b_end);
+            return !lexicographical_compare(a_begin, a_end, b_begin, b_end);
+        }
+
+        static int greater(const char *a, const char *b, ckernel_prefix *extra) {
+            const T *a_begin, *a_end, *b_begin, *b_end;
+            get_ranges(a, b, extra, a_begin, a_end, b_begin, b_end);
+            return lexicographical_compare(b_begin, b_end, a_begin, a_end);
+        }
+    };
+} // anonymous namespace
+
+#define DYND_PACKED_STRING_COMPARISON_TABLE_TYPE_LEVEL(type, offset_type) { \
+    packed_string_compare_kernel<type, offset_type>::less, \
+    packed_string_compare_kernel<type, offset_type>::less, \
+    packed_string_compare_kernel<type, offset_type>::less_equal, \
+    packed_string_compare_kernel<type, offset_type>::equal, \
+    packed_string_compare_kernel<type, offset_type>::not_equal, \
+    packed_string_compare_kernel<type, offset_type>::greater_equal, \
+    packed_string_compare_kernel<type, offset_type>::greater \
+    }
+
+size_t dynd::make_packed_string_comparison_kernel(
+                ckernel_builder *out, size_t offset_out,
+                string_encoding_t encoding, type_id_t offset_type_id,
+                const char *src0_metadata, const char *src1_metadata,
+                comparison_type_t comptype,
+                const eval::eval_context *DYND_UNUSED(ectx))
+{
+    static int lookup[5] = {0, 1, 0, 1, 2};
+    static binary_single_predicate_t packed_string_comparisons_table[2][3][7] = {
+        {
+            DYND_PACKED_STRING_COMPARISON_TABLE_TYPE_LEVEL(uint8_t, int32_t),
+            DYND_PACKED_STRING_COMPARISON_TABLE_TYPE_LEVEL(uint16_t, int32_t),
+            DYND_PACKED_STRING_COMPARISON_TABLE_TYPE_LEVEL(uint32_t, int32_t)
+        },
+        {
+            DYND_PACKED_STRING_COMPARISON_TABLE_TYPE_LEVEL(uint8_t, int64_t),
+            DYND_PACKED_STRING_COMPARISON_TABLE_TYPE_LEVEL(uint16_t, int64_t),
+            DYND_PACKED_STRING_COMPARISON_TABLE_TYPE_LEVEL(uint32_t, int64_t)
+        }
+    };
+    if (0 <= encoding && encoding < 5 && 0 <= comptype && comptype < 7 &&
+                    (offset_type_id == int32_type_id || offset_type_id == int64_type_id)) {
+        int offset_index = (offset_type_id == int32_type_id) ? 0 : 1;
+        out->ensure_capacity_leaf(offset_out + sizeof(packed_string_compare_kernel_extra));
+        packed_string_compare_kernel_extra *e = out->get_at<packed_string_compare_kernel_extra>(offset_out);
+        e->base.set_function<binary_single_predicate_t>(
+                        packed_string_comparisons_table[offset_index][lookup[encoding]][comptype]);
+        e->src0_metadata = reinterpret_cast<const packed_string_type_metadata *>(src0_metadata);
+        e->src1_metadata = reinterpret_cast<const packed_string_type_metadata *>(src1_metadata);
+        return offset_out + sizeof(packed_string_compare_kernel_extra);
+    } else {
+        stringstream ss;
+        ss << "make_packed_string_comparison_kernel: Unexpected encoding (" << encoding;
+        ss << "), offset type (" << offset_type_id << ") or comparison type (" << comptype << ")";
+        throw runtime_error(ss.str());
+    }
+}
+
+#undef DYND_PACKED_STRING_COMPARISON_TABLE_TYPE_LEVEL
+
+/////////////////////////////////////////
+// small string comparison
+
+namespace {
+    template<typename T>
+    struct small_string_compare_kernel {
+        static inline bool is_equal(const char *a, const char *b) {
+            if (small_string_is_inline(a) || small_string_is_inline(b)) {
+                // Inline strings are zero padded, and a string is only
+                // stored out of line when it doesn't fit inline
+                return memcmp(a, b, sizeof(small_string_type_data)) == 0;
+            } else {
+                const char *a_begin, *a_end, *b_begin, *b_end;
+                small_string_get_range(a, &a_begin, &a_end);
+                small_string_get_range(b, &b_begin, &b_end);
+                return (a_end - a_begin == b_end - b_begin) &&
+                        memcmp(a_begin, b_begin, a_end - a_begin) == 0;
+            }
+        }
+
+        static inline bool is_less(const char *a, const char *b) {
+            const char *a_begin, *a_end, *b_begin, *b_end;
+            small_string_get_range(a, &a_begin, &a_end);
+            small_string_get_range(b, &b_begin, &b_end);
+            return lexicographical_compare(
+                reinterpret_cast<const T *>(a_begin), reinterpret_cast<const T *>(a_end),
+                reinterpret_cast<const T *>(b_begin), reinterpret_cast<const T *>(b_end));
+        }
+
+        static int less(const char *a, const char *b, ckernel_prefix *DYND_UNUSED(extra)) {
+            return is_less(a, b);
+        }
+
+        static int less_equal(const char *a, const char *b, ckernel_prefix *DYND_UNUSED(extra)) {
+            return !is_less(b, a);
+        }
+
+        static int equal(const char *a, const char *b, ckernel_prefix *DYND_UNUSED(extra)) {
+            return is_equal(a, b);
+        }
+
+        static int not_equal(const char *a, const char *b, ckernel_prefix *DYND_UNUSED(extra)) {
+            return !is_equal(a, b);
+        }
+
+        static int greater_equal(const char *a, const char *b, ckernel_prefix *DYND_UNUSED(extra)) {
+            return !is_less(a, b);
+        }
+
+        static int greater(const char *a, const char *b, ckernel_prefix *DYND_UNUSED(extra)) {
+            return is_less(b, a);
+        }
+    };
+} // anonymous namespace
+
+#define DYND_SMALL_STRING_COMPARISON_TABLE_TYPE_LEVEL(type) { \
+    small_string_compare_kernel<type>::less, \
+    small_string_compare_kernel<type>::less, \
+    small_string_compare_kernel<type>::less_equal, \
+    small_string_compare_kernel<type>::equal, \
+    small_string_compare_kernel<type>::not_equal, \
+    small_string_compare_kernel<type>::greater_equal, \
+    small_string_compare_kernel<type>::greater \
+    }
+
+size_t dynd::make_small_string_comparison_kernel(
+                ckernel_builder *out, size_t offset_out,
+                string_encoding_t encoding,
+                comparison_type_t comptype,
+                const eval::eval_context *DYND_UNUSED(ectx))
+{
+    static int lookup[5] = {0, 1, 0, 1, 2};
+    static binary_single_predicate_t small_string_comparisons_table[3][7] = {
+        DYND_SMALL_STRING_COMPARISON_TABLE_TYPE_LEVEL(uint8_t),
+        DYND_SMALL_STRING_COMPARISON_TABLE_TYPE_LEVEL(uint16_t),
+        DYND_SMALL_STRING_COMPARISON_TABLE_TYPE_LEVEL(uint32_t)
+    };
+    if (0 <= encoding && encoding < 5 && 0 <= comptype && comptype < 7) {
+        out->ensure_capacity_leaf(offset_out + sizeof(ckernel_prefix));
+        ckernel_prefix *e = out->get_at<ckernel_prefix>(offset_out);
+        e->set_function<binary_single_predicate_t>(small_string_comparisons_table[lookup[encoding]][comptype]);
+        return offset_out + sizeof(ckernel_prefix);
+    } else {
+        stringstream ss;
+        ss << "make_small_string_comparison_kernel: Unexpected encoding (" << encoding;
+        ss << ") or comparison type (" << comptype << ")";
+        throw runtime_error(ss.str());
+    }
+}
+
+#undef DYND_SMALL_STRING_COMPARISON_TABLE_TYPE_LEVEL
+
 size_t dynd::make_general_string_comparison_kernel(
                 ckernel_builder *out, size_t offset_out,
                 const ndt::type& src0_dt, const char *src0_metadata,
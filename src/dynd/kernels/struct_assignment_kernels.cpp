@@ -11,6 +11,7 @@
 #include <dynd/diagnostics.hpp>
 #include <dynd/kernels/assignment_kernels.hpp>
 #include <dynd/kernels/struct_assignment_kernels.hpp>
+#include <dynd/kernels/ckernel_debug_info.hpp>
 
 using namespace std;
 using namespace dynd;
@@ -46,6 +47,28 @@ namespace {
             }
         }
 
+        static void strided(char *dst, intptr_t dst_stride,
+                        const char *src, intptr_t src_stride,
+                        size_t count, ckernel_prefix *extra)
+        {
+            char *eraw = reinterpret_cast<char *>(extra);
+            extra_type *e = reinterpret_cast<extra_type *>(extra);
+            const field_items *fi = reinterpret_cast<const field_items *>(e + 1);
+            size_t field_count = e->field_count;
+            ckernel_prefix *echild;
+            unary_strided_operation_t opchild;
+
+            // Process one field of all the elements at a time,
+            // with the strided child kernels
+            for (size_t i = 0; i < field_count; ++i) {
+                const field_items& item = fi[i];
+                echild  = reinterpret_cast<ckernel_prefix *>(eraw + item.child_kernel_offset);
+                opchild = echild->get_function<unary_strided_operation_t>();
+                opchild(dst + item.dst_data_offset, dst_stride,
+                                src + item.src_data_offset, src_stride, count, echild);
+            }
+        }
+
         static void destruct(ckernel_prefix *extra)
         {
             char *eraw = reinterpret_cast<char *>(extra);
@@ -63,7 +86,53 @@ namespace {
                 }
             }
         }
+
+        static void get_children(const ckernel_prefix *self, size_t DYND_UNUSED(self_size),
+                        std::vector<size_t>& out_child_offsets)
+        {
+            const extra_type *e = reinterpret_cast<const extra_type *>(self);
+            const field_items *fi = reinterpret_cast<const field_items *>(e + 1);
+            for (size_t i = 0; i < e->field_count; ++i) {
+                if (fi[i].child_kernel_offset != 0) {
+                    out_child_offsets.push_back(fi[i].child_kernel_offset);
+                }
+            }
+        }
+
+        static void describe(const ckernel_prefix *self, std::ostream& o)
+        {
+            // The field_items follow the fixed size part
+            o << reinterpret_cast<const extra_type *>(self)->field_count << " fields";
+        }
     };
+
+    /**
+     * Sets the function of a struct_kernel_extra. Its field kernels
+     * must be created with the same kernel request.
+     */
+    void set_struct_kernel_function(struct_kernel_extra *e, kernel_request_t kernreq)
+    {
+        switch (kernreq) {
+            case kernel_request_single:
+                e->base.set_function<unary_single_operation_t>(&struct_kernel_extra::single);
+                break;
+            case kernel_request_strided:
+                e->base.set_function<unary_strided_operation_t>(&struct_kernel_extra::strided);
+                break;
+            default: {
+                stringstream ss;
+                ss << "struct assignment kernel: unrecognized request " << (int)kernreq;
+                throw runtime_error(ss.str());
+            }
+        }
+    }
+
+    ckernel_debug_info_registrar struct_single_reg(&struct_kernel_extra::single,
+                    "struct assign", sizeof(struct_kernel_extra), false,
+                    &struct_kernel_extra::get_children, &struct_kernel_extra::describe);
+    ckernel_debug_info_registrar struct_strided_reg(&struct_kernel_extra::strided,
+                    "struct assign", sizeof(struct_kernel_extra), true,
+                    &struct_kernel_extra::get_children, &struct_kernel_extra::describe);
 } // anonymous namespace
 
 /////////////////////////////////////////
@@ -88,8 +157,6 @@ size_t dynd::make_struct_identical_assignment_kernel(
                         kernreq);
     }
 
-    ckb_offset = make_kernreq_to_single_kernel_adapter(out_ckb, ckb_offset, kernreq);
-
     const base_struct_type *sd = static_cast<const base_struct_type *>(val_struct_tp.extended());
     size_t field_count = sd->get_field_count();
 
@@ -97,7 +164,7 @@ size_t dynd::make_struct_identical_assignment_kernel(
                     field_count * sizeof(struct_kernel_extra::field_items);
     out_ckb->ensure_capacity(ckb_offset + extra_size);
     struct_kernel_extra *e = out_ckb->get_at<struct_kernel_extra>(ckb_offset);
-    e->base.set_function<unary_single_operation_t>(&struct_kernel_extra::single);
+    set_struct_kernel_function(e, kernreq);
     e->base.destructor = &struct_kernel_extra::destruct;
     e->field_count = field_count;
 
@@ -118,7 +185,7 @@ size_t dynd::make_struct_identical_assignment_kernel(
         current_offset = ::make_assignment_kernel(out_ckb, current_offset,
                         sd->get_field_types()[i], dst_metadata + sd->get_metadata_offsets()[i],
                         sd->get_field_types()[i], src_metadata + sd->get_metadata_offsets()[i],
-                        kernel_request_single, errmode, ectx);
+                        kernreq, errmode, ectx);
     }
     return current_offset;
 }
@@ -154,13 +221,11 @@ size_t dynd::make_struct_assignment_kernel(
         throw runtime_error(ss.str());
     }
 
-    ckb_offset = make_kernreq_to_single_kernel_adapter(out_ckb, ckb_offset, kernreq);
-
     size_t extra_size = sizeof(struct_kernel_extra) +
                     field_count * sizeof(struct_kernel_extra::field_items);
     out_ckb->ensure_capacity(ckb_offset + extra_size);
     struct_kernel_extra *e = out_ckb->get_at<struct_kernel_extra>(ckb_offset);
-    e->base.set_function<unary_single_operation_t>(&struct_kernel_extra::single);
+    set_struct_kernel_function(e, kernreq);
     e->base.destructor = &struct_kernel_extra::destruct;
     e->field_count = field_count;
 
@@ -203,7 +268,7 @@ size_t dynd::make_struct_assignment_kernel(
         current_offset = ::make_assignment_kernel(out_ckb, current_offset,
                         dst_field_types[i], dst_metadata + dst_metadata_offsets[i],
                         src_field_types[i_src], src_metadata + src_metadata_offsets[i_src],
-                        kernel_request_single, errmode, ectx);
+                        kernreq, errmode, ectx);
     }
     return current_offset;
 }
@@ -230,13 +295,11 @@ size_t dynd::make_broadcast_to_struct_assignment_kernel(
     const base_struct_type *dst_sd = static_cast<const base_struct_type *>(dst_struct_tp.extended());
     size_t field_count = dst_sd->get_field_count();
 
-    ckb_offset = make_kernreq_to_single_kernel_adapter(out_ckb, ckb_offset, kernreq);
-
     size_t extra_size = sizeof(struct_kernel_extra) +
                     field_count * sizeof(struct_kernel_extra::field_items);
     out_ckb->ensure_capacity(ckb_offset + extra_size);
     struct_kernel_extra *e = out_ckb->get_at<struct_kernel_extra>(ckb_offset);
-    e->base.set_function<unary_single_operation_t>(&struct_kernel_extra::single);
+    set_struct_kernel_function(e, kernreq);
     e->base.destructor = &struct_kernel_extra::destruct;
     e->field_count = field_count;
 
@@ -258,7 +321,7 @@ size_t dynd::make_broadcast_to_struct_assignment_kernel(
         current_offset = ::make_assignment_kernel(out_ckb, current_offset,
                         dst_field_types[i], dst_metadata + dst_metadata_offsets[i],
                         src_tp, src_metadata,
-                        kernel_request_single, errmode, ectx);
+                        kernreq, errmode, ectx);
     }
     return current_offset;
 }
@@ -10,6 +10,7 @@
 #include <dynd/diagnostics.hpp>
 #include <dynd/kernels/assignment_kernels.hpp>
 #include <dynd/kernels/var_dim_assignment_kernels.hpp>
+#include <dynd/kernels/ckernel_debug_info.hpp>
 #include <dynd/types/var_dim_type.hpp>
 #include <dynd/types/strided_dim_type.hpp>
 #include <dynd/types/fixed_dim_type.hpp>
@@ -75,6 +76,9 @@ namespace {
             }
         }
     };
+
+    ckernel_debug_info_registrar broadcast_to_var_assign_single_reg(&broadcast_to_var_assign_kernel_extra::single,
+                    "broadcast to var dim assign", sizeof(broadcast_to_var_assign_kernel_extra), false, &ckernel_child_follows);
 } // anonymous namespace
 
 size_t dynd::make_broadcast_to_var_dim_assignment_kernel(
@@ -187,6 +191,9 @@ namespace {
             }
         }
     };
+
+    ckernel_debug_info_registrar var_assign_single_reg(&var_assign_kernel_extra::single,
+                    "var dim assign", sizeof(var_assign_kernel_extra), false, &ckernel_child_follows);
 } // anonymous namespace
 
 size_t dynd::make_var_dim_assignment_kernel(
@@ -298,6 +305,9 @@ namespace {
             }
         }
     };
+
+    ckernel_debug_info_registrar strided_to_var_assign_single_reg(&strided_to_var_assign_kernel_extra::single,
+                    "strided to var dim assign", sizeof(strided_to_var_assign_kernel_extra), false, &ckernel_child_follows);
 } // anonymous namespace
 
 size_t dynd::make_strided_to_var_dim_assignment_kernel(
@@ -397,6 +407,9 @@ namespace {
             }
         }
     };
+
+    ckernel_debug_info_registrar var_to_strided_assign_single_reg(&var_to_strided_assign_kernel_extra::single,
+                    "var to strided dim assign", sizeof(var_to_strided_assign_kernel_extra), false, &ckernel_child_follows);
 } // anonymous namespace
 
 size_t dynd::make_var_to_strided_dim_assignment_kernel(
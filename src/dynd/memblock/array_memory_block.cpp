@@ -8,10 +8,51 @@
 #include <dynd/array.hpp>
 #include <dynd/exceptions.hpp>
 #include <dynd/shape_tools.hpp>
+#include <dynd/memblock/memory_chunk_pool.hpp>
 
 using namespace std;
 using namespace dynd;
 
+namespace {
+    // Every array memory block is preceded by a header recording the
+    // capacity it was allocated with, so that small blocks, like the
+    // views created by indexing, can be reused through the memory chunk
+    // pool. The header size keeps the malloc alignment of the block.
+    const size_t array_block_header_size = 16;
+    // Blocks up to this size, including the header, come from the pool
+    const size_t max_pooled_array_block_size = 1024;
+
+    char *allocate_array_block(size_t size)
+    {
+        size += array_block_header_size;
+        char *chunk;
+        intptr_t capacity;
+        if (size <= max_pooled_array_block_size) {
+            chunk = detail::memory_chunk_allocate(size, &capacity);
+        } else {
+            chunk = reinterpret_cast<char *>(malloc(size));
+            if (chunk == NULL) {
+                throw bad_alloc();
+            }
+            // Zero capacity marks a block for free()
+            capacity = 0;
+        }
+        *reinterpret_cast<intptr_t *>(chunk) = capacity;
+        return chunk + array_block_header_size;
+    }
+
+    void free_array_block(char *block)
+    {
+        char *chunk = block - array_block_header_size;
+        intptr_t capacity = *reinterpret_cast<intptr_t *>(chunk);
+        if (capacity == 0) {
+            free(chunk);
+        } else {
+            detail::memory_chunk_free(chunk, capacity);
+        }
+    }
+} // anonymous namespace
+
 namespace dynd { namespace detail {
 
 void free_array_memory_block(memory_block_data *memblock)
@@ -49,17 +90,14 @@ void free_array_memory_block(memory_block_data *memblock)
     }
 
     // Finally free the memory block itself
-    free(reinterpret_cast<void *>(memblock));
+    free_array_block(reinterpret_cast<char *>(memblock));
 }
 
 }} // namespace dynd::detail
 
 memory_block_ptr dynd::make_array_memory_block(size_t metadata_size)
 {
-    char *result = (char *)malloc(sizeof(memory_block_data) + sizeof(array_preamble) + metadata_size);
-    if (result == 0) {
-        throw bad_alloc();
-    }
+    char *result = allocate_array_block(sizeof(memory_block_data) + sizeof(array_preamble) + metadata_size);
     // Zero out all the metadata to start
     memset(result + sizeof(memory_block_data), 0, sizeof(array_preamble) + metadata_size);
     return memory_block_ptr(new (result) memory_block_data(1, array_memory_block_type), false);
@@ -70,10 +108,7 @@ memory_block_ptr dynd::make_array_memory_block(size_t metadata_size, size_t extr
 {
     size_t extra_offset = inc_to_alignment(sizeof(memory_block_data) + sizeof(array_preamble) + metadata_size,
                                         extra_alignment);
-    char *result = (char *)malloc(extra_offset + extra_size);
-    if (result == 0) {
-        throw bad_alloc();
-    }
+    char *result = allocate_array_block(extra_offset + extra_size);
     // Zero out all the metadata to start
     memset(result + sizeof(memory_block_data), 0, sizeof(array_preamble) + metadata_size);
     // Return a pointer to the extra allocated memory
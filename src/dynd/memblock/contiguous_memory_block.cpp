@@ -0,0 +1,128 @@
+//
+// Copyright (C) 2011-14 Mark Wiebe, DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <stdexcept>
+#include <sstream>
+#include <cstdlib>
+#include <algorithm>
+
+#include <dynd/memblock/contiguous_memory_block.hpp>
+#include <dynd/memblock/memory_chunk_pool.hpp>
+
+using namespace std;
+using namespace dynd;
+
+namespace {
+    inline contiguous_memory_block_data *get_contiguous(memory_block_data *memblock)
+    {
+        if (memblock->m_type != contiguous_memory_block_type) {
+            stringstream ss;
+            ss << "Expected a contiguous memory block, got a " << (memory_block_type_t)memblock->m_type;
+            ss << " memory block";
+            throw runtime_error(ss.str());
+        }
+        return reinterpret_cast<contiguous_memory_block_data *>(memblock);
+    }
+
+    /**
+     * Grows the buffer so it holds at least required_capacity bytes,
+     * following the memory block growth policy.
+     */
+    void grow_buffer(contiguous_memory_block_data *cmb, intptr_t required_capacity)
+    {
+        if (cmb->m_finalized) {
+            throw runtime_error("Cannot allocate memory from a finalized contiguous memory block");
+        }
+        intptr_t new_capacity = cmb->m_capacity + detail::memory_block_next_chunk_size(
+                        cmb->m_capacity, required_capacity - cmb->m_capacity);
+        char *data = reinterpret_cast<char *>(realloc(cmb->m_data, new_capacity));
+        if (data == NULL) {
+            throw bad_alloc();
+        }
+        cmb->m_data = data;
+        cmb->m_capacity = new_capacity;
+    }
+} // anonymous namespace
+
+memory_block_ptr dynd::make_contiguous_memory_block(intptr_t initial_capacity_bytes)
+{
+    contiguous_memory_block_data *cmb = new contiguous_memory_block_data(initial_capacity_bytes);
+    cmb->m_data = reinterpret_cast<char *>(malloc(max(initial_capacity_bytes, (intptr_t)1)));
+    if (cmb->m_data == NULL) {
+        delete cmb;
+        throw bad_alloc();
+    }
+    return memory_block_ptr(reinterpret_cast<memory_block_data *>(cmb), false);
+}
+
+intptr_t dynd::contiguous_memory_block_allocate(memory_block_data *self, intptr_t size_bytes, intptr_t alignment)
+{
+    contiguous_memory_block_data *cmb = get_contiguous(self);
+    // NOTE: We're assuming malloc produces memory which has good enough alignment for anything
+    intptr_t offset = (cmb->m_size + alignment - 1) & ~(alignment - 1);
+    if (offset + size_bytes > cmb->m_capacity) {
+        grow_buffer(cmb, offset + size_bytes);
+    }
+    cmb->m_size = offset + size_bytes;
+    return offset;
+}
+
+void dynd::contiguous_memory_block_resize(memory_block_data *self, intptr_t offset, intptr_t size_bytes)
+{
+    contiguous_memory_block_data *cmb = get_contiguous(self);
+    if (offset < 0 || offset > cmb->m_size) {
+        // Simple sanity check
+        throw runtime_error("contiguous_memory_block resize must be called only using the most recently allocated memory");
+    }
+    if (offset + size_bytes > cmb->m_capacity) {
+        grow_buffer(cmb, offset + size_bytes);
+    }
+    cmb->m_size = offset + size_bytes;
+}
+
+void dynd::contiguous_memory_block_finalize(memory_block_data *self)
+{
+    contiguous_memory_block_data *cmb = get_contiguous(self);
+    if (!cmb->m_finalized && cmb->m_size < cmb->m_capacity) {
+        // Unlike the pod memory block, the data is addressed by offsets,
+        // so it's fine if realloc moves it
+        char *data = reinterpret_cast<char *>(realloc(cmb->m_data, max(cmb->m_size, (intptr_t)1)));
+        if (data != NULL) {
+            cmb->m_data = data;
+            cmb->m_capacity = cmb->m_size;
+        }
+    }
+    cmb->m_finalized = true;
+}
+
+void dynd::contiguous_memory_block_reset(memory_block_data *self)
+{
+    contiguous_memory_block_data *cmb = get_contiguous(self);
+    cmb->m_size = 0;
+    cmb->m_finalized = false;
+}
+
+namespace dynd { namespace detail {
+
+void free_contiguous_memory_block(memory_block_data *memblock)
+{
+    contiguous_memory_block_data *cmb = reinterpret_cast<contiguous_memory_block_data *>(memblock);
+    free(cmb->m_data);
+    delete cmb;
+}
+
+}} // namespace dynd::detail
+
+void dynd::contiguous_memory_block_debug_print(const memory_block_data *memblock, std::ostream& o, const std::string& indent)
+{
+    const contiguous_memory_block_data *cmb = reinterpret_cast<const contiguous_memory_block_data *>(memblock);
+    o << indent << " data: " << (const void *)cmb->m_data << "\n";
+    o << indent << " size: " << cmb->m_size << "\n";
+    if (cmb->m_finalized) {
+        o << indent << " finalized capacity: " << cmb->m_capacity << "\n";
+    } else {
+        o << indent << " capacity: " << cmb->m_capacity << "\n";
+    }
+}
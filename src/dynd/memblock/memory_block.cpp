@@ -11,6 +11,7 @@
 #include <dynd/memblock/array_memory_block.hpp>
 #include <dynd/memblock/external_memory_block.hpp>
 #include <dynd/memblock/memmap_memory_block.hpp>
+#include <dynd/memblock/contiguous_memory_block.hpp>
 
 using namespace std;
 using namespace dynd;
@@ -57,7 +58,22 @@ void free_objectarray_memory_block(memory_block_data *memblock);
  * This should only be called by the memory_block decref code.
  */
 void free_memmap_memory_block(memory_block_data *memblock);
+/**
+ * INTERNAL: Frees a memory_block created by make_contiguous_memory_block.
+ * This should only be called by the memory_block decref code.
+ */
+void free_contiguous_memory_block(memory_block_data *memblock);
 
+/**
+ * INTERNAL: Moves the chunks of one POD memory block into another.
+ * This should only be called by memory_block_merge.
+ */
+void pod_memory_block_merge(memory_block_data *dst, memory_block_data *src);
+/**
+ * INTERNAL: Moves the chunks of one zeroinit memory block into another.
+ * This should only be called by memory_block_merge.
+ */
+void zeroinit_memory_block_merge(memory_block_data *dst, memory_block_data *src);
 
 /**
  * INTERNAL: Static instance of the pod allocator API for the POD memory block.
@@ -108,6 +124,9 @@ void dynd::detail::memory_block_free(memory_block_data *memblock)
         case memmap_memory_block_type:
             free_memmap_memory_block(memblock);
             return;
+        case contiguous_memory_block_type:
+            free_contiguous_memory_block(memblock);
+            return;
     }
 
     stringstream ss;
@@ -142,6 +161,9 @@ std::ostream& dynd::operator<<(std::ostream& o, memory_block_type_t mbt)
         case memmap_memory_block_type:
             o << "memmap";
             break;
+        case contiguous_memory_block_type:
+            o << "contiguous";
+            break;
         default:
             o << "unknown memory_block_type(" << (int)mbt << ")";
     }
@@ -179,6 +201,9 @@ void dynd::memory_block_debug_print(const memory_block_data *memblock, std::ostr
             case memmap_memory_block_type:
                 memmap_memory_block_debug_print(memblock, o, indent);
                 break;
+            case contiguous_memory_block_type:
+                contiguous_memory_block_debug_print(memblock, o, indent);
+                break;
         }
         o << indent << "------" << endl;
     } else {
@@ -203,6 +228,8 @@ memory_block_pod_allocator_api *dynd::get_memory_block_pod_allocator_api(memory_
             throw runtime_error("Cannot get a POD allocator API from an executable_memory_block");
         case memmap_memory_block_type:
             throw runtime_error("Cannot get a POD allocator API from a memmap_memory_block");
+        case contiguous_memory_block_type:
+            throw runtime_error("Cannot get a POD allocator API from a contiguous_memory_block");
         default:
             throw runtime_error("unknown memory block type");
     }
@@ -226,7 +253,31 @@ memory_block_objectarray_allocator_api *dynd::get_memory_block_objectarray_alloc
             throw runtime_error("Cannot get an objectarray allocator API from an executable_memory_block");
         case memmap_memory_block_type:
             throw runtime_error("Cannot get an objectarray allocator API from a memmap_memory_block");
+        case contiguous_memory_block_type:
+            throw runtime_error("Cannot get an objectarray allocator API from a contiguous_memory_block");
         default:
             throw runtime_error("unknown memory block type");
     }
 }
+
+void dynd::memory_block_merge(memory_block_data *dst, memory_block_data *src)
+{
+    if (dst == src) {
+        return;
+    } else if (dst->m_type == src->m_type) {
+        switch (dst->m_type) {
+            case pod_memory_block_type:
+                dynd::detail::pod_memory_block_merge(dst, src);
+                return;
+            case zeroinit_memory_block_type:
+                dynd::detail::zeroinit_memory_block_merge(dst, src);
+                return;
+            default:
+                break;
+        }
+    }
+    stringstream ss;
+    ss << "Cannot merge a " << (memory_block_type_t)src->m_type << " memory block into a ";
+    ss << (memory_block_type_t)dst->m_type << " memory block";
+    throw runtime_error(ss.str());
+}
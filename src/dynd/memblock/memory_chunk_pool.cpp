@@ -0,0 +1,364 @@
+//
+// Copyright (C) 2011-14 Mark Wiebe, DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <stdexcept>
+#include <sstream>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+
+#include <dynd/memblock/memory_chunk_pool.hpp>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#pragma intrinsic(_InterlockedExchange)
+#endif
+
+using namespace std;
+using namespace dynd;
+
+namespace {
+    // Chunks are pooled in power of two size classes from
+    // 2^min_size_class_shift up to 2^max_size_class_shift bytes.
+    // Bigger chunks go directly to malloc/free.
+    enum {
+        min_size_class_shift = 6,
+        max_size_class_shift = 20,
+        size_class_count = max_size_class_shift - min_size_class_shift + 1,
+        // Only size classes up to this size are cached per thread
+        max_thread_cached_shift = 16,
+        // The number of chunks cached per thread in each size class
+        thread_cache_chunk_count = 8,
+        // The bytes cached in the global pool for each size class
+        global_cache_class_bytes = 8 * 1024 * 1024
+    };
+
+    /**
+     * A free chunk in the pool. The link to the next free
+     * chunk is stored in the chunk memory itself.
+     */
+    struct free_chunk {
+        free_chunk *next;
+    };
+
+    struct chunk_list {
+        free_chunk *head;
+        intptr_t count;
+
+        inline void push(char *chunk) {
+            free_chunk *fc = reinterpret_cast<free_chunk *>(chunk);
+            fc->next = head;
+            head = fc;
+            ++count;
+        }
+
+        inline char *pop() {
+            free_chunk *fc = head;
+            head = fc->next;
+            --count;
+            return reinterpret_cast<char *>(fc);
+        }
+    };
+
+    inline intptr_t size_class_bytes(int size_class) {
+        return intptr_t(1) << (size_class + min_size_class_shift);
+    }
+
+    /**
+     * Returns the size class for a request, or -1 if the
+     * request is too big to be pooled.
+     */
+    inline int get_size_class(intptr_t size_bytes) {
+        int size_class = 0;
+        while (size_class < size_class_count) {
+            if (size_bytes <= size_class_bytes(size_class)) {
+                return size_class;
+            }
+            ++size_class;
+        }
+        return -1;
+    }
+
+    /** A minimal spin lock, the critical sections are a few pointer swaps */
+    class spin_lock {
+        volatile long m_locked;
+    public:
+        inline bool try_lock() {
+#if defined(_MSC_VER)
+            return _InterlockedExchange(&m_locked, 1) == 0;
+#else
+            return __sync_lock_test_and_set(&m_locked, 1) == 0;
+#endif
+        }
+
+        inline void lock() {
+            while (!try_lock()) {
+                while (m_locked) {
+                }
+            }
+        }
+
+        inline void unlock() {
+#if defined(_MSC_VER)
+            _InterlockedExchange(&m_locked, 0);
+#else
+            __sync_lock_release(&m_locked);
+#endif
+        }
+    };
+
+    class spin_lock_guard {
+        spin_lock& m_lock;
+
+        // Non-copyable
+        spin_lock_guard(const spin_lock_guard&);
+        spin_lock_guard& operator=(const spin_lock_guard&);
+    public:
+        explicit spin_lock_guard(spin_lock& lock)
+            : m_lock(lock)
+        {
+            m_lock.lock();
+        }
+
+        ~spin_lock_guard() {
+            m_lock.unlock();
+        }
+    };
+
+    /**
+     * The process-wide pool. This is POD and zero-initialized, so
+     * it is usable from any static initializer or thread destructor.
+     */
+    struct global_chunk_pool {
+        spin_lock m_lock;
+        chunk_list m_lists[size_class_count];
+        intptr_t m_cached_bytes;
+    };
+    global_chunk_pool global_pool;
+
+    /**
+     * Takes up to count chunks of the size class from the global
+     * pool, placing them in the list. Returns the number taken.
+     */
+    intptr_t global_pool_take(int size_class, chunk_list& list, intptr_t count)
+    {
+        spin_lock_guard guard(global_pool.m_lock);
+        chunk_list& gl = global_pool.m_lists[size_class];
+        intptr_t taken = 0;
+        while (taken < count && gl.head != NULL) {
+            list.push(gl.pop());
+            ++taken;
+        }
+        global_pool.m_cached_bytes -= taken * size_class_bytes(size_class);
+        return taken;
+    }
+
+    /**
+     * Gives up to count chunks from the list to the global pool,
+     * freeing any which exceed the global pool's capacity.
+     */
+    void global_pool_give(int size_class, chunk_list& list, intptr_t count)
+    {
+        intptr_t max_count = max(intptr_t(thread_cache_chunk_count),
+                        intptr_t(global_cache_class_bytes) / size_class_bytes(size_class));
+        spin_lock_guard guard(global_pool.m_lock);
+        chunk_list& gl = global_pool.m_lists[size_class];
+        for (intptr_t i = 0; i < count && list.head != NULL; ++i) {
+            char *chunk = list.pop();
+            if (gl.count < max_count) {
+                gl.push(chunk);
+                global_pool.m_cached_bytes += size_class_bytes(size_class);
+            } else {
+                free(chunk);
+            }
+        }
+    }
+
+#ifdef DYND_THREAD_LOCAL
+    /**
+     * Set once the thread's cache has been destroyed, so that memory
+     * blocks freed later during thread or process shutdown go directly
+     * to the global pool.
+     */
+    DYND_THREAD_LOCAL bool thread_cache_destroyed = false;
+
+    /**
+     * A per-thread cache of the smaller size classes, which allows
+     * chunks to be reused without touching the global lock. When the
+     * thread exits, its chunks are returned to the global pool.
+     */
+    class thread_chunk_cache {
+        chunk_list m_lists[max_thread_cached_shift - min_size_class_shift + 1];
+
+        // Non-copyable
+        thread_chunk_cache(const thread_chunk_cache&);
+        thread_chunk_cache& operator=(const thread_chunk_cache&);
+    public:
+        thread_chunk_cache() {
+            memset(m_lists, 0, sizeof(m_lists));
+        }
+
+        ~thread_chunk_cache() {
+            trim();
+            thread_cache_destroyed = true;
+        }
+
+        inline static bool is_cached_class(int size_class) {
+            return size_class <= max_thread_cached_shift - min_size_class_shift;
+        }
+
+        inline char *allocate(int size_class) {
+            chunk_list& list = m_lists[size_class];
+            if (list.head == NULL) {
+                // Refill half the cache in one trip to the global pool
+                global_pool_take(size_class, list, thread_cache_chunk_count / 2);
+            }
+            return (list.head != NULL) ? list.pop() : NULL;
+        }
+
+        inline void free(char *chunk, int size_class) {
+            chunk_list& list = m_lists[size_class];
+            if (list.count >= thread_cache_chunk_count) {
+                // Spill half the cache in one trip to the global pool
+                global_pool_give(size_class, list, thread_cache_chunk_count / 2);
+            }
+            list.push(chunk);
+        }
+
+        void trim() {
+            for (int i = 0; i <= max_thread_cached_shift - min_size_class_shift; ++i) {
+                global_pool_give(i, m_lists[i], m_lists[i].count);
+            }
+        }
+    };
+
+    DYND_THREAD_LOCAL thread_chunk_cache thread_cache;
+
+    /**
+     * Returns the calling thread's chunk cache, or NULL if it
+     * has already been destroyed.
+     */
+    inline thread_chunk_cache *get_thread_cache() {
+        return thread_cache_destroyed ? NULL : &thread_cache;
+    }
+#endif // DYND_THREAD_LOCAL
+
+    memory_block_growth_policy growth_policy = {0, 100, 0};
+} // anonymous namespace
+
+const memory_block_growth_policy& dynd::get_memory_block_growth_policy()
+{
+    return growth_policy;
+}
+
+void dynd::set_memory_block_growth_policy(const memory_block_growth_policy& policy)
+{
+    if (policy.min_chunk_bytes < 0 || policy.growth_percent <= 0 ||
+                    policy.max_chunk_bytes < 0 ||
+                    (policy.max_chunk_bytes != 0 && policy.max_chunk_bytes < policy.min_chunk_bytes)) {
+        stringstream ss;
+        ss << "Invalid memory block growth policy: min_chunk_bytes " << policy.min_chunk_bytes;
+        ss << ", growth_percent " << policy.growth_percent;
+        ss << ", max_chunk_bytes " << policy.max_chunk_bytes;
+        throw runtime_error(ss.str());
+    }
+    growth_policy = policy;
+}
+
+intptr_t dynd::memory_chunk_pool_cached_bytes()
+{
+    spin_lock_guard guard(global_pool.m_lock);
+    return global_pool.m_cached_bytes;
+}
+
+void dynd::memory_chunk_pool_trim()
+{
+#ifdef DYND_THREAD_LOCAL
+    thread_chunk_cache *tc = get_thread_cache();
+    if (tc != NULL) {
+        tc->trim();
+    }
+#endif
+    spin_lock_guard guard(global_pool.m_lock);
+    for (int i = 0; i < size_class_count; ++i) {
+        chunk_list& gl = global_pool.m_lists[i];
+        while (gl.head != NULL) {
+            free(gl.pop());
+        }
+    }
+    global_pool.m_cached_bytes = 0;
+}
+
+char *dynd::detail::memory_chunk_allocate(intptr_t size_bytes, intptr_t *out_capacity)
+{
+    int size_class = get_size_class(size_bytes);
+    if (size_class < 0) {
+        // Too big for the pool
+        char *result = reinterpret_cast<char *>(malloc(size_bytes));
+        if (result == NULL) {
+            throw bad_alloc();
+        }
+        *out_capacity = size_bytes;
+        return result;
+    }
+
+    char *result = NULL;
+#ifdef DYND_THREAD_LOCAL
+    thread_chunk_cache *tc = get_thread_cache();
+    if (tc != NULL && thread_chunk_cache::is_cached_class(size_class)) {
+        result = tc->allocate(size_class);
+    } else
+#endif
+    {
+        chunk_list list = {NULL, 0};
+        if (global_pool_take(size_class, list, 1) == 1) {
+            result = list.pop();
+        }
+    }
+    if (result == NULL) {
+        result = reinterpret_cast<char *>(malloc(size_class_bytes(size_class)));
+        if (result == NULL) {
+            throw bad_alloc();
+        }
+    }
+    *out_capacity = size_class_bytes(size_class);
+    return result;
+}
+
+void dynd::detail::memory_chunk_free(char *chunk, intptr_t capacity)
+{
+    if (chunk == NULL) {
+        return;
+    }
+    int size_class = get_size_class(capacity);
+    if (size_class < 0 || size_class_bytes(size_class) != capacity) {
+        // Not a pooled chunk
+        free(chunk);
+        return;
+    }
+
+#ifdef DYND_THREAD_LOCAL
+    thread_chunk_cache *tc = get_thread_cache();
+    if (tc != NULL && thread_chunk_cache::is_cached_class(size_class)) {
+        tc->free(chunk, size_class);
+        return;
+    }
+#endif
+    chunk_list list = {NULL, 0};
+    list.push(chunk);
+    global_pool_give(size_class, list, 1);
+}
+
+intptr_t dynd::detail::memory_block_next_chunk_size(intptr_t total_allocated_bytes, intptr_t requested_bytes)
+{
+    const memory_block_growth_policy& policy = growth_policy;
+    intptr_t result = total_allocated_bytes / 100 * policy.growth_percent +
+                    total_allocated_bytes % 100 * policy.growth_percent / 100;
+    result = max(result, policy.min_chunk_bytes);
+    if (policy.max_chunk_bytes != 0) {
+        result = min(result, policy.max_chunk_bytes);
+    }
+    return max(result, requested_bytes);
+}
@@ -9,6 +9,7 @@
 #include <algorithm>
 
 #include <dynd/memblock/objectarray_memory_block.hpp>
+#include <dynd/memblock/memory_chunk_pool.hpp>
 
 using namespace std;
 using namespace dynd;
@@ -17,6 +18,8 @@ namespace {
     struct memory_chunk {
         char *memory;
         size_t used_count, capacity_count;
+        /** The capacity in bytes, as returned by the chunk pool */
+        intptr_t capacity_bytes;
     };
 
     struct objectarray_memory_block {
@@ -27,7 +30,7 @@ namespace {
         intptr_t m_stride;
         size_t m_total_allocated_count;
         bool m_finalized;
-        /** The malloc'd memory */
+        /** The memory chunks, obtained from the chunk pool */
         vector<memory_chunk> m_memory_handles;
 
         /**
@@ -39,14 +42,15 @@ namespace {
             m_memory_handles.push_back(memory_chunk());
             memory_chunk& mc = m_memory_handles.back();
             mc.used_count = 0;
-            mc.capacity_count = count;
-            char *memory = reinterpret_cast<char *>(malloc(m_stride * count));
-            mc.memory = memory;
-            if (memory == NULL) {
+            try {
+                mc.memory = detail::memory_chunk_allocate(m_stride * count, &mc.capacity_bytes);
+            } catch(...) {
                 m_memory_handles.pop_back();
-                throw bad_alloc();
+                throw;
             }
-            m_total_allocated_count += count;
+            // Use any extra capacity the chunk pool rounded up to
+            mc.capacity_count = (m_stride > 0) ? (mc.capacity_bytes / m_stride) : count;
+            m_total_allocated_count += mc.capacity_count;
         }
 
         objectarray_memory_block(const ndt::type& dt, const char *metadata, intptr_t stride, intptr_t initial_count)
@@ -68,7 +72,7 @@ namespace {
             for (size_t i = 0, i_end = m_memory_handles.size(); i != i_end; ++i) {
                 memory_chunk& mc = m_memory_handles[i];
                 m_dt.extended()->data_destruct_strided(m_metadata, mc.memory, m_stride, mc.used_count);
-                free(mc.memory);
+                detail::memory_chunk_free(mc.memory, mc.capacity_bytes);
             }
         }
     };
@@ -90,6 +94,20 @@ void free_objectarray_memory_block(memory_block_data *memblock)
     delete emb;
 }
 
+/**
+ * Returns the number of elements for the next chunk, following
+ * the memory block growth policy.
+ */
+static size_t next_chunk_count(objectarray_memory_block *emb, size_t count)
+{
+    if (emb->m_stride <= 0) {
+        return max(emb->m_total_allocated_count, count);
+    }
+    intptr_t size_bytes = detail::memory_block_next_chunk_size(
+                    emb->m_stride * emb->m_total_allocated_count, emb->m_stride * count);
+    return (size_bytes + emb->m_stride - 1) / emb->m_stride;
+}
+
 static char *allocate(memory_block_data *self, size_t count)
 {
 //    cout << "allocating " << size_bytes << " of memory with alignment " << alignment << endl;
@@ -97,7 +115,7 @@ static char *allocate(memory_block_data *self, size_t count)
     objectarray_memory_block *emb = reinterpret_cast<objectarray_memory_block *>(self);
     memory_chunk *mc = &emb->m_memory_handles.back();
     if (mc->capacity_count - mc->used_count < count) {
-        emb->append_memory(max(emb->m_total_allocated_count, count));
+        emb->append_memory(next_chunk_count(emb, count));
         mc = &emb->m_memory_handles.back();
     }
 
@@ -124,17 +142,19 @@ static char *resize(memory_block_data *self, char *previous_allocated, size_t co
     char *result = previous_allocated;
 
     if (mc->capacity_count - previous_index < count) {
-        emb->append_memory(max(emb->m_total_allocated_count, count));
+        emb->append_memory(next_chunk_count(emb, count));
+        // Appending may have reallocated the vector of chunks
+        mc = &emb->m_memory_handles[emb->m_memory_handles.size() - 2];
         memory_chunk *new_mc = &emb->m_memory_handles.back();
         // Move the old memory to the newly allocated block
         if (previous_count > 0) {
             // Subtract the previously used memory from the old chunk's count
             mc->used_count -= previous_count;
-            memcpy(new_mc->memory, previous_allocated, previous_count);
+            memcpy(new_mc->memory, previous_allocated, emb->m_stride * previous_count);
             // If the old memory only had the memory being resized,
             // free it completely.
             if (previous_allocated == mc->memory) {
-                free(mc->memory);
+                detail::memory_chunk_free(mc->memory, mc->capacity_bytes);
                 // Remove the second-last element of the vector
                 emb->m_memory_handles.erase(
                             emb->m_memory_handles.begin() +
@@ -159,7 +179,9 @@ static char *resize(memory_block_data *self, char *previous_allocated, size_t co
     if ((emb->m_dt.get_flags()&type_flag_zeroinit) != 0) {
         // Zero-init the new memory
         intptr_t new_count = count - (intptr_t)previous_count;
-        memset(mc->memory + emb->m_stride * previous_count, 0, emb->m_stride * new_count);
+        if (new_count > 0) {
+            memset(result + emb->m_stride * previous_count, 0, emb->m_stride * new_count);
+        }
     } else {
         // TODO: Add a default data constructor to base_type
         //       as well, with a flag for it
@@ -190,7 +212,7 @@ static void reset(memory_block_data *self)
             memory_chunk& mc = emb->m_memory_handles[i];
             emb->m_dt.extended()->data_destruct_strided(
                             emb->m_metadata, mc.memory, emb->m_stride, mc.used_count);
-            free(mc.memory);
+            detail::memory_chunk_free(mc.memory, mc.capacity_bytes);
         }
         emb->m_memory_handles.front() = emb->m_memory_handles.back();
         emb->m_memory_handles.resize(1);
@@ -4,54 +4,87 @@
 //
 
 #include <stdexcept>
+#include <sstream>
 #include <vector>
 #include <cstdlib>
 #include <algorithm>
 
 #include <dynd/memblock/pod_memory_block.hpp>
+#include <dynd/memblock/memory_chunk_pool.hpp>
 
 using namespace std;
 using namespace dynd;
 
 namespace {
+    struct memory_chunk {
+        char *memory;
+        intptr_t capacity;
+    };
+
     struct pod_memory_block {
         /** Every memory block object needs this at the front */
         memory_block_data m_mbd;
         intptr_t m_total_allocated_capacity;
-        /** The malloc'd memory */
-        vector<char *> m_memory_handles;
-        /** The current malloc'd memory being doled out */
+        /** The memory chunks, obtained from the chunk pool */
+        vector<memory_chunk> m_memory_handles;
+        /** The current memory chunk being doled out */
         char *m_memory_begin, *m_memory_current, *m_memory_end;
 
         /**
          * Allocates some new memory from which to dole out
-         * more. Adds it to the memory handles vector.
+         * more. Adds it to the memory handles vector. If exact
+         * is true, the chunk is not rounded up to a chunk pool
+         * size class.
          */
-        void append_memory(intptr_t capacity_bytes)
+        void append_memory(intptr_t capacity_bytes, bool exact = false)
         {
-            m_memory_handles.push_back(NULL);
-            m_memory_begin = reinterpret_cast<char *>(malloc(capacity_bytes));
-            m_memory_handles.back() = m_memory_begin;
-            if (m_memory_begin == NULL) {
-                m_memory_handles.pop_back();
-                throw bad_alloc();
+            m_memory_handles.push_back(memory_chunk());
+            memory_chunk& mc = m_memory_handles.back();
+            if (exact) {
+                // The chunk pool accepts any malloc'd chunk back
+                mc.memory = reinterpret_cast<char *>(malloc(max(capacity_bytes, (intptr_t)1)));
+                mc.capacity = capacity_bytes;
+                if (mc.memory == NULL) {
+                    m_memory_handles.pop_back();
+                    throw bad_alloc();
+                }
+            } else {
+                try {
+                    mc.memory = detail::memory_chunk_allocate(capacity_bytes, &mc.capacity);
+                } catch(...) {
+                    m_memory_handles.pop_back();
+                    throw;
+                }
             }
+            m_memory_begin = mc.memory;
             m_memory_current = m_memory_begin;
-            m_memory_end = m_memory_current + capacity_bytes;
-            m_total_allocated_capacity += capacity_bytes;
+            m_memory_end = m_memory_current + mc.capacity;
+            m_total_allocated_capacity += mc.capacity;
         }
 
-        pod_memory_block(intptr_t initial_capacity_bytes)
+        pod_memory_block(intptr_t initial_capacity_bytes, bool exact)
             : m_mbd(1, pod_memory_block_type), m_total_allocated_capacity(0),
                     m_memory_handles()
         {
-            append_memory(initial_capacity_bytes);
+            append_memory(initial_capacity_bytes, exact);
+        }
+
+        /** Takes ownership of a chunk from the chunk pool, which is already full */
+        pod_memory_block(char *chunk, intptr_t capacity)
+            : m_mbd(1, pod_memory_block_type), m_total_allocated_capacity(capacity),
+                    m_memory_handles(1)
+        {
+            m_memory_handles[0].memory = chunk;
+            m_memory_handles[0].capacity = capacity;
+            m_memory_begin = chunk;
+            m_memory_current = chunk + capacity;
+            m_memory_end = m_memory_current;
         }
 
         ~pod_memory_block()
         {
             for (size_t i = 0, i_end = m_memory_handles.size(); i != i_end; ++i) {
-                free(m_memory_handles[i]);
+                detail::memory_chunk_free(m_memory_handles[i].memory, m_memory_handles[i].capacity);
             }
         }
     };
@@ -59,10 +92,43 @@ namespace {
 
 memory_block_ptr dynd::make_pod_memory_block(intptr_t initial_capacity_bytes)
 {
-    pod_memory_block *pmb = new pod_memory_block(initial_capacity_bytes);
+    pod_memory_block *pmb = new pod_memory_block(initial_capacity_bytes, false);
+    return memory_block_ptr(reinterpret_cast<memory_block_data *>(pmb), false);
+}
+
+memory_block_ptr dynd::make_exact_pod_memory_block(intptr_t capacity_bytes)
+{
+    pod_memory_block *pmb = new pod_memory_block(capacity_bytes, true);
+    return memory_block_ptr(reinterpret_cast<memory_block_data *>(pmb), false);
+}
+
+memory_block_ptr dynd::make_pod_memory_block_from_chunk(char *chunk, intptr_t capacity)
+{
+    pod_memory_block *pmb;
+    try {
+        pmb = new pod_memory_block(chunk, capacity);
+    } catch(...) {
+        detail::memory_chunk_free(chunk, capacity);
+        throw;
+    }
     return memory_block_ptr(reinterpret_cast<memory_block_data *>(pmb), false);
 }
 
+intptr_t dynd::pod_memory_block_get_capacity(const memory_block_data *memblock)
+{
+    if (memblock->m_type != pod_memory_block_type) {
+        stringstream ss;
+        ss << "Cannot get the POD capacity of a " << (memory_block_type_t)memblock->m_type << " memory block";
+        throw runtime_error(ss.str());
+    }
+    const pod_memory_block *emb = reinterpret_cast<const pod_memory_block *>(memblock);
+    intptr_t result = 0;
+    for (size_t i = 0, i_end = emb->m_memory_handles.size(); i != i_end; ++i) {
+        result += emb->m_memory_handles[i].capacity;
+    }
+    return result;
+}
+
 namespace dynd { namespace detail {
 
 void free_pod_memory_block(memory_block_data *memblock)
@@ -71,6 +137,25 @@ void free_pod_memory_block(memory_block_data *memblock)
     delete emb;
 }
 
+void pod_memory_block_merge(memory_block_data *dst, memory_block_data *src)
+{
+    pod_memory_block *dst_emb = reinterpret_cast<pod_memory_block *>(dst);
+    pod_memory_block *src_emb = reinterpret_cast<pod_memory_block *>(src);
+    // The unused end of src's current chunk doesn't count as allocated
+    if (src_emb->m_memory_current < src_emb->m_memory_end) {
+        src_emb->m_total_allocated_capacity -= src_emb->m_memory_end - src_emb->m_memory_current;
+    }
+    // The chunks go in front, so the last chunk is still dst's current one
+    dst_emb->m_memory_handles.insert(dst_emb->m_memory_handles.begin(),
+                    src_emb->m_memory_handles.begin(), src_emb->m_memory_handles.end());
+    dst_emb->m_total_allocated_capacity += src_emb->m_total_allocated_capacity;
+    src_emb->m_memory_handles.clear();
+    src_emb->m_total_allocated_capacity = 0;
+    src_emb->m_memory_begin = NULL;
+    src_emb->m_memory_current = NULL;
+    src_emb->m_memory_end = NULL;
+}
+
 static void allocate(memory_block_data *self, intptr_t size_bytes, intptr_t alignment, char **out_begin, char **out_end)
 {
 //    cout << "allocating " << size_bytes << " of memory with alignment " << alignment << endl;
@@ -81,9 +166,11 @@ static void allocate(memory_block_data *self, intptr_t size_bytes, intptr_t alig
     char *end = begin + size_bytes;
     if (end > emb->m_memory_end) {
         emb->m_total_allocated_capacity -= emb->m_memory_end - emb->m_memory_current;
-        // Allocate memory to double the amount used so far, or the requested size, whichever is larger
+        // Allocate memory according to the growth policy, by default doubling the amount
+        // used so far, or the requested size, whichever is larger
         // NOTE: We're assuming malloc produces memory which has good enough alignment for anything
-        emb->append_memory(max(emb->m_total_allocated_capacity, size_bytes));
+        emb->append_memory(detail::memory_block_next_chunk_size(
+                        emb->m_total_allocated_capacity, size_bytes));
         begin = emb->m_memory_begin;
         end = begin + size_bytes;
     }
@@ -115,9 +202,11 @@ static void resize(memory_block_data *self, intptr_t size_bytes, char **inout_be
     } else {
         // If it doesn't fit, need to copy to newly malloc'd memory
 		char *old_current = *inout_begin, *old_end = *inout_end;
-        // Allocate memory to double the amount used so far, or the requested size, whichever is larger
+        // Allocate memory according to the growth policy, by default doubling the amount
+        // used so far, or the requested size, whichever is larger
         // NOTE: We're assuming malloc produces memory which has good enough alignment for anything
-        emb->append_memory(max(emb->m_total_allocated_capacity, size_bytes));
+        emb->append_memory(detail::memory_block_next_chunk_size(
+                        emb->m_total_allocated_capacity, size_bytes));
         memcpy(emb->m_memory_begin, *inout_begin, *inout_end - *inout_begin);
         end = emb->m_memory_begin + size_bytes;
         emb->m_memory_current = end;
@@ -150,7 +239,8 @@ static void reset(memory_block_data *self)
         // If there are more than one allocated memory chunks,
         // throw them all away except the last
         for (size_t i = 0, i_end = emb->m_memory_handles.size() - 1; i != i_end; ++i) {
-            free(emb->m_memory_handles[i]);
+            detail::memory_chunk_free(emb->m_memory_handles[i].memory,
+                            emb->m_memory_handles[i].capacity);
         }
         emb->m_memory_handles.front() = emb->m_memory_handles.back();
         emb->m_memory_handles.resize(1);
@@ -9,18 +9,24 @@
 #include <algorithm>
 
 #include <dynd/memblock/zeroinit_memory_block.hpp>
+#include <dynd/memblock/memory_chunk_pool.hpp>
 
 using namespace std;
 using namespace dynd;
 
 namespace {
+    struct memory_chunk {
+        char *memory;
+        intptr_t capacity;
+    };
+
     struct zeroinit_memory_block {
         /** Every memory block object needs this at the front */
         memory_block_data m_mbd;
         intptr_t m_total_allocated_capacity;
-        /** The malloc'd memory */
-        vector<char *> m_memory_handles;
-        /** The current malloc'd memory being doled out */
+        /** The memory chunks, obtained from the chunk pool */
+        vector<memory_chunk> m_memory_handles;
+        /** The current memory chunk being doled out */
         char *m_memory_begin, *m_memory_current, *m_memory_end;
 
         /**
@@ -29,16 +35,18 @@ namespace {
          */
         void append_memory(intptr_t capacity_bytes)
         {
-            m_memory_handles.push_back(NULL);
-            m_memory_begin = reinterpret_cast<char *>(malloc(capacity_bytes));
-            m_memory_handles.back() = m_memory_begin;
-            if (m_memory_begin == NULL) {
+            m_memory_handles.push_back(memory_chunk());
+            memory_chunk& mc = m_memory_handles.back();
+            try {
+                mc.memory = detail::memory_chunk_allocate(capacity_bytes, &mc.capacity);
+            } catch(...) {
                 m_memory_handles.pop_back();
-                throw bad_alloc();
+                throw;
             }
+            m_memory_begin = mc.memory;
             m_memory_current = m_memory_begin;
-            m_memory_end = m_memory_current + capacity_bytes;
-            m_total_allocated_capacity += capacity_bytes;
+            m_memory_end = m_memory_current + mc.capacity;
+            m_total_allocated_capacity += mc.capacity;
         }
 
         zeroinit_memory_block(intptr_t initial_capacity_bytes)
@@ -51,7 +59,7 @@ namespace {
         ~zeroinit_memory_block()
         {
             for (size_t i = 0, i_end = m_memory_handles.size(); i != i_end; ++i) {
-                free(m_memory_handles[i]);
+                detail::memory_chunk_free(m_memory_handles[i].memory, m_memory_handles[i].capacity);
             }
         }
     };
@@ -71,6 +79,25 @@ void free_zeroinit_memory_block(memory_block_data *memblock)
     delete emb;
 }
 
+void zeroinit_memory_block_merge(memory_block_data *dst, memory_block_data *src)
+{
+    zeroinit_memory_block *dst_emb = reinterpret_cast<zeroinit_memory_block *>(dst);
+    zeroinit_memory_block *src_emb = reinterpret_cast<zeroinit_memory_block *>(src);
+    // The unused end of src's current chunk doesn't count as allocated
+    if (src_emb->m_memory_current < src_emb->m_memory_end) {
+        src_emb->m_total_allocated_capacity -= src_emb->m_memory_end - src_emb->m_memory_current;
+    }
+    // The chunks go in front, so the last chunk is still dst's current one
+    dst_emb->m_memory_handles.insert(dst_emb->m_memory_handles.begin(),
+                    src_emb->m_memory_handles.begin(), src_emb->m_memory_handles.end());
+    dst_emb->m_total_allocated_capacity += src_emb->m_total_allocated_capacity;
+    src_emb->m_memory_handles.clear();
+    src_emb->m_total_allocated_capacity = 0;
+    src_emb->m_memory_begin = NULL;
+    src_emb->m_memory_current = NULL;
+    src_emb->m_memory_end = NULL;
+}
+
 static void allocate(memory_block_data *self, intptr_t size_bytes, intptr_t alignment, char **out_begin, char **out_end)
 {
 //    cout << "allocating " << size_bytes << " of memory with alignment " << alignment << endl;
@@ -81,9 +108,11 @@ static void allocate(memory_block_data *self, intptr_t size_bytes, intptr_t alig
     char *end = begin + size_bytes;
     if (end > emb->m_memory_end) {
         emb->m_total_allocated_capacity -= emb->m_memory_end - emb->m_memory_current;
-        // Allocate memory to double the amount used so far, or the requested size, whichever is larger
+        // Allocate memory according to the growth policy, by default doubling the amount
+        // used so far, or the requested size, whichever is larger
         // NOTE: We're assuming malloc produces memory which has good enough alignment for anything
-        emb->append_memory(max(emb->m_total_allocated_capacity, size_bytes));
+        emb->append_memory(detail::memory_block_next_chunk_size(
+                        emb->m_total_allocated_capacity, size_bytes));
         begin = emb->m_memory_begin;
         end = begin + size_bytes;
     }
@@ -123,9 +152,11 @@ static void resize(memory_block_data *self, intptr_t size_bytes, char **inout_be
         // If it doesn't fit, need to copy to newly malloc'd memory
 		char *old_current = *inout_begin, *old_end = *inout_end;
         intptr_t old_size_bytes = *inout_end - *inout_begin;
-        // Allocate memory to double the amount used so far, or the requested size, whichever is larger
+        // Allocate memory according to the growth policy, by default doubling the amount
+        // used so far, or the requested size, whichever is larger
         // NOTE: We're assuming malloc produces memory which has good enough alignment for anything
-        emb->append_memory(max(emb->m_total_allocated_capacity, size_bytes));
+        emb->append_memory(detail::memory_block_next_chunk_size(
+                        emb->m_total_allocated_capacity, size_bytes));
         memcpy(emb->m_memory_begin, *inout_begin, old_size_bytes);
         end = emb->m_memory_begin + size_bytes;
         emb->m_memory_current = end;
@@ -161,7 +192,8 @@ static void reset(memory_block_data *self)
         // If there are more than one allocated memory chunks,
         // throw them all away except the last
         for (size_t i = 0, i_end = emb->m_memory_handles.size() - 1; i != i_end; ++i) {
-            free(emb->m_memory_handles[i]);
+            detail::memory_chunk_free(emb->m_memory_handles[i].memory,
+                            emb->m_memory_handles[i].capacity);
         }
         emb->m_memory_handles.front() = emb->m_memory_handles.back();
         emb->m_memory_handles.resize(1);
@@ -368,6 +368,92 @@ void dynd::multistrides_to_axis_perm(intptr_t ndim, int noperands, const intptr_
     }
 }
 
+bool dynd::get_strided_dim_params(const ndt::type& tp, const char *metadata,
+                intptr_t& out_size, intptr_t& out_stride,
+                ndt::type& out_el_tp, const char *&out_el_metadata)
+{
+    switch (tp.get_type_id()) {
+        case strided_dim_type_id: {
+            const strided_dim_type *sdd = static_cast<const strided_dim_type *>(tp.extended());
+            const strided_dim_type_metadata *md = reinterpret_cast<const strided_dim_type_metadata *>(metadata);
+            out_size = md->size;
+            out_stride = md->stride;
+            out_el_tp = sdd->get_element_type();
+            out_el_metadata = metadata + sizeof(strided_dim_type_metadata);
+            return true;
+        }
+        case fixed_dim_type_id: {
+            const fixed_dim_type *fdd = static_cast<const fixed_dim_type *>(tp.extended());
+            out_size = fdd->get_fixed_dim_size();
+            out_stride = fdd->get_fixed_stride();
+            out_el_tp = fdd->get_element_type();
+            out_el_metadata = metadata;
+            return true;
+        }
+        default:
+            return false;
+    }
+}
+
+void dynd::optimize_strided_dims(intptr_t& inout_ndim, intptr_t *shape,
+                int noperands, intptr_t **operstrides)
+{
+    // Remove the size-one dimensions, which don't affect the loop
+    intptr_t ndim = 0;
+    for (intptr_t i = 0; i < inout_ndim; ++i) {
+        if (shape[i] != 1) {
+            shape[ndim] = shape[i];
+            for (int j = 0; j < noperands; ++j) {
+                operstrides[j][ndim] = operstrides[j][i];
+            }
+            ++ndim;
+        }
+    }
+
+    if (ndim > 1) {
+        // Reorder the dimensions so the smallest strides are innermost.
+        // In axis_perm, the smallest strides come first.
+        shortvector<int> axis_perm(ndim);
+        dimvector tmp(ndim);
+        multistrides_to_axis_perm(ndim, noperands, operstrides, axis_perm.get());
+        for (intptr_t i = 0; i < ndim; ++i) {
+            tmp[ndim - i - 1] = shape[axis_perm[i]];
+        }
+        memcpy(shape, tmp.get(), ndim * sizeof(intptr_t));
+        for (int j = 0; j < noperands; ++j) {
+            for (intptr_t i = 0; i < ndim; ++i) {
+                tmp[ndim - i - 1] = operstrides[j][axis_perm[i]];
+            }
+            memcpy(operstrides[j], tmp.get(), ndim * sizeof(intptr_t));
+        }
+
+        // Merge each dimension into the one outside it when the
+        // outer stride steps over exactly the inner dimension
+        intptr_t outer = 0;
+        for (intptr_t i = 1; i < ndim; ++i) {
+            bool can_merge = true;
+            for (int j = 0; j < noperands; ++j) {
+                if (operstrides[j][outer] != operstrides[j][i] * shape[i]) {
+                    can_merge = false;
+                    break;
+                }
+            }
+            if (can_merge) {
+                shape[outer] *= shape[i];
+            } else {
+                ++outer;
+                shape[outer] = shape[i];
+            }
+            for (int j = 0; j < noperands; ++j) {
+                operstrides[j][outer] = operstrides[j][i];
+            }
+        }
+        ndim = outer + 1;
+    }
+
+    inout_ndim = ndim;
+}
+
 void dynd::print_shape(std::ostream& o, intptr_t ndim, const intptr_t *shape)
 {
     o << "(";
@@ -665,8 +751,9 @@ axis_order_classification_t dynd::classify_strided_axis_order(intptr_t current_s
             }
         }
         case pointer_type_id:
+        case offset_dim_type_id:
         case var_dim_type_id: {
-            // A pointer or a var type is treated like C-order
+            // A pointer, offset or var type is treated like C-order
             axis_order_classification_t aoc =
                             element_tp.extended()->classify_axis_order(element_metadata);
             return (aoc == axis_order_none || aoc == axis_order_c)
@@ -0,0 +1,66 @@
+//
+// Copyright (C) 2011-14 Mark Wiebe, DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <dynd/strided_view.hpp>
+#include <dynd/types/strided_dim_type.hpp>
+#include <dynd/types/fixed_dim_type.hpp>
+#include <dynd/exceptions.hpp>
+
+using namespace std;
+using namespace dynd;
+
+bool dynd::detail::get_strided_view_layout(const nd::array& a, int ndim, const ndt::type& dtp,
+                intptr_t *out_shape, intptr_t *out_strides)
+{
+    const ndt::type *tp = &a.get_type();
+    const char *metadata = a.get_ndo_meta();
+    for (int i = 0; i < ndim; ++i) {
+        switch (tp->get_type_id()) {
+            case strided_dim_type_id: {
+                const strided_dim_type_metadata *md =
+                                reinterpret_cast<const strided_dim_type_metadata *>(metadata);
+                out_shape[i] = md->size;
+                out_strides[i] = md->stride;
+                metadata += sizeof(strided_dim_type_metadata);
+                tp = &static_cast<const strided_dim_type *>(tp->extended())->get_element_type();
+                break;
+            }
+            case fixed_dim_type_id: {
+                const fixed_dim_type *fdt = static_cast<const fixed_dim_type *>(tp->extended());
+                out_shape[i] = fdt->get_fixed_dim_size();
+                out_strides[i] = fdt->get_fixed_stride();
+                tp = &fdt->get_element_type();
+                break;
+            }
+            default: {
+                stringstream ss;
+                ss << "cannot make a " << ndim << "-dimensional strided view of " << dtp;
+                ss << " from array with type " << a.get_type();
+                throw type_error(ss.str());
+            }
+        }
+    }
+    if (*tp != dtp) {
+        stringstream ss;
+        ss << "cannot make a " << ndim << "-dimensional strided view of " << dtp;
+        ss << " from array with type " << a.get_type();
+        throw type_error(ss.str());
+    }
+
+    // Check for C order, ignoring the strides of size 0 and 1 dimensions
+    intptr_t expected_stride = dtp.get_data_size();
+    bool contiguous = true;
+    for (int i = ndim - 1; i >= 0; --i) {
+        if (out_shape[i] == 0) {
+            return true;
+        } else if (out_shape[i] != 1) {
+            if (out_strides[i] != expected_stride) {
+                contiguous = false;
+            }
+            expected_stride *= out_shape[i];
+        }
+    }
+    return contiguous;
+}
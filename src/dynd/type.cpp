@@ -271,8 +271,9 @@ bool ndt::type::data_layout_compatible_with(const ndt::type& rhs) const
             }
             break;
         case strided_dim_type_id:
+        case offset_dim_type_id:
         case var_dim_type_id:
-            // For strided and var dimensions, it's data layout
+            // For strided, offset and var dimensions, it's data layout
             // compatible if the element is
             if (rhs.get_type_id() == get_type_id()) {
                 const base_uniform_dim_type *budd = static_cast<const base_uniform_dim_type *>(extended());
@@ -16,6 +16,12 @@ base_expression_type::~base_expression_type()
 {
 }
 
+size_t base_expression_type::compute_hash() const
+{
+    size_t result = hash_combine(base_type::compute_hash(), get_value_type().get_hash());
+    return hash_combine(result, get_operand_type().get_hash());
+}
+
 bool base_expression_type::is_expression() const
 {
     return true;
@@ -20,6 +20,11 @@ base_string_type::~base_string_type()
 {
 }
 
+size_t base_string_type::compute_hash() const
+{
+    return hash_combine(base_type::compute_hash(), get_encoding());
+}
+
 std::string base_string_type::get_utf8_string(const char *metadata, const char *data, assign_error_mode errmode) const
 {
     const char *begin, *end;
@@ -15,6 +15,21 @@ using namespace dynd;
 base_struct_type::~base_struct_type() {
 }
 
+size_t base_struct_type::compute_hash() const
+{
+    size_t result = base_type::compute_hash();
+    const ndt::type *field_types = get_field_types();
+    const string *field_names = get_field_names();
+    for (size_t i = 0; i != m_field_count; ++i) {
+        const string& name = field_names[i];
+        for (size_t j = 0, j_end = name.size(); j != j_end; ++j) {
+            result = hash_combine(result, static_cast<uint8_t>(name[j]));
+        }
+        result = hash_combine(result, field_types[i].get_hash());
+    }
+    return result;
+}
+
 void base_struct_type::get_shape(intptr_t ndim, intptr_t i, intptr_t *out_shape,
                 const char *metadata, const char *DYND_UNUSED(data)) const
 {
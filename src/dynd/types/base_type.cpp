@@ -3,7 +3,11 @@
 // BSD 2-Clause License, see LICENSE.txt
 //
 
+#include <map>
+#include <sstream>
+
 #include <dynd/type.hpp>
+#include <dynd/platform_mutex.hpp>
 #include <dynd/gfunc/callable.hpp>
 #include <dynd/types/builtin_type_properties.hpp>
 
@@ -15,6 +19,99 @@ base_type::~base_type()
 {
 }
 
+namespace {
+    /**
+     * The table of interned types. It's split into shards by hash,
+     * each with its own mutex, so threads making different types
+     * rarely contend.
+     */
+    struct type_intern_table {
+        enum { shard_count = 16 };
+
+        struct shard {
+            platform_mutex mutex;
+            /** The interned types, which hold no references */
+            multimap<size_t, const base_type *> types;
+        };
+
+        shard shards[shard_count];
+
+        shard& get_shard(size_t hash) {
+            return shards[(hash ^ (hash >> 16)) % shard_count];
+        }
+    };
+
+    type_intern_table& get_type_intern_table()
+    {
+        // Never destroyed, so that types released during static
+        // destruction can still remove themselves
+        static type_intern_table *table = new type_intern_table;
+        return *table;
+    }
+} // anonymous namespace
+
+size_t base_type::get_hash() const
+{
+    return m_interned ? m_hash : compute_hash();
+}
+
+size_t base_type::compute_hash() const
+{
+    size_t result = get_type_id();
+    result = hash_combine(result, get_kind());
+    result = hash_combine(result, get_data_size());
+    result = hash_combine(result, get_data_alignment());
+    result = hash_combine(result, get_metadata_size());
+    return hash_combine(result, get_ndim());
+}
+
+const base_type *dynd::intern_base_type(const base_type *bt)
+{
+    size_t hash = bt->compute_hash();
+    type_intern_table::shard& sh = get_type_intern_table().get_shard(hash);
+    const base_type *existing = NULL;
+    {
+        platform_mutex::scoped_lock lock(sh.mutex);
+        typedef multimap<size_t, const base_type *>::iterator iterator;
+        pair<iterator, iterator> range = sh.types.equal_range(hash);
+        for (iterator it = range.first; it != range.second; ++it) {
+            // Types being released have a zero use count, and
+            // mustn't be brought back
+            if (*it->second == *bt && atomic_refcount_increment_if_nonzero(it->second->m_use_count)) {
+                existing = it->second;
+                break;
+            }
+        }
+        if (existing == NULL) {
+            base_type *mbt = const_cast<base_type *>(bt);
+            mbt->m_hash = hash;
+            mbt->m_interned = true;
+            sh.types.insert(make_pair(hash, bt));
+            return bt;
+        }
+    }
+    // Release the duplicate outside the lock, as it may release interned types
+    base_type_decref(bt);
+    return existing;
+}
+
+void dynd::release_interned_base_type(const base_type *bt)
+{
+    type_intern_table::shard& sh = get_type_intern_table().get_shard(bt->m_hash);
+    {
+        platform_mutex::scoped_lock lock(sh.mutex);
+        typedef multimap<size_t, const base_type *>::iterator iterator;
+        pair<iterator, iterator> range = sh.types.equal_range(bt->m_hash);
+        for (iterator it = range.first; it != range.second; ++it) {
+            if (it->second == bt) {
+                sh.types.erase(it);
+                break;
+            }
+        }
+    }
+    delete bt;
+}
+
 bool base_type::is_type_subarray(const ndt::type& subarray_tp) const
 {
     // The default implementation is to check by-value equality.
@@ -171,6 +268,16 @@ void base_type::metadata_finalize_buffers(char *DYND_UNUSED(metadata)) const
     // By default there are no buffers to finalize
 }
 
+void base_type::metadata_merge_buffers(char *DYND_UNUSED(dst_metadata), char *DYND_UNUSED(src_metadata)) const
+{
+    // By default there are no buffers to merge
+    if (get_flags()&type_flag_blockref) {
+        stringstream ss;
+        ss << "TODO: metadata_merge_buffers for " << ndt::type(this, true) << " is not implemented";
+        throw std::runtime_error(ss.str());
+    }
+}
+
 // TODO: Make this a pure virtual function eventually
 void base_type::metadata_destruct(char *DYND_UNUSED(metadata)) const
 {
@@ -12,3 +12,8 @@ using namespace dynd;
 
 base_uniform_dim_type::~base_uniform_dim_type() {
 }
+
+size_t base_uniform_dim_type::compute_hash() const
+{
+    return hash_combine(base_type::compute_hash(), m_element_tp.get_hash());
+}
@@ -210,6 +210,15 @@ void bytes_type::metadata_finalize_buffers(char *metadata) const
     }
 }
 
+void bytes_type::metadata_merge_buffers(char *dst_metadata, char *src_metadata) const
+{
+    bytes_type_metadata *dst_md = reinterpret_cast<bytes_type_metadata *>(dst_metadata);
+    bytes_type_metadata *src_md = reinterpret_cast<bytes_type_metadata *>(src_metadata);
+    if (dst_md->blockref != NULL && src_md->blockref != NULL) {
+        memory_block_merge(dst_md->blockref, src_md->blockref);
+    }
+}
+
 void bytes_type::metadata_destruct(char *metadata) const
 {
     bytes_type_metadata *md = reinterpret_cast<bytes_type_metadata *>(metadata);
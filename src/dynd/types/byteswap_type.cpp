@@ -92,6 +92,41 @@ ndt::type byteswap_type::with_replaced_storage_type(const ndt::type& replacement
     }
 }
 
+size_t byteswap_type::make_assignment_kernel(
+                ckernel_builder *out, size_t offset_out,
+                const ndt::type& dst_tp, const char *dst_metadata,
+                const ndt::type& src_tp, const char *src_metadata,
+                kernel_request_t kernreq, assign_error_mode errmode,
+                const eval::eval_context *ectx) const
+{
+    // Fuse the byteswap with a conversion to or from another builtin type
+    if (m_operand_type.get_kind() != expression_kind && errmode != assign_error_default) {
+        if (this == src_tp.extended() && dst_tp.is_builtin() && dst_tp != m_value_type &&
+                        dst_tp.get_type_id() >= bool_type_id &&
+                        dst_tp.get_type_id() <= complex_float64_type_id) {
+            if (errmode != assign_error_none && ::dynd::is_lossless_assignment(dst_tp, m_value_type)) {
+                errmode = assign_error_none;
+            }
+            return make_byteswap_builtin_assignment_kernel(out, offset_out,
+                            dst_tp.get_type_id(), m_value_type.get_type_id(), true,
+                            kernreq, errmode);
+        } else if (this == dst_tp.extended() && src_tp.is_builtin() && src_tp != m_value_type &&
+                        src_tp.get_type_id() >= bool_type_id &&
+                        src_tp.get_type_id() <= complex_float64_type_id) {
+            if (errmode != assign_error_none && ::dynd::is_lossless_assignment(m_value_type, src_tp)) {
+                errmode = assign_error_none;
+            }
+            return make_byteswap_builtin_assignment_kernel(out, offset_out,
+                            m_value_type.get_type_id(), src_tp.get_type_id(), false,
+                            kernreq, errmode);
+        }
+    }
+
+    return base_expression_type::make_assignment_kernel(out, offset_out,
+                    dst_tp, dst_metadata, src_tp, src_metadata,
+                    kernreq, errmode, ectx);
+}
+
 size_t byteswap_type::make_operand_to_value_assignment_kernel(
                 ckernel_builder *out, size_t offset_out,
                 const char *DYND_UNUSED(dst_metadata), const char *DYND_UNUSED(src_metadata),
@@ -10,6 +10,7 @@
 #include <dynd/array_iter.hpp>
 #include <dynd/types/categorical_type.hpp>
 #include <dynd/kernels/assignment_kernels.hpp>
+#include <dynd/kernels/ckernel_debug_info.hpp>
 #include <dynd/kernels/comparison_kernels.hpp>
 #include <dynd/types/strided_dim_type.hpp>
 #include <dynd/types/convert_type.hpp>
@@ -425,22 +426,18 @@ size_t categorical_type::make_assignment_kernel(
         }
         // assign from the same category value type
         else if (src_tp == m_category_tp) {
-            offset_out = make_kernreq_to_single_kernel_adapter(out, offset_out, kernreq);
             out->ensure_capacity_leaf(offset_out + sizeof(category_to_categorical_kernel_extra));
             category_to_categorical_kernel_extra *e =
                             out->get_at<category_to_categorical_kernel_extra>(offset_out);
             switch (m_storage_type.get_type_id()) {
                 case uint8_type_id:
-                    e->base.set_function<unary_single_operation_t>(
-                                    &category_to_categorical_kernel_extra::single_uint8);
+                    set_unary_single_or_strided_function<&category_to_categorical_kernel_extra::single_uint8>(&e->base, kernreq);
                     break;
                 case uint16_type_id:
-                    e->base.set_function<unary_single_operation_t>(
-                                    &category_to_categorical_kernel_extra::single_uint16);
+                    set_unary_single_or_strided_function<&category_to_categorical_kernel_extra::single_uint16>(&e->base, kernreq);
                     break;
                 case uint32_type_id:
-                    e->base.set_function<unary_single_operation_t>(
-                                    &category_to_categorical_kernel_extra::single_uint32);
+                    set_unary_single_or_strided_function<&category_to_categorical_kernel_extra::single_uint32>(&e->base, kernreq);
                     break;
                 default:
                     throw runtime_error("internal error in categorical_type::make_assignment_kernel");
@@ -468,18 +465,17 @@ size_t categorical_type::make_assignment_kernel(
     }
     else {
         if (dst_tp.value_type().get_type_id() != categorical_type_id) {
-            offset_out = make_kernreq_to_single_kernel_adapter(out, offset_out, kernreq);
             out->ensure_capacity(offset_out + sizeof(categorical_to_other_kernel_extra));
             categorical_to_other_kernel_extra *e = out->get_at<categorical_to_other_kernel_extra>(offset_out);
             switch (m_storage_type.get_type_id()) {
                 case uint8_type_id:
-                    e->base.set_function<unary_single_operation_t>(&categorical_to_other_kernel_extra::single_uint8);
+                    set_unary_single_or_strided_function<&categorical_to_other_kernel_extra::single_uint8>(&e->base, kernreq);
                     break;
                 case uint16_type_id:
-                    e->base.set_function<unary_single_operation_t>(&categorical_to_other_kernel_extra::single_uint16);
+                    set_unary_single_or_strided_function<&categorical_to_other_kernel_extra::single_uint16>(&e->base, kernreq);
                     break;
                 case uint32_type_id:
-                    e->base.set_function<unary_single_operation_t>(&categorical_to_other_kernel_extra::single_uint32);
+                    set_unary_single_or_strided_function<&categorical_to_other_kernel_extra::single_uint32>(&e->base, kernreq);
                     break;
                 default:
                     throw runtime_error("internal error in categorical_type::make_assignment_kernel");
@@ -502,6 +498,12 @@ size_t categorical_type::make_assignment_kernel(
 
 }
 
+size_t categorical_type::compute_hash() const
+{
+    size_t result = hash_combine(base_type::compute_hash(), m_category_tp.get_hash());
+    return hash_combine(result, get_category_count());
+}
+
 bool categorical_type::operator==(const base_type& rhs) const
 {
     if (this == &rhs)
@@ -625,3 +627,29 @@ void categorical_type::get_dynamic_type_properties(
     *out_count = sizeof(categorical_type_properties) / sizeof(categorical_type_properties[0]);
 }
 
+namespace {
+    ckernel_debug_info_registrar categorical_to_other_uint8_single_reg(&categorical_to_other_kernel_extra::single_uint8,
+                    "categorical uint8 to category assign", sizeof(categorical_to_other_kernel_extra), false, &ckernel_child_follows);
+    ckernel_debug_info_registrar categorical_to_other_uint8_strided_reg(&strided_loop_of_single<&categorical_to_other_kernel_extra::single_uint8>,
+                    "categorical uint8 to category assign", sizeof(categorical_to_other_kernel_extra), true, &ckernel_child_follows);
+    ckernel_debug_info_registrar categorical_to_other_uint16_single_reg(&categorical_to_other_kernel_extra::single_uint16,
+                    "categorical uint16 to category assign", sizeof(categorical_to_other_kernel_extra), false, &ckernel_child_follows);
+    ckernel_debug_info_registrar categorical_to_other_uint16_strided_reg(&strided_loop_of_single<&categorical_to_other_kernel_extra::single_uint16>,
+                    "categorical uint16 to category assign", sizeof(categorical_to_other_kernel_extra), true, &ckernel_child_follows);
+    ckernel_debug_info_registrar categorical_to_other_uint32_single_reg(&categorical_to_other_kernel_extra::single_uint32,
+                    "categorical uint32 to category assign", sizeof(categorical_to_other_kernel_extra), false, &ckernel_child_follows);
+    ckernel_debug_info_registrar categorical_to_other_uint32_strided_reg(&strided_loop_of_single<&categorical_to_other_kernel_extra::single_uint32>,
+                    "categorical uint32 to category assign", sizeof(categorical_to_other_kernel_extra), true, &ckernel_child_follows);
+    ckernel_debug_info_registrar category_to_categorical_uint8_single_reg(&category_to_categorical_kernel_extra::single_uint8,
+                    "category to categorical uint8 assign", sizeof(category_to_categorical_kernel_extra), false, NULL);
+    ckernel_debug_info_registrar category_to_categorical_uint8_strided_reg(&strided_loop_of_single<&category_to_categorical_kernel_extra::single_uint8>,
+                    "category to categorical uint8 assign", sizeof(category_to_categorical_kernel_extra), true, NULL);
+    ckernel_debug_info_registrar category_to_categorical_uint16_single_reg(&category_to_categorical_kernel_extra::single_uint16,
+                    "category to categorical uint16 assign", sizeof(category_to_categorical_kernel_extra), false, NULL);
+    ckernel_debug_info_registrar category_to_categorical_uint16_strided_reg(&strided_loop_of_single<&category_to_categorical_kernel_extra::single_uint16>,
+                    "category to categorical uint16 assign", sizeof(category_to_categorical_kernel_extra), true, NULL);
+    ckernel_debug_info_registrar category_to_categorical_uint32_single_reg(&category_to_categorical_kernel_extra::single_uint32,
+                    "category to categorical uint32 assign", sizeof(category_to_categorical_kernel_extra), false, NULL);
+    ckernel_debug_info_registrar category_to_categorical_uint32_strided_reg(&strided_loop_of_single<&category_to_categorical_kernel_extra::single_uint32>,
+                    "category to categorical uint32 assign", sizeof(category_to_categorical_kernel_extra), true, NULL);
+} // anonymous namespace
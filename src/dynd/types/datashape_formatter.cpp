@@ -138,6 +138,9 @@ static void format_string_datashape(std::ostream& o, const ndt::type& dt)
     switch (dt.get_type_id()) {
         case string_type_id:
         case fixedstring_type_id:
+        case packed_string_type_id:
+        case small_string_type_id:
+        case dictionary_string_type_id:
             // data shape only has one kind of string
             o << "string";
             break;
@@ -4,8 +4,9 @@
 //
 
 #include <map>
-#include <set>
+#include <list>
 
+#include <dynd/platform_mutex.hpp>
 #include <dynd/types/datashape_parser.hpp>
 #include <dynd/types/strided_dim_type.hpp>
 #include <dynd/types/var_dim_type.hpp>
@@ -13,6 +14,9 @@
 #include <dynd/types/cstruct_type.hpp>
 #include <dynd/types/string_type.hpp>
 #include <dynd/types/fixedstring_type.hpp>
+#include <dynd/types/packed_string_type.hpp>
+#include <dynd/types/small_string_type.hpp>
+#include <dynd/types/dictionary_string_type.hpp>
 #include <dynd/types/json_type.hpp>
 #include <dynd/types/date_type.hpp>
 #include <dynd/types/datetime_type.hpp>
@@ -54,59 +58,122 @@ namespace {
 
 static ndt::type parse_rhs_expression(const char *&begin, const char *end, map<string, ndt::type>& symtable);
 
-static const map<string, ndt::type>& get_builtin_types()
-{
-    static map<string, ndt::type> builtin_types;
-    if (builtin_types.empty()) {
-        builtin_types["void"] = ndt::make_type<void>();
-        builtin_types["bool"] = ndt::make_type<dynd_bool>();
-        builtin_types["int8"] = ndt::make_type<int8_t>();
-        builtin_types["int16"] = ndt::make_type<int16_t>();
-        builtin_types["int32"] = ndt::make_type<int32_t>();
-        builtin_types["int64"] = ndt::make_type<int64_t>();
-        builtin_types["int128"] = ndt::make_type<dynd_int128>();
-        builtin_types["intptr"] = ndt::make_type<intptr_t>();
-        builtin_types["uint8"] = ndt::make_type<uint8_t>();
-        builtin_types["uint16"] = ndt::make_type<uint16_t>();
-        builtin_types["uint32"] = ndt::make_type<uint32_t>();
-        builtin_types["uint64"] = ndt::make_type<uint64_t>();
-        builtin_types["uint128"] = ndt::make_type<dynd_uint128>();
-        builtin_types["uintptr"] = ndt::make_type<uintptr_t>();
-        builtin_types["float16"] = ndt::make_type<dynd_float16>();
-        builtin_types["float32"] = ndt::make_type<float>();
-        builtin_types["float64"] = ndt::make_type<double>();
-        builtin_types["float128"] = ndt::make_type<dynd_float128>();
-        builtin_types["complex64"] = ndt::make_type<dynd_complex<float> >();
-        builtin_types["complex128"] = ndt::make_type<dynd_complex<double> >();
-        builtin_types["json"] = ndt::make_json();
-        builtin_types["date"] = ndt::make_date();
-        builtin_types["bytes"] = ndt::make_bytes(1);
-        builtin_types["type"] = ndt::make_type();
-        builtin_types["ckernel_deferred"] = ndt::make_ckernel_deferred();
-    }
-    return builtin_types;
-}
-static const set<string>& get_reserved_typenames()
-{
-    static set<string> reserved_typenames;
-    if (reserved_typenames.empty()) {
-        const map<string, ndt::type>& builtin_types = get_builtin_types();
-        for (map<string, ndt::type>::const_iterator i = builtin_types.begin();
-                        i != builtin_types.end(); ++i) {
-            reserved_typenames.insert(i->first);
-        }
-        reserved_typenames.insert("string");
-        reserved_typenames.insert("char");
-        reserved_typenames.insert("datetime");
-        reserved_typenames.insert("unaligned");
-        reserved_typenames.insert("pointer");
-        reserved_typenames.insert("complex");
-        reserved_typenames.insert("bytes");
-        reserved_typenames.insert("byteswap");
-		reserved_typenames.insert("cuda_host");
-		reserved_typenames.insert("cuda_device");
-    }
-    return reserved_typenames;
+/**
+ * Looks up the types named by a single reserved identifier,
+ * like "int32" or "json". Returns false if the name isn't one of them.
+ */
+static bool lookup_builtin_type(const string& n, ndt::type& out_tp)
+{
+    type_id_t tid = uninitialized_type_id;
+    // Dispatch on the length first, so most names need one or two compares
+    switch (n.size()) {
+        case 4:
+            if (n == "void") {
+                tid = void_type_id;
+            } else if (n == "bool") {
+                tid = bool_type_id;
+            } else if (n == "int8") {
+                tid = int8_type_id;
+            } else if (n == "json") {
+                static const ndt::type json_tp = ndt::make_json();
+                out_tp = json_tp;
+                return true;
+            } else if (n == "date") {
+                static const ndt::type date_tp = ndt::make_date();
+                out_tp = date_tp;
+                return true;
+            } else if (n == "type") {
+                static const ndt::type type_tp = ndt::make_type();
+                out_tp = type_tp;
+                return true;
+            }
+            break;
+        case 5:
+            if (n == "int16") {
+                tid = int16_type_id;
+            } else if (n == "int32") {
+                tid = int32_type_id;
+            } else if (n == "int64") {
+                tid = int64_type_id;
+            } else if (n == "uint8") {
+                tid = uint8_type_id;
+            } else if (n == "bytes") {
+                static const ndt::type bytes_tp = ndt::make_bytes(1);
+                out_tp = bytes_tp;
+                return true;
+            }
+            break;
+        case 6:
+            if (n == "int128") {
+                tid = int128_type_id;
+            } else if (n == "intptr") {
+                tid = ndt::make_type<intptr_t>().get_type_id();
+            } else if (n == "uint16") {
+                tid = uint16_type_id;
+            } else if (n == "uint32") {
+                tid = uint32_type_id;
+            } else if (n == "uint64") {
+                tid = uint64_type_id;
+            }
+            break;
+        case 7:
+            if (n == "float64") {
+                tid = float64_type_id;
+            } else if (n == "float32") {
+                tid = float32_type_id;
+            } else if (n == "float16") {
+                tid = float16_type_id;
+            } else if (n == "uint128") {
+                tid = uint128_type_id;
+            } else if (n == "uintptr") {
+                tid = ndt::make_type<uintptr_t>().get_type_id();
+            }
+            break;
+        case 8:
+            if (n == "float128") {
+                tid = float128_type_id;
+            }
+            break;
+        case 9:
+            if (n == "complex64") {
+                tid = complex_float32_type_id;
+            }
+            break;
+        case 10:
+            if (n == "complex128") {
+                tid = complex_float64_type_id;
+            }
+            break;
+        case 16:
+            if (n == "ckernel_deferred") {
+                static const ndt::type ckernel_deferred_tp = ndt::make_ckernel_deferred();
+                out_tp = ckernel_deferred_tp;
+                return true;
+            }
+            break;
+        default:
+            break;
+    }
+    if (tid != uninitialized_type_id) {
+        out_tp = ndt::type(tid);
+        return true;
+    }
+    return false;
+}
+
+static bool is_builtin_typename(const string& n)
+{
+    ndt::type tp;
+    return lookup_builtin_type(n, tp);
+}
+
+/** Names which can't be used for type variables */
+static bool is_reserved_typename(const string& n)
+{
+    return is_builtin_typename(n) || n == "string" || n == "packed_string" ||
+                    n == "small_string" || n == "dictionary_string" || n == "char" || n == "datetime" ||
+                    n == "unaligned" || n == "pointer" || n == "complex" ||
+                    n == "byteswap" || n == "cuda_host" || n == "cuda_device";
 }
 
 static const char *skip_whitespace(const char *begin, const char *end)
@@ -344,6 +411,84 @@ static ndt::type parse_string_parameters(const char *&begin, const char *end)
     }
 }
 
+// packed_string_type : packed_string |
+//                      packed_string['encoding'] |
+//                      packed_string[offset_type] |
+//                      packed_string['encoding', offset_type]
+// This is called after 'packed_string' is already matched
+static ndt::type parse_packed_string_parameters(const char *&begin, const char *end)
+{
+    string_encoding_t encoding = string_encoding_utf_8;
+    type_id_t offset_type_id = int32_type_id;
+    if (parse_token(begin, end, '[')) {
+        const char *saved_begin = begin;
+        string encoding_str;
+        bool need_offset_type = false;
+        if (parse_quoted_string(begin, end, encoding_str)) {
+            encoding = string_to_encoding(saved_begin, encoding_str);
+            need_offset_type = parse_token(begin, end, ',');
+        } else {
+            need_offset_type = true;
+        }
+        if (need_offset_type) {
+            saved_begin = skip_whitespace(begin, end);
+            string offset_type = parse_name(begin, end);
+            if (offset_type == "int32") {
+                offset_type_id = int32_type_id;
+            } else if (offset_type == "int64") {
+                offset_type_id = int64_type_id;
+            } else {
+                throw datashape_parse_error(saved_begin, "expected a string encoding, int32 or int64");
+            }
+        }
+        if (!parse_token(begin, end, ']')) {
+            throw datashape_parse_error(begin, "expected closing ']'");
+        }
+    }
+    return ndt::make_packed_string(encoding, offset_type_id);
+}
+
+// small_string_type : small_string |
+//                     small_string['encoding']
+// This is called after 'small_string' is already matched
+static ndt::type parse_small_string_parameters(const char *&begin, const char *end)
+{
+    string_encoding_t encoding = string_encoding_utf_8;
+    if (parse_token(begin, end, '[')) {
+        const char *saved_begin = begin;
+        string encoding_str;
+        if (!parse_quoted_string(begin, end, encoding_str)) {
+            throw datashape_parse_error(saved_begin, "expected a string encoding");
+        }
+        encoding = string_to_encoding(saved_begin, encoding_str);
+        if (!parse_token(begin, end, ']')) {
+            throw datashape_parse_error(begin, "expected closing ']'");
+        }
+    }
+    return ndt::make_small_string(encoding);
+}
+
+// dictionary_string_type : dictionary_string |
+//                          dictionary_string['encoding']
+// This is called after 'dictionary_string' is already matched. The
+// datashape doesn't name a dictionary, so it's the shared one.
+static ndt::type parse_dictionary_string_parameters(const char *&begin, const char *end)
+{
+    string_encoding_t encoding = string_encoding_utf_8;
+    if (parse_token(begin, end, '[')) {
+        const char *saved_begin = begin;
+        string encoding_str;
+        if (!parse_quoted_string(begin, end, encoding_str)) {
+            throw datashape_parse_error(saved_begin, "expected a string encoding");
+        }
+        encoding = string_to_encoding(saved_begin, encoding_str);
+        if (!parse_token(begin, end, ']')) {
+            throw datashape_parse_error(begin, "expected closing ']'");
+        }
+    }
+    return ndt::make_shared_dictionary_string(encoding);
+}
+
 // char_type : char | char[encoding]
 // This is called after 'char' is already matched
 static ndt::type parse_char_parameters(const char *&begin, const char *end)
@@ -666,7 +811,6 @@ static ndt::type parse_record(const char *&begin, const char *end, map<string, n
 /** This is what parses the main datashape grammar, excluding type aliases, etc. */
 static ndt::type parse_rhs_expression(const char *&begin, const char *end, map<string, ndt::type>& symtable)
 {
-    const set<string>& reserved_typenames = get_reserved_typenames();
     ndt::type result;
     vector<intptr_t> shape;
     // rhs_expression : ((NAME | NUMBER) ASTERISK)* (record | NAME LPAREN rhs_expression RPAREN | NAME)
@@ -684,8 +828,7 @@ static ndt::type parse_rhs_expression(const char *&begin, const char *end, map<s
             } else if (n == "var") {
                 // Use -1 to signal a variable-length dimension
                 shape.push_back(-1);
-            } else if (reserved_typenames.find(n) == reserved_typenames.end() &&
-                            symtable.find(n) == symtable.end()) {
+            } else if (!is_reserved_typename(n) && symtable.find(n) == symtable.end()) {
                 // Use -2 to signal a free dimension
                 shape.push_back(-2);
             } else {
@@ -708,6 +851,12 @@ static ndt::type parse_rhs_expression(const char *&begin, const char *end, map<s
             }
         } else if (n == "string") {
             result = parse_string_parameters(begin, end);
+        } else if (n == "packed_string") {
+            result = parse_packed_string_parameters(begin, end);
+        } else if (n == "small_string") {
+            result = parse_small_string_parameters(begin, end);
+        } else if (n == "dictionary_string") {
+            result = parse_dictionary_string_parameters(begin, end);
         } else if (n == "complex") {
             result = parse_complex_parameters(begin, end, symtable);
         } else if (n == "datetime") {
@@ -726,25 +875,19 @@ static ndt::type parse_rhs_expression(const char *&begin, const char *end, map<s
             result = parse_cuda_host_parameters(begin, end, symtable);
         } else if (n == "cuda_device") {
             result = parse_cuda_device_parameters(begin, end, symtable);
-        } else {
-            const map<string, ndt::type>& builtin_types = get_builtin_types();
-            map<string, ndt::type>::const_iterator i = builtin_types.find(n);
-            if (i != builtin_types.end()) {
+        } else if (!lookup_builtin_type(n, result)) {
+            map<string, ndt::type>::const_iterator i = symtable.find(n);
+            if (i != symtable.end()) {
                 result = i->second;
             } else {
-                i = symtable.find(n);
-                if (i != symtable.end()) {
-                    result = i->second;
+                // LPAREN rhs_expression RPAREN
+                const char *begin_tmp = begin;
+                if (parse_token(begin_tmp, end, '(')) {
+                    throw datashape_parse_error(begin,
+                                    "DyND does not support this kind of datashape parsing yet");
                 } else {
-                    // LPAREN rhs_expression RPAREN
-                    const char *begin_tmp = begin;
-                    if (parse_token(begin_tmp, end, '(')) {
-                        throw datashape_parse_error(begin,
-                                        "DyND does not support this kind of datashape parsing yet");
-                    } else {
-                        throw datashape_parse_error(skip_whitespace(begin_saved, end),
-                                        "unrecognized data type");
-                    }
+                    throw datashape_parse_error(skip_whitespace(begin_saved, end),
+                                    "unrecognized data type");
                 }
             }
         }
@@ -772,13 +915,12 @@ static ndt::type parse_stmt(const char *&begin, const char *end, map<string, ndt
     // stmt : TYPE name EQUALS rhs_expression
     // NOTE that this doesn't support parameterized lhs_expression, this is subset of Blaze datashape
     if (parse_token(begin, end, "type")) {
-        const map<string, ndt::type>& builtin_types = get_builtin_types();
         const char *saved_begin = begin;
         string tname = parse_name(begin, end);
         if (tname.empty()) {
             if (skip_whitespace(begin, end) == end) {
                 // If it's only "type" by itself, return the "type" type
-                return builtin_types.find("type")->second;
+                return ndt::make_type();
             } else {
                 throw datashape_parse_error(begin, "expected an identifier for a type name");
             }
@@ -791,7 +933,7 @@ static ndt::type parse_stmt(const char *&begin, const char *end, map<string, ndt
             throw datashape_parse_error(begin, "expected a data type");
         }
         // ACTION: Put the parsed type in the symbol table
-        if (builtin_types.find(tname) != builtin_types.end()) {
+        if (is_builtin_typename(tname)) {
             throw datashape_parse_error(skip_whitespace(saved_begin, end),
                             "cannot redefine a builtin type");
         }
@@ -860,7 +1002,62 @@ static void get_error_line_column(const char *begin, const char *end, const char
     throw runtime_error("Cannot get line number of error, its position is out of range");
 }
 
-ndt::type dynd::type_from_datashape(const char *datashape_begin, const char *datashape_end)
+namespace {
+    /**
+     * A bounded cache from datashape strings to their parsed types,
+     * dropping the least recently used string when it's full.
+     */
+    class datashape_cache {
+        typedef list<pair<string, ndt::type> > entry_list;
+
+        platform_mutex m_mutex;
+        /** The cached datashapes, most recently used first */
+        entry_list m_entries;
+        map<string, entry_list::iterator> m_index;
+
+    public:
+        enum {
+            capacity = 256,
+            // Longer datashapes aren't cached, to bound the memory used
+            max_datashape_size = 1024
+        };
+
+        bool find(const string& ds, ndt::type& out_tp) {
+            platform_mutex::scoped_lock lock(m_mutex);
+            map<string, entry_list::iterator>::iterator it = m_index.find(ds);
+            if (it == m_index.end()) {
+                return false;
+            }
+            m_entries.splice(m_entries.begin(), m_entries, it->second);
+            out_tp = it->second->second;
+            return true;
+        }
+
+        void insert(const string& ds, const ndt::type& tp) {
+            platform_mutex::scoped_lock lock(m_mutex);
+            if (m_index.find(ds) != m_index.end()) {
+                // Another thread parsed it at the same time
+                return;
+            }
+            if (m_entries.size() >= capacity) {
+                m_index.erase(m_entries.back().first);
+                m_entries.pop_back();
+            }
+            m_entries.push_front(make_pair(ds, tp));
+            m_index[ds] = m_entries.begin();
+        }
+    };
+
+    datashape_cache& get_datashape_cache()
+    {
+        // Never destroyed, because it holds types which may be
+        // released after other static objects are gone
+        static datashape_cache *cache = new datashape_cache;
+        return *cache;
+    }
+} // anonymous namespace
+
+static ndt::type parse_datashape(const char *datashape_begin, const char *datashape_end)
 {
     try {
         // Symbol table for intermediate types declared in the datashape
@@ -888,3 +1085,19 @@ ndt::type dynd::type_from_datashape(const char *datashape_begin, const char *dat
     }
 }
 
+ndt::type dynd::type_from_datashape(const char *datashape_begin, const char *datashape_end)
+{
+    if (datashape_end - datashape_begin > datashape_cache::max_datashape_size) {
+        return parse_datashape(datashape_begin, datashape_end);
+    }
+
+    datashape_cache& cache = get_datashape_cache();
+    string ds(datashape_begin, datashape_end);
+    ndt::type result;
+    if (!cache.find(ds, result)) {
+        // Parse outside the lock, errors are not cached
+        result = parse_datashape(datashape_begin, datashape_end);
+        cache.insert(ds, result);
+    }
+    return result;
+}
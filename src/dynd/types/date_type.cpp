@@ -483,26 +483,25 @@ size_t date_type::make_elwise_property_getter_kernel(
                 const char *DYND_UNUSED(src_metadata), size_t src_property_index,
                 kernel_request_t kernreq, const eval::eval_context *DYND_UNUSED(ectx)) const
 {
-    offset_out = make_kernreq_to_single_kernel_adapter(out, offset_out, kernreq);
     ckernel_prefix *e = out->get_at<ckernel_prefix>(offset_out);
     switch (src_property_index) {
         case dateprop_year:
-            e->set_function<unary_single_operation_t>(&get_property_kernel_year_single);
+            set_unary_single_or_strided_function<&get_property_kernel_year_single>(e, kernreq);
             return offset_out + sizeof(ckernel_prefix);
         case dateprop_month:
-            e->set_function<unary_single_operation_t>(&get_property_kernel_month_single);
+            set_unary_single_or_strided_function<&get_property_kernel_month_single>(e, kernreq);
             return offset_out + sizeof(ckernel_prefix);
         case dateprop_day:
-            e->set_function<unary_single_operation_t>(&get_property_kernel_day_single);
+            set_unary_single_or_strided_function<&get_property_kernel_day_single>(e, kernreq);
             return offset_out + sizeof(ckernel_prefix);
         case dateprop_weekday:
-            e->set_function<unary_single_operation_t>(&get_property_kernel_weekday_single);
+            set_unary_single_or_strided_function<&get_property_kernel_weekday_single>(e, kernreq);
             return offset_out + sizeof(ckernel_prefix);
         case dateprop_days_after_1970_int64:
-            e->set_function<unary_single_operation_t>(&get_property_kernel_days_after_1970_int64_single);
+            set_unary_single_or_strided_function<&get_property_kernel_days_after_1970_int64_single>(e, kernreq);
             return offset_out + sizeof(ckernel_prefix);
         case dateprop_struct:
-            e->set_function<unary_single_operation_t>(&get_property_kernel_struct_single);
+            set_unary_single_or_strided_function<&get_property_kernel_struct_single>(e, kernreq);
             return offset_out + sizeof(ckernel_prefix);
         default:
             stringstream ss;
@@ -517,14 +516,13 @@ size_t date_type::make_elwise_property_setter_kernel(
                 const char *DYND_UNUSED(src_metadata),
                 kernel_request_t kernreq, const eval::eval_context *DYND_UNUSED(ectx)) const
 {
-    offset_out = make_kernreq_to_single_kernel_adapter(out, offset_out, kernreq);
     ckernel_prefix *e = out->get_at<ckernel_prefix>(offset_out);
     switch (dst_property_index) {
         case dateprop_days_after_1970_int64:
-            e->set_function<unary_single_operation_t>(&set_property_kernel_days_after_1970_int64_single);
+            set_unary_single_or_strided_function<&set_property_kernel_days_after_1970_int64_single>(e, kernreq);
             return offset_out + sizeof(ckernel_prefix);
         case dateprop_struct:
-            e->set_function<unary_single_operation_t>(&set_property_kernel_struct_single);
+            set_unary_single_or_strided_function<&set_property_kernel_struct_single>(e, kernreq);
             return offset_out + sizeof(ckernel_prefix);
         default:
             stringstream ss;
@@ -279,6 +279,12 @@ bool datetime_type::is_lossless_assignment(const ndt::type& dst_tp, const ndt::t
     }
 }
 
+size_t datetime_type::compute_hash() const
+{
+    size_t result = hash_combine(base_type::compute_hash(), m_unit);
+    return hash_combine(result, m_timezone);
+}
+
 bool datetime_type::operator==(const base_type& rhs) const
 {
     if (this == &rhs) {
@@ -0,0 +1,619 @@
+//
+// Copyright (C) 2011-14 Mark Wiebe, DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <cstring>
+#include <algorithm>
+
+#include <dynd/types/dictionary_string_type.hpp>
+#include <dynd/types/strided_dim_type.hpp>
+#include <dynd/memblock/pod_memory_block.hpp>
+#include <dynd/kernels/assignment_kernels.hpp>
+#include <dynd/kernels/string_comparison_kernels.hpp>
+#include <dynd/kernels/string_numeric_assignment_kernels.hpp>
+#include <dynd/iter/string_iter.hpp>
+#include <dynd/gfunc/make_callable.hpp>
+#include <dynd/exceptions.hpp>
+
+using namespace std;
+using namespace dynd;
+
+string_dictionary::string_dictionary()
+    : m_storage(make_pod_memory_block()), m_entries(), m_slots(64, 0)
+{
+}
+
+uint32_t string_dictionary::hash_bytes(const char *begin, const char *end)
+{
+    // 32-bit FNV-1a
+    uint32_t result = 2166136261u;
+    for (; begin != end; ++begin) {
+        result ^= static_cast<uint8_t>(*begin);
+        result *= 16777619u;
+    }
+    return result;
+}
+
+void string_dictionary::grow_slots()
+{
+    vector<uint32_t> slots(m_slots.size() * 2, 0);
+    size_t mask = slots.size() - 1;
+    for (size_t code = 0, code_end = m_entries.size(); code != code_end; ++code) {
+        size_t i = m_entries[code].hash & mask;
+        while (slots[i] != 0) {
+            i = (i + 1) & mask;
+        }
+        slots[i] = static_cast<uint32_t>(code + 1);
+    }
+    m_slots.swap(slots);
+}
+
+size_t string_dictionary::size() const
+{
+    platform_mutex::scoped_lock lock(m_mutex);
+    return m_entries.size();
+}
+
+string_type_data string_dictionary::get(uint32_t code) const
+{
+    platform_mutex::scoped_lock lock(m_mutex);
+    if (code >= m_entries.size()) {
+        throw runtime_error("dictionary string code is out of bounds");
+    }
+    return m_entries[code].str;
+}
+
+intptr_t string_dictionary::find(const char *begin, const char *end) const
+{
+    platform_mutex::scoped_lock lock(m_mutex);
+    return find_unlocked(begin, end);
+}
+
+intptr_t string_dictionary::find_unlocked(const char *begin, const char *end) const
+{
+    uint32_t hash = hash_bytes(begin, end);
+    size_t size = end - begin;
+    size_t mask = m_slots.size() - 1;
+    for (size_t i = hash & mask; m_slots[i] != 0; i = (i + 1) & mask) {
+        const entry& e = m_entries[m_slots[i] - 1];
+        if (e.hash == hash && (size_t)(e.str.end - e.str.begin) == size &&
+                        memcmp(e.str.begin, begin, size) == 0) {
+            return m_slots[i] - 1;
+        }
+    }
+    return -1;
+}
+
+uint32_t string_dictionary::intern(const char *begin, const char *end)
+{
+    platform_mutex::scoped_lock lock(m_mutex);
+    intptr_t code = find_unlocked(begin, end);
+    if (code >= 0) {
+        return static_cast<uint32_t>(code);
+    }
+
+    if (m_entries.size() >= 0xffffffffu) {
+        throw runtime_error("dictionary string type has run out of uint32 codes");
+    }
+    // Keep the hash table at most half full
+    if (2 * (m_entries.size() + 1) > m_slots.size()) {
+        grow_slots();
+    }
+
+    // Copy the string into the dictionary's storage
+    entry e;
+    e.hash = hash_bytes(begin, end);
+    e.str.begin = NULL;
+    e.str.end = NULL;
+    memory_block_pod_allocator_api *allocator = get_memory_block_pod_allocator_api(m_storage.get());
+    allocator->allocate(m_storage.get(), end - begin, 4, &e.str.begin, &e.str.end);
+    memcpy(e.str.begin, begin, end - begin);
+
+    code = m_entries.size();
+    m_entries.push_back(e);
+    size_t mask = m_slots.size() - 1;
+    size_t i = e.hash & mask;
+    while (m_slots[i] != 0) {
+        i = (i + 1) & mask;
+    }
+    m_slots[i] = static_cast<uint32_t>(code + 1);
+    return static_cast<uint32_t>(code);
+}
+
+namespace {
+    /**
+     * Re-encodes the string [begin, end) into out, which is used
+     * as a scratch buffer.
+     */
+    void transcode_string(const char *begin, const char *end,
+                    next_unicode_codepoint_t next_fn, append_unicode_codepoint_t append_fn,
+                    intptr_t src_charsize, intptr_t dst_charsize, string& out)
+    {
+        out.resize(((end - begin) / src_charsize + 16) * dst_charsize);
+        char *dst_begin = &out[0], *dst_current = dst_begin, *dst_end = dst_begin + out.size();
+        while (begin < end) {
+            uint32_t cp = next_fn(begin, end);
+            if (dst_end - dst_current < 8) {
+                intptr_t used = dst_current - dst_begin;
+                out.resize(2 * out.size());
+                dst_begin = &out[0];
+                dst_current = dst_begin + used;
+                dst_end = dst_begin + out.size();
+            }
+            append_fn(cp, dst_current, dst_end);
+        }
+        out.resize(dst_current - dst_begin);
+    }
+
+    // Assign from any string type to a dictionary string type
+    struct string_to_dictionary_kernel_extra {
+        typedef string_to_dictionary_kernel_extra extra_type;
+
+        ckernel_prefix base;
+        const dictionary_string_type *dst_dict_tp;
+        const base_string_type *src_string_tp;
+        const char *src_metadata;
+        bool same_encoding;
+        intptr_t src_charsize, dst_charsize;
+        next_unicode_codepoint_t next_fn;
+        append_unicode_codepoint_t append_fn;
+
+        static void single(char *dst, const char *src, ckernel_prefix *extra)
+        {
+            extra_type *e = reinterpret_cast<extra_type *>(extra);
+            const char *src_begin, *src_end;
+            if (e->src_string_tp->get_type_id() == string_type_id) {
+                src_begin = reinterpret_cast<const string_type_data *>(src)->begin;
+                src_end = reinterpret_cast<const string_type_data *>(src)->end;
+            } else {
+                e->src_string_tp->get_string_range(&src_begin, &src_end, e->src_metadata, src);
+            }
+            string_dictionary& dict = e->dst_dict_tp->get_dictionary();
+            if (e->same_encoding) {
+                *reinterpret_cast<uint32_t *>(dst) = dict.intern(src_begin, src_end);
+            } else {
+                string tmp;
+                transcode_string(src_begin, src_end, e->next_fn, e->append_fn,
+                                e->src_charsize, e->dst_charsize, tmp);
+                *reinterpret_cast<uint32_t *>(dst) = dict.intern(tmp.data(), tmp.data() + tmp.size());
+            }
+        }
+
+        static void destruct(ckernel_prefix *extra)
+        {
+            extra_type *e = reinterpret_cast<extra_type *>(extra);
+            base_type_xdecref(e->dst_dict_tp);
+            base_type_xdecref(e->src_string_tp);
+        }
+    };
+
+    /**
+     * The metadata of the blockref string views of dictionary strings. With
+     * a NULL blockref, assignment to a blockref string always copies.
+     */
+    const string_type_metadata dictionary_string_view_metadata = {NULL};
+
+    // Assign from a dictionary string type to some other type
+    struct dictionary_to_other_kernel_extra {
+        typedef dictionary_to_other_kernel_extra extra_type;
+
+        ckernel_prefix base;
+        const dictionary_string_type *src_dict_tp;
+
+        static void single(char *dst, const char *src, ckernel_prefix *extra)
+        {
+            extra_type *e = reinterpret_cast<extra_type *>(extra);
+            ckernel_prefix *echild = &(e + 1)->base;
+            unary_single_operation_t opchild = echild->get_function<unary_single_operation_t>();
+
+            uint32_t code = *reinterpret_cast<const uint32_t *>(src);
+            string_type_data src_val = e->src_dict_tp->get_dictionary().get(code);
+            opchild(dst, reinterpret_cast<const char *>(&src_val), echild);
+        }
+
+        static void destruct(ckernel_prefix *extra)
+        {
+            extra_type *e = reinterpret_cast<extra_type *>(extra);
+            base_type_xdecref(e->src_dict_tp);
+            ckernel_prefix *echild = &(e + 1)->base;
+            if (echild->destructor) {
+                echild->destructor(echild);
+            }
+        }
+    };
+
+    // Compare two dictionary strings which share a dictionary
+    struct dictionary_compare_kernel_extra {
+        ckernel_prefix base;
+        const dictionary_string_type *dict_tp;
+
+        static void destruct(ckernel_prefix *extra)
+        {
+            dictionary_compare_kernel_extra *e = reinterpret_cast<dictionary_compare_kernel_extra *>(extra);
+            base_type_xdecref(e->dict_tp);
+        }
+    };
+
+    template<typename T>
+    struct dictionary_compare_kernel {
+        static inline bool less_codes(uint32_t a, uint32_t b, ckernel_prefix *extra) {
+            const string_dictionary& dict = reinterpret_cast<dictionary_compare_kernel_extra *>(
+                            extra)->dict_tp->get_dictionary();
+            string_type_data da = dict.get(a), db = dict.get(b);
+            return lexicographical_compare(
+                reinterpret_cast<const T *>(da.begin), reinterpret_cast<const T *>(da.end),
+                reinterpret_cast<const T *>(db.begin), reinterpret_cast<const T *>(db.end));
+        }
+
+        static int less(const char *a, const char *b, ckernel_prefix *extra) {
+            uint32_t ca = *reinterpret_cast<const uint32_t *>(a), cb = *reinterpret_cast<const uint32_t *>(b);
+            return ca != cb && less_codes(ca, cb, extra);
+        }
+
+        static int less_equal(const char *a, const char *b, ckernel_prefix *extra) {
+            uint32_t ca = *reinterpret_cast<const uint32_t *>(a), cb = *reinterpret_cast<const uint32_t *>(b);
+            return ca == cb || !less_codes(cb, ca, extra);
+        }
+
+        // Equal strings always have the same code
+        static int equal(const char *a, const char *b, ckernel_prefix *DYND_UNUSED(extra)) {
+            return *reinterpret_cast<const uint32_t *>(a) == *reinterpret_cast<const uint32_t *>(b);
+        }
+
+        static int not_equal(const char *a, const char *b, ckernel_prefix *DYND_UNUSED(extra)) {
+            return *reinterpret_cast<const uint32_t *>(a) != *reinterpret_cast<const uint32_t *>(b);
+        }
+
+        static int greater_equal(const char *a, const char *b, ckernel_prefix *extra) {
+            uint32_t ca = *reinterpret_cast<const uint32_t *>(a), cb = *reinterpret_cast<const uint32_t *>(b);
+            return ca == cb || !less_codes(ca, cb, extra);
+        }
+
+        static int greater(const char *a, const char *b, ckernel_prefix *extra) {
+            uint32_t ca = *reinterpret_cast<const uint32_t *>(a), cb = *reinterpret_cast<const uint32_t *>(b);
+            return ca != cb && less_codes(cb, ca, extra);
+        }
+    };
+} // anonymous namespace
+
+#define DYND_DICTIONARY_COMPARISON_TABLE_TYPE_LEVEL(type) { \
+    dictionary_compare_kernel<type>::less, \
+    dictionary_compare_kernel<type>::less, \
+    dictionary_compare_kernel<type>::less_equal, \
+    dictionary_compare_kernel<type>::equal, \
+    dictionary_compare_kernel<type>::not_equal, \
+    dictionary_compare_kernel<type>::greater_equal, \
+    dictionary_compare_kernel<type>::greater \
+    }
+
+dictionary_string_type::dictionary_string_type(string_encoding_t encoding)
+    : base_string_type(dictionary_string_type_id, sizeof(uint32_t), sizeof(uint32_t),
+                    type_flag_scalar, 0),
+            m_encoding(encoding), m_dictionary(NULL)
+{
+    switch (encoding) {
+        case string_encoding_ascii:
+        case string_encoding_ucs_2:
+        case string_encoding_utf_8:
+        case string_encoding_utf_16:
+        case string_encoding_utf_32:
+            break;
+        default:
+            throw runtime_error("Unrecognized string encoding in dictionary string type constructor");
+    }
+    m_dictionary = new string_dictionary();
+}
+
+dictionary_string_type::~dictionary_string_type()
+{
+    delete m_dictionary;
+}
+
+nd::array dictionary_string_type::get_strings() const
+{
+    intptr_t count = m_dictionary->size();
+    nd::array result = nd::make_strided_array(count, ndt::make_string(m_encoding));
+    const char *result_metadata = result.get_ndo_meta() + sizeof(strided_dim_type_metadata);
+    intptr_t stride = reinterpret_cast<const strided_dim_type_metadata *>(result.get_ndo_meta())->stride;
+    assignment_ckernel_builder k;
+    ::make_assignment_kernel(&k, 0,
+                    ndt::make_string(m_encoding), result_metadata,
+                    ndt::make_string(m_encoding), reinterpret_cast<const char *>(&dictionary_string_view_metadata),
+                    kernel_request_single, assign_error_default, &eval::default_eval_context);
+    char *dst = result.get_readwrite_originptr();
+    for (intptr_t i = 0; i < count; ++i, dst += stride) {
+        string_type_data d = m_dictionary->get(static_cast<uint32_t>(i));
+        k(dst, reinterpret_cast<const char *>(&d));
+    }
+    result.flag_as_immutable();
+    return result;
+}
+
+void dictionary_string_type::get_string_range(const char **out_begin, const char**out_end,
+                const char *DYND_UNUSED(metadata), const char *data) const
+{
+    string_type_data d = m_dictionary->get(*reinterpret_cast<const uint32_t *>(data));
+    *out_begin = d.begin;
+    *out_end = d.end;
+}
+
+void dictionary_string_type::set_utf8_string(const char *DYND_UNUSED(metadata), char *data,
+                assign_error_mode errmode, const char* utf8_begin, const char *utf8_end) const
+{
+    if (m_encoding == string_encoding_utf_8 && errmode == assign_error_none) {
+        *reinterpret_cast<uint32_t *>(data) = m_dictionary->intern(utf8_begin, utf8_end);
+    } else {
+        string tmp;
+        transcode_string(utf8_begin, utf8_end,
+                        get_next_unicode_codepoint_function(string_encoding_utf_8, errmode),
+                        get_append_unicode_codepoint_function(m_encoding, errmode),
+                        1, string_encoding_char_size_table[m_encoding], tmp);
+        *reinterpret_cast<uint32_t *>(data) = m_dictionary->intern(tmp.data(), tmp.data() + tmp.size());
+    }
+}
+
+void dictionary_string_type::print_data(std::ostream& o, const char *metadata, const char *data) const
+{
+    uint32_t cp;
+    next_unicode_codepoint_t next_fn;
+    next_fn = get_next_unicode_codepoint_function(m_encoding, assign_error_none);
+    const char *begin, *end;
+    get_string_range(&begin, &end, metadata, data);
+
+    // Print as an escaped string
+    o << "\"";
+    while (begin < end) {
+        cp = next_fn(begin, end);
+        print_escaped_unicode_codepoint(o, cp);
+    }
+    o << "\"";
+}
+
+void dictionary_string_type::print_type(std::ostream& o) const
+{
+    o << "dictionary_string";
+    if (m_encoding != string_encoding_utf_8) {
+        o << "['" << m_encoding << "']";
+    }
+}
+
+void dictionary_string_type::get_shape(intptr_t ndim, intptr_t i, intptr_t *out_shape,
+                const char *DYND_UNUSED(metadata), const char *DYND_UNUSED(data)) const
+{
+    out_shape[i] = -1;
+    if (i+1 < ndim) {
+        stringstream ss;
+        ss << "requested too many dimensions from type " << ndt::type(this, true);
+        throw runtime_error(ss.str());
+    }
+}
+
+bool dictionary_string_type::is_lossless_assignment(
+                const ndt::type& dst_tp, const ndt::type& src_tp) const
+{
+    // Only copying codes within the same dictionary can skip the
+    // error checking, so that decoding errors get caught appropriately.
+    return dst_tp.extended() == this && src_tp.extended() == this;
+}
+
+size_t dictionary_string_type::compute_hash() const
+{
+    return hash_combine(base_string_type::compute_hash(), reinterpret_cast<uintptr_t>(m_dictionary));
+}
+
+bool dictionary_string_type::operator==(const base_type& rhs) const
+{
+    if (this == &rhs) {
+        return true;
+    } else if (rhs.get_type_id() != dictionary_string_type_id) {
+        return false;
+    } else {
+        const dictionary_string_type *dt = static_cast<const dictionary_string_type*>(&rhs);
+        return m_encoding == dt->m_encoding && m_dictionary == dt->m_dictionary;
+    }
+}
+
+void dictionary_string_type::metadata_default_construct(char *DYND_UNUSED(metadata),
+                intptr_t DYND_UNUSED(ndim), const intptr_t* DYND_UNUSED(shape)) const
+{
+    // Data is stored as uint32 codes, no metadata to process
+}
+
+void dictionary_string_type::metadata_copy_construct(char *DYND_UNUSED(dst_metadata),
+                const char *DYND_UNUSED(src_metadata),
+                memory_block_data *DYND_UNUSED(embedded_reference)) const
+{
+    // Data is stored as uint32 codes, no metadata to process
+}
+
+void dictionary_string_type::metadata_destruct(char *DYND_UNUSED(metadata)) const
+{
+    // Data is stored as uint32 codes, no metadata to process
+}
+
+size_t dictionary_string_type::make_assignment_kernel(
+                ckernel_builder *out, size_t offset_out,
+                const ndt::type& dst_tp, const char *dst_metadata,
+                const ndt::type& src_tp, const char *src_metadata,
+                kernel_request_t kernreq, assign_error_mode errmode,
+                const eval::eval_context *ectx) const
+{
+    if (this == dst_tp.extended()) {
+        if (this == src_tp.extended()) {
+            // When the dictionaries match, just copy the codes
+            return make_pod_typed_data_assignment_kernel(out, offset_out,
+                            get_data_size(), get_data_alignment(), kernreq);
+        } else if (src_tp.get_kind() == string_kind) {
+            const base_string_type *src_string_tp = static_cast<const base_string_type *>(src_tp.extended());
+            offset_out = make_kernreq_to_single_kernel_adapter(out, offset_out, kernreq);
+            out->ensure_capacity_leaf(offset_out + sizeof(string_to_dictionary_kernel_extra));
+            string_to_dictionary_kernel_extra *e =
+                            out->get_at<string_to_dictionary_kernel_extra>(offset_out);
+            e->base.set_function<unary_single_operation_t>(&string_to_dictionary_kernel_extra::single);
+            e->base.destructor = &string_to_dictionary_kernel_extra::destruct;
+            // The kernel data owns references to these types
+            e->dst_dict_tp = static_cast<const dictionary_string_type *>(ndt::type(dst_tp).release());
+            e->src_string_tp = static_cast<const base_string_type *>(ndt::type(src_tp).release());
+            e->src_metadata = src_metadata;
+            e->same_encoding = (src_string_tp->get_encoding() == m_encoding);
+            e->src_charsize = string_encoding_char_size_table[src_string_tp->get_encoding()];
+            e->dst_charsize = string_encoding_char_size_table[m_encoding];
+            e->next_fn = get_next_unicode_codepoint_function(src_string_tp->get_encoding(), errmode);
+            e->append_fn = get_append_unicode_codepoint_function(m_encoding, errmode);
+            return offset_out + sizeof(string_to_dictionary_kernel_extra);
+        } else if (!src_tp.is_builtin()) {
+            return src_tp.extended()->make_assignment_kernel(out, offset_out,
+                            dst_tp, dst_metadata,
+                            src_tp, src_metadata,
+                            kernreq, errmode, ectx);
+        } else {
+            return make_builtin_to_string_assignment_kernel(out, offset_out,
+                            dst_tp, dst_metadata,
+                            src_tp.get_type_id(),
+                            kernreq, errmode, ectx);
+        }
+    } else {
+        // Assign each string from the dictionary, viewed as a blockref string
+        offset_out = make_kernreq_to_single_kernel_adapter(out, offset_out, kernreq);
+        out->ensure_capacity(offset_out + sizeof(dictionary_to_other_kernel_extra));
+        dictionary_to_other_kernel_extra *e = out->get_at<dictionary_to_other_kernel_extra>(offset_out);
+        e->base.set_function<unary_single_operation_t>(&dictionary_to_other_kernel_extra::single);
+        e->base.destructor = &dictionary_to_other_kernel_extra::destruct;
+        // The kernel data owns a reference to this type
+        e->src_dict_tp = static_cast<const dictionary_string_type *>(ndt::type(src_tp).release());
+        return ::make_assignment_kernel(out, offset_out + sizeof(dictionary_to_other_kernel_extra),
+                        dst_tp, dst_metadata,
+                        ndt::make_string(m_encoding),
+                        reinterpret_cast<const char *>(&dictionary_string_view_metadata),
+                        kernel_request_single, errmode, ectx);
+    }
+}
+
+size_t dictionary_string_type::make_comparison_kernel(
+                ckernel_builder *out, size_t offset_out,
+                const ndt::type& src0_dt, const char *src0_metadata,
+                const ndt::type& src1_dt, const char *src1_metadata,
+                comparison_type_t comptype,
+                const eval::eval_context *ectx) const
+{
+    if (this == src0_dt.extended()) {
+        if (this == src1_dt.extended()) {
+            static int lookup[5] = {0, 1, 0, 1, 2};
+            static binary_single_predicate_t dictionary_comparisons_table[3][7] = {
+                DYND_DICTIONARY_COMPARISON_TABLE_TYPE_LEVEL(uint8_t),
+                DYND_DICTIONARY_COMPARISON_TABLE_TYPE_LEVEL(uint16_t),
+                DYND_DICTIONARY_COMPARISON_TABLE_TYPE_LEVEL(uint32_t)
+            };
+            if (0 <= comptype && comptype < 7) {
+                out->ensure_capacity_leaf(offset_out + sizeof(dictionary_compare_kernel_extra));
+                dictionary_compare_kernel_extra *e = out->get_at<dictionary_compare_kernel_extra>(offset_out);
+                e->base.set_function<binary_single_predicate_t>(
+                                dictionary_comparisons_table[lookup[m_encoding]][comptype]);
+                e->base.destructor = &dictionary_compare_kernel_extra::destruct;
+                // The kernel data owns a reference to this type
+                e->dict_tp = static_cast<const dictionary_string_type *>(ndt::type(src0_dt).release());
+                return offset_out + sizeof(dictionary_compare_kernel_extra);
+            }
+        } else if (src1_dt.get_kind() == string_kind) {
+            return make_general_string_comparison_kernel(out, offset_out,
+                            src0_dt, src0_metadata,
+                            src1_dt, src1_metadata,
+                            comptype, ectx);
+        } else if (!src1_dt.is_builtin()) {
+            return src1_dt.extended()->make_comparison_kernel(out, offset_out,
+                            src0_dt, src0_metadata,
+                            src1_dt, src1_metadata,
+                            comptype, ectx);
+        }
+    }
+
+    throw not_comparable_error(src0_dt, src1_dt, comptype);
+}
+
+#undef DYND_DICTIONARY_COMPARISON_TABLE_TYPE_LEVEL
+
+void dictionary_string_type::make_string_iter(dim_iter *out_di, string_encoding_t encoding,
+            const char *metadata, const char *data,
+            const memory_block_ptr& ref,
+            intptr_t buffer_max_mem,
+            const eval::eval_context *ectx) const
+{
+    const char *begin, *end;
+    get_string_range(&begin, &end, metadata, data);
+    iter::make_string_iter(out_di, encoding,
+            m_encoding, begin, end, ref, buffer_max_mem, ectx);
+}
+
+static nd::array property_ndo_get_ints(const nd::array& n) {
+    ndt::type udt = n.get_dtype().value_type();
+    const dictionary_string_type *dd = static_cast<const dictionary_string_type *>(udt.extended());
+    return n.view_scalars(dd->get_storage_type());
+}
+
+static pair<string, gfunc::callable> dictionary_string_array_properties[] = {
+    pair<string, gfunc::callable>("ints",
+                    gfunc::make_callable(&property_ndo_get_ints, "self"))
+};
+
+void dictionary_string_type::get_dynamic_array_properties(
+                const std::pair<std::string, gfunc::callable> **out_properties,
+                size_t *out_count) const
+{
+    *out_properties = dictionary_string_array_properties;
+    *out_count = sizeof(dictionary_string_array_properties) / sizeof(dictionary_string_array_properties[0]);
+}
+
+static string property_type_get_encoding(const ndt::type& d) {
+    const dictionary_string_type *dd = static_cast<const dictionary_string_type *>(d.extended());
+    stringstream ss;
+    ss << dd->get_encoding();
+    return ss.str();
+}
+
+static nd::array property_type_get_strings(const ndt::type& d) {
+    const dictionary_string_type *dd = static_cast<const dictionary_string_type *>(d.extended());
+    return dd->get_strings();
+}
+
+static ndt::type property_type_get_storage_type(const ndt::type& d) {
+    const dictionary_string_type *dd = static_cast<const dictionary_string_type *>(d.extended());
+    return dd->get_storage_type();
+}
+
+static pair<string, gfunc::callable> dictionary_string_type_properties[] = {
+    pair<string, gfunc::callable>("encoding",
+                    gfunc::make_callable(&property_type_get_encoding, "self")),
+    pair<string, gfunc::callable>("strings",
+                    gfunc::make_callable(&property_type_get_strings, "self")),
+    pair<string, gfunc::callable>("storage_type",
+                    gfunc::make_callable(&property_type_get_storage_type, "self"))
+};
+
+void dictionary_string_type::get_dynamic_type_properties(
+                const std::pair<std::string, gfunc::callable> **out_properties,
+                size_t *out_count) const
+{
+    *out_properties = dictionary_string_type_properties;
+    *out_count = sizeof(dictionary_string_type_properties) / sizeof(dictionary_string_type_properties[0]);
+}
+
+static const ndt::type *make_shared_dictionary_strings()
+{
+    ndt::type *result = new ndt::type[string_encoding_utf_32 + 1];
+    for (int i = 0; i <= string_encoding_utf_32; ++i) {
+        result[i] = ndt::make_dictionary_string(static_cast<string_encoding_t>(i));
+    }
+    return result;
+}
+
+ndt::type ndt::make_shared_dictionary_string(string_encoding_t encoding)
+{
+    // Never destroyed, so that arrays released during static
+    // destruction can still use the types
+    static const ndt::type *shared_types = make_shared_dictionary_strings();
+    if (encoding < 0 || encoding > string_encoding_utf_32) {
+        throw runtime_error("Unrecognized string encoding in dictionary string type constructor");
+    }
+    return shared_types[encoding];
+}
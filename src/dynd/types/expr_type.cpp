@@ -8,6 +8,7 @@
 #include <dynd/types/cstruct_type.hpp>
 #include <dynd/types/builtin_type_properties.hpp>
 #include <dynd/shape_tools.hpp>
+#include <dynd/kernels/ckernel_profiler.hpp>
 
 using namespace std;
 using namespace dynd;
@@ -364,6 +365,15 @@ size_t expr_type::make_operand_to_value_assignment_kernel(
         offset_out = make_expr_type_offset_applier(out, offset_out,
                         input_count, src_data_offsets.get());
     }
+    ckernel_profiler_scope profiled;
+    if (ectx != NULL && ectx->profiler != NULL) {
+        stringstream ss;
+        ss << "expr ";
+        m_kgen->print_type(ss);
+        ss << " -> " << m_value_type;
+        offset_out = profiled.push(ectx->profiler, out, offset_out,
+                        expr_operation_funcproto, kernel_request_single, ss.str());
+    }
     return m_kgen->make_expr_kernel(out, offset_out,
                     m_value_type, dst_metadata,
                     input_count, &src_dt[0],
@@ -159,6 +159,15 @@ void json_type::metadata_finalize_buffers(char *metadata) const
     }
 }
 
+void json_type::metadata_merge_buffers(char *dst_metadata, char *src_metadata) const
+{
+    json_type_metadata *dst_md = reinterpret_cast<json_type_metadata *>(dst_metadata);
+    json_type_metadata *src_md = reinterpret_cast<json_type_metadata *>(src_metadata);
+    if (dst_md->blockref != NULL && src_md->blockref != NULL) {
+        memory_block_merge(dst_md->blockref, src_md->blockref);
+    }
+}
+
 void json_type::metadata_destruct(char *metadata) const
 {
     json_type_metadata *md = reinterpret_cast<json_type_metadata *>(metadata);
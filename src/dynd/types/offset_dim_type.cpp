@@ -0,0 +1,696 @@
+//
+// Copyright (C) 2011-14 Mark Wiebe, DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <dynd/types/offset_dim_type.hpp>
+#include <dynd/types/var_dim_type.hpp>
+#include <dynd/types/strided_dim_type.hpp>
+#include <dynd/types/fixed_dim_type.hpp>
+#include <dynd/shape_tools.hpp>
+#include <dynd/exceptions.hpp>
+#include <dynd/kernels/assignment_kernels.hpp>
+#include <dynd/kernels/offset_dim_assignment_kernels.hpp>
+#include <dynd/gfunc/callable.hpp>
+#include <dynd/gfunc/make_callable.hpp>
+
+using namespace std;
+using namespace dynd;
+
+namespace {
+    /**
+     * After the leading dimension, each row of an offset_dim starts
+     * at a different offset into the values, so indexing the rows by
+     * an integer or a partial slice can't make a strided view.
+     */
+    type_error non_leading_index_error(size_t current_i, const ndt::type& root_tp)
+    {
+        stringstream ss;
+        ss << "Cannot index dimension " << current_i << " of dynd type " << root_tp;
+        ss << ", an offset dimension which isn't the leading dimension only supports";
+        ss << " the full slice. Index one row at a time or copy to a var dimension first";
+        return type_error(ss.str());
+    }
+} // anonymous namespace
+
+offset_dim_type::offset_dim_type(const ndt::type& element_tp)
+    : base_uniform_dim_type(offset_dim_type_id, element_tp, sizeof(intptr_t),
+                    sizeof(intptr_t), sizeof(offset_dim_type_metadata),
+                    type_flag_blockref)
+{
+    // Copy nd::array properties and functions from the first non-array dimension
+    get_scalar_properties_and_functions(m_array_properties, m_array_functions);
+}
+
+offset_dim_type::~offset_dim_type()
+{
+}
+
+void offset_dim_type::print_data(std::ostream& o, const char *metadata, const char *data) const
+{
+    const offset_dim_type_metadata *md = reinterpret_cast<const offset_dim_type_metadata *>(metadata);
+    const char *element_data = offset_dim_element_begin(md, data);
+    intptr_t stride = md->stride;
+    metadata += sizeof(offset_dim_type_metadata);
+    o << "[";
+    for (intptr_t i = 0, i_end = offset_dim_element_size(data); i != i_end; ++i, element_data += stride) {
+        m_element_tp.print_data(o, metadata, element_data);
+        if (i != i_end - 1) {
+            o << ", ";
+        }
+    }
+    o << "]";
+}
+
+void offset_dim_type::print_type(std::ostream& o) const
+{
+    o << "offset * " << m_element_tp;
+}
+
+bool offset_dim_type::is_expression() const
+{
+    return m_element_tp.is_expression();
+}
+
+bool offset_dim_type::is_unique_data_owner(const char *metadata) const
+{
+    const offset_dim_type_metadata *md = reinterpret_cast<const offset_dim_type_metadata *>(metadata);
+    if (md->blockref != NULL && md->blockref->m_use_count != 1) {
+        return false;
+    }
+    if (m_element_tp.is_builtin()) {
+        return true;
+    } else {
+        return m_element_tp.extended()->is_unique_data_owner(metadata + sizeof(offset_dim_type_metadata));
+    }
+}
+
+void offset_dim_type::transform_child_types(type_transform_fn_t transform_fn, void *extra,
+                ndt::type& out_transformed_tp, bool& out_was_transformed) const
+{
+    ndt::type tmp_tp;
+    bool was_transformed = false;
+    transform_fn(m_element_tp, extra, tmp_tp, was_transformed);
+    if (was_transformed) {
+        out_transformed_tp = ndt::type(new offset_dim_type(tmp_tp), false);
+        out_was_transformed = true;
+    } else {
+        out_transformed_tp = ndt::type(this, true);
+    }
+}
+
+ndt::type offset_dim_type::get_canonical_type() const
+{
+    // Copies of the data become var dimensions, since an offset
+    // dimension can't be allocated on its own
+    return ndt::type(new var_dim_type(m_element_tp.get_canonical_type()), false);
+}
+
+bool offset_dim_type::is_strided() const
+{
+    return true;
+}
+
+void offset_dim_type::process_strided(const char *metadata, const char *data,
+                ndt::type& out_dt, const char *&out_origin,
+                intptr_t& out_stride, intptr_t& out_dim_size) const
+{
+    const offset_dim_type_metadata *md = reinterpret_cast<const offset_dim_type_metadata *>(metadata);
+    out_dt = m_element_tp;
+    out_origin = offset_dim_element_begin(md, data);
+    out_stride = md->stride;
+    out_dim_size = offset_dim_element_size(data);
+}
+
+ndt::type offset_dim_type::apply_linear_index(intptr_t nindices, const irange *indices,
+                size_t current_i, const ndt::type& root_tp, bool leading_dimension) const
+{
+    if (nindices == 0) {
+        return ndt::type(this, true);
+    } else if (leading_dimension) {
+        if (indices->step() == 0) {
+            return m_element_tp.apply_linear_index(nindices-1, indices+1,
+                            current_i+1, root_tp, true);
+        } else {
+            // In leading dimensions, we convert offset_dim to strided_dim
+            ndt::type edt = m_element_tp.apply_linear_index(nindices-1, indices+1,
+                            current_i+1, root_tp, false);
+            return ndt::type(new strided_dim_type(edt), false);
+        }
+    } else if (indices->is_nop()) {
+        // If the indexing operation does nothing, then leave things unchanged
+        ndt::type edt = m_element_tp.apply_linear_index(nindices-1, indices+1,
+                        current_i+1, root_tp, false);
+        return ndt::type(new offset_dim_type(edt), false);
+    } else {
+        throw non_leading_index_error(current_i, root_tp);
+    }
+}
+
+intptr_t offset_dim_type::apply_linear_index(intptr_t nindices, const irange *indices, const char *metadata,
+                const ndt::type& result_tp, char *out_metadata,
+                memory_block_data *embedded_reference,
+                size_t current_i, const ndt::type& root_tp,
+                bool leading_dimension, char **inout_data,
+                memory_block_data **inout_dataref) const
+{
+    if (nindices == 0) {
+        // If there are no more indices, copy the metadata verbatim
+        metadata_copy_construct(out_metadata, metadata, embedded_reference);
+        return 0;
+    }
+    const offset_dim_type_metadata *md = reinterpret_cast<const offset_dim_type_metadata *>(metadata);
+    if (leading_dimension) {
+        bool remove_dimension;
+        intptr_t start_index, index_stride, dimension_size;
+        apply_single_linear_index(*indices, offset_dim_element_size(*inout_data), current_i, &root_tp,
+                        remove_dimension, start_index, index_stride, dimension_size);
+        // Point at the values, which live in the blockref
+        *inout_data = offset_dim_element_begin(md, *inout_data) + start_index * md->stride;
+        if (*inout_dataref) {
+            memory_block_decref(*inout_dataref);
+        }
+        *inout_dataref = md->blockref ? md->blockref : embedded_reference;
+        memory_block_incref(*inout_dataref);
+        if (remove_dimension) {
+            // Apply the rest of the indices to the element type
+            if (!m_element_tp.is_builtin()) {
+                return m_element_tp.extended()->apply_linear_index(
+                                nindices - 1, indices + 1,
+                                metadata + sizeof(offset_dim_type_metadata),
+                                result_tp, out_metadata, embedded_reference,
+                                current_i + 1, root_tp,
+                                true, inout_data, inout_dataref);
+            } else {
+                return 0;
+            }
+        } else {
+            // Produce a strided array result
+            strided_dim_type_metadata *out_md = reinterpret_cast<strided_dim_type_metadata *>(out_metadata);
+            out_md->size = dimension_size;
+            out_md->stride = dimension_size > 1 ? md->stride * index_stride : 0;
+            if (!m_element_tp.is_builtin()) {
+                const strided_dim_type *sad = static_cast<const strided_dim_type *>(result_tp.extended());
+                return m_element_tp.extended()->apply_linear_index(
+                                nindices - 1, indices + 1,
+                                metadata + sizeof(offset_dim_type_metadata),
+                                sad->get_element_type(),
+                                out_metadata + sizeof(strided_dim_type_metadata), embedded_reference,
+                                current_i + 1, root_tp,
+                                false, NULL, NULL);
+            } else {
+                return 0;
+            }
+        }
+    } else if (indices->is_nop()) {
+        // If the indexing operation does nothing, then leave things unchanged
+        offset_dim_type_metadata *out_md = reinterpret_cast<offset_dim_type_metadata *>(out_metadata);
+        out_md->blockref = md->blockref ? md->blockref : embedded_reference;
+        memory_block_incref(out_md->blockref);
+        out_md->values = md->values;
+        out_md->stride = md->stride;
+        if (!m_element_tp.is_builtin()) {
+            const offset_dim_type *odt = static_cast<const offset_dim_type *>(result_tp.extended());
+            out_md->values += m_element_tp.extended()->apply_linear_index(
+                            nindices - 1, indices + 1,
+                            metadata + sizeof(offset_dim_type_metadata),
+                            odt->get_element_type(),
+                            out_metadata + sizeof(offset_dim_type_metadata), embedded_reference,
+                            current_i + 1, root_tp,
+                            false, NULL, NULL);
+        }
+        return 0;
+    } else {
+        throw non_leading_index_error(current_i, root_tp);
+    }
+}
+
+ndt::type offset_dim_type::at_single(intptr_t i0, const char **inout_metadata, const char **inout_data) const
+{
+    if (inout_metadata) {
+        const offset_dim_type_metadata *md = reinterpret_cast<const offset_dim_type_metadata *>(*inout_metadata);
+        // Modify the metadata
+        *inout_metadata += sizeof(offset_dim_type_metadata);
+        // If requested, modify the data pointer
+        if (inout_data) {
+            // Bounds-checking of the index
+            i0 = apply_single_index(i0, offset_dim_element_size(*inout_data), NULL);
+            *inout_data = offset_dim_element_begin(md, *inout_data) + i0 * md->stride;
+        }
+    }
+    return m_element_tp;
+}
+
+ndt::type offset_dim_type::get_type_at_dimension(char **inout_metadata, intptr_t i, intptr_t total_ndim) const
+{
+    if (i == 0) {
+        return ndt::type(this, true);
+    } else {
+        if (inout_metadata) {
+            *inout_metadata += sizeof(offset_dim_type_metadata);
+        }
+        return m_element_tp.get_type_at_dimension(inout_metadata, i - 1, total_ndim + 1);
+    }
+}
+
+intptr_t offset_dim_type::get_dim_size(const char *DYND_UNUSED(metadata), const char *data) const
+{
+    if (data != NULL) {
+        return offset_dim_element_size(data);
+    } else {
+        return -1;
+    }
+}
+
+void offset_dim_type::get_shape(intptr_t ndim, intptr_t i, intptr_t *out_shape,
+                const char *metadata, const char *data) const
+{
+    if (metadata == NULL || data == NULL) {
+        out_shape[i] = -1;
+        data = NULL;
+    } else {
+        const offset_dim_type_metadata *md = reinterpret_cast<const offset_dim_type_metadata *>(metadata);
+        out_shape[i] = offset_dim_element_size(data);
+        if (out_shape[i] == 1) {
+            data = offset_dim_element_begin(md, data);
+        } else {
+            data = NULL;
+        }
+    }
+
+    // Process the later shape values
+    if (i+1 < ndim) {
+        if (!m_element_tp.is_builtin()) {
+            m_element_tp.extended()->get_shape(ndim, i+1, out_shape,
+                            metadata ? (metadata + sizeof(offset_dim_type_metadata)) : NULL,
+                            data);
+        } else {
+            stringstream ss;
+            ss << "requested too many dimensions from type " << ndt::type(this, true);
+            throw runtime_error(ss.str());
+        }
+    }
+}
+
+void offset_dim_type::get_strides(size_t i, intptr_t *out_strides, const char *metadata) const
+{
+    const offset_dim_type_metadata *md = reinterpret_cast<const offset_dim_type_metadata *>(metadata);
+
+    out_strides[i] = md->stride;
+
+    // Process the later shape values
+    if (!m_element_tp.is_builtin()) {
+        m_element_tp.extended()->get_strides(i+1, out_strides, metadata + sizeof(offset_dim_type_metadata));
+    }
+}
+
+axis_order_classification_t offset_dim_type::classify_axis_order(const char *metadata) const
+{
+    // Treat the offset_dim type as C-order
+    if (m_element_tp.get_ndim() > 1) {
+        axis_order_classification_t aoc = m_element_tp.extended()->classify_axis_order(
+                        metadata + sizeof(offset_dim_type_metadata));
+        return (aoc == axis_order_none || aoc == axis_order_c)
+                        ? axis_order_c : axis_order_neither;
+    } else {
+        return axis_order_c;
+    }
+}
+
+bool offset_dim_type::is_lossless_assignment(const ndt::type& dst_tp, const ndt::type& src_tp) const
+{
+    if (dst_tp.extended() == this) {
+        if (src_tp.extended() == this) {
+            return true;
+        } else if (src_tp.get_type_id() == offset_dim_type_id) {
+            return *dst_tp.extended() == *src_tp.extended();
+        }
+    }
+
+    return false;
+}
+
+bool offset_dim_type::operator==(const base_type& rhs) const
+{
+    if (this == &rhs) {
+        return true;
+    } else if (rhs.get_type_id() != offset_dim_type_id) {
+        return false;
+    } else {
+        const offset_dim_type *dt = static_cast<const offset_dim_type*>(&rhs);
+        return m_element_tp == dt->m_element_tp;
+    }
+}
+
+void offset_dim_type::metadata_default_construct(char *DYND_UNUSED(metadata),
+                intptr_t DYND_UNUSED(ndim), const intptr_t* DYND_UNUSED(shape)) const
+{
+    stringstream ss;
+    ss << "Cannot default construct type " << ndt::type(this, true);
+    ss << ", use nd::make_offset_dim_array to view existing values and offsets";
+    throw type_error(ss.str());
+}
+
+void offset_dim_type::metadata_copy_construct(char *dst_metadata, const char *src_metadata, memory_block_data *embedded_reference) const
+{
+    metadata_copy_construct_onedim(dst_metadata, src_metadata, embedded_reference);
+    if (!m_element_tp.is_builtin()) {
+        m_element_tp.extended()->metadata_copy_construct(dst_metadata + sizeof(offset_dim_type_metadata),
+                        src_metadata + sizeof(offset_dim_type_metadata), embedded_reference);
+    }
+}
+
+size_t offset_dim_type::metadata_copy_construct_onedim(char *dst_metadata, const char *src_metadata,
+                memory_block_data *embedded_reference) const
+{
+    const offset_dim_type_metadata *src_md = reinterpret_cast<const offset_dim_type_metadata *>(src_metadata);
+    offset_dim_type_metadata *dst_md = reinterpret_cast<offset_dim_type_metadata *>(dst_metadata);
+    dst_md->values = src_md->values;
+    dst_md->stride = src_md->stride;
+    dst_md->blockref = src_md->blockref ? src_md->blockref : embedded_reference;
+    if (dst_md->blockref) {
+        memory_block_incref(dst_md->blockref);
+    }
+    return sizeof(offset_dim_type_metadata);
+}
+
+void offset_dim_type::metadata_destruct(char *metadata) const
+{
+    offset_dim_type_metadata *md = reinterpret_cast<offset_dim_type_metadata *>(metadata);
+    if (md->blockref) {
+        memory_block_decref(md->blockref);
+    }
+    if (!m_element_tp.is_builtin()) {
+        m_element_tp.extended()->metadata_destruct(metadata + sizeof(offset_dim_type_metadata));
+    }
+}
+
+void offset_dim_type::metadata_debug_print(const char *metadata, std::ostream& o, const std::string& indent) const
+{
+    const offset_dim_type_metadata *md = reinterpret_cast<const offset_dim_type_metadata *>(metadata);
+    o << indent << "offset_dim metadata\n";
+    o << indent << " values: " << (const void *)md->values << "\n";
+    o << indent << " stride: " << md->stride << "\n";
+    memory_block_debug_print(md->blockref, o, indent + " ");
+    if (!m_element_tp.is_builtin()) {
+        m_element_tp.extended()->metadata_debug_print(metadata + sizeof(offset_dim_type_metadata), o, indent + "  ");
+    }
+}
+
+size_t offset_dim_type::make_assignment_kernel(
+                ckernel_builder *out, size_t offset_out,
+                const ndt::type& dst_tp, const char *dst_metadata,
+                const ndt::type& src_tp, const char *src_metadata,
+                kernel_request_t kernreq, assign_error_mode errmode,
+                const eval::eval_context *ectx) const
+{
+    if (this == dst_tp.extended()) {
+        if (src_tp.get_ndim() < dst_tp.get_ndim() ||
+                        src_tp.get_type_id() == strided_dim_type_id ||
+                        src_tp.get_type_id() == fixed_dim_type_id) {
+            // strided_dim to offset_dim, or broadcasting to it
+            return make_strided_to_offset_dim_assignment_kernel(out, offset_out,
+                            dst_tp, dst_metadata,
+                            src_tp, src_metadata,
+                            kernreq, errmode, ectx);
+        } else if (src_tp.get_type_id() == offset_dim_type_id) {
+            // offset_dim to offset_dim
+            return make_offset_dim_assignment_kernel(out, offset_out,
+                            dst_tp, dst_metadata,
+                            src_tp, src_metadata,
+                            kernreq, errmode, ectx);
+        } else if (src_tp.get_type_id() == var_dim_type_id) {
+            // var_dim to offset_dim
+            return make_var_to_offset_dim_assignment_kernel(out, offset_out,
+                            dst_tp, dst_metadata,
+                            src_tp, src_metadata,
+                            kernreq, errmode, ectx);
+        } else if (!src_tp.is_builtin()) {
+            // Give the src type a chance to make a kernel
+            return src_tp.extended()->make_assignment_kernel(out, offset_out,
+                            dst_tp, dst_metadata,
+                            src_tp, src_metadata,
+                            kernreq, errmode, ectx);
+        } else {
+            stringstream ss;
+            ss << "Cannot assign from " << src_tp << " to " << dst_tp;
+            throw dynd::type_error(ss.str());
+        }
+    } else if (dst_tp.get_ndim() < src_tp.get_ndim()) {
+        throw broadcast_error(dst_tp, dst_metadata, src_tp, src_metadata);
+    } else if (dst_tp.get_type_id() == var_dim_type_id) {
+        // offset_dim to var_dim
+        return make_offset_to_var_dim_assignment_kernel(out, offset_out,
+                        dst_tp, dst_metadata,
+                        src_tp, src_metadata,
+                        kernreq, errmode, ectx);
+    } else if (dst_tp.get_type_id() == strided_dim_type_id ||
+                    dst_tp.get_type_id() == fixed_dim_type_id) {
+        // offset_dim to strided_dim
+        return make_offset_to_strided_dim_assignment_kernel(out, offset_out,
+                        dst_tp, dst_metadata,
+                        src_tp, src_metadata,
+                        kernreq, errmode, ectx);
+    } else {
+        stringstream ss;
+        ss << "Cannot assign from " << src_tp << " to " << dst_tp;
+        throw dynd::type_error(ss.str());
+    }
+}
+
+void offset_dim_type::foreach_leading(char *data, const char *metadata, foreach_fn_t callback, void *callback_data) const
+{
+    const offset_dim_type_metadata *md = reinterpret_cast<const offset_dim_type_metadata *>(metadata);
+    const char *child_metadata = metadata + sizeof(offset_dim_type_metadata);
+    intptr_t stride = md->stride, size = offset_dim_element_size(data);
+    data = offset_dim_element_begin(md, data);
+    for (intptr_t i = 0; i < size; ++i, data += stride) {
+        callback(m_element_tp, data, child_metadata, callback_data);
+    }
+}
+
+static ndt::type get_element_type(const ndt::type& dt) {
+    const offset_dim_type *d = static_cast<const offset_dim_type *>(dt.extended());
+    return d->get_element_type();
+}
+
+static pair<string, gfunc::callable> offset_dim_type_properties[] = {
+    pair<string, gfunc::callable>("element_type", gfunc::make_callable(&get_element_type, "self"))
+};
+
+void offset_dim_type::get_dynamic_type_properties(
+                const std::pair<std::string, gfunc::callable> **out_properties,
+                size_t *out_count) const
+{
+    *out_properties = offset_dim_type_properties;
+    *out_count = sizeof(offset_dim_type_properties) / sizeof(offset_dim_type_properties[0]);
+}
+
+void offset_dim_type::get_dynamic_array_properties(const std::pair<std::string, gfunc::callable> **out_properties, size_t *out_count) const
+{
+    *out_properties = m_array_properties.empty() ? NULL : &m_array_properties[0];
+    *out_count = (int)m_array_properties.size();
+}
+
+void offset_dim_type::get_dynamic_array_functions(const std::pair<std::string, gfunc::callable> **out_functions, size_t *out_count) const
+{
+    *out_functions = m_array_functions.empty() ? NULL : &m_array_functions[0];
+    *out_count = (int)m_array_functions.size();
+}
+
+/**
+ * Gets the layout of a one-dimensional strided or fixed array,
+ * throwing a type_error naming `what` for any other type.
+ */
+static void get_one_dim_layout(const nd::array& a, const char *what,
+                ndt::type& out_element_tp, const char *&out_element_metadata,
+                intptr_t& out_size, intptr_t& out_stride)
+{
+    const ndt::type& tp = a.get_type();
+    if (tp.get_type_id() == strided_dim_type_id) {
+        const strided_dim_type_metadata *md =
+                        reinterpret_cast<const strided_dim_type_metadata *>(a.get_ndo_meta());
+        out_element_tp = static_cast<const strided_dim_type *>(tp.extended())->get_element_type();
+        out_element_metadata = a.get_ndo_meta() + sizeof(strided_dim_type_metadata);
+        out_size = md->size;
+        out_stride = md->stride;
+    } else if (tp.get_type_id() == fixed_dim_type_id) {
+        const fixed_dim_type *fdt = static_cast<const fixed_dim_type *>(tp.extended());
+        out_element_tp = fdt->get_element_type();
+        out_element_metadata = a.get_ndo_meta();
+        out_size = fdt->get_fixed_dim_size();
+        out_stride = fdt->get_fixed_stride();
+    } else {
+        stringstream ss;
+        ss << "the " << what << " of an offset_dim array must be a strided or fixed dimension, not " << tp;
+        throw type_error(ss.str());
+    }
+}
+
+nd::array nd::make_offset_dim_array(const nd::array& values, const nd::array& offsets)
+{
+    ndt::type element_tp;
+    const char *element_metadata;
+    intptr_t value_count, value_stride;
+    get_one_dim_layout(values, "values", element_tp, element_metadata, value_count, value_stride);
+
+    // The offsets are used in place if they're already contiguous intptr_t
+    ndt::type offsets_tp = ndt::make_strided_dim(ndt::make_type<intptr_t>());
+    nd::array offs = offsets;
+    if (offs.get_type() != offsets_tp || (offs.get_dim_size() > 1 &&
+                    reinterpret_cast<const strided_dim_type_metadata *>(
+                                    offs.get_ndo_meta())->stride != sizeof(intptr_t))) {
+        if (offs.get_ndim() != 1) {
+            stringstream ss;
+            ss << "the offsets of an offset_dim array must be one-dimensional, not " << offsets.get_type();
+            throw type_error(ss.str());
+        }
+        offs = nd::empty(offsets.get_dim_size(), offsets_tp);
+        offs.val_assign(offsets);
+    }
+    intptr_t row_count = offs.get_dim_size() - 1;
+    if (row_count < 0) {
+        throw invalid_argument("the offsets of an offset_dim array need at least one entry");
+    }
+    const intptr_t *off = reinterpret_cast<const intptr_t *>(offs.get_readonly_originptr());
+    if (off[0] < 0 || off[row_count] > value_count) {
+        stringstream ss;
+        ss << "offsets [" << off[0] << ", " << off[row_count] << "] are out of bounds for ";
+        ss << value_count << " values";
+        throw invalid_argument(ss.str());
+    }
+    for (intptr_t i = 0; i < row_count; ++i) {
+        if (off[i] > off[i + 1]) {
+            stringstream ss;
+            ss << "the offsets of an offset_dim array must be non-decreasing, but offset ";
+            ss << i << " is " << off[i] << " and offset " << (i + 1) << " is " << off[i + 1];
+            throw invalid_argument(ss.str());
+        }
+    }
+
+    ndt::type result_tp = ndt::make_strided_dim(ndt::make_offset_dim(element_tp));
+    nd::array result(make_array_memory_block(result_tp.get_metadata_size()));
+    array_preamble *ndo = result.get_ndo();
+    ndo->m_type = ndt::type(result_tp).release();
+    // The data of the outer dimension is the offsets
+    ndo->m_data_pointer = const_cast<char *>(offs.get_readonly_originptr());
+    ndo->m_data_reference = offs.get_data_memblock().release();
+    strided_dim_type_metadata *md = reinterpret_cast<strided_dim_type_metadata *>(result.get_ndo_meta());
+    md->size = row_count;
+    md->stride = row_count > 1 ? sizeof(intptr_t) : 0;
+    offset_dim_type_metadata *omd = reinterpret_cast<offset_dim_type_metadata *>(md + 1);
+    omd->blockref = values.get_data_memblock().release();
+    omd->values = const_cast<char *>(values.get_readonly_originptr());
+    omd->stride = value_stride;
+    if (!element_tp.is_builtin()) {
+        element_tp.extended()->metadata_copy_construct(reinterpret_cast<char *>(omd + 1),
+                        element_metadata, values.get_memblock().get());
+    }
+    // Writing goes to the values, so their permissions apply, but the
+    // result is only immutable if both inputs are
+    ndo->m_flags = values.get_access_flags();
+    if ((offs.get_access_flags() & immutable_access_flag) == 0) {
+        ndo->m_flags &= ~immutable_access_flag;
+    }
+    return result;
+}
+
+/**
+ * Gets the offset_dim of an `offset * T` or `strided * offset * T`
+ * array, along with the offsets of its first and last values, throwing
+ * a type_error if the values of the rows aren't contiguous.
+ */
+static const offset_dim_type *get_offset_dim_range(const nd::array& a,
+                const offset_dim_type_metadata *&out_md, const intptr_t *&out_offsets,
+                intptr_t& out_row_count)
+{
+    const ndt::type& tp = a.get_type();
+    const char *data = a.get_readonly_originptr();
+    if (tp.get_type_id() == offset_dim_type_id) {
+        out_md = reinterpret_cast<const offset_dim_type_metadata *>(a.get_ndo_meta());
+        out_offsets = reinterpret_cast<const intptr_t *>(data);
+        out_row_count = 1;
+        return static_cast<const offset_dim_type *>(tp.extended());
+    }
+    intptr_t row_count = 0, row_stride = 0;
+    const ndt::type *element_tp = NULL;
+    const char *element_metadata = NULL;
+    if (tp.get_type_id() == strided_dim_type_id) {
+        const strided_dim_type_metadata *md =
+                        reinterpret_cast<const strided_dim_type_metadata *>(a.get_ndo_meta());
+        row_count = md->size;
+        row_stride = md->stride;
+        element_tp = &static_cast<const strided_dim_type *>(tp.extended())->get_element_type();
+        element_metadata = a.get_ndo_meta() + sizeof(strided_dim_type_metadata);
+    } else if (tp.get_type_id() == fixed_dim_type_id) {
+        const fixed_dim_type *fdt = static_cast<const fixed_dim_type *>(tp.extended());
+        row_count = fdt->get_fixed_dim_size();
+        row_stride = fdt->get_fixed_stride();
+        element_tp = &fdt->get_element_type();
+        element_metadata = a.get_ndo_meta();
+    }
+    if (element_tp == NULL || element_tp->get_type_id() != offset_dim_type_id) {
+        stringstream ss;
+        ss << "expected an array with an offset_dim type, not " << tp;
+        throw type_error(ss.str());
+    }
+    if (row_count > 1 && row_stride != sizeof(intptr_t)) {
+        stringstream ss;
+        ss << "the rows of the array with type " << tp << " are not adjacent, ";
+        ss << "make a copy to get all its values as one array";
+        throw type_error(ss.str());
+    }
+    out_md = reinterpret_cast<const offset_dim_type_metadata *>(element_metadata);
+    out_offsets = reinterpret_cast<const intptr_t *>(data);
+    out_row_count = row_count;
+    return static_cast<const offset_dim_type *>(element_tp->extended());
+}
+
+nd::array nd::offset_dim_values(const nd::array& a)
+{
+    const offset_dim_type_metadata *md;
+    const intptr_t *off;
+    intptr_t row_count;
+    const offset_dim_type *odt = get_offset_dim_range(a, md, off, row_count);
+    const ndt::type& element_tp = odt->get_element_type();
+
+    intptr_t begin = 0, size = 0;
+    if (row_count > 0) {
+        begin = off[0];
+        size = off[row_count] - off[0];
+    }
+    nd::array result(make_array_memory_block(ndt::make_strided_dim(element_tp).get_metadata_size()));
+    array_preamble *ndo = result.get_ndo();
+    ndo->m_type = ndt::make_strided_dim(element_tp).release();
+    ndo->m_data_pointer = md->values + begin * md->stride;
+    ndo->m_data_reference = md->blockref ? md->blockref : a.get_memblock().get();
+    memory_block_incref(ndo->m_data_reference);
+    strided_dim_type_metadata *out_md = reinterpret_cast<strided_dim_type_metadata *>(result.get_ndo_meta());
+    out_md->size = size;
+    out_md->stride = size > 1 ? md->stride : 0;
+    if (!element_tp.is_builtin()) {
+        element_tp.extended()->metadata_copy_construct(reinterpret_cast<char *>(out_md + 1),
+                        reinterpret_cast<const char *>(md + 1), a.get_memblock().get());
+    }
+    ndo->m_flags = a.get_flags();
+    return result;
+}
+
+nd::array nd::offset_dim_offsets(const nd::array& a)
+{
+    if (a.get_type().get_type_id() == offset_dim_type_id) {
+        stringstream ss;
+        ss << "offset_dim_offsets requires an array with an outer dimension, not " << a.get_type();
+        throw type_error(ss.str());
+    }
+    const offset_dim_type_metadata *md;
+    const intptr_t *off;
+    intptr_t row_count;
+    get_offset_dim_range(a, md, off, row_count);
+
+    intptr_t offset_count = row_count + 1, offset_stride = sizeof(intptr_t);
+    int32_t access_flags = nd::read_access_flag | (a.get_access_flags() & nd::immutable_access_flag);
+    return nd::make_strided_array_from_data(ndt::make_type<intptr_t>(), 1, &offset_count,
+                    &offset_stride, access_flags, const_cast<char *>(a.get_readonly_originptr()),
+                    a.get_data_memblock(), NULL);
+}
@@ -0,0 +1,335 @@
+//
+// Copyright (C) 2011-14 Mark Wiebe, DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <dynd/types/packed_string_type.hpp>
+#include <dynd/memblock/contiguous_memory_block.hpp>
+#include <dynd/kernels/string_assignment_kernels.hpp>
+#include <dynd/kernels/string_comparison_kernels.hpp>
+#include <dynd/kernels/string_numeric_assignment_kernels.hpp>
+#include <dynd/iter/string_iter.hpp>
+#include <dynd/exceptions.hpp>
+
+#include <limits>
+
+using namespace std;
+using namespace dynd;
+
+packed_string_type::packed_string_type(string_encoding_t encoding, type_id_t offset_type_id)
+    : base_string_type(packed_string_type_id,
+                    offset_type_id == int64_type_id ? sizeof(packed_string_type_data<int64_t>)
+                                                    : sizeof(packed_string_type_data<int32_t>),
+                    offset_type_id == int64_type_id ? sizeof(int64_t) : sizeof(int32_t),
+                    type_flag_scalar|type_flag_zeroinit|type_flag_blockref,
+                    sizeof(packed_string_type_metadata)),
+            m_encoding(encoding), m_offset_type_id(offset_type_id)
+{
+    switch (encoding) {
+        case string_encoding_ascii:
+        case string_encoding_ucs_2:
+        case string_encoding_utf_8:
+        case string_encoding_utf_16:
+        case string_encoding_utf_32:
+            break;
+        default:
+            throw runtime_error("Unrecognized string encoding in packed string type constructor");
+    }
+    if (offset_type_id != int32_type_id && offset_type_id != int64_type_id) {
+        stringstream ss;
+        ss << "The offsets of a packed string type must be int32 or int64, not " << ndt::type(offset_type_id);
+        throw type_error(ss.str());
+    }
+}
+
+packed_string_type::~packed_string_type()
+{
+}
+
+void packed_string_type::set_offsets(char *data, intptr_t begin, intptr_t end) const
+{
+    if (m_offset_type_id == int32_type_id) {
+        if (end > numeric_limits<int32_t>::max()) {
+            throw runtime_error("The buffer of a packed string has grown too large for int32 offsets");
+        }
+        packed_string_type_data<int32_t> *d = reinterpret_cast<packed_string_type_data<int32_t> *>(data);
+        d->begin = static_cast<int32_t>(begin);
+        d->end = static_cast<int32_t>(end);
+    } else {
+        packed_string_type_data<int64_t> *d = reinterpret_cast<packed_string_type_data<int64_t> *>(data);
+        d->begin = begin;
+        d->end = end;
+    }
+}
+
+void packed_string_type::get_string_range(const char **out_begin, const char**out_end,
+                const char *metadata, const char *data) const
+{
+    const packed_string_type_metadata *md = reinterpret_cast<const packed_string_type_metadata *>(metadata);
+    const char *buffer = contiguous_memory_block_get_data(md->blockref);
+    intptr_t begin, end;
+    get_offsets(data, &begin, &end);
+    *out_begin = buffer + begin;
+    *out_end = buffer + end;
+}
+
+void packed_string_type::set_utf8_string(const char *data_metadata, char *data,
+                assign_error_mode errmode, const char* utf8_begin, const char *utf8_end) const
+{
+    const packed_string_type_metadata *data_md = reinterpret_cast<const packed_string_type_metadata *>(data_metadata);
+    memory_block_data *blockref = data_md->blockref;
+    intptr_t dst_charsize = string_encoding_char_size_table[m_encoding];
+
+    if (m_encoding == string_encoding_utf_8 && errmode == assign_error_none) {
+        // No validation or conversion needed, just copy the bytes
+        intptr_t size = utf8_end - utf8_begin;
+        intptr_t offset = contiguous_memory_block_allocate(blockref, size, 1);
+        memcpy(contiguous_memory_block_get_data(blockref) + offset, utf8_begin, size);
+        set_offsets(data, offset, offset + size);
+        return;
+    }
+
+    next_unicode_codepoint_t next_fn = get_next_unicode_codepoint_function(string_encoding_utf_8, errmode);
+    append_unicode_codepoint_t append_fn = get_append_unicode_codepoint_function(m_encoding, errmode);
+    uint32_t cp;
+
+    // Allocate the initial output as the src number of characters + some padding
+    intptr_t capacity = ((utf8_end - utf8_begin) + 16) * dst_charsize * 1124 / 1024;
+    intptr_t offset = contiguous_memory_block_allocate(blockref, capacity, dst_charsize);
+    char *dst_begin = contiguous_memory_block_get_data(blockref) + offset;
+    char *dst_current = dst_begin, *dst_end = dst_begin + capacity;
+    while (utf8_begin < utf8_end) {
+        cp = next_fn(utf8_begin, utf8_end);
+        // Append the codepoint, or increase the allocated memory as necessary.
+        // Growing may move the buffer, so the pointers are recomputed.
+        if (dst_end - dst_current < 8) {
+            intptr_t used = dst_current - dst_begin;
+            capacity *= 2;
+            contiguous_memory_block_resize(blockref, offset, capacity);
+            dst_begin = contiguous_memory_block_get_data(blockref) + offset;
+            dst_current = dst_begin + used;
+            dst_end = dst_begin + capacity;
+        }
+        append_fn(cp, dst_current, dst_end);
+    }
+
+    // Shrink-wrap the memory to just fit the string
+    intptr_t size = dst_current - dst_begin;
+    contiguous_memory_block_resize(blockref, offset, size);
+    set_offsets(data, offset, offset + size);
+}
+
+void packed_string_type::print_data(std::ostream& o, const char *metadata, const char *data) const
+{
+    uint32_t cp;
+    next_unicode_codepoint_t next_fn;
+    next_fn = get_next_unicode_codepoint_function(m_encoding, assign_error_none);
+    const char *begin, *end;
+    get_string_range(&begin, &end, metadata, data);
+
+    // Print as an escaped string
+    o << "\"";
+    while (begin < end) {
+        cp = next_fn(begin, end);
+        print_escaped_unicode_codepoint(o, cp);
+    }
+    o << "\"";
+}
+
+void packed_string_type::print_type(std::ostream& o) const
+{
+    o << "packed_string";
+    if (m_encoding != string_encoding_utf_8) {
+        o << "['" << m_encoding << "'";
+        if (m_offset_type_id != int32_type_id) {
+            o << "," << m_offset_type_id;
+        }
+        o << "]";
+    } else if (m_offset_type_id != int32_type_id) {
+        o << "[" << m_offset_type_id << "]";
+    }
+}
+
+bool packed_string_type::is_unique_data_owner(const char *metadata) const
+{
+    const packed_string_type_metadata *md = reinterpret_cast<const packed_string_type_metadata *>(metadata);
+    if (md->blockref != NULL && md->blockref->m_use_count != 1) {
+        return false;
+    }
+    return true;
+}
+
+ndt::type packed_string_type::get_canonical_type() const
+{
+    return ndt::type(this, true);
+}
+
+void packed_string_type::get_shape(intptr_t ndim, intptr_t i, intptr_t *out_shape,
+                const char *DYND_UNUSED(metadata), const char *DYND_UNUSED(data)) const
+{
+    out_shape[i] = -1;
+    if (i+1 < ndim) {
+        stringstream ss;
+        ss << "requested too many dimensions from type " << ndt::type(this, true);
+        throw runtime_error(ss.str());
+    }
+}
+
+bool packed_string_type::is_lossless_assignment(
+                const ndt::type& DYND_UNUSED(dst_tp),
+                const ndt::type& DYND_UNUSED(src_tp)) const
+{
+    // Don't shortcut anything to 'none' error checking, so that
+    // decoding errors get caught appropriately.
+    return false;
+}
+
+bool packed_string_type::operator==(const base_type& rhs) const
+{
+    if (this == &rhs) {
+        return true;
+    } else if (rhs.get_type_id() != packed_string_type_id) {
+        return false;
+    } else {
+        const packed_string_type *dt = static_cast<const packed_string_type*>(&rhs);
+        return m_encoding == dt->m_encoding && m_offset_type_id == dt->m_offset_type_id;
+    }
+}
+
+void packed_string_type::metadata_default_construct(char *metadata,
+                intptr_t DYND_UNUSED(ndim), const intptr_t* DYND_UNUSED(shape)) const
+{
+    // All the strings of the array share one contiguous buffer
+    packed_string_type_metadata *md = reinterpret_cast<packed_string_type_metadata *>(metadata);
+    md->blockref = make_contiguous_memory_block().release();
+}
+
+void packed_string_type::metadata_copy_construct(char *dst_metadata, const char *src_metadata,
+                memory_block_data *DYND_UNUSED(embedded_reference)) const
+{
+    // The offsets are only meaningful relative to the source's buffer,
+    // so the blockref is always copied as is
+    const packed_string_type_metadata *src_md = reinterpret_cast<const packed_string_type_metadata *>(src_metadata);
+    packed_string_type_metadata *dst_md = reinterpret_cast<packed_string_type_metadata *>(dst_metadata);
+    dst_md->blockref = src_md->blockref;
+    if (dst_md->blockref) {
+        memory_block_incref(dst_md->blockref);
+    }
+}
+
+void packed_string_type::metadata_reset_buffers(char *metadata) const
+{
+    const packed_string_type_metadata *md = reinterpret_cast<const packed_string_type_metadata *>(metadata);
+    if (md->blockref != NULL) {
+        contiguous_memory_block_reset(md->blockref);
+    } else {
+        throw runtime_error("can only reset the buffers of a dynd packed string "
+                        "type if the memory block reference was constructed by default");
+    }
+}
+
+void packed_string_type::metadata_finalize_buffers(char *metadata) const
+{
+    packed_string_type_metadata *md = reinterpret_cast<packed_string_type_metadata *>(metadata);
+    if (md->blockref != NULL) {
+        contiguous_memory_block_finalize(md->blockref);
+    }
+}
+
+void packed_string_type::metadata_destruct(char *metadata) const
+{
+    packed_string_type_metadata *md = reinterpret_cast<packed_string_type_metadata *>(metadata);
+    if (md->blockref) {
+        memory_block_decref(md->blockref);
+    }
+}
+
+void packed_string_type::metadata_debug_print(const char *metadata, std::ostream& o, const std::string& indent) const
+{
+    const packed_string_type_metadata *md = reinterpret_cast<const packed_string_type_metadata *>(metadata);
+    o << indent << "packed string metadata\n";
+    memory_block_debug_print(md->blockref, o, indent + " ");
+}
+
+size_t packed_string_type::make_assignment_kernel(
+                ckernel_builder *out, size_t offset_out,
+                const ndt::type& dst_tp, const char *dst_metadata,
+                const ndt::type& src_tp, const char *src_metadata,
+                kernel_request_t kernreq, assign_error_mode errmode,
+                const eval::eval_context *ectx) const
+{
+    if (this == dst_tp.extended()) {
+        if (src_tp.get_kind() == string_kind) {
+            return make_to_packed_string_assignment_kernel(out, offset_out,
+                            dst_tp, dst_metadata,
+                            src_tp, src_metadata,
+                            kernreq, errmode, ectx);
+        } else if (!src_tp.is_builtin()) {
+            return src_tp.extended()->make_assignment_kernel(out, offset_out,
+                            dst_tp, dst_metadata,
+                            src_tp, src_metadata,
+                            kernreq, errmode, ectx);
+        } else {
+            return make_builtin_to_string_assignment_kernel(out, offset_out,
+                            dst_tp, dst_metadata,
+                            src_tp.get_type_id(),
+                            kernreq, errmode, ectx);
+        }
+    } else {
+        if (dst_tp.is_builtin()) {
+            return make_string_to_builtin_assignment_kernel(out, offset_out,
+                            dst_tp.get_type_id(),
+                            src_tp, src_metadata,
+                            kernreq, errmode, ectx);
+        } else {
+            return make_packed_string_to_string_assignment_kernel(out, offset_out,
+                            dst_tp, dst_metadata,
+                            src_tp, src_metadata,
+                            kernreq, errmode, ectx);
+        }
+    }
+}
+
+size_t packed_string_type::make_comparison_kernel(
+                ckernel_builder *out, size_t offset_out,
+                const ndt::type& src0_dt, const char *src0_metadata,
+                const ndt::type& src1_dt, const char *src1_metadata,
+                comparison_type_t comptype,
+                const eval::eval_context *ectx) const
+{
+    if (this == src0_dt.extended()) {
+        if (*this == *src1_dt.extended()) {
+            return make_packed_string_comparison_kernel(out, offset_out,
+                            m_encoding, m_offset_type_id,
+                            src0_metadata, src1_metadata,
+                            comptype, ectx);
+        } else if (src1_dt.get_kind() == string_kind) {
+            return make_general_string_comparison_kernel(out, offset_out,
+                            src0_dt, src0_metadata,
+                            src1_dt, src1_metadata,
+                            comptype, ectx);
+        } else if (!src1_dt.is_builtin()) {
+            return src1_dt.extended()->make_comparison_kernel(out, offset_out,
+                            src0_dt, src0_metadata,
+                            src1_dt, src1_metadata,
+                            comptype, ectx);
+        }
+    }
+
+    throw not_comparable_error(src0_dt, src1_dt, comptype);
+}
+
+void packed_string_type::make_string_iter(dim_iter *out_di, string_encoding_t encoding,
+            const char *metadata, const char *data,
+            const memory_block_ptr& DYND_UNUSED(ref),
+            intptr_t buffer_max_mem,
+            const eval::eval_context *ectx) const
+{
+    // NOTE: The iterator points into the contiguous buffer, so it
+    //       is invalidated if more strings get appended to it
+    const packed_string_type_metadata *md = reinterpret_cast<const packed_string_type_metadata *>(metadata);
+    const char *begin, *end;
+    get_string_range(&begin, &end, metadata, data);
+    iter::make_string_iter(out_di, encoding,
+            m_encoding, begin, end, memory_block_ptr(md->blockref), buffer_max_mem, ectx);
+}
@@ -382,6 +382,14 @@ void strided_dim_type::metadata_finalize_buffers(char *metadata) const
     }
 }
 
+void strided_dim_type::metadata_merge_buffers(char *dst_metadata, char *src_metadata) const
+{
+    if (!m_element_tp.is_builtin()) {
+        m_element_tp.extended()->metadata_merge_buffers(dst_metadata + sizeof(strided_dim_type_metadata),
+                        src_metadata + sizeof(strided_dim_type_metadata));
+    }
+}
+
 void strided_dim_type::metadata_destruct(char *metadata) const
 {
     if (!m_element_tp.is_builtin()) {
@@ -500,68 +508,14 @@ size_t strided_dim_type::make_assignment_kernel(
                 const eval::eval_context *ectx) const
 {
     if (this == dst_tp.extended()) {
-        out->ensure_capacity(offset_out + sizeof(strided_assign_kernel_extra));
-        const strided_dim_type_metadata *dst_md =
-                        reinterpret_cast<const strided_dim_type_metadata *>(dst_metadata);
-        strided_assign_kernel_extra *e = out->get_at<strided_assign_kernel_extra>(offset_out);
-        switch (kernreq) {
-            case kernel_request_single:
-                e->base.set_function<unary_single_operation_t>(&strided_assign_kernel_extra::single);
-                break;
-            case kernel_request_strided:
-                e->base.set_function<unary_strided_operation_t>(&strided_assign_kernel_extra::strided);
-                break;
-            default: {
-                stringstream ss;
-                ss << "strided_dim_type::make_assignment_kernel: unrecognized request " << (int)kernreq;
-                throw runtime_error(ss.str());
-            }
-        }
-        e->base.destructor = strided_assign_kernel_extra::destruct;
-        if (src_tp.get_ndim() < dst_tp.get_ndim()) {
-            // If the src has fewer dimensions, broadcast it across this one
-            e->size = dst_md->size;
-            e->dst_stride = dst_md->stride;
-            e->src_stride = 0;
-            return ::make_assignment_kernel(out, offset_out + sizeof(strided_assign_kernel_extra),
-                            m_element_tp, dst_metadata + sizeof(strided_dim_type_metadata),
+        if (src_tp.get_ndim() < dst_tp.get_ndim() ||
+                        src_tp.get_type_id() == strided_dim_type_id ||
+                        src_tp.get_type_id() == fixed_dim_type_id) {
+            // Handles all the leading strided dimensions together
+            return make_strided_dims_assignment_kernel(out, offset_out,
+                            dst_tp, dst_metadata,
                             src_tp, src_metadata,
-                            kernel_request_strided, errmode, ectx);
-        } else if (src_tp.get_type_id() == strided_dim_type_id) {
-            // strided_dim -> strided_dim
-            const strided_dim_type *src_sad = static_cast<const strided_dim_type *>(src_tp.extended());
-            const strided_dim_type_metadata *src_md =
-                        reinterpret_cast<const strided_dim_type_metadata *>(src_metadata);
-            // Check for a broadcasting error
-            if (src_md->size != 1 && dst_md->size != src_md->size) {
-                throw broadcast_error(dst_tp, dst_metadata, src_tp, src_metadata);
-            }
-            e->size = dst_md->size;
-            e->dst_stride = dst_md->stride;
-            // In DyND, the src stride is required to be zero for size-one dimensions,
-            // so we don't have to check the size here.
-            e->src_stride = src_md->stride;
-            return ::make_assignment_kernel(out, offset_out + sizeof(strided_assign_kernel_extra),
-                            m_element_tp, dst_metadata + sizeof(strided_dim_type_metadata),
-                            src_sad->get_element_type(), src_metadata + sizeof(strided_dim_type_metadata),
-                            kernel_request_strided, errmode, ectx);
-        } else if (src_tp.get_type_id() == fixed_dim_type_id) {
-            // fixed_array -> strided_dim
-            const fixed_dim_type *src_fad = static_cast<const fixed_dim_type *>(src_tp.extended());
-            intptr_t src_size = src_fad->get_fixed_dim_size();
-            // Check for a broadcasting error
-            if (src_size != 1 && dst_md->size != src_size) {
-                throw broadcast_error(dst_tp, dst_metadata, src_tp, src_metadata);
-            }
-            e->size = dst_md->size;
-            e->dst_stride = dst_md->stride;
-            // In DyND, the src stride is required to be zero for size-one dimensions,
-            // so we don't have to check the size here.
-            e->src_stride = src_fad->get_fixed_stride();
-            return ::make_assignment_kernel(out, offset_out + sizeof(strided_assign_kernel_extra),
-                            m_element_tp, dst_metadata + sizeof(strided_dim_type_metadata),
-                            src_fad->get_element_type(), src_metadata,
-                            kernel_request_strided, errmode, ectx);
+                            kernreq, errmode, ectx);
         } else if (!src_tp.is_builtin()) {
             // Give the src type a chance to make a kernel
             return src_tp.extended()->make_assignment_kernel(out, offset_out,
@@ -202,6 +202,15 @@ void string_type::metadata_finalize_buffers(char *metadata) const
     }
 }
 
+void string_type::metadata_merge_buffers(char *dst_metadata, char *src_metadata) const
+{
+    string_type_metadata *dst_md = reinterpret_cast<string_type_metadata *>(dst_metadata);
+    string_type_metadata *src_md = reinterpret_cast<string_type_metadata *>(src_metadata);
+    if (dst_md->blockref != NULL && src_md->blockref != NULL) {
+        memory_block_merge(dst_md->blockref, src_md->blockref);
+    }
+}
+
 void string_type::metadata_destruct(char *metadata) const
 {
     string_type_metadata *md = reinterpret_cast<string_type_metadata *>(metadata);
@@ -400,6 +400,17 @@ void struct_type::metadata_finalize_buffers(char *metadata) const
     }
 }
 
+void struct_type::metadata_merge_buffers(char *dst_metadata, char *src_metadata) const
+{
+    for (size_t i = 0; i < m_field_types.size(); ++i) {
+        const ndt::type& field_dt = m_field_types[i];
+        if (!field_dt.is_builtin()) {
+            field_dt.extended()->metadata_merge_buffers(dst_metadata + m_metadata_offsets[i],
+                            src_metadata + m_metadata_offsets[i]);
+        }
+    }
+}
+
 void struct_type::metadata_destruct(char *metadata) const
 {
     for (size_t i = 0; i < m_field_types.size(); ++i) {
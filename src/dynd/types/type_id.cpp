@@ -97,6 +97,12 @@ std::ostream& dynd::operator<<(std::ostream& o, type_id_t tid)
             return (o << "string");
         case fixedstring_type_id:
             return (o << "fixedstring");
+        case packed_string_type_id:
+            return (o << "packed_string");
+        case small_string_type_id:
+            return (o << "small_string");
+        case dictionary_string_type_id:
+            return (o << "dictionary_string");
         case categorical_type_id:
             return (o << "categorical");
         case date_type_id:
@@ -111,6 +117,8 @@ std::ostream& dynd::operator<<(std::ostream& o, type_id_t tid)
             return (o << "strided_dim");
         case fixed_dim_type_id:
             return (o << "fixed_dim");
+        case offset_dim_type_id:
+            return (o << "offset_dim");
         case var_dim_type_id:
             return (o << "var_dim");
         case struct_type_id:
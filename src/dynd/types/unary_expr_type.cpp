@@ -7,6 +7,7 @@
 #include <dynd/shortvector.hpp>
 #include <dynd/types/builtin_type_properties.hpp>
 #include <dynd/shape_tools.hpp>
+#include <dynd/kernels/ckernel_profiler.hpp>
 
 using namespace std;
 using namespace dynd;
@@ -110,6 +111,15 @@ size_t unary_expr_type::make_operand_to_value_assignment_kernel(
     // As a special case, when src_count == 1, the kernel generated
     // is a unary_single_operation_t/unary_strided_operation_t instead of
     // expr_single_operation_t/expr_strided_operation_t
+    ckernel_profiler_scope profiled;
+    if (ectx != NULL && ectx->profiler != NULL) {
+        stringstream ss;
+        ss << "unary expr ";
+        m_kgen->print_type(ss);
+        ss << " -> " << m_value_type;
+        offset_out = profiled.push(ectx->profiler, out, offset_out,
+                        unary_operation_funcproto, kernreq, ss.str());
+    }
     return m_kgen->make_expr_kernel(out, offset_out,
                     m_value_type, dst_metadata,
                     1, &m_operand_type.value_type(),
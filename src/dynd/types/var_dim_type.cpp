@@ -537,6 +537,20 @@ void var_dim_type::metadata_finalize_buffers(char *metadata) const
     }
 }
 
+void var_dim_type::metadata_merge_buffers(char *dst_metadata, char *src_metadata) const
+{
+    if (!m_element_tp.is_builtin()) {
+        m_element_tp.extended()->metadata_merge_buffers(dst_metadata + sizeof(var_dim_type_metadata),
+                        src_metadata + sizeof(var_dim_type_metadata));
+    }
+
+    var_dim_type_metadata *dst_md = reinterpret_cast<var_dim_type_metadata *>(dst_metadata);
+    var_dim_type_metadata *src_md = reinterpret_cast<var_dim_type_metadata *>(src_metadata);
+    if (dst_md->blockref != NULL && src_md->blockref != NULL) {
+        memory_block_merge(dst_md->blockref, src_md->blockref);
+    }
+}
+
 void var_dim_type::metadata_destruct(char *metadata) const
 {
     var_dim_type_metadata *md = reinterpret_cast<var_dim_type_metadata *>(metadata);
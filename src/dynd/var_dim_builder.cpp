@@ -0,0 +1,120 @@
+//
+// Copyright (C) 2011-14 Mark Wiebe, DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <algorithm>
+
+#include <dynd/var_dim_builder.hpp>
+#include <dynd/types/var_dim_type.hpp>
+#include <dynd/types/strided_dim_type.hpp>
+#include <dynd/memblock/pod_memory_block.hpp>
+#include <dynd/memblock/memory_chunk_pool.hpp>
+
+using namespace std;
+using namespace dynd;
+
+var_dim_builder::var_dim_builder(const ndt::type& element_tp)
+    : m_element_tp(element_tp), m_element_size(0),
+        m_heap(NULL), m_heap_capacity(0), m_heap_size(0), m_rows()
+{
+    if (!element_tp.is_pod() || element_tp.get_metadata_size() != 0 ||
+                    element_tp.get_data_size() == 0) {
+        stringstream ss;
+        ss << "var_dim_builder requires a POD element type without metadata, not " << element_tp;
+        throw type_error(ss.str());
+    }
+    m_element_size = element_tp.get_data_size();
+}
+
+var_dim_builder::~var_dim_builder()
+{
+    detail::memory_chunk_free(m_heap, m_heap_capacity);
+}
+
+void var_dim_builder::grow_heap(intptr_t min_capacity)
+{
+    // Double the capacity, so appending is amortized O(1)
+    intptr_t capacity;
+    char *heap = detail::memory_chunk_allocate(max(min_capacity, 2 * m_heap_capacity), &capacity);
+    if (m_heap_size > 0) {
+        memcpy(heap, m_heap, m_heap_size);
+    }
+    detail::memory_chunk_free(m_heap, m_heap_capacity);
+    m_heap = heap;
+    m_heap_capacity = capacity;
+}
+
+void var_dim_builder::reserve(intptr_t row_count, intptr_t element_count)
+{
+    if (row_count > (intptr_t)m_rows.capacity()) {
+        m_rows.reserve(row_count);
+    }
+    if (element_count * m_element_size > m_heap_capacity) {
+        grow_heap(element_count * m_element_size);
+    }
+}
+
+char *var_dim_builder::append_uninitialized_row(intptr_t count)
+{
+    if (count < 0) {
+        stringstream ss;
+        ss << "var_dim_builder cannot append a row with negative size " << count;
+        throw runtime_error(ss.str());
+    }
+    intptr_t row_bytes = count * m_element_size;
+    if (m_heap_size + row_bytes > m_heap_capacity) {
+        grow_heap(m_heap_size + row_bytes);
+    }
+    row r = {m_heap_size, count};
+    m_rows.push_back(r);
+    char *result = m_heap + m_heap_size;
+    m_heap_size += row_bytes;
+    return result;
+}
+
+void var_dim_builder::append_row(const void *data, intptr_t count)
+{
+    char *dst = append_uninitialized_row(count);
+    if (count > 0) {
+        memcpy(dst, data, count * m_element_size);
+    }
+}
+
+nd::array var_dim_builder::finalize()
+{
+    intptr_t row_count = (intptr_t)m_rows.size();
+    nd::array result = nd::make_strided_array(row_count, ndt::make_var_dim(m_element_tp));
+
+    // The heap becomes the memory block the var dimension points into,
+    // which takes ownership of it even if this throws
+    char *heap = m_heap;
+    intptr_t heap_capacity = m_heap_capacity;
+    m_heap = NULL;
+    m_heap_capacity = 0;
+    m_heap_size = 0;
+    memory_block_ptr heap_block;
+    try {
+        heap_block = make_pod_memory_block_from_chunk(heap, heap_capacity);
+    } catch(...) {
+        m_rows.clear();
+        throw;
+    }
+
+    const strided_dim_type_metadata *md =
+                    reinterpret_cast<const strided_dim_type_metadata *>(result.get_ndo_meta());
+    var_dim_type_metadata *var_md = reinterpret_cast<var_dim_type_metadata *>(
+                    result.get_ndo_meta() + sizeof(strided_dim_type_metadata));
+    memory_block_decref(var_md->blockref);
+    var_md->blockref = heap_block.release();
+
+    char *dst = result.get_readwrite_originptr();
+    for (intptr_t i = 0; i < row_count; ++i, dst += md->stride) {
+        var_dim_type_data *d = reinterpret_cast<var_dim_type_data *>(dst);
+        d->begin = heap + m_rows[i].offset;
+        d->size = m_rows[i].size;
+    }
+    m_rows.clear();
+
+    return result;
+}
@@ -32,6 +32,36 @@ TEST(Array, NullConstructor) {
     EXPECT_EQ(NULL, a.get_memblock().get());
 }
 
+#ifdef DYND_RVALUE_REFS
+TEST(Array, MoveConstructor) {
+    nd::array a = nd::empty(3, "M * string");
+    memory_block_data *mbd = a.get_memblock().get();
+    EXPECT_EQ(1, mbd->m_use_count);
+
+    // Moving transfers the reference without touching the count
+    nd::array b(std::move(a));
+    EXPECT_EQ(NULL, a.get_memblock().get());
+    EXPECT_EQ(mbd, &b.get_ndo()->m_memblockdata);
+    EXPECT_EQ(1, mbd->m_use_count);
+}
+#endif // DYND_RVALUE_REFS
+
+TEST(Array, IndexingReferenceCounts) {
+    nd::array a = nd::empty(3, 4, "M * M * string");
+    const base_type *a_tp = a.get_type().extended();
+    int32_t a_tp_count = a_tp->get_use_count();
+    {
+        nd::array b = a(1);
+        EXPECT_EQ(ndt::type("M * string"), b.get_type());
+        EXPECT_EQ(a_tp_count, a_tp->get_use_count());
+        // The result owns one reference to its type
+        int32_t b_tp_count = b.get_type().extended()->get_use_count();
+        nd::array c = a(2);
+        EXPECT_EQ(b_tp_count + 1, b.get_type().extended()->get_use_count());
+    }
+    EXPECT_EQ(a_tp_count, a_tp->get_use_count());
+}
+
 TEST(Array, FromValueConstructor) {
     nd::array a;
     // Bool
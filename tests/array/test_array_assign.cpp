@@ -13,6 +13,7 @@
 #include <dynd/array.hpp>
 #include <dynd/types/convert_type.hpp>
 #include <dynd/types/strided_dim_type.hpp>
+#include <dynd/kernels/assignment_kernels.hpp>
 
 using namespace std;
 using namespace dynd;
@@ -197,6 +198,141 @@ TYPED_TEST_P(ArrayAssign, ScalarAssignment_Uint64) {
     EXPECT_EQ(20000000000ULL, TestFixture::First::Dereference(ptr_u64));
 }
 
+TEST(ArrayAssign, CoalescedDimensions) {
+    intptr_t shape[3] = {2, 3, 4};
+    int f_order[3] = {0, 1, 2};
+    nd::array a = nd::make_strided_array(ndt::make_type<int32_t>(), 3, shape);
+    nd::array b = nd::make_strided_array(ndt::make_type<int32_t>(), 3, shape);
+    nd::array c = nd::make_strided_array(ndt::make_type<int32_t>(), 3, shape,
+                    nd::read_access_flag|nd::write_access_flag, f_order);
+    for (int i = 0; i < 24; ++i) {
+        reinterpret_cast<int32_t *>(a.get_readwrite_originptr())[i] = i;
+    }
+
+    // A C-order copy is a single loop over all the elements
+    assignment_ckernel_builder k;
+    size_t kernel_size = make_assignment_kernel(&k, 0,
+                    b.get_type(), b.get_ndo_meta(), a.get_type(), a.get_ndo_meta(),
+                    kernel_request_single, assign_error_default, &eval::default_eval_context);
+    EXPECT_EQ(sizeof(strided_assign_kernel_extra) + sizeof(ckernel_prefix), kernel_size);
+    k(b.get_readwrite_originptr(), a.get_readonly_originptr());
+    for (int i = 0; i < 24; ++i) {
+        EXPECT_EQ(i, reinterpret_cast<const int32_t *>(b.get_readonly_originptr())[i]);
+    }
+
+    // C-order to F-order, and back again
+    c.vals() = a;
+    for (int i = 0; i < 2; ++i) {
+        for (int j = 0; j < 3; ++j) {
+            for (int k = 0; k < 4; ++k) {
+                EXPECT_EQ(12 * i + 4 * j + k, c(i, j, k).as<int32_t>());
+                EXPECT_EQ(12 * i + 4 * j + k, reinterpret_cast<const int32_t *>(
+                                c.get_readonly_originptr())[i + 2 * j + 6 * k]);
+            }
+        }
+    }
+    b.vals() = 0;
+    b.vals() = c;
+    for (int i = 0; i < 24; ++i) {
+        EXPECT_EQ(i, reinterpret_cast<const int32_t *>(b.get_readonly_originptr())[i]);
+    }
+
+    // Broadcasting along a middle dimension
+    nd::array d = nd::make_strided_array(ndt::make_type<int32_t>(), 3, shape);
+    d.vals() = a(irange(), irange() < 1, irange());
+    EXPECT_EQ(13, d(1, 2, 1).as<int32_t>());
+    EXPECT_EQ(3, d(0, 1, 3).as<int32_t>());
+}
+
+TEST(ArrayAssign, ContiguousCopy) {
+    // Small and large (non-temporal) contiguous copies, with
+    // sizes which aren't a multiple of the vector block size
+    intptr_t sizes[3] = {37, 3 * 1024 * 1024 + 5, 1024 * 1024 + 3};
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i) {
+        nd::array a = nd::empty(sizes[i], "M * int32");
+        int32_t *a_ptr = reinterpret_cast<int32_t *>(a.get_readwrite_originptr());
+        for (intptr_t j = 0; j < sizes[i]; ++j) {
+            a_ptr[j] = (int32_t)j;
+        }
+        nd::array b = nd::empty(sizes[i], "M * int32");
+        b.vals() = a;
+        const int32_t *b_ptr = reinterpret_cast<const int32_t *>(b.get_readonly_originptr());
+        for (intptr_t j = 0; j < sizes[i]; ++j) {
+            if (b_ptr[j] != (int32_t)j) {
+                EXPECT_EQ(j, b_ptr[j]);
+                break;
+            }
+        }
+    }
+
+    // A large copy from a source which is offset by one element
+    nd::array a = nd::empty(sizes[2], "M * 12 * uint8");
+    uint8_t *a_ptr = reinterpret_cast<uint8_t *>(a.get_readwrite_originptr());
+    for (intptr_t j = 0; j < sizes[2] * 12; ++j) {
+        a_ptr[j] = (uint8_t)(j % 251);
+    }
+    nd::array b = nd::empty(sizes[2] - 1, "M * 12 * uint8");
+    b.vals() = a(irange(1, sizes[2]));
+    const uint8_t *b_ptr = reinterpret_cast<const uint8_t *>(b.get_readonly_originptr());
+    for (intptr_t j = 0; j < (sizes[2] - 1) * 12; ++j) {
+        if (b_ptr[j] != (uint8_t)((j + 12) % 251)) {
+            EXPECT_EQ((j + 12) % 251, b_ptr[j]);
+            break;
+        }
+    }
+}
+
+TEST(ArrayAssign, BlockCheckedConversion) {
+    // Enough values for several range check blocks and a partial one
+    intptr_t size = 300;
+    nd::array a = nd::empty(size, "M * float64");
+    double *a_ptr = reinterpret_cast<double *>(a.get_readwrite_originptr());
+    for (intptr_t j = 0; j < size; ++j) {
+        a_ptr[j] = (double)(j - 150) * 1000000;
+    }
+    nd::array b = nd::empty(size, "M * int32");
+    const int32_t *b_ptr = reinterpret_cast<const int32_t *>(b.get_readonly_originptr());
+    b.val_assign(a, assign_error_fractional);
+    for (intptr_t j = 0; j < size; ++j) {
+        EXPECT_EQ((j - 150) * 1000000, b_ptr[j]);
+    }
+    // With a strided source
+    b = nd::empty(size / 2, "M * int32");
+    b_ptr = reinterpret_cast<const int32_t *>(b.get_readonly_originptr());
+    b.val_assign(a(irange().by(2)), assign_error_overflow);
+    for (intptr_t j = 0; j < size / 2; ++j) {
+        EXPECT_EQ((2 * j - 150) * 1000000, b_ptr[j]);
+    }
+
+    // An error in the middle of the second block is raised after
+    // assigning all the values before it
+    b = nd::empty(size, "M * int32");
+    b.vals() = 0;
+    b_ptr = reinterpret_cast<const int32_t *>(b.get_readonly_originptr());
+    a_ptr[200] = 3e9;
+    EXPECT_THROW(b.val_assign(a, assign_error_overflow), overflow_error);
+    EXPECT_EQ(199 * 1000000 - 150000000, b_ptr[199]);
+    EXPECT_EQ(0, b_ptr[200]);
+    a_ptr[200] = 1.5;
+    EXPECT_THROW(b.val_assign(a, assign_error_fractional), runtime_error);
+    b.val_assign(a, assign_error_overflow);
+    EXPECT_EQ(1, b_ptr[200]);
+
+    // Narrowing integers
+    nd::array c = nd::empty(size, "M * int16");
+    const int16_t *c_ptr = reinterpret_cast<const int16_t *>(c.get_readonly_originptr());
+    b = nd::empty(size, "M * int32");
+    int32_t *bw_ptr = reinterpret_cast<int32_t *>(b.get_readwrite_originptr());
+    for (intptr_t j = 0; j < size; ++j) {
+        bw_ptr[j] = (int32_t)(j * 100 - 15000);
+    }
+    c.val_assign(b, assign_error_overflow);
+    EXPECT_EQ(-15000, c_ptr[0]);
+    EXPECT_EQ(14900, c_ptr[size - 1]);
+    bw_ptr[size - 1] = 40000;
+    EXPECT_THROW(c.val_assign(b, assign_error_overflow), overflow_error);
+}
+
 #if !(defined(_WIN32) && !defined(_M_X64)) // TODO: How to mark as expected failures in googletest?
 
 TYPED_TEST_P(ArrayAssign, ScalarAssignment_Uint64_LargeNumbers) {
@@ -12,6 +12,7 @@
 
 #include "dynd/array.hpp"
 #include "dynd/exceptions.hpp"
+#include "dynd/json_parser.hpp"
 
 using namespace std;
 using namespace dynd;
@@ -217,3 +218,57 @@ INSTANTIATE_TYPED_TEST_CASE_P(Default, ArrayIndex, DefaultMemory);
 #ifdef DYND_CUDA
 INSTANTIATE_TYPED_TEST_CASE_P(CUDA, ArrayIndex, CUDAMemory);
 #endif // DYND_CUDA
+
+TEST(ArrayGetAt, StridedAndFixed) {
+    int i0[3][2] = {{1,2},{3,4},{5,6}};
+    nd::array a = i0;
+    EXPECT_EQ(1, a.get_at<int>(0, 0));
+    EXPECT_EQ(4, a.get_at<int>(1, 1));
+    EXPECT_EQ(6, a.get_at<int>(-1, -1));
+    // Converts to the requested type
+    EXPECT_EQ(5.0, a.get_at<double>(2, 0));
+    EXPECT_TRUE(a.get_at<bool>(0, 0));
+    EXPECT_THROW(a.get_at<bool>(0, 1), overflow_error);
+    EXPECT_THROW(a.get_at<int>(3, 0), index_out_of_bounds);
+    EXPECT_THROW(a.get_at<int>(0, -3), index_out_of_bounds);
+    EXPECT_THROW(a.get_at<int>(0, 0, 0), too_many_indices);
+    // Not a scalar
+    EXPECT_THROW(a.get_at<int>(0), broadcast_error);
+
+    nd::array b = nd::empty("3 * 2 * int16");
+    b.vals() = a;
+    EXPECT_EQ(3, b.get_at<int>(1, 0));
+    EXPECT_EQ(2, b.get_at<int16_t>(0, 1));
+}
+
+TEST(ArrayGetAt, VarAndStruct) {
+    nd::array a = nd::empty("2 * var * {x: int32, y: string}");
+    a.vals() = parse_json("2 * var * {x: int32, y: string}",
+                    "[[{\"x\": 1, \"y\": \"a\"}], [{\"x\": 2, \"y\": \"b\"}, {\"x\": 3, \"y\": \"c\"}]]");
+    EXPECT_EQ(1, a.get_at<int>(0, 0, 0));
+    EXPECT_EQ(3, a.get_at<int>(1, -1, 0));
+    EXPECT_THROW(a.get_at<int>(0, 1, 0), index_out_of_bounds);
+    EXPECT_EQ("c", a(1, 1, 1).as<string>());
+}
+
+TEST(ArrayIndex, IntegerIndexView) {
+    int i0[3][2] = {{1,2},{3,4},{5,6}};
+    nd::array a = i0;
+    nd::array b = a(1);
+    EXPECT_EQ(ndt::type("strided * int32"), b.get_type());
+    EXPECT_EQ(2, b.get_shape()[0]);
+    EXPECT_EQ(3, b(0).as<int>());
+    EXPECT_EQ(4, b(1).as<int>());
+    EXPECT_EQ(a.get_readonly_originptr() + 2 * sizeof(int), b.get_readonly_originptr());
+    // The view keeps the data alive
+    a = nd::array();
+    EXPECT_EQ(4, b(-1).as<int>());
+
+    nd::array c = nd::empty("3 * 2 * int32");
+    c.vals() = i0;
+    EXPECT_EQ(ndt::type("2 * int32"), c(2).get_type());
+    EXPECT_EQ(6, c(2)(1).as<int>());
+    EXPECT_EQ(ndt::make_type<int>(), c(2, 1).get_type());
+    EXPECT_EQ(c.get_access_flags(), c(2, 1).get_access_flags());
+    EXPECT_EQ(6, c(2, 1).as<int>());
+}
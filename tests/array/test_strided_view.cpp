@@ -0,0 +1,79 @@
+//
+// Copyright (C) 2011-14 Mark Wiebe, DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <iostream>
+#include <stdexcept>
+#include <numeric>
+
+#include "inc_gtest.hpp"
+
+#include <dynd/array.hpp>
+#include <dynd/strided_view.hpp>
+#include <dynd/exceptions.hpp>
+
+using namespace std;
+using namespace dynd;
+
+TEST(StridedView, TwoDimensional) {
+    int i0[3][2] = {{1,2},{3,4},{5,6}};
+    nd::array a = nd::array(i0).eval_copy(nd::readwrite_access_flags);
+
+    strided_view<int, 2> v(a);
+    EXPECT_EQ(3, v.get_dim_size(0));
+    EXPECT_EQ(2, v.get_dim_size(1));
+    EXPECT_EQ(8, v.get_stride(0));
+    EXPECT_EQ(4, v.get_stride(1));
+    EXPECT_EQ(6, v.get_size());
+    EXPECT_TRUE(v.is_contiguous());
+    EXPECT_EQ(1, v(0, 0));
+    EXPECT_EQ(4, v(1, 1));
+    EXPECT_EQ(5, v(2, 0));
+
+    // Writes go to the array
+    v(2, 1) = 100;
+    EXPECT_EQ(100, a(2, 1).as<int>());
+    EXPECT_EQ(115, accumulate(v.begin(), v.end(), 0));
+}
+
+TEST(StridedView, NonContiguous) {
+    double d0[6] = {1, 2, 3, 4, 5, 6};
+    nd::array a = nd::array(d0).eval_copy(nd::readwrite_access_flags);
+    nd::array b = a(irange().by(-2));
+    strided_view<const double, 1> v(b);
+    EXPECT_EQ(3, v.get_dim_size(0));
+    EXPECT_EQ(-16, v.get_stride(0));
+    EXPECT_FALSE(v.is_contiguous());
+    EXPECT_EQ(6, v(0));
+    EXPECT_EQ(4, v(1));
+    EXPECT_EQ(2, v(2));
+    EXPECT_THROW(v.begin(), runtime_error);
+}
+
+TEST(StridedView, FixedDim) {
+    nd::array a = nd::empty("2 * 3 * float32");
+    a.vals() = 1.5f;
+    strided_view<float, 2> v(a);
+    EXPECT_TRUE(v.is_contiguous());
+    for (float *it = v.begin(); it != v.end(); ++it) {
+        *it += 1;
+    }
+    EXPECT_EQ(2.5f, a(1, 2).as<float>());
+}
+
+TEST(StridedView, ReadOnly) {
+    int i0[3] = {1, 2, 3};
+    nd::array a = nd::array(i0).eval_copy(nd::default_access_flags);
+    EXPECT_THROW((strided_view<int, 1>(a)), runtime_error);
+    strided_view<const int, 1> v(a);
+    EXPECT_EQ(3, v(2));
+}
+
+TEST(StridedView, TypeMismatch) {
+    nd::array a = nd::empty("3 * var * int32");
+    EXPECT_THROW((strided_view<int, 2>(a)), type_error);
+    EXPECT_THROW((strided_view<int64_t, 1>(nd::empty("3 * int32"))), type_error);
+    EXPECT_THROW((strided_view<int, 2>(nd::empty("3 * int32"))), type_error);
+    EXPECT_THROW((strided_view<int, 1>(nd::empty("3 * 2 * int32"))), type_error);
+}
@@ -8,12 +8,208 @@
 #include <stdexcept>
 #include "inc_gtest.hpp"
 
-#if 0 // TODO reenable
 #include <dynd/codegen/codegen_cache.hpp>
 
 using namespace std;
 using namespace dynd;
 
+static bool is_codegen_available() {
+    return is_strided_loop_codegen_supported(
+                    strided_loop_signature(int32_type_id, false, int32_type_id, false));
+}
+
+TEST(CodeGenCache, StridedLoopCaching) {
+    if (!is_codegen_available()) {
+        return;
+    }
+    codegen_cache cgcache;
+    unary_strided_operation_t a, b, c;
+    a = cgcache.codegen_strided_loop(strided_loop_signature(float64_type_id, false, int32_type_id, false));
+    b = cgcache.codegen_strided_loop(strided_loop_signature(float64_type_id, false, int32_type_id, false));
+    c = cgcache.codegen_strided_loop(strided_loop_signature(float64_type_id, false, int32_type_id, true));
+    ASSERT_TRUE(a != NULL);
+    // The same signature reuses the generated loop
+    EXPECT_EQ(a, b);
+    EXPECT_NE(a, c);
+
+    // Unsupported types
+    EXPECT_TRUE(cgcache.codegen_strided_loop(
+                    strided_loop_signature(bool_type_id, false, int32_type_id, false)) == NULL);
+    EXPECT_TRUE(cgcache.codegen_strided_loop(
+                    strided_loop_signature(complex_float64_type_id, false, float64_type_id, false)) == NULL);
+    EXPECT_TRUE(cgcache.codegen_strided_loop(
+                    strided_loop_signature(uint64_type_id, false, float64_type_id, false)) == NULL);
+
+    codegen_cache_stats stats = cgcache.get_stats();
+    EXPECT_EQ(1u, stats.hits);
+    EXPECT_EQ(2u, stats.misses);
+    EXPECT_EQ(0u, stats.evictions);
+    EXPECT_EQ(2u, stats.size);
+}
+
+TEST(CodeGenCache, StridedLoopEviction) {
+    if (!is_codegen_available()) {
+        return;
+    }
+    codegen_cache cgcache(2);
+    strided_loop_signature sig_a(float64_type_id, false, int32_type_id, false);
+    strided_loop_signature sig_b(float64_type_id, false, int16_type_id, false);
+    strided_loop_signature sig_c(float64_type_id, false, int8_type_id, false);
+    cgcache.codegen_strided_loop(sig_a);
+    cgcache.codegen_strided_loop(sig_b);
+    // Use 'a' so 'b' is the least recently used
+    cgcache.codegen_strided_loop(sig_a);
+    cgcache.codegen_strided_loop(sig_c);
+    codegen_cache_stats stats = cgcache.get_stats();
+    EXPECT_EQ(1u, stats.hits);
+    EXPECT_EQ(3u, stats.misses);
+    EXPECT_EQ(1u, stats.evictions);
+    EXPECT_EQ(2u, stats.size);
+    // 'a' is still cached, 'b' isn't
+    cgcache.codegen_strided_loop(sig_a);
+    EXPECT_EQ(2u, cgcache.get_stats().hits);
+    memory_block_ptr first_memblock = cgcache.get_exec_memblock();
+    cgcache.codegen_strided_loop(sig_b);
+    EXPECT_EQ(4u, cgcache.get_stats().misses);
+    EXPECT_EQ(2u, cgcache.get_stats().evictions);
+    // Once as many loops as the capacity are dead, a new executable block is used
+    EXPECT_NE(first_memblock.get(), cgcache.get_exec_memblock().get());
+
+    // Kernels made from a replaced block keep working
+    int8_t src[2] = {-5, 6};
+    double dst[2];
+    assignment_strided_ckernel_builder k;
+    ASSERT_NE(0u, cgcache.make_strided_loop_kernel(&k, 0, sig_c, kernel_request_strided));
+    for (int i = 0; i < 4; ++i) {
+        cgcache.codegen_strided_loop(i % 2 ? sig_a : sig_b);
+        cgcache.codegen_strided_loop(strided_loop_signature(float32_type_id, false, int8_type_id, i % 2 == 0));
+    }
+    k(reinterpret_cast<char *>(dst), sizeof(double), reinterpret_cast<const char *>(src), 1, 2);
+    EXPECT_EQ(-5., dst[0]);
+    EXPECT_EQ(6., dst[1]);
+}
+
+TEST(CodeGenCache, StridedLoopConvert) {
+    if (!is_codegen_available()) {
+        return;
+    }
+    codegen_cache cgcache;
+    unary_strided_operation_t fn;
+
+    // int32 -> float64, contiguous
+    int32_t i32[5] = {-3, 0, 7, 2147483647, -2147483647 - 1};
+    double f64[5];
+    fn = cgcache.codegen_strided_loop(strided_loop_signature(float64_type_id, false, int32_type_id, false));
+    fn(reinterpret_cast<char *>(f64), sizeof(double), reinterpret_cast<const char *>(i32), sizeof(int32_t), 5, NULL);
+    for (int i = 0; i < 5; ++i) {
+        EXPECT_EQ((double)i32[i], f64[i]);
+    }
+
+    // float64 -> int16, reversed src
+    int16_t i16[5] = {0, 0, 0, 0, 0};
+    double f64_in[5] = {1.75, -2.5, 100.0, -32768.0, 32767.0};
+    fn = cgcache.codegen_strided_loop(strided_loop_signature(int16_type_id, false, float64_type_id, false));
+    fn(reinterpret_cast<char *>(i16), sizeof(int16_t),
+                    reinterpret_cast<const char *>(f64_in + 4), -(intptr_t)sizeof(double), 5, NULL);
+    for (int i = 0; i < 5; ++i) {
+        EXPECT_EQ((int16_t)f64_in[4 - i], i16[i]);
+    }
+
+    // uint32 -> float32, zero stride src
+    uint32_t u32 = 4000000000u;
+    float f32[3];
+    fn = cgcache.codegen_strided_loop(strided_loop_signature(float32_type_id, false, uint32_type_id, false));
+    fn(reinterpret_cast<char *>(f32), sizeof(float), reinterpret_cast<const char *>(&u32), 0, 3, NULL);
+    for (int i = 0; i < 3; ++i) {
+        EXPECT_EQ((float)u32, f32[i]);
+    }
+
+    // float32 -> int64, nothing with a zero count
+    float f32_in[2] = {-1.5e10f, 3.25f};
+    int64_t i64[2] = {5, 5};
+    fn = cgcache.codegen_strided_loop(strided_loop_signature(int64_type_id, false, float32_type_id, false));
+    fn(reinterpret_cast<char *>(i64), sizeof(int64_t), reinterpret_cast<const char *>(f32_in), sizeof(float), 0, NULL);
+    EXPECT_EQ(5, i64[0]);
+    fn(reinterpret_cast<char *>(i64), sizeof(int64_t), reinterpret_cast<const char *>(f32_in), sizeof(float), 2, NULL);
+    EXPECT_EQ((int64_t)f32_in[0], i64[0]);
+    EXPECT_EQ(3, i64[1]);
+
+    // uint8 -> float64 and int8 -> uint16
+    uint8_t u8[2] = {200, 3};
+    int8_t i8[2] = {-1, 5};
+    uint16_t u16[2];
+    fn = cgcache.codegen_strided_loop(strided_loop_signature(float64_type_id, false, uint8_type_id, false));
+    fn(reinterpret_cast<char *>(f64), sizeof(double), reinterpret_cast<const char *>(u8), 1, 2, NULL);
+    EXPECT_EQ(200., f64[0]);
+    EXPECT_EQ(3., f64[1]);
+    fn = cgcache.codegen_strided_loop(strided_loop_signature(uint16_type_id, false, int8_type_id, false));
+    fn(reinterpret_cast<char *>(u16), sizeof(uint16_t), reinterpret_cast<const char *>(i8), 1, 2, NULL);
+    EXPECT_EQ(65535u, u16[0]);
+    EXPECT_EQ(5u, u16[1]);
+}
+
+TEST(CodeGenCache, StridedLoopByteswap) {
+    if (!is_codegen_available()) {
+        return;
+    }
+    codegen_cache cgcache;
+    unary_strided_operation_t fn;
+
+    // Swapped int16 -> int64, sign extended after the swap
+    uint8_t i16_be[4] = {0xff, 0xfe, 0x01, 0x02};
+    int64_t i64[2];
+    fn = cgcache.codegen_strided_loop(strided_loop_signature(int64_type_id, false, int16_type_id, true));
+    fn(reinterpret_cast<char *>(i64), sizeof(int64_t), reinterpret_cast<const char *>(i16_be), 2, 2, NULL);
+    EXPECT_EQ(-2, i64[0]);
+    EXPECT_EQ(0x0102, i64[1]);
+
+    // Swapped uint32 -> float64 from unaligned data
+    uint8_t u32_be[9] = {0, 0xff, 0xff, 0xff, 0xff, 0x00, 0x00, 0x01, 0x00};
+    double f64[2];
+    fn = cgcache.codegen_strided_loop(strided_loop_signature(float64_type_id, false, uint32_type_id, true));
+    fn(reinterpret_cast<char *>(f64), sizeof(double), reinterpret_cast<const char *>(u32_be + 1), 4, 2, NULL);
+    EXPECT_EQ(4294967295., f64[0]);
+    EXPECT_EQ(256., f64[1]);
+
+    // float32 -> swapped float64 -> float32
+    float f32_in[3] = {1.5f, -2.25f, 1e30f}, f32_out[3];
+    double f64_swapped[3];
+    fn = cgcache.codegen_strided_loop(strided_loop_signature(float64_type_id, true, float32_type_id, false));
+    fn(reinterpret_cast<char *>(f64_swapped), sizeof(double), reinterpret_cast<const char *>(f32_in), sizeof(float), 3, NULL);
+    const uint8_t *f64_bytes = reinterpret_cast<const uint8_t *>(f64_swapped);
+    // 1.5 is 0x3ff8000000000000
+    EXPECT_EQ(0x3f, f64_bytes[0]);
+    EXPECT_EQ(0xf8, f64_bytes[1]);
+    fn = cgcache.codegen_strided_loop(strided_loop_signature(float32_type_id, false, float64_type_id, true));
+    fn(reinterpret_cast<char *>(f32_out), sizeof(float), reinterpret_cast<const char *>(f64_swapped), sizeof(double), 3, NULL);
+    for (int i = 0; i < 3; ++i) {
+        EXPECT_EQ(f32_in[i], f32_out[i]);
+    }
+}
+
+TEST(CodeGenCache, StridedLoopKernel) {
+    if (!is_codegen_available()) {
+        return;
+    }
+    int32_t src[3] = {1, -2, 3};
+    double dst[3];
+    assignment_strided_ckernel_builder k;
+    {
+        codegen_cache cgcache;
+        strided_loop_signature sig(float64_type_id, false, int32_type_id, false);
+        // Only strided kernels are generated
+        EXPECT_EQ(0u, cgcache.make_strided_loop_kernel(&k, 0, sig, kernel_request_single));
+        EXPECT_NE(0u, cgcache.make_strided_loop_kernel(&k, 0, sig, kernel_request_strided));
+    }
+    // The kernel keeps the generated code alive after the cache is gone
+    k(reinterpret_cast<char *>(dst), sizeof(double), reinterpret_cast<const char *>(src), sizeof(int32_t), 3);
+    EXPECT_EQ(1., dst[0]);
+    EXPECT_EQ(-2., dst[1]);
+    EXPECT_EQ(3., dst[2]);
+}
+
+#if 0 // TODO reenable
+
 static int int_float_fn1(float x) {
     return (int)(x * 2);
 }
@@ -11,6 +11,7 @@
 #include "inc_gtest.hpp"
 
 #include <dynd/types/fixedstring_type.hpp>
+#include <dynd/types/pointer_type.hpp>
 #include <dynd/types/ckernel_deferred_type.hpp>
 #include <dynd/kernels/ckernel_deferred.hpp>
 #include <dynd/kernels/assignment_kernels.hpp>
@@ -203,6 +204,31 @@ TEST(CKernelDeferred, LiftUnaryExpr_StridedDim) {
     EXPECT_EQ(12345, out(2).as<int>());
 }
 
+TEST(CKernelDeferred, LiftUnaryExpr_PointerToStridedDim) {
+    nd::array ckd_base = nd::empty(ndt::make_ckernel_deferred());
+    // Create a deferred ckernel for converting string to int
+    make_ckernel_deferred_from_assignment(
+                    ndt::make_type<int>(), ndt::make_fixedstring(16), ndt::make_fixedstring(16),
+                    expr_operation_funcproto, assign_error_default,
+                    *reinterpret_cast<ckernel_deferred *>(ckd_base.get_readwrite_originptr()));
+
+    // Lift the kernel with a source dimension hidden behind a pointer,
+    // which the strided kernels can't process
+    ckernel_deferred ckd;
+    vector<ndt::type> lifted_types;
+    lifted_types.push_back(ndt::type("strided * int32"));
+    lifted_types.push_back(ndt::make_pointer(ndt::type("strided * string[16]")));
+    lift_ckernel_deferred(&ckd, ckd_base, lifted_types);
+
+    // Instantiating it should raise an error instead of recursing
+    ckernel_builder ckb;
+    nd::array out = nd::empty(3, ndt::type("strided * int32"));
+    const char *dynd_metadata[2] = {NULL, NULL};
+    dynd_metadata[0] = out.get_ndo_meta();
+    EXPECT_THROW(ckd.instantiate_func(ckd.data_ptr, &ckb, 0, dynd_metadata, kernel_request_single),
+                    runtime_error);
+}
+
 TEST(CKernelDeferred, LiftUnaryExpr_StridedToVarDim) {
     nd::array ckd_base = nd::empty(ndt::make_ckernel_deferred());
     // Create a deferred ckernel for converting string to int
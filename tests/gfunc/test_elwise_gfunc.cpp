@@ -0,0 +1,110 @@
+//
+// Copyright (C) 2011-14 Mark Wiebe, DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <iostream>
+#include <stdexcept>
+
+#include "inc_gtest.hpp"
+
+#include <dynd/gfunc/elwise_gfunc.hpp>
+#include <dynd/gfunc/elwise_reduce_gfunc.hpp>
+
+using namespace std;
+using namespace dynd;
+
+static void add_binary_kernel(gfunc::elwise& gf, const ndt::type& tp)
+{
+    gfunc::elwise_kernel k;
+    k.m_returntype = tp;
+    k.m_paramtypes.push_back(tp);
+    k.m_paramtypes.push_back(tp);
+    gf.add_kernel(k);
+}
+
+TEST(ElwiseGFunc, ExactMatch) {
+    gfunc::elwise gf("add");
+    add_binary_kernel(gf, ndt::make_type<int32_t>());
+    add_binary_kernel(gf, ndt::make_type<double>());
+    add_binary_kernel(gf, ndt::type("string"));
+
+    vector<ndt::type> sig(2, ndt::make_type<double>());
+    const gfunc::elwise_kernel *k = gf.find_matching_kernel(sig);
+    ASSERT_TRUE(k != NULL);
+    EXPECT_EQ(ndt::make_type<double>(), k->m_returntype);
+
+    sig.assign(2, ndt::type("string"));
+    k = gf.find_matching_kernel(sig);
+    ASSERT_TRUE(k != NULL);
+    EXPECT_EQ(ndt::type("string"), k->m_returntype);
+
+    // No implicit promotion for the exact lookup
+    sig.assign(2, ndt::make_type<float>());
+    EXPECT_TRUE(gf.find_matching_kernel(sig) == NULL);
+
+    // Adding the same signature again is an error
+    EXPECT_THROW(add_binary_kernel(gf, ndt::make_type<double>()), runtime_error);
+}
+
+TEST(ElwiseGFunc, ResolveWithPromotion) {
+    gfunc::elwise gf("add");
+    add_binary_kernel(gf, ndt::make_type<int32_t>());
+    add_binary_kernel(gf, ndt::make_type<int64_t>());
+    add_binary_kernel(gf, ndt::make_type<double>());
+
+    vector<ndt::type> sig;
+    sig.push_back(ndt::make_type<int32_t>());
+    sig.push_back(ndt::make_type<double>());
+    EXPECT_TRUE(gf.find_matching_kernel(sig) == NULL);
+    const gfunc::elwise_kernel *k = gf.resolve_kernel(sig);
+    ASSERT_TRUE(k != NULL);
+    EXPECT_EQ(ndt::make_type<double>(), k->m_paramtypes[0]);
+    // Resolving it again gives the cached kernel
+    EXPECT_EQ(k, gf.resolve_kernel(sig));
+
+    sig[0] = ndt::make_type<int8_t>();
+    sig[1] = ndt::make_type<int64_t>();
+    k = gf.resolve_kernel(sig);
+    ASSERT_TRUE(k != NULL);
+    EXPECT_EQ(ndt::make_type<int64_t>(), k->m_paramtypes[0]);
+
+    // Types without an arithmetic promotion don't match
+    sig[0] = ndt::type("string");
+    sig[1] = ndt::make_type<int32_t>();
+    EXPECT_TRUE(gf.resolve_kernel(sig) == NULL);
+    EXPECT_TRUE(gf.resolve_kernel(sig) == NULL);
+
+    // Once a kernel is added for complex, the previously
+    // failed promotion to it succeeds
+    sig[0] = ndt::make_type<complex<double> >();
+    sig[1] = ndt::make_type<int32_t>();
+    EXPECT_TRUE(gf.resolve_kernel(sig) == NULL);
+    add_binary_kernel(gf, ndt::make_type<complex<double> >());
+    k = gf.resolve_kernel(sig);
+    ASSERT_TRUE(k != NULL);
+    EXPECT_EQ(ndt::make_type<complex<double> >(), k->m_returntype);
+}
+
+TEST(ElwiseReduceGFunc, ExactAndResolve) {
+    gfunc::elwise_reduce gf("sum");
+    gfunc::elwise_reduce_kernel k;
+    k.m_associative = true;
+    k.m_commutative = true;
+    k.m_returntype = ndt::make_type<int64_t>();
+    k.m_paramtypes.push_back(ndt::make_type<int64_t>());
+    gf.add_kernel(k);
+
+    vector<ndt::type> sig(1, ndt::make_type<int64_t>());
+    const gfunc::elwise_reduce_kernel *rk = gf.find_matching_kernel(sig);
+    ASSERT_TRUE(rk != NULL);
+    EXPECT_TRUE(rk->m_commutative);
+
+    // A single int32 parameter doesn't promote to int64
+    sig[0] = ndt::make_type<int32_t>();
+    EXPECT_TRUE(gf.resolve_kernel(sig) == NULL);
+
+    k.m_returntype = ndt::make_type<int64_t>();
+    k.m_paramtypes.assign(1, ndt::make_type<int64_t>());
+    EXPECT_THROW(gf.add_kernel(k), runtime_error);
+}
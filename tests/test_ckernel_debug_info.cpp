@@ -0,0 +1,140 @@
+//
+// Copyright (C) 2011-14 Mark Wiebe, DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <inc_gtest.hpp>
+
+#include <dynd/array.hpp>
+#include <dynd/kernels/assignment_kernels.hpp>
+#include <dynd/kernels/ckernel_debug_info.hpp>
+#include <dynd/kernels/ckernel_profiler.hpp>
+
+using namespace std;
+using namespace dynd;
+
+TEST(CKernelDebugInfo, StridedDimAssign) {
+    nd::array a = nd::make_strided_array(5, ndt::make_type<int32_t>());
+    nd::array b = nd::make_strided_array(5, ndt::make_type<double>());
+    assignment_ckernel_builder k;
+    make_assignment_kernel(&k, 0, b.get_type(), b.get_ndo_meta(),
+                    a.get_type(), a.get_ndo_meta(),
+                    kernel_request_single, assign_error_default, &eval::default_eval_context);
+
+    stringstream ss, expected;
+    k.debug_print(ss);
+    expected << "[0] strided dim assign (single, " << sizeof(strided_assign_kernel_extra)
+             << " bytes) size=5 dst_stride=8 src_stride=4\n";
+    expected << "  [" << sizeof(strided_assign_kernel_extra)
+             << "] builtin assign float64 <- int32, errmode=none (strided, "
+             << sizeof(ckernel_prefix) << " bytes)\n";
+    EXPECT_EQ(expected.str(), ss.str());
+}
+
+TEST(CKernelDebugInfo, SingleAsStridedAdapter) {
+    // A strided request for a kernel which only has a single version
+    // gets the adapter which calls it once per element
+    assignment_ckernel_builder k;
+    size_t offset = make_kernreq_to_single_kernel_adapter(&k, 0, kernel_request_strided);
+    make_pod_typed_data_assignment_kernel(&k, offset, 4, 4, kernel_request_single);
+
+    stringstream ss, expected;
+    k.debug_print(ss, "> ");
+    expected << "> [0] single as strided adapter (strided, " << sizeof(ckernel_prefix) << " bytes)\n";
+    expected << ">   [" << sizeof(ckernel_prefix) << "] aligned copy 4 bytes (single, "
+             << sizeof(ckernel_prefix) << " bytes)\n";
+    EXPECT_EQ(expected.str(), ss.str());
+}
+
+TEST(CKernelDebugInfo, Profiled) {
+    ckernel_profiler prof;
+    eval::eval_context ectx;
+    ectx.profiler = &prof;
+    assignment_ckernel_builder k;
+    make_assignment_kernel(&k, 0, ndt::make_type<int64_t>(), NULL,
+                    ndt::make_type<int16_t>(), NULL,
+                    kernel_request_single, assign_error_default, &ectx);
+
+    stringstream ss;
+    k.debug_print(ss);
+    EXPECT_NE(string::npos, ss.str().find("[0] profiled (single"));
+    EXPECT_NE(string::npos, ss.str().find("\"assign int64 <- int16\""));
+    EXPECT_NE(string::npos, ss.str().find("\n  ["));
+    EXPECT_NE(string::npos, ss.str().find("] builtin assign int64 <- int16, errmode=none (single"));
+}
+
+static void unregistered_kernel(char *DYND_UNUSED(dst), const char *DYND_UNUSED(src),
+                ckernel_prefix *DYND_UNUSED(extra))
+{
+}
+
+TEST(CKernelDebugInfo, Unregistered) {
+    assignment_ckernel_builder k;
+    EXPECT_TRUE(get_ckernel_debug_info(k.get()->function) == NULL);
+    stringstream ss;
+    k.debug_print(ss);
+    EXPECT_EQ("[0] (empty ckernel)\n", ss.str());
+
+    k.get()->set_function<unary_single_operation_t>(&unregistered_kernel);
+    ss.str("");
+    k.debug_print(ss);
+    EXPECT_NE(string::npos, ss.str().find("[0] unregistered ckernel function "));
+
+    // Registering it makes it show up by name
+    register_ckernel_debug_info((void *)&unregistered_kernel, "test kernel",
+                    sizeof(ckernel_prefix), false, NULL);
+    ss.str("");
+    k.debug_print(ss);
+    EXPECT_EQ(0u, ss.str().find("[0] test kernel (single, "));
+    k.get()->function = NULL;
+}
+
+static int loader_call_count = 0;
+
+static void loaded_kernel(char *DYND_UNUSED(dst), const char *DYND_UNUSED(src),
+                ckernel_prefix *DYND_UNUSED(extra))
+{
+}
+
+static void load_test_debug_info()
+{
+    ++loader_call_count;
+    register_ckernel_debug_info((void *)&loaded_kernel, "loaded kernel",
+                    sizeof(ckernel_prefix), false, NULL);
+}
+
+TEST(CKernelDebugInfo, Loader) {
+    // A loader only runs once, on the first lookup after it is added
+    register_ckernel_debug_info_loader(&load_test_debug_info);
+    EXPECT_EQ(0, loader_call_count);
+    const ckernel_debug_info *info = get_ckernel_debug_info((void *)&loaded_kernel);
+    EXPECT_EQ(1, loader_call_count);
+    ASSERT_TRUE(info != NULL);
+    EXPECT_EQ("loaded kernel", info->name);
+    EXPECT_EQ(info, get_ckernel_debug_info((void *)&loaded_kernel));
+    EXPECT_EQ(1, loader_call_count);
+}
+
+TEST(CKernelDebugInfo, NoSingleAsStridedAdapter) {
+    // String, date, categorical and struct assignments provide
+    // strided kernels directly, without the per-element adapter
+    const char *src_types[] = {"string", "string", "date", "{x: int32, y: string}"};
+    const char *dst_types[] = {"string[16]", "date", "string", "{y: string, x: int64}"};
+    for (size_t i = 0; i != sizeof(src_types) / sizeof(src_types[0]); ++i) {
+        nd::array a = nd::make_strided_array(3, ndt::type(src_types[i]));
+        nd::array b = nd::make_strided_array(3, ndt::type(dst_types[i]));
+        assignment_ckernel_builder k;
+        make_assignment_kernel(&k, 0, b.get_type(), b.get_ndo_meta(),
+                        a.get_type(), a.get_ndo_meta(),
+                        kernel_request_single, assign_error_default, &eval::default_eval_context);
+        stringstream ss;
+        k.debug_print(ss);
+        EXPECT_EQ(string::npos, ss.str().find("adapter")) << src_types[i] << " -> " << dst_types[i]
+                        << "\n" << ss.str();
+        EXPECT_EQ(string::npos, ss.str().find("unregistered")) << src_types[i] << " -> " << dst_types[i]
+                        << "\n" << ss.str();
+    }
+}
@@ -0,0 +1,92 @@
+//
+// Copyright (C) 2011-14 Mark Wiebe, DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <inc_gtest.hpp>
+
+#include <dynd/array.hpp>
+#include <dynd/kernels/ckernel_profiler.hpp>
+
+using namespace std;
+using namespace dynd;
+
+TEST(CKernelProfiler, Assignment) {
+    ckernel_profiler prof;
+    eval::eval_context ectx;
+    ectx.profiler = &prof;
+
+    int32_t vals[] = {3, 1, 4, 1, 5};
+    nd::array a = vals;
+    nd::array b = nd::empty(5, "strided * float64");
+    b.val_assign(a, assign_error_default, &ectx);
+    EXPECT_EQ(4., b(2).as<double>());
+
+    // The strided dimension kernel, with the builtin kernel as its child
+    const ckernel_profile_node& root = prof.get_root();
+    ASSERT_EQ(1u, root.children.size());
+    const ckernel_profile_node *node = root.children[0];
+    EXPECT_EQ("assign strided * float64 <- strided * int32", node->name);
+    EXPECT_FALSE(node->strided);
+    EXPECT_EQ(1u, node->calls);
+    EXPECT_EQ(1u, node->elements);
+    ASSERT_EQ(1u, node->children.size());
+    const ckernel_profile_node *child = node->children[0];
+    EXPECT_EQ("assign float64 <- int32", child->name);
+    EXPECT_TRUE(child->strided);
+    EXPECT_EQ(1u, child->calls);
+    EXPECT_EQ(5u, child->elements);
+    EXPECT_EQ(node, child->parent);
+    EXPECT_GE(node->ticks, child->ticks);
+    EXPECT_EQ(node->ticks - child->ticks, node->get_self_ticks());
+
+    // Another assignment adds another tree, and counts can be reset
+    b.val_assign(a, assign_error_default, &ectx);
+    ASSERT_EQ(2u, root.children.size());
+    prof.reset_counts();
+    EXPECT_EQ(0u, root.children[0]->calls);
+    EXPECT_EQ(0u, root.children[0]->children[0]->elements);
+    EXPECT_EQ(0u, root.children[0]->children[0]->ticks);
+
+    stringstream ss;
+    prof.print(ss);
+    EXPECT_NE(string::npos, ss.str().find("    assign float64 <- int32 (strided)"));
+}
+
+TEST(CKernelProfiler, Arithmetic) {
+    ckernel_profiler prof;
+    eval::eval_context ectx;
+    ectx.profiler = &prof;
+
+    int32_t vals0[] = {3, 1, 4, 1, 5};
+    int32_t vals1[] = {1, 2, 3, 4, 5};
+    nd::array a = vals0, b = vals1;
+    nd::array c = (a + b).eval(&ectx);
+    EXPECT_EQ(7, c(2).as<int>());
+
+    // Evaluation assigns from the expression, whose kernel
+    // runs the elementwise addition over the dimension
+    const ckernel_profile_node& root = prof.get_root();
+    ASSERT_EQ(1u, root.children.size());
+    const ckernel_profile_node *node = root.children[0];
+    EXPECT_EQ(0u, node->name.find("assign strided * int32 <- expr<"));
+    ASSERT_EQ(1u, node->children.size());
+    node = node->children[0];
+    EXPECT_EQ("expr addition(op0, op1) -> strided * int32", node->name);
+    EXPECT_EQ(1u, node->calls);
+    ASSERT_EQ(1u, node->children.size());
+    node = node->children[0];
+    EXPECT_EQ("elwise addition(op0, op1) -> int32", node->name);
+    EXPECT_TRUE(node->strided);
+    EXPECT_EQ(5u, node->elements);
+}
+
+TEST(CKernelProfiler, Disabled) {
+    // Without a profiler, the default context adds no kernels
+    eval::eval_context ectx;
+    EXPECT_EQ(NULL, ectx.profiler);
+    EXPECT_EQ(NULL, eval::default_eval_context.profiler);
+}
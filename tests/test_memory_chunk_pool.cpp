@@ -0,0 +1,84 @@
+//
+// Copyright (C) 2011-14 Mark Wiebe, DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <iostream>
+#include <stdexcept>
+#include "inc_gtest.hpp"
+
+#include "dynd/memblock/memory_chunk_pool.hpp"
+#include "dynd/memblock/pod_memory_block.hpp"
+#include "dynd/array.hpp"
+
+using namespace std;
+using namespace dynd;
+
+TEST(MemoryChunkPool, SizeClasses) {
+    intptr_t capacity;
+    char *chunk;
+
+    // Small requests get rounded up to a power of two
+    chunk = detail::memory_chunk_allocate(1, &capacity);
+    EXPECT_EQ(64, capacity);
+    detail::memory_chunk_free(chunk, capacity);
+    chunk = detail::memory_chunk_allocate(1000, &capacity);
+    EXPECT_EQ(1024, capacity);
+    detail::memory_chunk_free(chunk, capacity);
+    chunk = detail::memory_chunk_allocate(1024, &capacity);
+    EXPECT_EQ(1024, capacity);
+    detail::memory_chunk_free(chunk, capacity);
+
+    // Big requests are exact
+    chunk = detail::memory_chunk_allocate(3 * 1024 * 1024 + 5, &capacity);
+    EXPECT_EQ(3 * 1024 * 1024 + 5, capacity);
+    detail::memory_chunk_free(chunk, capacity);
+}
+
+TEST(MemoryChunkPool, PodMemoryBlockReuse) {
+    char *begin, *end, *first_begin;
+    memory_block_pod_allocator_api *api;
+    memory_block_ptr a = make_pod_memory_block(2048);
+    api = get_memory_block_pod_allocator_api(a.get());
+    api->allocate(a.get(), 100, 1, &first_begin, &end);
+    EXPECT_EQ(100, end - first_begin);
+    a = memory_block_ptr();
+
+    // The chunk freed by the first memory block gets reused
+    memory_block_ptr b = make_pod_memory_block(2048);
+    api->allocate(b.get(), 100, 1, &begin, &end);
+    EXPECT_EQ(first_begin, begin);
+}
+
+TEST(MemoryChunkPool, GrowthPolicy) {
+    memory_block_growth_policy saved = get_memory_block_growth_policy();
+
+    // The default doubles the capacity
+    EXPECT_EQ(1000, detail::memory_block_next_chunk_size(1000, 10));
+    EXPECT_EQ(5000, detail::memory_block_next_chunk_size(1000, 5000));
+
+    memory_block_growth_policy policy = {256, 50, 4096};
+    set_memory_block_growth_policy(policy);
+    EXPECT_EQ(500, detail::memory_block_next_chunk_size(1000, 10));
+    EXPECT_EQ(256, detail::memory_block_next_chunk_size(100, 10));
+    EXPECT_EQ(4096, detail::memory_block_next_chunk_size(100000, 10));
+    EXPECT_EQ(10000, detail::memory_block_next_chunk_size(100000, 10000));
+
+    // Strings still get assigned properly with a small growth policy
+    memory_block_growth_policy small_policy = {1, 1, 64};
+    set_memory_block_growth_policy(small_policy);
+    nd::array a = nd::empty(20, "M * string");
+    for (int i = 0; i < 20; ++i) {
+        a(i).vals() = "a somewhat longer string value";
+    }
+    EXPECT_EQ("a somewhat longer string value", a(19).as<string>());
+    set_memory_block_growth_policy(saved);
+
+    memory_block_growth_policy bad_policy = {0, 0, 0};
+    EXPECT_THROW(set_memory_block_growth_policy(bad_policy), runtime_error);
+}
+
+TEST(MemoryChunkPool, Trim) {
+    memory_chunk_pool_trim();
+    EXPECT_EQ(0, memory_chunk_pool_cached_bytes());
+}
@@ -0,0 +1,179 @@
+//
+// Copyright (C) 2011-14 Mark Wiebe, DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+#include <inc_gtest.hpp>
+
+#include <dynd/array.hpp>
+#include <dynd/json_parser.hpp>
+#include <dynd/json_formatter.hpp>
+#include <dynd/var_dim_builder.hpp>
+#include <dynd/eval/thread_pool.hpp>
+#include <dynd/eval/parallel_eval.hpp>
+#include <dynd/types/string_type.hpp>
+#include <dynd/types/dictionary_string_type.hpp>
+#include <dynd/types/strided_dim_type.hpp>
+
+using namespace std;
+using namespace dynd;
+
+static void square_task(intptr_t task_index, void *extra)
+{
+    reinterpret_cast<intptr_t *>(extra)[task_index] = task_index * task_index;
+}
+
+TEST(ThreadPool, Run) {
+    eval::thread_pool pool(4);
+    EXPECT_EQ(4, pool.get_num_threads());
+    vector<intptr_t> out(1000, -1);
+    pool.run(1000, &square_task, &out[0]);
+    for (intptr_t i = 0; i < 1000; ++i) {
+        EXPECT_EQ(i * i, out[i]);
+    }
+    // The pool can be used again
+    out.assign(1000, -1);
+    pool.run(3, &square_task, &out[0]);
+    EXPECT_EQ(4, out[2]);
+    EXPECT_EQ(-1, out[3]);
+
+    // With one thread, the tasks run on the calling thread
+    eval::thread_pool single(1);
+    single.run(10, &square_task, &out[0]);
+    EXPECT_EQ(81, out[9]);
+
+    EXPECT_GE(eval::thread_pool::get_hardware_concurrency(), 1);
+    EXPECT_THROW(eval::thread_pool(-1), invalid_argument);
+}
+
+TEST(ParallelEval, Convert) {
+    eval::thread_pool pool(4);
+    eval::eval_context ectx;
+    ectx.pool = &pool;
+    ectx.parallel_grain_size = 10;
+
+    nd::array a = nd::empty(1001, "strided * int32");
+    for (int i = 0; i < 1001; ++i) {
+        a(i).vals() = i * 3;
+    }
+    nd::array b = a.ucast<double>().eval(&ectx);
+    EXPECT_EQ(ndt::type("strided * float64"), b.get_type());
+    for (int i = 0; i < 1001; ++i) {
+        EXPECT_EQ(i * 3., b(i).as<double>());
+    }
+
+    // Multi-dimensional, with the result keeping the input's axis order
+    nd::array fvals = nd::empty(40 * 30, "strided * int16");
+    for (int i = 0; i < 40 * 30; ++i) {
+        fvals(i).vals() = i;
+    }
+    intptr_t shape[2] = {40, 30}, strides[2] = {2, 80};
+    nd::array c = nd::make_strided_array_from_data(ndt::make_type<int16_t>(), 2, shape, strides,
+                    nd::read_access_flag, fvals.get_readwrite_originptr(), fvals.get_data_memblock(), NULL);
+    nd::array d = c.ucast<int64_t>().eval(&ectx);
+    EXPECT_EQ(ndt::type("strided * strided * int64"), d.get_type());
+    EXPECT_EQ(8, d.get_strides()[0]);
+    EXPECT_EQ(320, d.get_strides()[1]);
+    EXPECT_EQ(39, d(39, 0).as<int>());
+    EXPECT_EQ(17 + 29 * 40, d(17, 29).as<int>());
+
+    // Conversion errors from the worker threads reach the caller
+    ectx.default_assign_error_mode = assign_error_overflow;
+    a(700).vals() = 1000;
+    EXPECT_THROW(a.ucast<int8_t>().eval(&ectx), overflow_error);
+
+    // Small arrays are evaluated on the calling thread
+    ectx.parallel_grain_size = 1000;
+    EXPECT_EQ(3, a(irange(0, 3)).ucast<int8_t>().eval(&ectx)(1).as<int>());
+}
+
+TEST(ParallelEval, BlockrefResults) {
+    eval::thread_pool pool(3);
+    eval::eval_context ectx;
+    ectx.pool = &pool;
+    ectx.parallel_grain_size = 1;
+
+    // Strings each thread allocates are merged into the result's memory block
+    nd::array a = nd::empty(100, "strided * int32");
+    for (int i = 0; i < 100; ++i) {
+        a(i).vals() = i * 7;
+    }
+    nd::array b = a.ucast(ndt::make_string()).eval(&ectx);
+    a = nd::array();
+    EXPECT_EQ(ndt::type("strided * string"), b.get_type());
+    for (int i = 0; i < 100; ++i) {
+        stringstream ss;
+        ss << i * 7;
+        EXPECT_EQ(ss.str(), b(i).as<string>());
+    }
+
+    // Var dims, with the rows split between the threads
+    var_dim_builder vb(ndt::make_type<int32_t>());
+    int32_t vals[] = {1, 2, 3, 4, 5, 6, 7, 8, 9};
+    vb.append_row(vals, 2);
+    vb.append_row(NULL, 0);
+    vb.append_row(vals + 2, 1);
+    vb.append_row(vals + 3, 3);
+    vb.append_row(vals + 6, 1);
+    vb.append_row(vals + 7, 2);
+    nd::array c = vb.finalize();
+    nd::array d = c.ucast<double>().eval(&ectx);
+    c = nd::array();
+    EXPECT_EQ(ndt::type("strided * var * float64"), d.get_type());
+    EXPECT_EQ("[[1,2],[],[3],[4,5,6],[7],[8,9]]", format_json(d).as<string>());
+
+    // Struct fields with strings
+    nd::array e = nd::empty(3, "strided * {x: int32, y: string}");
+    e.vals() = parse_json("3 * {x: int32, y: string}", "[{\"x\": 1, \"y\": \"one\"}, {\"x\": 2, \"y\": \"two\"}, {\"x\": 3, \"y\": \"three\"}]");
+    nd::array f = e.eval_copy(nd::readwrite_access_flags, &ectx);
+    e = nd::array();
+    EXPECT_EQ("[{\"x\":1,\"y\":\"one\"},{\"x\":2,\"y\":\"two\"},{\"x\":3,\"y\":\"three\"}]",
+                    format_json(f).as<string>());
+}
+
+TEST(ParallelEval, ErrorTypes) {
+    eval::thread_pool pool(4);
+    eval::eval_context ectx;
+    ectx.pool = &pool;
+    ectx.parallel_grain_size = 1;
+
+    // A broadcasting error in one of the threads keeps its type
+    var_dim_builder vb(ndt::make_type<int32_t>());
+    int32_t vals[] = {1, 2, 3};
+    for (int i = 0; i < 8; ++i) {
+        vb.append_row(vals, i == 5 ? 2 : 3);
+    }
+    nd::array a = vb.finalize();
+    nd::array b = nd::empty(8, 3, "strided * strided * int32");
+    EXPECT_THROW(eval::parallel_eval_assign(b, a, &ectx), broadcast_error);
+}
+
+TEST(ParallelEval, SerialTypes) {
+    eval::thread_pool pool(8);
+    eval::eval_context ectx;
+    ectx.pool = &pool;
+    ectx.parallel_grain_size = 1;
+
+    // The dictionary of a dictionary_string type grows during assignment,
+    // so it isn't split across the threads
+    nd::array a = nd::empty(20000, "strided * int32");
+    for (int i = 0; i < 20000; ++i) {
+        a(i).vals() = i % 500;
+    }
+    nd::array b = a.ucast(ndt::make_string()).eval();
+    nd::array c = nd::empty(20000, ndt::make_strided_dim(ndt::make_dictionary_string()));
+    EXPECT_FALSE(eval::parallel_eval_assign(c, b, &ectx));
+    nd::array d = b.ucast(ndt::make_dictionary_string()).eval(&ectx);
+    const dictionary_string_type *dst = static_cast<const dictionary_string_type *>(
+                    d.get_dtype().extended());
+    EXPECT_EQ(500u, dst->get_dictionary().size());
+    for (int i = 0; i < 20000; i += 37) {
+        stringstream ss;
+        ss << i % 500;
+        EXPECT_EQ(ss.str(), d(i).as<string>());
+    }
+}
@@ -135,3 +135,38 @@ TEST(ShapeTools, MultiStridesToAxisPerm_TwoOps) {
     EXPECT_EQ(0, axis_perm[2]);
     EXPECT_EQ(1, axis_perm[3]);
 }
+
+TEST(ShapeTools, OptimizeStridedDims) {
+    // C-order dimensions merge into one
+    intptr_t ndim = 3;
+    intptr_t shape[] = {2, 3, 4};
+    intptr_t strides0[] = {96, 32, 8}, strides1[] = {48, 16, 4};
+    intptr_t *stridesptr[2] = {strides0, strides1};
+    optimize_strided_dims(ndim, shape, 2, stridesptr);
+    EXPECT_EQ(1, ndim);
+    EXPECT_EQ(24, shape[0]);
+    EXPECT_EQ(8, strides0[0]);
+    EXPECT_EQ(4, strides1[0]);
+
+    // Transposed dimensions get reordered so the smallest stride is
+    // innermost, and the size-one dimension is removed
+    ndim = 3;
+    intptr_t shape_t[] = {5, 1, 3};
+    intptr_t strides_t0[] = {4, 0, 20}, strides_t1[] = {4, 0, 20};
+    stridesptr[0] = strides_t0;
+    stridesptr[1] = strides_t1;
+    optimize_strided_dims(ndim, shape_t, 2, stridesptr);
+    EXPECT_EQ(1, ndim);
+    EXPECT_EQ(15, shape_t[0]);
+    EXPECT_EQ(4, strides_t0[0]);
+
+    // Strides which only line up in one operand don't merge
+    ndim = 2;
+    intptr_t shape_m[] = {3, 4};
+    intptr_t strides_m0[] = {16, 4}, strides_m1[] = {4, 12};
+    stridesptr[0] = strides_m0;
+    stridesptr[1] = strides_m1;
+    optimize_strided_dims(ndim, shape_m, 2, stridesptr);
+    EXPECT_EQ(2, ndim);
+    EXPECT_EQ(12, shape_m[0] * shape_m[1]);
+}
@@ -12,6 +12,8 @@
 #include <dynd/types/byteswap_type.hpp>
 #include <dynd/types/convert_type.hpp>
 #include <dynd/types/fixedbytes_type.hpp>
+#include <dynd/types/strided_dim_type.hpp>
+#include <dynd/kernels/byteswap_kernels.hpp>
 
 using namespace std;
 using namespace dynd;
@@ -78,3 +80,91 @@ TEST(ByteswapDType, CanonicalDType) {
     // The canonical type of a byteswap type is always the non-swapped version
     EXPECT_EQ((ndt::make_type<float>()), (ndt::make_byteswap<float>().get_canonical_type()));
 }
+
+template<typename T>
+static void check_byteswap_roundtrip(intptr_t size)
+{
+    nd::array a = nd::empty(size, ndt::make_strided_dim(ndt::make_type<T>()));
+    T *a_ptr = reinterpret_cast<T *>(a.get_readwrite_originptr());
+    for (intptr_t i = 0; i < size; ++i) {
+        a_ptr[i] = static_cast<T>(i * 0x01020304 + 5);
+    }
+    // Native -> swapped
+    nd::array b = nd::empty(size, ndt::make_strided_dim(ndt::make_byteswap<T>()));
+    b.vals() = a;
+    const char *b_ptr = b.get_readonly_originptr();
+    for (intptr_t i = 0; i < size; ++i) {
+        const char *a_bytes = reinterpret_cast<const char *>(a_ptr + i);
+        for (size_t j = 0; j < sizeof(T); ++j) {
+            if (a_bytes[j] != b_ptr[i * sizeof(T) + sizeof(T) - j - 1]) {
+                ADD_FAILURE() << "byte " << j << " of value " << i << " was not swapped";
+                return;
+            }
+        }
+    }
+    // Swapped -> native
+    nd::array c = nd::empty(size, ndt::make_strided_dim(ndt::make_type<T>()));
+    c.vals() = b;
+    EXPECT_EQ(0, memcmp(a.get_readonly_originptr(), c.get_readonly_originptr(), size * sizeof(T)));
+}
+
+TEST(ByteswapDType, StridedContiguous) {
+    // Sizes which aren't a multiple of the vector size
+    check_byteswap_roundtrip<int16_t>(1001);
+    check_byteswap_roundtrip<int32_t>(1001);
+    check_byteswap_roundtrip<int64_t>(1001);
+    check_byteswap_roundtrip<double>(3);
+
+    // Pairwise swaps of complex values
+    nd::array a = nd::empty(37, ndt::make_strided_dim(ndt::make_type<dynd_complex<float> >()));
+    for (int i = 0; i < 37; ++i) {
+        a(i).vals() = dynd_complex<float>(1.5f * i, -2.25f * i);
+    }
+    nd::array b = nd::empty(37, ndt::make_strided_dim(ndt::make_byteswap<dynd_complex<float> >()));
+    b.vals() = a;
+    const uint32_t *a_ptr = reinterpret_cast<const uint32_t *>(a.get_readonly_originptr());
+    const uint32_t *b_ptr = reinterpret_cast<const uint32_t *>(b.get_readonly_originptr());
+    EXPECT_EQ(byteswap_value(a_ptr[21]), b_ptr[21]);
+    EXPECT_EQ(byteswap_value(a_ptr[60]), b_ptr[60]);
+    nd::array c = b.ucast(ndt::make_type<dynd_complex<float> >()).eval();
+    EXPECT_EQ(dynd_complex<float>(1.5f * 30, -2.25f * 30), c(30).as<dynd_complex<float> >());
+
+    // A strided source
+    nd::array d = nd::empty(500, ndt::make_strided_dim(ndt::make_byteswap<int32_t>()));
+    d.vals() = 0x01020304;
+    nd::array e = d(irange().by(2)).ucast(ndt::make_type<int32_t>()).eval();
+    ASSERT_EQ(250, e.get_dim_size());
+    EXPECT_EQ(0x01020304, e(249).as<int32_t>());
+}
+
+TEST(ByteswapDType, FusedConvert) {
+    intptr_t size = 1001;
+    // Big-endian style int32 values read as float64
+    nd::array a = nd::empty(size, ndt::make_strided_dim(ndt::make_byteswap<int32_t>()));
+    uint32_t *a_ptr = reinterpret_cast<uint32_t *>(a.get_readwrite_originptr());
+    for (intptr_t i = 0; i < size; ++i) {
+        a_ptr[i] = byteswap_value(static_cast<uint32_t>(i * 1000 - 500000));
+    }
+    nd::array b = nd::empty(size, ndt::make_strided_dim(ndt::make_type<double>()));
+    b.vals() = a;
+    const double *b_ptr = reinterpret_cast<const double *>(b.get_readonly_originptr());
+    for (intptr_t i = 0; i < size; ++i) {
+        if (b_ptr[i] != i * 1000 - 500000) {
+            EXPECT_EQ(i * 1000 - 500000, b_ptr[i]);
+            break;
+        }
+    }
+
+    // And back, with error checking on the conversion
+    nd::array c = nd::empty(size, ndt::make_strided_dim(ndt::make_byteswap<int32_t>()));
+    c.val_assign(b, assign_error_fractional);
+    EXPECT_EQ(0, memcmp(a.get_readonly_originptr(), c.get_readonly_originptr(), size * sizeof(int32_t)));
+    b(500).vals() = 1.5;
+    EXPECT_THROW(c.val_assign(b, assign_error_fractional), runtime_error);
+
+    // Narrowing from the swapped type
+    nd::array d = nd::empty(size, ndt::make_strided_dim(ndt::make_type<int16_t>()));
+    EXPECT_THROW(d.val_assign(a, assign_error_overflow), overflow_error);
+    d.val_assign(a, assign_error_none);
+    EXPECT_EQ(static_cast<int16_t>(-500000), d(0).as<int16_t>());
+}
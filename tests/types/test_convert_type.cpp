@@ -8,9 +8,15 @@
 #include <stdexcept>
 #include "inc_gtest.hpp"
 
+#include <dynd/array.hpp>
 #include <dynd/typed_data_assign.hpp>
 #include <dynd/types/byteswap_type.hpp>
 #include <dynd/types/convert_type.hpp>
+#include <dynd/types/type_alignment.hpp>
+#include <dynd/types/fixedbytes_type.hpp>
+#include <dynd/types/strided_dim_type.hpp>
+#include <dynd/types/string_type.hpp>
+#include <dynd/kernels/byteswap_kernels.hpp>
 
 using namespace std;
 using namespace dynd;
@@ -28,3 +34,49 @@ TEST(ConvertDType, CanonicalDType) {
     EXPECT_EQ((ndt::make_type<float>()), (ndt::make_convert<float, int>().get_canonical_type()));
 }
 
+TEST(ConvertDType, FusedChain) {
+    // Unaligned, byteswapped int32 read as float64, as when reading a big-endian file
+    ndt::type d = ndt::make_convert(ndt::make_type<double>(), make_unaligned(ndt::make_byteswap<int32_t>()));
+    EXPECT_EQ(ndt::make_fixedbytes(4, 1), d.storage_type());
+    intptr_t size = 1001;
+    nd::array a = nd::empty(size, ndt::make_strided_dim(d));
+    char *a_ptr = a.get_readwrite_originptr();
+    for (intptr_t i = 0; i < size; ++i) {
+        uint32_t value = byteswap_value(static_cast<uint32_t>(i * 3 - 1000));
+        memcpy(a_ptr + 4 * i, &value, 4);
+    }
+    nd::array b = a.eval();
+    ASSERT_EQ(ndt::make_strided_dim(ndt::make_type<double>()), b.get_type());
+    const double *b_ptr = reinterpret_cast<const double *>(b.get_readonly_originptr());
+    for (intptr_t i = 0; i < size; ++i) {
+        if (b_ptr[i] != i * 3 - 1000) {
+            EXPECT_EQ(i * 3 - 1000, b_ptr[i]);
+            break;
+        }
+    }
+
+    // With a final conversion to another type
+    nd::array c = nd::empty(size, ndt::make_strided_dim(ndt::make_type<int16_t>()));
+    c.val_assign(a, assign_error_overflow);
+    EXPECT_EQ(-1000, c(0).as<int16_t>());
+    EXPECT_EQ(2000, c(1000).as<int16_t>());
+    EXPECT_EQ(-997, c(1).as<int16_t>());
+    EXPECT_EQ(-997, a(1).as<int16_t>());
+}
+
+TEST(ConvertDType, BufferedChunks) {
+    // A conversion chain which can't be fused uses a buffer, make sure
+    // it works across several chunks of the buffer
+    intptr_t size = 300;
+    nd::array a = nd::empty(size, "M * string");
+    for (intptr_t i = 0; i < size; ++i) {
+        stringstream ss;
+        ss << i;
+        a(i).vals() = ss.str();
+    }
+    nd::array b = nd::empty(size, "M * float64");
+    b.vals() = a.ucast(ndt::make_type<int32_t>());
+    for (intptr_t i = 0; i < size; ++i) {
+        EXPECT_EQ(i, b(i).as<double>());
+    }
+}
@@ -54,6 +54,28 @@ TEST(DataShapeParser, BasicThrow) {
     EXPECT_THROW(type_from_datashape("int33"), runtime_error);
 }
 
+TEST(DataShapeParser, Cached) {
+    // Parsing the same datashape again gives the same type
+    ndt::type a = type_from_datashape("var * {x: int32, y: string}");
+    ndt::type b = type_from_datashape("var * {x: int32, y: string}");
+    EXPECT_EQ(a, b);
+    EXPECT_EQ(a.extended(), b.extended());
+    EXPECT_EQ(ndt::make_var_dim(ndt::make_cstruct(ndt::make_type<int32_t>(), "x",
+                    ndt::make_string(), "y")), b);
+    // Errors are reported every time
+    EXPECT_THROW(type_from_datashape("3 * boot"), runtime_error);
+    EXPECT_THROW(type_from_datashape("3 * boot"), runtime_error);
+    // Enough distinct datashapes to cycle through the cache
+    for (int i = 1; i < 600; ++i) {
+        stringstream ss;
+        ss << i << " * int16";
+        EXPECT_EQ(ndt::make_fixed_dim(i, ndt::make_type<int16_t>()), type_from_datashape(ss.str()));
+    }
+    EXPECT_EQ(a, type_from_datashape("var * {x: int32, y: string}"));
+    // Builtin names can't be redefined
+    EXPECT_THROW(type_from_datashape("type float16 = int32\nfloat16"), runtime_error);
+}
+
 TEST(DataShapeParser, StringAtoms) {
     // Default string
     EXPECT_EQ(ndt::make_string(string_encoding_utf_8),
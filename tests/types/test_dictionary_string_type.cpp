@@ -0,0 +1,203 @@
+//
+// Copyright (C) 2011-14 Mark Wiebe, DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include "inc_gtest.hpp"
+
+#include <dynd/array.hpp>
+#include <dynd/types/dictionary_string_type.hpp>
+#include <dynd/types/categorical_type.hpp>
+#include <dynd/types/fixedstring_type.hpp>
+#include <dynd/types/strided_dim_type.hpp>
+#include <dynd/eval/thread_pool.hpp>
+#include <dynd/gfunc/call_callable.hpp>
+
+using namespace std;
+using namespace dynd;
+
+TEST(DictionaryStringType, Create) {
+    ndt::type d;
+
+    d = ndt::make_dictionary_string();
+    EXPECT_EQ(dictionary_string_type_id, d.get_type_id());
+    EXPECT_EQ(string_kind, d.get_kind());
+    EXPECT_EQ(4u, d.get_data_alignment());
+    EXPECT_EQ(4u, d.get_data_size());
+    EXPECT_EQ(0u, d.get_metadata_size());
+    EXPECT_EQ("dictionary_string", d.str());
+    // Each type has its own dictionary
+    EXPECT_EQ(d, d);
+    EXPECT_NE(d, ndt::make_dictionary_string());
+
+    d = ndt::make_dictionary_string(string_encoding_utf_16);
+    EXPECT_EQ("dictionary_string['utf16']", d.str());
+
+    // The datashape is the type shared by the whole process
+    d = ndt::type("dictionary_string");
+    EXPECT_EQ(ndt::make_shared_dictionary_string(), d);
+    EXPECT_EQ(d, ndt::type(d.str()));
+    EXPECT_NE(d, ndt::make_dictionary_string());
+    d = ndt::type("dictionary_string['utf16']");
+    EXPECT_EQ(ndt::make_shared_dictionary_string(string_encoding_utf_16), d);
+    EXPECT_EQ(d, ndt::type(d.str()));
+    EXPECT_NE(d, ndt::type("dictionary_string"));
+    EXPECT_EQ(ndt::make_strided_dim(d), ndt::type("strided * dictionary_string['utf16']"));
+}
+
+TEST(DictionaryStringType, Dictionary) {
+    string_dictionary dict;
+    const char *strs[3] = {"abc", "", "defg"};
+    for (int i = 0; i < 3; ++i) {
+        EXPECT_EQ((uint32_t)i, dict.intern(strs[i], strs[i] + strlen(strs[i])));
+    }
+    EXPECT_EQ(3u, dict.size());
+    EXPECT_EQ(2, dict.find("defg", "defg" + 4));
+    EXPECT_EQ(-1, dict.find("def", "def" + 3));
+    EXPECT_EQ(0u, dict.intern("abc", "abc" + 3));
+    EXPECT_THROW(dict.get(3), runtime_error);
+
+    // Grow well past the initial hash table size
+    for (int i = 0; i < 1000; ++i) {
+        stringstream ss;
+        ss << "str" << i;
+        string s = ss.str();
+        EXPECT_EQ((uint32_t)(i + 3), dict.intern(s.data(), s.data() + s.size()));
+    }
+    EXPECT_EQ(1003u, dict.size());
+    EXPECT_EQ(503, dict.find("str500", "str500" + 6));
+    string_type_data sd = dict.get(3);
+    EXPECT_EQ("str0", string(sd.begin, sd.end));
+}
+
+static void intern_task(intptr_t task_index, void *extra)
+{
+    string_dictionary& dict = *reinterpret_cast<string_dictionary *>(extra);
+    for (int i = 0; i < 2000; ++i) {
+        stringstream ss;
+        ss << "str" << (i * (task_index + 1)) % 2000;
+        string s = ss.str();
+        dict.get(dict.intern(s.data(), s.data() + s.size()));
+    }
+}
+
+TEST(DictionaryStringType, ThreadedIntern) {
+    // Several threads growing one dictionary at the same time
+    string_dictionary dict;
+    eval::thread_pool pool(8);
+    pool.run(8, &intern_task, &dict);
+    EXPECT_EQ(2000u, dict.size());
+    for (int i = 0; i < 2000; ++i) {
+        stringstream ss;
+        ss << "str" << i;
+        string s = ss.str();
+        intptr_t code = dict.find(s.data(), s.data() + s.size());
+        ASSERT_GE(code, 0);
+        string_type_data sd = dict.get(static_cast<uint32_t>(code));
+        EXPECT_EQ(s, string(sd.begin, sd.end));
+    }
+}
+
+TEST(DictionaryStringType, Assign) {
+    const char *a_arr[5] = {"red", "green", "red", "blue", "green"};
+    ndt::type d = ndt::make_dictionary_string();
+    nd::array a, b;
+
+    a = nd::array(a_arr).ucast(d).eval();
+    ASSERT_EQ(ndt::make_strided_dim(d), a.get_type());
+    for (int i = 0; i < 5; ++i) {
+        EXPECT_EQ(a_arr[i], a(i).as<string>());
+    }
+    // Repeated strings share a code
+    b = a.p("ints");
+    EXPECT_EQ(ndt::make_strided_dim(ndt::make_type<uint32_t>()), b.get_type());
+    EXPECT_EQ(0u, b(0).as<uint32_t>());
+    EXPECT_EQ(1u, b(1).as<uint32_t>());
+    EXPECT_EQ(0u, b(2).as<uint32_t>());
+    EXPECT_EQ(2u, b(3).as<uint32_t>());
+    EXPECT_EQ(1u, b(4).as<uint32_t>());
+
+    // A second array with the same type shares the dictionary
+    b = nd::empty(d);
+    b.vals() = "blue";
+    EXPECT_EQ(2u, b.p("ints").as<uint32_t>());
+    b.vals() = "yellow";
+    EXPECT_EQ(3u, b.p("ints").as<uint32_t>());
+    EXPECT_EQ(4u, static_cast<const dictionary_string_type *>(d.extended())->get_dictionary().size());
+
+    b = d.p("strings");
+    ASSERT_EQ(4, b.get_dim_size());
+    EXPECT_EQ("red", b(0).as<string>());
+    EXPECT_EQ("yellow", b(3).as<string>());
+
+    // To other string types, and between dictionaries with other encodings
+    b = a.ucast(ndt::make_fixedstring(5)).eval();
+    EXPECT_EQ("green", b(1).as<string>());
+    b = a.ucast(ndt::make_dictionary_string(string_encoding_utf_16)).eval();
+    EXPECT_EQ("blue", b(3).as<string>());
+    b = b.ucast(ndt::make_string()).eval();
+    EXPECT_EQ("red", b(2).as<string>());
+
+    // To and from categorical
+    const char *cats[3] = {"blue", "green", "red"};
+    b = a.ucast(ndt::make_categorical(cats)).eval();
+    EXPECT_EQ(2u, b.p("ints")(0).as<uint32_t>());
+    b = b.ucast(ndt::make_dictionary_string()).eval();
+    EXPECT_EQ("green", b(4).as<string>());
+
+    // Numbers
+    b = nd::empty(d);
+    b.vals() = 1234;
+    EXPECT_EQ("1234", b.as<string>());
+    EXPECT_EQ(1234, b.as<int>());
+}
+
+TEST(DictionaryStringType, Comparisons) {
+    ndt::type d = ndt::make_dictionary_string();
+    nd::array a, b;
+
+    a = nd::array("abc").ucast(d).eval();
+    b = nd::array("abd").ucast(d).eval();
+    EXPECT_TRUE(a.op_sorting_less(b));
+    EXPECT_TRUE(a < b);
+    EXPECT_TRUE(a <= b);
+    EXPECT_FALSE(a == b);
+    EXPECT_TRUE(a != b);
+    EXPECT_FALSE(a >= b);
+    EXPECT_FALSE(a > b);
+    EXPECT_TRUE(b > a);
+
+    // The ordering is by string, not by code
+    a = nd::array("zzz").ucast(d).eval();
+    EXPECT_TRUE(a > b);
+    b = nd::array("zzz").ucast(d).eval();
+    EXPECT_TRUE(a == b);
+    EXPECT_TRUE(a <= b);
+    EXPECT_FALSE(a < b);
+
+    // Against other strings and other dictionaries
+    b = nd::array("zzz");
+    EXPECT_TRUE(a == b);
+    b = nd::array("zzz").ucast(ndt::make_dictionary_string(string_encoding_utf_16)).eval();
+    EXPECT_TRUE(a == b);
+    EXPECT_FALSE(a < b);
+}
+
+TEST(DictionaryStringType, Find) {
+    nd::array a, b, c;
+
+    const char *a_arr[4] = {"abc", "ababc", "ababab", "abd"};
+    a = nd::array(a_arr).ucast(ndt::make_dictionary_string()).eval();
+    b = "abc";
+
+    c = a.f("find", b).eval();
+    ASSERT_EQ(ndt::make_strided_dim(ndt::make_type<intptr_t>()), c.get_type());
+    ASSERT_EQ(4, c.get_shape()[0]);
+    EXPECT_EQ(0, c(0).as<intptr_t>());
+    EXPECT_EQ(2, c(1).as<intptr_t>());
+    EXPECT_EQ(-1, c(2).as<intptr_t>());
+    EXPECT_EQ(-1, c(3).as<intptr_t>());
+}
@@ -0,0 +1,231 @@
+//
+// Copyright (C) 2011-14 Mark Wiebe, DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include "inc_gtest.hpp"
+
+#include <dynd/array.hpp>
+#include <dynd/types/offset_dim_type.hpp>
+#include <dynd/types/var_dim_type.hpp>
+#include <dynd/types/strided_dim_type.hpp>
+#include <dynd/types/ckernel_deferred_type.hpp>
+#include <dynd/kernels/ckernel_deferred.hpp>
+#include <dynd/kernels/expr_kernel_generator.hpp>
+#include <dynd/kernels/lift_ckernel_deferred.hpp>
+#include <dynd/json_parser.hpp>
+#include <dynd/json_formatter.hpp>
+#include <dynd/strided_view.hpp>
+
+using namespace std;
+using namespace dynd;
+
+static nd::array make_test_offset_array()
+{
+    int32_t values[] = {1, 2, 3, 4, 5, 6, 7};
+    intptr_t offsets[] = {0, 3, 3, 7};
+    return nd::make_offset_dim_array(values, offsets);
+}
+
+TEST(OffsetDimType, Basic) {
+    ndt::type d = ndt::make_offset_dim(ndt::make_type<int32_t>());
+
+    EXPECT_EQ(offset_dim_type_id, d.get_type_id());
+    EXPECT_EQ(ndt::make_type<int32_t>(), d.p("element_type").as<ndt::type>());
+    EXPECT_EQ("offset * int32", d.str());
+    // Copies become var dimensions
+    EXPECT_EQ(ndt::make_var_dim(ndt::make_type<int32_t>()), d.get_canonical_type());
+    // It can only be viewed, not allocated
+    EXPECT_THROW(nd::empty(3, ndt::make_strided_dim(d)), type_error);
+}
+
+TEST(OffsetDimType, MakeArray) {
+    nd::array a = make_test_offset_array();
+    EXPECT_EQ(ndt::make_strided_dim(ndt::make_offset_dim(ndt::make_type<int32_t>())), a.get_type());
+    EXPECT_EQ(3, a.get_dim_size());
+    EXPECT_EQ("[[1,2,3],[],[4,5,6,7]]", format_json(a).as<string>());
+    EXPECT_EQ(3, a(0).get_dim_size());
+    EXPECT_EQ(0, a(1).get_dim_size());
+    EXPECT_EQ(4, a(2).get_dim_size());
+    EXPECT_EQ(5, a(2, 1).as<int>());
+    EXPECT_EQ(7, a(2, -1).as<int>());
+    EXPECT_THROW(a(0, 3), index_out_of_bounds);
+    EXPECT_EQ("[5,6]", format_json(a(2, irange(1, 3))).as<string>());
+    EXPECT_EQ("[[],[4,5,6,7]]", format_json(a(irange(1, 3))).as<string>());
+    EXPECT_EQ("[[1,2,3],[],[4,5,6,7]]", format_json(a(irange(), irange())).as<string>());
+    // The rows start at different offsets, so slicing within all of them isn't a view
+    EXPECT_THROW(a(irange(), 0), type_error);
+    EXPECT_THROW(a(irange(), irange(1, 2)), type_error);
+
+    // Offsets of another integer type are converted
+    int32_t values[] = {1, 2, 3};
+    int16_t offsets[] = {0, 1, 3};
+    nd::array b = nd::make_offset_dim_array(values, offsets);
+    EXPECT_EQ("[[1],[2,3]]", format_json(b).as<string>());
+
+    // Bad offsets
+    intptr_t decreasing[] = {0, 2, 1, 3};
+    EXPECT_THROW(nd::make_offset_dim_array(values, decreasing), invalid_argument);
+    intptr_t out_of_bounds[] = {0, 2, 4};
+    EXPECT_THROW(nd::make_offset_dim_array(values, out_of_bounds), invalid_argument);
+    EXPECT_THROW(nd::make_offset_dim_array(values, nd::empty(0, "strided * int64")), invalid_argument);
+}
+
+TEST(OffsetDimType, FlatValues) {
+    int32_t values[] = {1, 2, 3, 4, 5, 6, 7};
+    intptr_t offsets[] = {0, 3, 3, 7};
+    nd::array vals = values, offs = offsets;
+    nd::array a = nd::make_offset_dim_array(vals, offs);
+
+    // The flat values and the offsets are views, not copies
+    nd::array v = nd::offset_dim_values(a);
+    EXPECT_EQ(vals.get_readonly_originptr(), v.get_readonly_originptr());
+    EXPECT_EQ("[1,2,3,4,5,6,7]", format_json(v).as<string>());
+    nd::array o = nd::offset_dim_offsets(a);
+    EXPECT_EQ(offs.get_readonly_originptr(), o.get_readonly_originptr());
+    EXPECT_EQ("[0,3,3,7]", format_json(o).as<string>());
+    EXPECT_THROW(o(0).vals() = 1, runtime_error);
+    vals(4).vals() = 50;
+    EXPECT_EQ(50, a(2, 1).as<int>());
+
+    // A flat loop over all the values
+    strided_view<const int32_t, 1> sv(v);
+    int32_t total = 0;
+    for (const int32_t *it = sv.begin(); it != sv.end(); ++it) {
+        total += *it;
+    }
+    EXPECT_EQ(73, total);
+
+    // The values of a subset of adjacent rows, or of a single row
+    EXPECT_EQ("[4,50,6,7]", format_json(nd::offset_dim_values(a(irange(1, 3)))).as<string>());
+    EXPECT_EQ("[1,2,3]", format_json(nd::offset_dim_values(a(0))).as<string>());
+    EXPECT_EQ("[]", format_json(nd::offset_dim_values(a(irange(1, 1)))).as<string>());
+    // Reversed rows aren't adjacent
+    EXPECT_THROW(nd::offset_dim_values(a(irange().by(-1))), type_error);
+    EXPECT_THROW(nd::offset_dim_values(vals), type_error);
+}
+
+TEST(OffsetDimType, Assign) {
+    nd::array a = make_test_offset_array();
+
+    // Copying makes a var dimension
+    nd::array b = a.eval_copy(nd::readwrite_access_flags);
+    EXPECT_EQ(ndt::type("strided * var * int32"), b.get_type());
+    EXPECT_EQ("[[1,2,3],[],[4,5,6,7]]", format_json(b).as<string>());
+
+    // offset to strided, var and offset
+    nd::array c = nd::empty(4, "strided * float64");
+    c.vals() = a(2);
+    EXPECT_EQ("[4,5,6,7]", format_json(c).as<string>());
+    b(0).vals() = a(0, irange().by(-1));
+    EXPECT_EQ("[[3,2,1],[],[4,5,6,7]]", format_json(b).as<string>());
+    int32_t values[] = {7, 6, 5, 4, 3, 2, 1};
+    intptr_t offsets[] = {0, 3, 3, 7};
+    nd::array d = nd::make_offset_dim_array(values, offsets);
+    d.vals() = a;
+    EXPECT_EQ("[[1,2,3],[],[4,5,6,7]]", format_json(d).as<string>());
+    EXPECT_THROW(d.vals() = a(irange().by(-1)), broadcast_error);
+
+    // strided, var and scalars to offset
+    int32_t row[] = {10, 20, 30};
+    a(0).vals() = row;
+    EXPECT_EQ("[[10,20,30],[],[4,5,6,7]]", format_json(a).as<string>());
+    a.vals() = b;
+    EXPECT_EQ("[[3,2,1],[],[4,5,6,7]]", format_json(a).as<string>());
+    a.vals() = 8;
+    EXPECT_EQ("[[8,8,8],[],[8,8,8,8]]", format_json(a).as<string>());
+    EXPECT_THROW(a(2).vals() = row, broadcast_error);
+}
+
+TEST(OffsetDimType, LiftExpr) {
+    nd::array ckd_base = nd::empty(ndt::make_ckernel_deferred());
+    // Create a deferred ckernel for converting int16 to int32
+    make_ckernel_deferred_from_assignment(
+                    ndt::make_type<int32_t>(), ndt::make_type<int16_t>(), ndt::make_type<int16_t>(),
+                    expr_operation_funcproto, assign_error_default,
+                    *reinterpret_cast<ckernel_deferred *>(ckd_base.get_readwrite_originptr()));
+
+    int16_t values[] = {1, 2, 3, 4, 5, 6};
+    intptr_t offsets[] = {0, 2, 6};
+    nd::array in = nd::make_offset_dim_array(values, offsets);
+
+    // Lift it from offset to var
+    ckernel_deferred ckd;
+    vector<ndt::type> lifted_types;
+    lifted_types.push_back(ndt::type("strided * var * int32"));
+    lifted_types.push_back(in.get_type());
+    lift_ckernel_deferred(&ckd, ckd_base, lifted_types);
+
+    ckernel_builder ckb;
+    nd::array out = nd::empty(2, "strided * var * int32");
+    const char *in_ptr = in.get_readonly_originptr();
+    const char *dynd_metadata[2] = {out.get_ndo_meta(), in.get_ndo_meta()};
+    ckd.instantiate_func(ckd.data_ptr, &ckb, 0, dynd_metadata, kernel_request_single);
+    expr_single_operation_t usngo = ckb.get()->get_function<expr_single_operation_t>();
+    usngo(out.get_readwrite_originptr(), &in_ptr, ckb.get());
+    EXPECT_EQ("[[1,2],[3,4,5,6]]", format_json(out).as<string>());
+
+    // Lift it from one offset row to a strided dimension
+    nd::array in_row = in(1);
+    ckernel_deferred ckd_row;
+    lifted_types[0] = ndt::type("strided * int32");
+    lifted_types[1] = in_row.get_type();
+    lift_ckernel_deferred(&ckd_row, ckd_base, lifted_types);
+
+    ckb.reset();
+    nd::array out_row = nd::empty(4, "strided * int32");
+    in_ptr = in_row.get_readonly_originptr();
+    dynd_metadata[0] = out_row.get_ndo_meta();
+    dynd_metadata[1] = in_row.get_ndo_meta();
+    ckd_row.instantiate_func(ckd_row.data_ptr, &ckb, 0, dynd_metadata, kernel_request_single);
+    usngo = ckb.get()->get_function<expr_single_operation_t>();
+    usngo(out_row.get_readwrite_originptr(), &in_ptr, ckb.get());
+    EXPECT_EQ("[3,4,5,6]", format_json(out_row).as<string>());
+
+    // Lift it from var to the rows of an offset dimension
+    int32_t out_values[6] = {0, 0, 0, 0, 0, 0};
+    nd::array out_vals = out_values;
+    nd::array out_offset = nd::make_offset_dim_array(out_vals, offsets);
+    nd::array in_var = parse_json("2 * var * int16", "[[7,8],[9,10,11,12]]");
+    ckernel_deferred ckd_offset;
+    lifted_types[0] = out_offset.get_type();
+    lifted_types[1] = in_var.get_type();
+    lift_ckernel_deferred(&ckd_offset, ckd_base, lifted_types);
+
+    ckb.reset();
+    in_ptr = in_var.get_readonly_originptr();
+    dynd_metadata[0] = out_offset.get_ndo_meta();
+    dynd_metadata[1] = in_var.get_ndo_meta();
+    ckd_offset.instantiate_func(ckd_offset.data_ptr, &ckb, 0, dynd_metadata, kernel_request_single);
+    usngo = ckb.get()->get_function<expr_single_operation_t>();
+    usngo(out_offset.get_readwrite_originptr(), &in_ptr, ckb.get());
+    EXPECT_EQ("[7,8,9,10,11,12]", format_json(out_vals).as<string>());
+
+    // A strided src broadcasts to every row, so it has to have size one
+    // or the size of each row
+    nd::array in_strided = parse_json("2 * 1 * int16", "[[1],[2]]");
+    lifted_types[1] = in_strided.get_type();
+    ckernel_deferred ckd_strided;
+    lift_ckernel_deferred(&ckd_strided, ckd_base, lifted_types);
+    ckb.reset();
+    in_ptr = in_strided.get_readonly_originptr();
+    dynd_metadata[1] = in_strided.get_ndo_meta();
+    ckd_strided.instantiate_func(ckd_strided.data_ptr, &ckb, 0, dynd_metadata, kernel_request_single);
+    usngo = ckb.get()->get_function<expr_single_operation_t>();
+    usngo(out_offset.get_readwrite_originptr(), &in_ptr, ckb.get());
+    EXPECT_EQ("[1,1,2,2,2,2]", format_json(out_vals).as<string>());
+
+    in_strided = parse_json("2 * 2 * int16", "[[1,2],[3,4]]");
+    lifted_types[1] = in_strided.get_type();
+    ckernel_deferred ckd_mismatch;
+    lift_ckernel_deferred(&ckd_mismatch, ckd_base, lifted_types);
+    ckb.reset();
+    in_ptr = in_strided.get_readonly_originptr();
+    dynd_metadata[1] = in_strided.get_ndo_meta();
+    ckd_mismatch.instantiate_func(ckd_mismatch.data_ptr, &ckb, 0, dynd_metadata, kernel_request_single);
+    usngo = ckb.get()->get_function<expr_single_operation_t>();
+    EXPECT_THROW(usngo(out_offset.get_readwrite_originptr(), &in_ptr, ckb.get()), broadcast_error);
+}
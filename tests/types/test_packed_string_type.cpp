@@ -0,0 +1,142 @@
+//
+// Copyright (C) 2011-14 Mark Wiebe, DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include "inc_gtest.hpp"
+
+#include <dynd/array.hpp>
+#include <dynd/types/packed_string_type.hpp>
+#include <dynd/types/string_type.hpp>
+#include <dynd/types/fixedstring_type.hpp>
+#include <dynd/types/strided_dim_type.hpp>
+#include <dynd/memblock/contiguous_memory_block.hpp>
+#include <dynd/gfunc/call_callable.hpp>
+
+using namespace std;
+using namespace dynd;
+
+TEST(PackedStringType, Create) {
+    ndt::type d;
+
+    d = ndt::make_packed_string();
+    EXPECT_EQ(packed_string_type_id, d.get_type_id());
+    EXPECT_EQ(string_kind, d.get_kind());
+    EXPECT_EQ(4u, d.get_data_alignment());
+    EXPECT_EQ(8u, d.get_data_size());
+    EXPECT_EQ("packed_string", d.str());
+    // Roundtripping through a string
+    EXPECT_EQ(d, ndt::type(d.str()));
+
+    d = ndt::make_packed_string(string_encoding_utf_16, int64_type_id);
+    EXPECT_EQ(packed_string_type_id, d.get_type_id());
+    EXPECT_EQ(8u, d.get_data_alignment());
+    EXPECT_EQ(16u, d.get_data_size());
+    EXPECT_EQ("packed_string['utf16',int64]", d.str());
+    EXPECT_EQ(d, ndt::type(d.str()));
+
+    d = ndt::make_packed_string(string_encoding_utf_8, int64_type_id);
+    EXPECT_EQ("packed_string[int64]", d.str());
+    EXPECT_EQ(d, ndt::type(d.str()));
+
+    EXPECT_THROW(ndt::make_packed_string(string_encoding_utf_8, int16_type_id), type_error);
+}
+
+TEST(PackedStringType, ContiguousStorage) {
+    const char *a_arr[4] = {"abc", "", "a longer string", "xyz"};
+    nd::array a = nd::array(a_arr).ucast(ndt::make_packed_string()).eval();
+    ASSERT_EQ(ndt::type("M * packed_string"), a.get_type());
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_EQ(a_arr[i], a(i).as<string>());
+    }
+
+    // All the characters are back to back in one buffer
+    const packed_string_type_metadata *md = reinterpret_cast<const packed_string_type_metadata *>(
+                    a.get_ndo_meta() + sizeof(strided_dim_type_metadata));
+    const int32_t *offsets = reinterpret_cast<const int32_t *>(a.get_readonly_originptr());
+    EXPECT_EQ(0, offsets[0]);
+    EXPECT_EQ(3, offsets[1]);
+    EXPECT_EQ(3, offsets[2]);
+    EXPECT_EQ(3, offsets[3]);
+    EXPECT_EQ(18, offsets[5]);
+    EXPECT_EQ(21, offsets[7]);
+    EXPECT_EQ("abca longer stringxyz",
+                    string(contiguous_memory_block_get_data(md->blockref), 21));
+}
+
+TEST(PackedStringType, Assign) {
+    const char *a_arr[3] = {"testing", "one", "two"};
+    nd::array a, b, c;
+
+    // string -> packed_string -> string
+    a = nd::empty(3, "M * packed_string");
+    a.vals() = a_arr;
+    EXPECT_EQ("one", a(1).as<string>());
+    b = nd::empty(3, "M * string");
+    b.vals() = a;
+    EXPECT_EQ("testing", b(0).as<string>());
+    EXPECT_EQ("two", b(2).as<string>());
+
+    // Changing the encoding
+    c = a.ucast(ndt::make_packed_string(string_encoding_utf_32, int64_type_id)).eval();
+    EXPECT_EQ("two", c(2).as<string>());
+    c = c.ucast(ndt::make_packed_string(string_encoding_utf_16)).eval();
+    EXPECT_EQ("testing", c(0).as<string>());
+
+    // packed_string -> fixedstring
+    c = a.ucast(ndt::make_fixedstring(7)).eval();
+    EXPECT_EQ("testing", c(0).as<string>());
+    EXPECT_EQ("one", c(1).as<string>());
+
+    // Numbers
+    a = nd::empty("packed_string");
+    a.vals() = 1234;
+    EXPECT_EQ("1234", a.as<string>());
+    EXPECT_EQ(1234, a.as<int>());
+}
+
+TEST(PackedStringType, Comparisons) {
+    nd::array a, b;
+
+    a = nd::array("abc").ucast(ndt::make_packed_string()).eval();
+    b = nd::array("abd").ucast(ndt::make_packed_string()).eval();
+    EXPECT_TRUE(a.op_sorting_less(b));
+    EXPECT_TRUE(a < b);
+    EXPECT_TRUE(a <= b);
+    EXPECT_FALSE(a == b);
+    EXPECT_TRUE(a != b);
+    EXPECT_FALSE(a >= b);
+    EXPECT_FALSE(a > b);
+    EXPECT_TRUE(b > a);
+
+    // Against a blockref string
+    b = nd::array("abc");
+    EXPECT_TRUE(a == b);
+    EXPECT_FALSE(a < b);
+
+    // Different encodings and offsets
+    a = nd::array("abcd").ucast(ndt::make_packed_string(string_encoding_utf_16, int64_type_id)).eval();
+    b = nd::array("abcde").ucast(ndt::make_packed_string(string_encoding_utf_16, int64_type_id)).eval();
+    EXPECT_TRUE(a < b);
+    EXPECT_FALSE(a == b);
+    EXPECT_TRUE(b >= a);
+}
+
+TEST(PackedStringType, Find) {
+    nd::array a, b, c;
+
+    const char *a_arr[4] = {"abc", "ababc", "ababab", "abd"};
+    a = nd::array(a_arr).ucast(ndt::make_packed_string()).eval();
+    b = "abc";
+
+    c = a.f("find", b).eval();
+    ASSERT_EQ(ndt::make_strided_dim(ndt::make_type<intptr_t>()), c.get_type());
+    ASSERT_EQ(4, c.get_shape()[0]);
+    EXPECT_EQ(0, c(0).as<intptr_t>());
+    EXPECT_EQ(2, c(1).as<intptr_t>());
+    EXPECT_EQ(-1, c(2).as<intptr_t>());
+    EXPECT_EQ(-1, c(3).as<intptr_t>());
+}
@@ -0,0 +1,145 @@
+//
+// Copyright (C) 2011-14 Mark Wiebe, DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include "inc_gtest.hpp"
+
+#include <dynd/array.hpp>
+#include <dynd/types/small_string_type.hpp>
+#include <dynd/types/string_type.hpp>
+#include <dynd/types/fixedstring_type.hpp>
+#include <dynd/types/packed_string_type.hpp>
+#include <dynd/gfunc/call_callable.hpp>
+
+using namespace std;
+using namespace dynd;
+
+TEST(SmallStringType, Create) {
+    ndt::type d;
+
+    d = ndt::make_small_string();
+    EXPECT_EQ(small_string_type_id, d.get_type_id());
+    EXPECT_EQ(string_kind, d.get_kind());
+    EXPECT_EQ(sizeof(const char *), d.get_data_alignment());
+    EXPECT_EQ(16u, d.get_data_size());
+    EXPECT_EQ("small_string", d.str());
+    // Roundtripping through a string
+    EXPECT_EQ(d, ndt::type(d.str()));
+
+    d = ndt::make_small_string(string_encoding_utf_16);
+    EXPECT_EQ("small_string['utf16']", d.str());
+    EXPECT_EQ(d, ndt::type(d.str()));
+}
+
+TEST(SmallStringType, InlineStorage) {
+    const char *a_arr[4] = {"", "abc", "fifteen bytes!!", "sixteen bytes!!!"};
+    nd::array a = nd::array(a_arr).ucast(ndt::make_small_string()).eval();
+    ASSERT_EQ(ndt::type("M * small_string"), a.get_type());
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_EQ(a_arr[i], a(i).as<string>());
+    }
+
+    // Strings of up to 15 bytes are stored in the element
+    const char *data = a.get_readonly_originptr();
+    EXPECT_TRUE(small_string_is_inline(data));
+    EXPECT_EQ(0, data[15]);
+    EXPECT_TRUE(small_string_is_inline(data + 16));
+    EXPECT_EQ(3, data[16 + 15]);
+    EXPECT_EQ("abc", string(data + 16, 3));
+    EXPECT_TRUE(small_string_is_inline(data + 32));
+    EXPECT_FALSE(small_string_is_inline(data + 48));
+
+    // Transcoding a short string also stores it inline
+    a = nd::array("abcdefg").ucast(ndt::make_small_string(string_encoding_utf_16)).eval();
+    EXPECT_TRUE(small_string_is_inline(a.get_readonly_originptr()));
+    EXPECT_EQ("abcdefg", a.as<string>());
+    a = nd::array("abcdefgh").ucast(ndt::make_small_string(string_encoding_utf_16)).eval();
+    EXPECT_FALSE(small_string_is_inline(a.get_readonly_originptr()));
+    EXPECT_EQ("abcdefgh", a.as<string>());
+}
+
+TEST(SmallStringType, Assign) {
+    const char *a_arr[3] = {"testing", "a rather longer string", "two"};
+    nd::array a, b, c;
+
+    // string -> small_string -> string
+    a = nd::empty(3, "M * small_string");
+    a.vals() = a_arr;
+    EXPECT_EQ("a rather longer string", a(1).as<string>());
+    b = nd::empty(3, "M * string");
+    b.vals() = a;
+    EXPECT_EQ("testing", b(0).as<string>());
+    EXPECT_EQ("a rather longer string", b(1).as<string>());
+
+    // small_string -> small_string, including between encodings
+    c = a.ucast(ndt::make_small_string(string_encoding_utf_32)).eval();
+    EXPECT_EQ("two", c(2).as<string>());
+    c = c.ucast(ndt::make_small_string()).eval();
+    EXPECT_EQ("a rather longer string", c(1).as<string>());
+    c = a.ucast(ndt::make_packed_string()).eval();
+    EXPECT_EQ("testing", c(0).as<string>());
+
+    // small_string -> fixedstring
+    c = a(2).ucast(ndt::make_fixedstring(7)).eval();
+    EXPECT_EQ("two", c.as<string>());
+    EXPECT_THROW(a(1).ucast(ndt::make_fixedstring(7)).eval(), runtime_error);
+
+    // Numbers
+    a = nd::empty("small_string");
+    a.vals() = 1234;
+    EXPECT_EQ("1234", a.as<string>());
+    EXPECT_EQ(1234, a.as<int>());
+}
+
+TEST(SmallStringType, Comparisons) {
+    nd::array a, b;
+
+    a = nd::array("abc").ucast(ndt::make_small_string()).eval();
+    b = nd::array("abd").ucast(ndt::make_small_string()).eval();
+    EXPECT_TRUE(a.op_sorting_less(b));
+    EXPECT_TRUE(a < b);
+    EXPECT_TRUE(a <= b);
+    EXPECT_FALSE(a == b);
+    EXPECT_TRUE(a != b);
+    EXPECT_FALSE(a >= b);
+    EXPECT_FALSE(a > b);
+    EXPECT_TRUE(b > a);
+
+    // Inline against out of line strings
+    b = nd::array("abc, but longer than fifteen").ucast(ndt::make_small_string()).eval();
+    EXPECT_TRUE(a < b);
+    EXPECT_FALSE(a == b);
+    a = nd::array("abc, but longer than fifteen").ucast(ndt::make_small_string()).eval();
+    EXPECT_TRUE(a == b);
+    EXPECT_TRUE(a >= b);
+    EXPECT_FALSE(a != b);
+
+    // Against a blockref string
+    b = nd::array("abc, but longer than fifteen");
+    EXPECT_TRUE(a == b);
+    EXPECT_FALSE(a < b);
+
+    a = nd::array("abcd").ucast(ndt::make_small_string(string_encoding_utf_16)).eval();
+    b = nd::array("abcde").ucast(ndt::make_small_string(string_encoding_utf_16)).eval();
+    EXPECT_TRUE(a < b);
+    EXPECT_FALSE(a == b);
+}
+
+TEST(SmallStringType, Find) {
+    nd::array a, b, c;
+
+    const char *a_arr[4] = {"abc", "ababc", "ababababababababc", "abd"};
+    a = nd::array(a_arr).ucast(ndt::make_small_string()).eval();
+    b = "abc";
+
+    c = a.f("find", b).eval();
+    ASSERT_EQ(4, c.get_shape()[0]);
+    EXPECT_EQ(0, c(0).as<intptr_t>());
+    EXPECT_EQ(2, c(1).as<intptr_t>());
+    EXPECT_EQ(14, c(2).as<intptr_t>());
+    EXPECT_EQ(-1, c(3).as<intptr_t>());
+}
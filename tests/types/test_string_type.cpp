@@ -586,3 +586,38 @@ TEST(StringType, Iter) {
     EXPECT_TRUE(ascii_T_compare(str, reinterpret_cast<const uint32_t *>(it.data_ptr), it.data_elcount));
     it.destroy();
 }
+
+TEST(StringType, CompactBuffers) {
+    nd::array a, b;
+    intptr_t reclaimed;
+
+    a = parse_json("4 * string", "[\"first\", \"\", \"third string\", \"4\"]");
+    reclaimed = a.finalize_buffers(true);
+    EXPECT_LT(0, reclaimed);
+    EXPECT_EQ("first", a(0).as<string>());
+    EXPECT_EQ("", a(1).as<string>());
+    EXPECT_EQ("third string", a(2).as<string>());
+    EXPECT_EQ("4", a(3).as<string>());
+    // Compacting again has nothing left to reclaim
+    EXPECT_EQ(0, a.finalize_buffers(true));
+
+    // Strings nested in var dims and structs
+    a = parse_json("3 * {x: string, y: var * string}",
+                    "[{\"x\": \"one\", \"y\": [\"a\", \"bb\"]},"
+                    " {\"x\": \"two\", \"y\": []},"
+                    " {\"x\": \"three\", \"y\": [\"ccc\"]}]");
+    EXPECT_LT(0, a.finalize_buffers(true));
+    EXPECT_EQ("one", a(0, 0).as<string>());
+    EXPECT_EQ("three", a(2, 0).as<string>());
+    EXPECT_EQ("bb", a(0, 1, 1).as<string>());
+    EXPECT_EQ("ccc", a(2, 1, 0).as<string>());
+
+    // Can't compact data which is shared with another array
+    a = parse_json("2 * string", "[\"abc\", \"def\"]");
+    b = a(0);
+    EXPECT_THROW(a.finalize_buffers(true), runtime_error);
+    b = nd::array();
+    EXPECT_LT(0, a.finalize_buffers(true));
+    EXPECT_EQ("abc", a(0).as<string>());
+    EXPECT_EQ("def", a(1).as<string>());
+}
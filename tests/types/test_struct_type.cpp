@@ -443,3 +443,35 @@ TEST(StructDType, SingleCompareDifferentMetadata) {
     EXPECT_THROW((b > a), not_comparable_error);
 }
 
+
+TEST(StructDType, StridedAssignWithStrings) {
+    // Assigning a strided dimension of structs processes one field of
+    // all the elements at a time
+    ndt::type dt = ndt::make_struct(ndt::make_string(), "name", ndt::make_type<int>(), "id");
+    nd::array a = nd::make_strided_array(3, dt);
+    a(0,0).vals() = "alpha";
+    a(0,1).vals() = 1;
+    a(1,0).vals() = "beta";
+    a(1,1).vals() = 2;
+    a(2,0).vals() = "gamma";
+    a(2,1).vals() = 3;
+
+    ndt::type dt2 = ndt::make_struct(ndt::make_type<int64_t>(), "id", ndt::make_fixedstring(8), "name");
+    nd::array b = nd::make_strided_array(3, dt2);
+    b.val_assign(a);
+    EXPECT_EQ(1, b(0, 0).as<int64_t>());
+    EXPECT_EQ("alpha", b(0, 1).as<string>());
+    EXPECT_EQ(2, b(1, 0).as<int64_t>());
+    EXPECT_EQ("beta", b(1, 1).as<string>());
+    EXPECT_EQ(3, b(2, 0).as<int64_t>());
+    EXPECT_EQ("gamma", b(2, 1).as<string>());
+
+    // Broadcasting one value to every field
+    nd::array c = nd::make_strided_array(3, ndt::make_struct(ndt::make_string(), "a",
+                    ndt::make_type<double>(), "b"));
+    c.vals() = 12;
+    for (int i = 0; i != 3; ++i) {
+        EXPECT_EQ("12", c(i, 0).as<string>());
+        EXPECT_EQ(12., c(i, 1).as<double>());
+    }
+}
@@ -9,6 +9,11 @@
 #include "inc_gtest.hpp"
 
 #include <dynd/type.hpp>
+#include <dynd/types/strided_dim_type.hpp>
+#include <dynd/types/string_type.hpp>
+#include <dynd/types/cstruct_type.hpp>
+#include <dynd/types/var_dim_type.hpp>
+#include <dynd/types/dictionary_string_type.hpp>
 
 using namespace std;
 using namespace dynd;
@@ -151,3 +156,40 @@ TEST(DType, BasicConstructor) {
     EXPECT_EQ(d, ndt::type(d.str()));
 }
 
+
+TEST(DType, Interning) {
+    ndt::type a, b, c;
+
+    // Structurally equal types share one instance
+    a = ndt::make_strided_dim(ndt::make_string());
+    b = ndt::type("M * string");
+    EXPECT_TRUE(a.extended()->is_interned());
+    EXPECT_EQ(a.extended(), b.extended());
+    EXPECT_EQ(a.get_hash(), b.get_hash());
+    c = ndt::make_cstruct(ndt::make_type<int32_t>(), "x", ndt::make_string(), "y");
+    EXPECT_EQ(c.extended(), ndt::type(c.str()).extended());
+
+    // Different types stay different
+    b = ndt::make_strided_dim(ndt::make_string(string_encoding_utf_16));
+    EXPECT_NE(a.extended(), b.extended());
+    EXPECT_NE(a, b);
+    EXPECT_NE(a.get_hash(), b.get_hash());
+
+    // The hash mixes in the type's parameters, not only its printed form
+    b = ndt::make_cstruct(ndt::make_type<int32_t>(), "x", ndt::make_string(), "z");
+    EXPECT_NE(c.get_hash(), b.get_hash());
+    b = ndt::make_dictionary_string();
+    EXPECT_EQ(b.str(), ndt::make_dictionary_string().str());
+    EXPECT_NE(b.get_hash(), ndt::make_dictionary_string().get_hash());
+    EXPECT_EQ(ndt::make_var_dim(b).get_hash(), ndt::make_var_dim(b).get_hash());
+
+    // A type freed from the table is interned again when remade
+    int32_t use_count = a.extended()->get_use_count();
+    b = a;
+    EXPECT_EQ(use_count + 1, a.extended()->get_use_count());
+    a = ndt::type();
+    b = ndt::type();
+    a = ndt::make_strided_dim(ndt::make_string());
+    EXPECT_TRUE(a.extended()->is_interned());
+    EXPECT_EQ(a, ndt::type("M * string"));
+}
@@ -15,6 +15,9 @@
 #include <dynd/types/fixed_dim_type.hpp>
 #include <dynd/kernels/assignment_kernels.hpp>
 #include <dynd/json_parser.hpp>
+#include <dynd/json_formatter.hpp>
+#include <dynd/var_dim_builder.hpp>
+#include <dynd/memblock/pod_memory_block.hpp>
 
 using namespace std;
 using namespace dynd;
@@ -534,3 +537,67 @@ TEST(VarDimDType, IsTypeSubarray) {
     EXPECT_FALSE(ndt::type("strided * int32").is_type_subarray(ndt::type("var * int32")));
     EXPECT_FALSE(ndt::type("3 * int32").is_type_subarray(ndt::type("var * int32")));
 }
+
+TEST(VarDimBuilder, AppendRows) {
+    var_dim_builder b(ndt::make_type<int32_t>());
+    int32_t vals[] = {1, 2, 3, 4, 5, 6};
+    b.append_row(vals, 3);
+    b.append_row(NULL, 0);
+    int32_t *r = reinterpret_cast<int32_t *>(b.append_uninitialized_row(2));
+    r[0] = 10;
+    r[1] = 20;
+    b.append_row(vals + 3, 3);
+    EXPECT_EQ(4, b.get_row_count());
+    EXPECT_EQ(8, b.get_element_count());
+
+    nd::array a = b.finalize();
+    EXPECT_EQ(0, b.get_row_count());
+    EXPECT_EQ(0, b.get_element_count());
+    EXPECT_EQ(ndt::type("strided * var * int32"), a.get_type());
+    EXPECT_EQ("[[1,2,3],[],[10,20],[4,5,6]]", format_json(a).as<string>());
+
+    // All the rows are in one chunk of a POD memory block
+    const var_dim_type_metadata *md = reinterpret_cast<const var_dim_type_metadata *>(
+                    a.get_ndo_meta() + sizeof(strided_dim_type_metadata));
+    EXPECT_EQ((uint32_t)pod_memory_block_type, md->blockref->m_type);
+    EXPECT_EQ(a(0, 0).get_readonly_originptr() + 3 * sizeof(int32_t),
+                    a(2, 0).get_readonly_originptr());
+
+    // The builder can be reused, and the first array is unaffected
+    b.append_row(vals, 1);
+    nd::array c = b.finalize();
+    EXPECT_EQ("[[1]]", format_json(c).as<string>());
+    EXPECT_EQ("[[1,2,3],[],[10,20],[4,5,6]]", format_json(a).as<string>());
+}
+
+TEST(VarDimBuilder, Growth) {
+    var_dim_builder b(ndt::make_fixed_dim(2, ndt::make_type<double>()));
+    b.reserve(10, 4);
+    double pair[2];
+    for (int i = 0; i < 1000; ++i) {
+        char *r = b.append_uninitialized_row(i % 7);
+        for (int j = 0; j < i % 7; ++j) {
+            pair[0] = i;
+            pair[1] = j;
+            memcpy(r + j * sizeof(pair), pair, sizeof(pair));
+        }
+    }
+    nd::array a = b.finalize();
+    EXPECT_EQ(ndt::type("strided * var * 2 * float64"), a.get_type());
+    EXPECT_EQ(1000, a.get_dim_size());
+    EXPECT_EQ(0, a(700).get_dim_size());
+    EXPECT_EQ(6, a(699).get_dim_size());
+    EXPECT_EQ(699, a(699, 5, 0).as<int>());
+    EXPECT_EQ(5, a(699, 5, 1).as<int>());
+    EXPECT_EQ(10, a(10, 2, 0).as<int>());
+}
+
+TEST(VarDimBuilder, Errors) {
+    EXPECT_THROW(var_dim_builder(ndt::type("string")), type_error);
+    EXPECT_THROW(var_dim_builder(ndt::type("strided * int32")), type_error);
+    var_dim_builder b(ndt::make_type<int8_t>());
+    EXPECT_THROW(b.append_uninitialized_row(-1), runtime_error);
+    // An unused builder gives an empty array
+    nd::array a = b.finalize();
+    EXPECT_EQ(0, a.get_dim_size());
+}